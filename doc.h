@@ -5,12 +5,16 @@
  * Strings:
  * <ul>
  *  <li>\ref string/parsenum.c</li>
+ *  <li>\ref string/parsefloat.c</li>
+ *  <li>\ref string/formatnum.c</li>
+ *  <li>\ref string/csv.c (columnar parsing of delimited numeric text)</li>
  *  <li>
  *   Safe (out of bounds) string.h functions variants:
  *   <ul>
  *     <li>\ref string/strcpy_s.c</li>
  *     <li>\ref string/strcat_s.c</li>
  *     <li>\ref string/stpcpy_s.c</li>
+ *     <li>\ref string/strbuf.c (growable)</li>
  *   </ul>
  *   <ul>
  *    <li>
@@ -30,18 +34,37 @@
  *    </ul>
  *   </li>
  *  </ul>
+ *  <li>\ref string/aho_corasick.c (multiple patterns search)</li>
+ * </ul>
+ *
+ * Unicode:
+ * <ul>
+ *  <li>\ref unicode/transcode.c (UTF-8, UTF-16, UTF-32 and Latin-1 conversions)</li>
  * </ul>
  *
  * Data structures:
  * <ul>
  *  <li>\ref iterator/iterator.c</li>
+ *  <li>\ref iterator/aggregate.c</li>
+ *  <li>\ref iterator/generator.c</li>
  *  <li>
  *   Lists:
  *   <ul>
  *    <li>\ref lists/dlist.c</li>
+ *    <li>\ref lists/ulist.c</li>
+ *    <li>\ref lists/idlist.c (intrusive)</li>
  *   </ul>
  *  </li>
  *  <li>\ref hashtable/hashtable.c</li>
+ *  <li>\ref hashtable/ihashtable.c (intrusive)</li>
+ *  <li>\ref rbtree/irbtree.c (intrusive)</li>
+ *  <li>
+ *   Lock-free queues:
+ *   <ul>
+ *    <li>\ref queues/mpmc_queue.c (bounded)</li>
+ *    <li>\ref queues/mpsc_queue.c (unbounded)</li>
+ *   </ul>
+ *  </li>
  *  <ul>
  *   <li>
  *    Dynamic arrays:
@@ -50,5 +73,6 @@
  *     <li>\ref dynamic_arrays/dptrarray.c</li>
  *    </ul>
  *  </li>
+ *  <li>\ref sort/external_sort.c (larger than memory)</li>
  * </ul>
  */
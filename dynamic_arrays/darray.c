@@ -309,7 +309,7 @@ void darray_remove_range(DArray *da, unsigned int from, unsigned int to)
 
     diff = to - from + 1;
     darray_destroy_elements(da, from, diff);
-    memmove(OFFSET_TO_ADDR(da, to + 1), OFFSET_TO_ADDR(da, from), LENGTH(da, da->length - diff));
+    memmove(OFFSET_TO_ADDR(da, from), OFFSET_TO_ADDR(da, to + 1), LENGTH(da, da->length - to - 1));
     da->length -= diff;
     darray_wipeout(da, diff);
 }
@@ -463,6 +463,38 @@ static void darray_iterator_previous(const void *collection, void **state)
     *((uint8_t **) state) -= ary->element_size;
 }
 
+static size_t darray_iterator_next_span(const void *collection, void **state, const void **base, size_t *element_size)
+{
+    size_t n;
+    DArray *ary;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+
+    n = 0;
+    ary = (DArray *) collection;
+    if (darray_iterator_is_valid(collection, state)) {
+        *base = *(uint8_t **) state;
+        *element_size = ary->element_size;
+        n = ary->length - (*((uint8_t **) state) - ary->data) / ary->element_size;
+        *((uint8_t **) state) = ary->data + LENGTH(ary, ary->length);
+    }
+
+    return n;
+}
+
+static void darray_iterator_split(const void *collection, void **UNUSED(state), size_t index, size_t parts, Iterator *slice)
+{
+    DArray *ary;
+    size_t from, to;
+
+    assert(NULL != collection);
+
+    ary = (DArray *) collection;
+    iterator_split_range(ary->length, index, parts, &from, &to);
+    array_to_iterator(slice, ary->data + LENGTH(ary, from), ary->element_size, to - from);
+}
+
 /**
  * Initialize an *Iterator* to loop, in both directions, on the values of a dynamic array
  *
@@ -483,5 +515,83 @@ void darray_to_iterator(Iterator *it, DArray *da)
         NULL,
         (iterator_count_t) darray_length, NULL, NULL
     );
+    iterator_set_next_span(it, darray_iterator_next_span);
+    iterator_set_split(it, darray_iterator_split);
+}
+
+static void darray_collectable_into(void *collection, void *UNUSED(key), void *value)
+{
+    assert(NULL != collection);
+
+    darray_append((DArray *) collection, value);
+}
+
+static void darray_collectable_reserve(void *collection, size_t n)
+{
+    DArray *da;
+
+    assert(NULL != collection);
+
+    da = (DArray *) collection;
+    darray_set_size(da, da->length + n);
+}
+
+static void darray_collectable_into_batch(void *collection, void **UNUSED(keys), void **values, size_t n)
+{
+    size_t i;
+    DArray *da;
+
+    assert(NULL != collection);
+
+    da = (DArray *) collection;
+    darray_maybe_resize_of(da, n);
+    for (i = 0; i < n; i++) {
+        memcpy(OFFSET_TO_ADDR(da, da->length + i), values[i], da->element_size);
+    }
+    da->length += n;
+}
+
+static void darray_collectable_into_span(void *collection, const void *base, size_t element_size, size_t n)
+{
+    DArray *da;
+
+    assert(NULL != collection);
+
+    da = (DArray *) collection;
+    if (element_size == da->element_size) {
+        darray_append_all(da, base, n);
+    } else {
+        size_t i;
+
+        darray_maybe_resize_of(da, n);
+        for (i = 0; i < n; i++) {
+            memcpy(OFFSET_TO_ADDR(da, da->length + i), (const uint8_t *) base + i * element_size, da->element_size);
+        }
+        da->length += n;
+    }
+}
+
+/**
+ * Initialize a *Collectable* to append, through `iterator_into`, the
+ * values of an iterator to a dynamic array
+ *
+ * The array is grown once when the count of the iterator is known and
+ * contiguous elements (like the ones of an other DArray) are copied at once.
+ *
+ * @param collectable the collectable to initialize
+ * @param da the dynamic array to fill
+ *
+ * @note the values of the iterator have to point to elements of the size
+ * of the elements of *da* (element_size bytes are copied from each)
+ **/
+void darray_to_collectable(Collectable *collectable, DArray *da)
+{
+    assert(NULL != collectable);
+    assert(NULL != da);
+
+    collectable_init(collectable, da, darray_collectable_into);
+    collectable_set_reserve(collectable, darray_collectable_reserve);
+    collectable_set_into_batch(collectable, darray_collectable_into_batch);
+    collectable_set_into_span(collectable, darray_collectable_into_span);
 }
 #endif /* !WITHOUT_ITERATOR */
@@ -4,6 +4,7 @@
  */
 
 #define _GNU_SOURCE
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -424,19 +425,20 @@ static bool dptrarray_iterator_is_valid(const void *collection, void **state)
     return *((void ***) state) >= ary->data && *((void ***) state) < (ary->data + ary->length);
 }
 
-static void dptrarray_iterator_current(const void *collection, void **state, void **value, void **key)
+static void dptrarray_iterator_current(const void *collection, void **state, void **key, void **value)
 {
     DPtrArray *ary;
 
     assert(NULL != collection);
     assert(NULL != state);
-    assert(NULL != value);
 
     ary = (DPtrArray *) collection;
     if (NULL != key) {
-        *((int *) key) = *((void ***) state) - ary->data;
+        *((uint64_t *) key) = *((void ***) state) - ary->data;
+    }
+    if (NULL != value) {
+        *value = **(void ***) state;
     }
-    *value = **(void ***) state;
 }
 
 static void dptrarray_iterator_next(const void *UNUSED(collection), void **state)
@@ -453,11 +455,53 @@ static void dptrarray_iterator_previous(const void *UNUSED(collection), void **s
     --*((void ***) state);
 }
 
+static size_t dptrarray_iterator_next_batch(const void *collection, void **state, void **keys, void **values, size_t n)
+{
+    size_t i;
+    DPtrArray *ary;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+
+    ary = (DPtrArray *) collection;
+    if (!dptrarray_iterator_is_valid(collection, state)) {
+        return 0;
+    }
+    n = MIN(n, (size_t) (ary->data + ary->length - *((void ***) state)));
+    if (NULL != values) {
+        memcpy(values, *((void ***) state), n * sizeof(*values));
+    }
+    if (NULL != keys) {
+        for (i = 0; i < n; i++) {
+            *((uint64_t *) &keys[i]) = *((void ***) state) - ary->data + i;
+        }
+    }
+    *((void ***) state) += n;
+
+    return n;
+}
+
+static void dptrarray_iterator_split(const void *collection, void **UNUSED(state), size_t index, size_t parts, Iterator *slice)
+{
+    DPtrArray *ary;
+    size_t from, to;
+
+    assert(NULL != collection);
+
+    ary = (DPtrArray *) collection;
+    iterator_split_range(ary->length, index, parts, &from, &to);
+    ptr_array_to_iterator(slice, ary->data + from, to - from);
+}
+
 /**
- * XXX
+ * Initialize an *Iterator* to loop, in both directions, on the pointers
+ * of a dynamic array of pointers
  *
- * @param it
- * @param this
+ * @param it the iterator to initialize
+ * @param this the dynamic array to traverse
+ *
+ * @note iterator directions: forward and backward
+ * @note keys (element's index) are typed as uint64_t
  */
 void dptrarray_to_iterator(Iterator *it, DPtrArray *this)
 {
@@ -470,5 +514,63 @@ void dptrarray_to_iterator(Iterator *it, DPtrArray *this)
         NULL,
         (iterator_count_t) dptrarray_length, NULL, NULL
     );
+    iterator_set_next_batch(it, dptrarray_iterator_next_batch);
+    iterator_set_split(it, dptrarray_iterator_split);
+}
+
+static void dptrarray_collectable_into(void *collection, void *UNUSED(key), void *value)
+{
+    assert(NULL != collection);
+
+    dptrarray_push((DPtrArray *) collection, value);
+}
+
+static void dptrarray_collectable_reserve(void *collection, size_t n)
+{
+    DPtrArray *this;
+
+    assert(NULL != collection);
+
+    this = (DPtrArray *) collection;
+    dptrarray_maybe_resize_of(this, n);
+}
+
+static void dptrarray_collectable_into_batch(void *collection, void **UNUSED(keys), void **values, size_t n)
+{
+    DPtrArray *this;
+
+    assert(NULL != collection);
+
+    this = (DPtrArray *) collection;
+    dptrarray_maybe_resize_of(this, n);
+    if (NULL == this->duper) {
+        memcpy(this->data + this->length, values, n * sizeof(*values));
+        this->length += n;
+    } else {
+        size_t i;
+
+        for (i = 0; i < n; i++) {
+            this->data[this->length++] = this->duper(values[i]);
+        }
+    }
+}
+
+/**
+ * Initialize a *Collectable* to append, through `iterator_into`, the
+ * values of an iterator to a DPtrArray
+ *
+ * @param collectable the collectable to initialize
+ * @param this the array to fill
+ *
+ * @note the values are duplicated if the array has a duper
+ **/
+void dptrarray_to_collectable(Collectable *collectable, DPtrArray *this)
+{
+    assert(NULL != collectable);
+    assert(NULL != this);
+
+    collectable_init(collectable, this, dptrarray_collectable_into);
+    collectable_set_reserve(collectable, dptrarray_collectable_reserve);
+    collectable_set_into_batch(collectable, dptrarray_collectable_into_batch);
 }
 #endif /* !WITHOUT_ITERATOR */
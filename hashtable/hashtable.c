@@ -853,6 +853,99 @@ static void hashtable_iterator_previous(const void *UNUSED(collection), void **s
     *state = ((HashNode *) *state)->gPrev;
 }
 
+typedef struct {
+    HashNode *first;
+    HashNode *node;
+    size_t length;
+    size_t left;
+} hss_t /*hashtable_slice_state*/;
+
+static void hashtable_slice_iterator_first(const void *UNUSED(collection), void **state)
+{
+    hss_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (hss_t *) *state;
+    s->node = s->first;
+    s->left = s->length;
+}
+
+static bool hashtable_slice_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    return 0 != ((hss_t *) *state)->left;
+}
+
+static void hashtable_slice_iterator_current(const void *UNUSED(collection), void **state, void **key, void **value)
+{
+    HashNode *n;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    n = ((hss_t *) *state)->node;
+    if (NULL != value) {
+        *value = n->data;
+    }
+    if (NULL != key) {
+        *key = (void *) n->key;
+    }
+}
+
+static void hashtable_slice_iterator_next(const void *UNUSED(collection), void **state)
+{
+    hss_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (hss_t *) *state;
+    s->node = s->node->gNext;
+    --s->left;
+}
+
+static void hashtable_iterator_split(const void *collection, void **UNUSED(state), size_t index, size_t parts, Iterator *slice)
+{
+    hss_t *s;
+    size_t from, to, i;
+    HashNode *n;
+    const HashTable *ht;
+
+    assert(NULL != collection);
+
+    ht = (const HashTable *) collection;
+    iterator_split_range(ht->count, index, parts, &from, &to);
+    // walk the insertion-order list to the first node of the slice, from the nearest end
+    if (from == to) {
+        n = NULL;
+    } else if (from <= ht->count / 2) {
+        for (n = ht->gHead, i = 0; i < from; i++) {
+            n = n->gNext;
+        }
+    } else {
+        for (n = ht->gTail, i = ht->count - 1; i > from; i--) {
+            n = n->gPrev;
+        }
+    }
+    s = malloc(sizeof(*s));
+    s->first = s->node = n;
+    s->length = s->left = to - from;
+
+    iterator_init(
+        slice, ht, s,
+        hashtable_slice_iterator_first, NULL,
+        hashtable_slice_iterator_current,
+        hashtable_slice_iterator_next, NULL,
+        hashtable_slice_iterator_is_valid,
+        free,
+        NULL, NULL, NULL
+    );
+}
+
 /**
  * Initialize an iterator to loop on the values of an HashTable
  *
@@ -860,6 +953,8 @@ static void hashtable_iterator_previous(const void *UNUSED(collection), void **s
  * @param ht the hashtable to traverse
  *
  * @note iterator directions: forward and backward
+ * @note it is splittable: the parts are consecutive runs of the insertion
+ *   order (but locating the start of a part walks the nodes up to it)
  **/
 void hashtable_to_iterator(Iterator *it, HashTable *ht)
 {
@@ -872,5 +967,61 @@ void hashtable_to_iterator(Iterator *it, HashTable *ht)
         NULL,
         (iterator_count_t) hashtable_size, (iterator_member_t) _hashtable_contains, NULL
     );
+    iterator_set_split(it, hashtable_iterator_split);
+}
+
+static void hashtable_collectable_into(void *collection, void *key, void *value)
+{
+    assert(NULL != collection);
+
+    hashtable_put((HashTable *) collection, 0, key, value, NULL);
+}
+
+static void hashtable_collectable_reserve(void *collection, size_t n)
+{
+    size_t capacity;
+    HashTable *ht;
+
+    assert(NULL != collection);
+
+    ht = (HashTable *) collection;
+    // hashtable_maybe_resize grows the table as soon as count reaches capacity
+    capacity = nearest_power(ht->count + n + 1, HASHTABLE_MIN_SIZE);
+    if (capacity > ht->capacity) {
+        HashNode **nodes;
+
+        // it is only a hint: on failure, the table keeps growing as needed by hashtable_put
+        if (NULL == (nodes = realloc(ht->nodes, sizeof(*ht->nodes) * capacity))) {
+            return;
+        }
+        ht->nodes = nodes;
+        memset(ht->nodes, 0, capacity * sizeof(*ht->nodes));
+        ht->capacity = capacity;
+        ht->mask = ht->capacity - 1;
+        hashtable_rehash(ht);
+    }
+}
+
+/**
+ * Initialize a *Collectable* to put, through `iterator_into`, the keys and
+ * values of an iterator into a hashtable
+ *
+ * The buckets are allocated (and existing nodes rehashed) once, up front,
+ * when the count of the iterator is known.
+ *
+ * @param collectable the collectable to initialize
+ * @param ht the hashtable to fill
+ *
+ * @note keys are the ones of the iterator, as is (the pointers for a
+ * hashtable, the indexes for arrays, ...), a value replaces the previous
+ * one of the same key
+ **/
+void hashtable_to_collectable(Collectable *collectable, HashTable *ht)
+{
+    assert(NULL != collectable);
+    assert(NULL != ht);
+
+    collectable_init(collectable, ht, hashtable_collectable_into);
+    collectable_set_reserve(collectable, hashtable_collectable_reserve);
 }
 #endif /* !WITHOUT_ITERATOR */
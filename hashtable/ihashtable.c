@@ -0,0 +1,352 @@
+/**
+ * @file hashtable/ihashtable.c
+ * @brief an intrusive hashtable implementation
+ *
+ * Elements embed a `HashLink` and are chained into the buckets through it:
+ * once the bucket array is allocated, insertions and removals don't allocate
+ * anything (except when the table grows). The hash is kept into the link so
+ * growths never call the hash function again.
+ *
+ * \code
+ *   typedef struct {
+ *       int fd;
+ *       HashLink by_fd;
+ *   } Connection;
+ *
+ *   static bool fd_equal(ht_key_t key, const HashLink *link) {
+ *       return (int) key == ihashtable_entry(link, const Connection, by_fd)->fd;
+ *   }
+ *
+ *   IHashTable connections;
+ *   HashLink *link;
+ *
+ *   if (!ihashtable_init(&connections, 0, NULL, fd_equal, &error)) {
+ *       // ...
+ *   }
+ *   ihashtable_put(&connections, conn->fd, &conn->by_fd);
+ *   if (NULL != (link = ihashtable_get(&connections, fd))) {
+ *       Connection *conn = ihashtable_entry(link, Connection, by_fd);
+ *       // ...
+ *       ihashtable_remove(&connections, link);
+ *   }
+ * \endcode
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "nearest_power.h"
+#include "ihashtable.h"
+#include "error.h"
+
+#define IHASHTABLE_MIN_SIZE 8
+
+static inline void ihashtable_link(HashLink **bucket, HashLink *link)
+{
+    link->next = *bucket;
+    link->pprev = bucket;
+    if (NULL != link->next) {
+        link->next->pprev = &link->next;
+    }
+    *bucket = link;
+}
+
+static inline void ihashtable_maybe_resize(IHashTable *ht)
+{
+    size_t i, capacity;
+    HashLink **buckets, *l, *next;
+
+    if (EXPECTED(ht->count < ht->capacity)) {
+        return;
+    }
+    capacity = ht->capacity << 1;
+    if (UNEXPECTED(0 == capacity) || NULL == (buckets = calloc(capacity, sizeof(*buckets)))) {
+        // keep going with longer chains
+        return;
+    }
+    for (i = 0; i < ht->capacity; i++) {
+        for (l = ht->buckets[i]; NULL != l; l = next) {
+            next = l->next;
+            ihashtable_link(&buckets[l->hash & (capacity - 1)], l);
+        }
+    }
+    free(ht->buckets);
+    ht->buckets = buckets;
+    ht->capacity = capacity;
+    ht->mask = capacity - 1;
+}
+
+/**
+ * Initialize an intrusive hashtable
+ *
+ * @param ht the hashtable to set
+ * @param capacity the initial capacity of the hashtable
+ * @param hf callback to hash keys (NULL to use the key as its hash)
+ * @param ef callback to determine if an element has a given key
+ * @param error the error to set if the buckets can't be allocated
+ *
+ * @return `false` on allocation failure (the hashtable is left empty and can
+ * only be given to ihashtable_destroy)
+ */
+bool ihashtable_init(IHashTable *ht, size_t capacity, HashFunc hf, HashLinkEqualFunc ef, char **error)
+{
+    assert(NULL != ht);
+    assert(NULL != ef);
+
+    ht->count = 0;
+    ht->capacity = nearest_power(capacity, IHASHTABLE_MIN_SIZE);
+    ht->mask = ht->capacity - 1;
+    ht->hf = hf;
+    ht->ef = ef;
+    if (NULL == (ht->buckets = calloc(ht->capacity, sizeof(*ht->buckets)))) {
+        set_malloc_error(error, ht->capacity * sizeof(*ht->buckets));
+        ht->capacity = 0;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Unlink all the elements of a hashtable
+ *
+ * @param ht the hashtable to clear
+ *
+ * @note the objects themselves are left untouched
+ */
+void ihashtable_clear(IHashTable *ht)
+{
+    assert(NULL != ht);
+
+    ht->count = 0;
+    memset(ht->buckets, 0, ht->capacity * sizeof(*ht->buckets));
+}
+
+/**
+ * Free the memory internally used by a hashtable
+ *
+ * @param ht the hashtable to destroy
+ *
+ * @note the objects still in the hashtable are left untouched
+ */
+void ihashtable_destroy(IHashTable *ht)
+{
+    assert(NULL != ht);
+
+    free(ht->buckets);
+    ht->buckets = NULL;
+    ht->count = ht->capacity = 0;
+}
+
+/**
+ * Get items count
+ *
+ * @param ht the hashtable
+ *
+ * @return the number of elements inside ht
+ */
+size_t ihashtable_size(IHashTable *ht)
+{
+    assert(NULL != ht);
+
+    return ht->count;
+}
+
+/**
+ * Look for an element from its key and the hash of this key
+ *
+ * @param ht the hashtable
+ * @param h the hash of the key
+ * @param key the key to look for
+ *
+ * @return `NULL` if there is no element with this key
+ */
+HashLink *_ihashtable_quick_get(IHashTable *ht, ht_hash_t h, ht_key_t key)
+{
+    HashLink *l;
+
+    assert(NULL != ht);
+
+    for (l = ht->buckets[h & ht->mask]; NULL != l; l = l->next) {
+        if (l->hash == h && ht->ef(key, l)) {
+            break;
+        }
+    }
+
+    return l;
+}
+
+/**
+ * Look for an element from its key
+ *
+ * @param ht the hashtable
+ * @param key the key to look for
+ *
+ * @return `NULL` if there is no element with this key
+ */
+HashLink *_ihashtable_get(IHashTable *ht, ht_key_t key)
+{
+    return _ihashtable_quick_get(ht, NULL == ht->hf ? key : ht->hf(key), key);
+}
+
+/**
+ * Insert an element when the hash of its key is already known
+ *
+ * @param ht the hashtable
+ * @param h the hash of the key
+ * @param key the key of the object which embeds *link*
+ * @param link the link to insert (it must not already be in a hashtable)
+ *
+ * @return `NULL` if *link* was inserted else the element already registered
+ * with the same key (*link* is not inserted)
+ */
+HashLink *_ihashtable_quick_put(IHashTable *ht, ht_hash_t h, ht_key_t key, HashLink *link)
+{
+    HashLink *l;
+
+    assert(NULL != ht);
+    assert(NULL != link);
+
+    if (NULL != (l = _ihashtable_quick_get(ht, h, key))) {
+        return l;
+    }
+    link->hash = h;
+    ihashtable_link(&ht->buckets[h & ht->mask], link);
+    ++ht->count;
+    ihashtable_maybe_resize(ht);
+
+    return NULL;
+}
+
+/**
+ * Insert an element
+ *
+ * @param ht the hashtable
+ * @param key the key of the object which embeds *link*
+ * @param link the link to insert (it must not already be in a hashtable)
+ *
+ * @return `NULL` if *link* was inserted else the element already registered
+ * with the same key (*link* is not inserted)
+ */
+HashLink *_ihashtable_put(IHashTable *ht, ht_key_t key, HashLink *link)
+{
+    return _ihashtable_quick_put(ht, NULL == ht->hf ? key : ht->hf(key), key, link);
+}
+
+/**
+ * Unlink an element from the hashtable, in O(1) (no lookup)
+ *
+ * @param ht the hashtable
+ * @param link the element to remove
+ *
+ * @note the object which embeds *link* is left untouched
+ */
+void ihashtable_remove(IHashTable *ht, HashLink *link)
+{
+    assert(NULL != ht);
+    assert(NULL != link);
+
+    *link->pprev = link->next;
+    if (NULL != link->next) {
+        link->next->pprev = link->pprev;
+    }
+    link->next = NULL;
+    link->pprev = NULL;
+    --ht->count;
+}
+
+#ifndef WITHOUT_ITERATOR
+typedef struct {
+    size_t bucket;
+    HashLink *link;
+} ihts_t /*ihashtable_state*/;
+
+static void ihashtable_iterator_seek(const IHashTable *ht, ihts_t *s)
+{
+    while (NULL == s->link && ++s->bucket < ht->capacity) {
+        s->link = ht->buckets[s->bucket];
+    }
+}
+
+static void ihashtable_iterator_first(const void *collection, void **state)
+{
+    ihts_t *s;
+    const IHashTable *ht;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (ihts_t *) *state;
+    ht = (const IHashTable *) collection;
+    s->bucket = 0;
+    s->link = ht->buckets[0];
+    ihashtable_iterator_seek(ht, s);
+}
+
+static bool ihashtable_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    return NULL != ((ihts_t *) *state)->link;
+}
+
+static void ihashtable_iterator_current(const void *UNUSED(collection), void **state, void **UNUSED(key), void **value)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    if (NULL != value) {
+        *value = ((ihts_t *) *state)->link;
+    }
+}
+
+static void ihashtable_iterator_next(const void *collection, void **state)
+{
+    ihts_t *s;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (ihts_t *) *state;
+    s->link = s->link->next;
+    ihashtable_iterator_seek((const IHashTable *) collection, s);
+}
+
+/**
+ * Initialize an iterator to loop on the links of an intrusive hashtable
+ *
+ * @param it the iterator to initialize
+ * @param ht the hashtable to traverse
+ *
+ * @note iterator directions: forward only, in no particular order
+ * @note values are the `HashLink *` (use ihashtable_entry to get the object)
+ * @note there is no key
+ **/
+void ihashtable_to_iterator(Iterator *it, IHashTable *ht)
+{
+    ihts_t *s;
+
+    assert(NULL != it);
+    assert(NULL != ht);
+
+    s = malloc(sizeof(*s));
+    s->bucket = 0;
+    s->link = NULL;
+
+    iterator_init(
+        it, ht, s,
+        ihashtable_iterator_first, NULL,
+        ihashtable_iterator_current,
+        ihashtable_iterator_next, NULL,
+        ihashtable_iterator_is_valid,
+        free,
+        (iterator_count_t) ihashtable_size, NULL, NULL
+    );
+}
+#endif /* !WITHOUT_ITERATOR */
@@ -0,0 +1,722 @@
+/**
+ * @file iterator/aggregate.c
+ * @brief vectorized sum/min/max/count of contiguous arrays of numbers
+ *
+ * Kernels exist for int32_t, int64_t, uint64_t and double. The SSE2 or
+ * AVX2 version (selected at runtime, according to the CPU) processes the
+ * bulk of the array, the scalar code takes care of the rest (or of
+ * everything on other CPUs).
+ *
+ * They can be directly applied on a C array or on the data of a DArray
+ * (see darray_sum, darray_min, ...):
+ * \code
+ *   int32_t max;
+ *
+ *   if (array_max_int32_t(numbers, ARRAY_SIZE(numbers), &max)) {
+ *       // ...
+ *   }
+ * \endcode
+ *
+ * Or on any iterator of numbers: contiguous elements, as exposed by
+ * array_to_iterator or darray_to_iterator, are handed to the kernels,
+ * the others are fetched by batches.
+ * \code
+ *   int32_t numbers[] = {1, 2, 3};
+ *
+ *   array_to_iterator(&it, numbers, sizeof(numbers[0]), ARRAY_SIZE(numbers));
+ *   printf("%" PRIi64 "\n", iterator_sum_int32_t(&it));
+ *   iterator_close(&it);
+ * \endcode
+ *
+ * @note sums of int32_t are computed on 64 bits
+ * @note the vectorized sums of doubles don't add the values in the order
+ * of the array: the result may slightly differ from a sequential sum
+ * @note the minimum/maximum of an array of doubles containing NaN is unspecified
+ */
+
+#include <assert.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "simd.h"
+#include "aggregate.h"
+
+#ifdef HAVE_X86_SIMD
+# define SIMD_DISPATCH(avx2, sse2) \
+    do { \
+        if (CPU_HAS_AVX2()) { \
+            return avx2; \
+        } \
+        if (CPU_HAS_SSE2()) { \
+            return sse2; \
+        } \
+    } while (0)
+
+# define LANES_REDUCE(lanes, op, result) \
+    do { \
+        size_t _l; \
+ \
+        result = lanes[0]; \
+        for (_l = 1; _l < ARRAY_SIZE(lanes); _l++) { \
+            result = op(result, lanes[_l]); \
+        } \
+    } while (0)
+
+# define ADD(a, b) ((a) + (b))
+# define SMALLER(a, b) ((b) < (a) ? (b) : (a))
+# define GREATER(a, b) ((b) > (a) ? (b) : (a))
+
+# define LOAD_SSE2_SI(p) _mm_loadu_si128((const __m128i *) (p))
+# define STORE_SSE2_SI(p, v) _mm_storeu_si128((__m128i *) (p), v)
+# define LOAD_SSE2_PD(p) _mm_loadu_pd(p)
+# define STORE_SSE2_PD(p, v) _mm_storeu_pd(p, v)
+# define LOAD_AVX2_SI(p) _mm256_loadu_si256((const __m256i *) (p))
+# define STORE_AVX2_SI(p, v) _mm256_storeu_si256((__m256i *) (p), v)
+# define LOAD_AVX2_PD(p) _mm256_loadu_pd(p)
+# define STORE_AVX2_PD(p, v) _mm256_storeu_pd(p, v)
+
+/* ========== sum ========== */
+
+static TARGET("sse2") size_t sum_int32_t_sse2(const int32_t *values, size_t count, int64_t *sum)
+{
+    size_t i;
+    __m128i acc;
+    int64_t lanes[2], result;
+
+    acc = _mm_setzero_si128();
+    for (i = 0; i + 4 <= count; i += 4) {
+        __m128i v, sign;
+
+        // no _mm_cvtepi32_epi64 before SSE4.1: interleave with the sign
+        v = LOAD_SSE2_SI(values + i);
+        sign = _mm_srai_epi32(v, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+    }
+    STORE_SSE2_SI(lanes, acc);
+    LANES_REDUCE(lanes, ADD, result);
+    *sum += result;
+
+    return i;
+}
+
+static TARGET("avx2") size_t sum_int32_t_avx2(const int32_t *values, size_t count, int64_t *sum)
+{
+    size_t i;
+    __m256i acc;
+    int64_t lanes[4], result;
+
+    acc = _mm256_setzero_si256();
+    for (i = 0; i + 8 <= count; i += 8) {
+        __m256i v;
+
+        v = LOAD_AVX2_SI(values + i);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    STORE_AVX2_SI(lanes, acc);
+    LANES_REDUCE(lanes, ADD, result);
+    *sum += result;
+
+    return i;
+}
+
+/* int64_t and uint64_t sums only differ by the interpretation of the result */
+static TARGET("sse2") size_t sum_64_sse2(const void *values, size_t count, uint64_t *sum)
+{
+    size_t i;
+    __m128i acc;
+    uint64_t lanes[2], result;
+
+    acc = _mm_setzero_si128();
+    for (i = 0; i + 2 <= count; i += 2) {
+        acc = _mm_add_epi64(acc, LOAD_SSE2_SI((const uint64_t *) values + i));
+    }
+    STORE_SSE2_SI(lanes, acc);
+    LANES_REDUCE(lanes, ADD, result);
+    *sum += result;
+
+    return i;
+}
+
+static TARGET("avx2") size_t sum_64_avx2(const void *values, size_t count, uint64_t *sum)
+{
+    size_t i;
+    __m256i acc;
+    uint64_t lanes[4], result;
+
+    acc = _mm256_setzero_si256();
+    for (i = 0; i + 4 <= count; i += 4) {
+        acc = _mm256_add_epi64(acc, LOAD_AVX2_SI((const uint64_t *) values + i));
+    }
+    STORE_AVX2_SI(lanes, acc);
+    LANES_REDUCE(lanes, ADD, result);
+    *sum += result;
+
+    return i;
+}
+
+static TARGET("sse2") size_t sum_double_sse2(const double *values, size_t count, double *sum)
+{
+    size_t i;
+    __m128d acc;
+    double lanes[2], result;
+
+    acc = _mm_setzero_pd();
+    for (i = 0; i + 2 <= count; i += 2) {
+        acc = _mm_add_pd(acc, LOAD_SSE2_PD(values + i));
+    }
+    STORE_SSE2_PD(lanes, acc);
+    LANES_REDUCE(lanes, ADD, result);
+    *sum += result;
+
+    return i;
+}
+
+static TARGET("avx2") size_t sum_double_avx2(const double *values, size_t count, double *sum)
+{
+    size_t i;
+    __m256d acc;
+    double lanes[4], result;
+
+    acc = _mm256_setzero_pd();
+    for (i = 0; i + 4 <= count; i += 4) {
+        acc = _mm256_add_pd(acc, LOAD_AVX2_PD(values + i));
+    }
+    STORE_AVX2_PD(lanes, acc);
+    LANES_REDUCE(lanes, ADD, result);
+    *sum += result;
+
+    return i;
+}
+
+/* ========== min/max ========== */
+
+# define MINMAX_KERNEL(name, isa, type, vector, width, load, store, select, reduce) \
+    static TARGET(isa) size_t name(const type *values, size_t count, type *result) \
+    { \
+        size_t i; \
+        vector acc; \
+        type lanes[width]; \
+ \
+        if (count < width) { \
+            return 0; \
+        } \
+        acc = load(values); \
+        for (i = width; i + width <= count; i += width) { \
+            vector v; \
+ \
+            v = load(values + i); \
+            acc = select(acc, v); \
+        } \
+        store(lanes, acc); \
+        LANES_REDUCE(lanes, reduce, *result); \
+ \
+        return i; \
+    }
+
+/* SSE2 has no min/max for 32 bits integers: select with a comparison */
+# define SSE2_SELECT(mask, a, b) _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b))
+# define SSE2_MIN_EPI32(a, b) SSE2_SELECT(_mm_cmpgt_epi32(a, b), b, a)
+# define SSE2_MAX_EPI32(a, b) SSE2_SELECT(_mm_cmpgt_epi32(b, a), b, a)
+/* AVX2 has no min/max for 64 bits integers: select with a comparison */
+# define AVX2_MIN_EPI64(a, b) _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b))
+# define AVX2_MAX_EPI64(a, b) _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a))
+/* unsigned comparisons are signed ones after flipping the sign bits */
+# define AVX2_FLIP64(a) _mm256_xor_si256(a, _mm256_set1_epi64x(INT64_MIN))
+# define AVX2_MIN_EPU64(a, b) _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(AVX2_FLIP64(a), AVX2_FLIP64(b)))
+# define AVX2_MAX_EPU64(a, b) _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(AVX2_FLIP64(b), AVX2_FLIP64(a)))
+
+MINMAX_KERNEL(min_int32_t_sse2, "sse2", int32_t, __m128i, 4, LOAD_SSE2_SI, STORE_SSE2_SI, SSE2_MIN_EPI32, SMALLER)
+MINMAX_KERNEL(max_int32_t_sse2, "sse2", int32_t, __m128i, 4, LOAD_SSE2_SI, STORE_SSE2_SI, SSE2_MAX_EPI32, GREATER)
+MINMAX_KERNEL(min_int32_t_avx2, "avx2", int32_t, __m256i, 8, LOAD_AVX2_SI, STORE_AVX2_SI, _mm256_min_epi32, SMALLER)
+MINMAX_KERNEL(max_int32_t_avx2, "avx2", int32_t, __m256i, 8, LOAD_AVX2_SI, STORE_AVX2_SI, _mm256_max_epi32, GREATER)
+MINMAX_KERNEL(min_int64_t_avx2, "avx2", int64_t, __m256i, 4, LOAD_AVX2_SI, STORE_AVX2_SI, AVX2_MIN_EPI64, SMALLER)
+MINMAX_KERNEL(max_int64_t_avx2, "avx2", int64_t, __m256i, 4, LOAD_AVX2_SI, STORE_AVX2_SI, AVX2_MAX_EPI64, GREATER)
+MINMAX_KERNEL(min_uint64_t_avx2, "avx2", uint64_t, __m256i, 4, LOAD_AVX2_SI, STORE_AVX2_SI, AVX2_MIN_EPU64, SMALLER)
+MINMAX_KERNEL(max_uint64_t_avx2, "avx2", uint64_t, __m256i, 4, LOAD_AVX2_SI, STORE_AVX2_SI, AVX2_MAX_EPU64, GREATER)
+MINMAX_KERNEL(min_double_sse2, "sse2", double, __m128d, 2, LOAD_SSE2_PD, STORE_SSE2_PD, _mm_min_pd, SMALLER)
+MINMAX_KERNEL(max_double_sse2, "sse2", double, __m128d, 2, LOAD_SSE2_PD, STORE_SSE2_PD, _mm_max_pd, GREATER)
+MINMAX_KERNEL(min_double_avx2, "avx2", double, __m256d, 4, LOAD_AVX2_PD, STORE_AVX2_PD, _mm256_min_pd, SMALLER)
+MINMAX_KERNEL(max_double_avx2, "avx2", double, __m256d, 4, LOAD_AVX2_PD, STORE_AVX2_PD, _mm256_max_pd, GREATER)
+
+# undef MINMAX_KERNEL
+
+/* ========== count ========== */
+
+/**
+ * Integer comparisons are reduced to ==, < and >: !=, >= and <= are
+ * counted as the complement of the first ones
+ */
+static AggregateCmp aggregate_integer_cmp(AggregateCmp op, bool *complement)
+{
+    *complement = AGGREGATE_NE == op || AGGREGATE_GE == op || AGGREGATE_LE == op;
+    switch (op) {
+        case AGGREGATE_NE:
+            return AGGREGATE_EQ;
+        case AGGREGATE_GE:
+            return AGGREGATE_LT;
+        case AGGREGATE_LE:
+            return AGGREGATE_GT;
+        default:
+            return op;
+    }
+}
+
+# define COUNT_LOOP(vector, width, load, compare, movemask) \
+    for (i = 0; i + width <= count; i += width) { \
+        vector v; \
+ \
+        v = load(values + i); \
+        *matches += __builtin_popcount(movemask(compare(v, x))); \
+    }
+
+# define INTEGER_COUNT_KERNEL(name, isa, type, vector, width, load, set1, eq, lt, gt, movemask) \
+    static TARGET(isa) size_t name(const type *values, size_t count, AggregateCmp op, type value, size_t *matches) \
+    { \
+        size_t i, before; \
+        vector x; \
+        bool complement; \
+ \
+        before = *matches; \
+        x = set1(value); \
+        switch (aggregate_integer_cmp(op, &complement)) { \
+            case AGGREGATE_EQ: \
+                COUNT_LOOP(vector, width, load, eq, movemask); \
+                break; \
+            case AGGREGATE_GT: \
+                COUNT_LOOP(vector, width, load, gt, movemask); \
+                break; \
+            default: \
+                COUNT_LOOP(vector, width, load, lt, movemask); \
+                break; \
+        } \
+        if (complement) { \
+            *matches = before + i - (*matches - before); \
+        } \
+ \
+        return i; \
+    }
+
+# define SSE2_MOVEMASK_EPI32(m) _mm_movemask_ps(_mm_castsi128_ps(m))
+# define AVX2_MOVEMASK_EPI32(m) _mm256_movemask_ps(_mm256_castsi256_ps(m))
+# define AVX2_MOVEMASK_EPI64(m) _mm256_movemask_pd(_mm256_castsi256_pd(m))
+# define AVX2_CMPLT_EPI32(a, b) _mm256_cmpgt_epi32(b, a)
+# define AVX2_CMPLT_EPI64(a, b) _mm256_cmpgt_epi64(b, a)
+# define AVX2_CMPGT_EPU64(a, b) _mm256_cmpgt_epi64(AVX2_FLIP64(a), AVX2_FLIP64(b))
+# define AVX2_CMPLT_EPU64(a, b) AVX2_CMPGT_EPU64(b, a)
+
+INTEGER_COUNT_KERNEL(count_if_int32_t_sse2, "sse2", int32_t, __m128i, 4, LOAD_SSE2_SI, _mm_set1_epi32, _mm_cmpeq_epi32, _mm_cmplt_epi32, _mm_cmpgt_epi32, SSE2_MOVEMASK_EPI32)
+INTEGER_COUNT_KERNEL(count_if_int32_t_avx2, "avx2", int32_t, __m256i, 8, LOAD_AVX2_SI, _mm256_set1_epi32, _mm256_cmpeq_epi32, AVX2_CMPLT_EPI32, _mm256_cmpgt_epi32, AVX2_MOVEMASK_EPI32)
+INTEGER_COUNT_KERNEL(count_if_int64_t_avx2, "avx2", int64_t, __m256i, 4, LOAD_AVX2_SI, _mm256_set1_epi64x, _mm256_cmpeq_epi64, AVX2_CMPLT_EPI64, _mm256_cmpgt_epi64, AVX2_MOVEMASK_EPI64)
+INTEGER_COUNT_KERNEL(count_if_uint64_t_avx2, "avx2", uint64_t, __m256i, 4, LOAD_AVX2_SI, _mm256_set1_epi64x, _mm256_cmpeq_epi64, AVX2_CMPLT_EPU64, AVX2_CMPGT_EPU64, AVX2_MOVEMASK_EPI64)
+
+# undef INTEGER_COUNT_KERNEL
+
+/* doubles: all the comparisons exist (and NaN makes the complement trick wrong) */
+# define DOUBLE_COUNT_KERNEL(name, isa, vector, width, load, set1, eq, ne, lt, le, gt, ge, movemask) \
+    static TARGET(isa) size_t name(const double *values, size_t count, AggregateCmp op, double value, size_t *matches) \
+    { \
+        size_t i; \
+        vector x; \
+ \
+        x = set1(value); \
+        switch (op) { \
+            case AGGREGATE_EQ: \
+                COUNT_LOOP(vector, width, load, eq, movemask); \
+                break; \
+            case AGGREGATE_NE: \
+                COUNT_LOOP(vector, width, load, ne, movemask); \
+                break; \
+            case AGGREGATE_LT: \
+                COUNT_LOOP(vector, width, load, lt, movemask); \
+                break; \
+            case AGGREGATE_LE: \
+                COUNT_LOOP(vector, width, load, le, movemask); \
+                break; \
+            case AGGREGATE_GT: \
+                COUNT_LOOP(vector, width, load, gt, movemask); \
+                break; \
+            case AGGREGATE_GE: \
+                COUNT_LOOP(vector, width, load, ge, movemask); \
+                break; \
+            default: \
+                i = 0; \
+                break; \
+        } \
+ \
+        return i; \
+    }
+
+# define AVX2_CMPEQ_PD(a, b) _mm256_cmp_pd(a, b, _CMP_EQ_OQ)
+# define AVX2_CMPNE_PD(a, b) _mm256_cmp_pd(a, b, _CMP_NEQ_UQ)
+# define AVX2_CMPLT_PD(a, b) _mm256_cmp_pd(a, b, _CMP_LT_OQ)
+# define AVX2_CMPLE_PD(a, b) _mm256_cmp_pd(a, b, _CMP_LE_OQ)
+# define AVX2_CMPGT_PD(a, b) _mm256_cmp_pd(a, b, _CMP_GT_OQ)
+# define AVX2_CMPGE_PD(a, b) _mm256_cmp_pd(a, b, _CMP_GE_OQ)
+
+DOUBLE_COUNT_KERNEL(count_if_double_sse2, "sse2", __m128d, 2, LOAD_SSE2_PD, _mm_set1_pd, _mm_cmpeq_pd, _mm_cmpneq_pd, _mm_cmplt_pd, _mm_cmple_pd, _mm_cmpgt_pd, _mm_cmpge_pd, _mm_movemask_pd)
+DOUBLE_COUNT_KERNEL(count_if_double_avx2, "avx2", __m256d, 4, LOAD_AVX2_PD, _mm256_set1_pd, AVX2_CMPEQ_PD, AVX2_CMPNE_PD, AVX2_CMPLT_PD, AVX2_CMPLE_PD, AVX2_CMPGT_PD, AVX2_CMPGE_PD, _mm256_movemask_pd)
+
+# undef DOUBLE_COUNT_KERNEL
+# undef COUNT_LOOP
+#endif /* HAVE_X86_SIMD */
+
+/* ========== dispatch ========== */
+
+/*
+ * Each *_simd function returns the number of elements it processed (from
+ * the start of the array, 0 if none) and accumulates its result
+ */
+
+#ifdef HAVE_X86_SIMD
+static size_t sum_int32_t_simd(const int32_t *values, size_t count, int64_t *sum)
+{
+    SIMD_DISPATCH(sum_int32_t_avx2(values, count, sum), sum_int32_t_sse2(values, count, sum));
+
+    return 0;
+}
+
+static size_t sum_int64_t_simd(const int64_t *values, size_t count, int64_t *sum)
+{
+    size_t i;
+    uint64_t usum;
+
+    i = 0;
+    usum = 0;
+    if (CPU_HAS_AVX2()) {
+        i = sum_64_avx2(values, count, &usum);
+    } else if (CPU_HAS_SSE2()) {
+        i = sum_64_sse2(values, count, &usum);
+    }
+    *sum += (int64_t) usum;
+
+    return i;
+}
+
+static size_t sum_uint64_t_simd(const uint64_t *values, size_t count, uint64_t *sum)
+{
+    SIMD_DISPATCH(sum_64_avx2(values, count, sum), sum_64_sse2(values, count, sum));
+
+    return 0;
+}
+
+static size_t sum_double_simd(const double *values, size_t count, double *sum)
+{
+    SIMD_DISPATCH(sum_double_avx2(values, count, sum), sum_double_sse2(values, count, sum));
+
+    return 0;
+}
+
+# define simd_dispatchers(type, avx2_only) \
+    static size_t min_## type ##_simd(const type *values, size_t count, type *result) \
+    { \
+        SIMD_DISPATCH(min_## type ##_avx2(values, count, result), avx2_only ? 0 : min_## type ##_sse2(values, count, result)); \
+ \
+        return 0; \
+    } \
+ \
+    static size_t max_## type ##_simd(const type *values, size_t count, type *result) \
+    { \
+        SIMD_DISPATCH(max_## type ##_avx2(values, count, result), avx2_only ? 0 : max_## type ##_sse2(values, count, result)); \
+ \
+        return 0; \
+    } \
+ \
+    static size_t count_if_## type ##_simd(const type *values, size_t count, AggregateCmp op, type value, size_t *matches) \
+    { \
+        SIMD_DISPATCH(count_if_## type ##_avx2(values, count, op, value, matches), avx2_only ? 0 : count_if_## type ##_sse2(values, count, op, value, matches)); \
+ \
+        return 0; \
+    }
+
+/* SSE2 has no 64 bits integer comparison: no SSE2 kernel for min, max and count of (u)int64_t */
+# define min_int64_t_sse2(values, count, result) 0
+# define max_int64_t_sse2(values, count, result) 0
+# define count_if_int64_t_sse2(values, count, op, value, matches) 0
+# define min_uint64_t_sse2(values, count, result) 0
+# define max_uint64_t_sse2(values, count, result) 0
+# define count_if_uint64_t_sse2(values, count, op, value, matches) 0
+
+simd_dispatchers(int32_t, false)
+simd_dispatchers(int64_t, true)
+simd_dispatchers(uint64_t, true)
+simd_dispatchers(double, false)
+
+# undef simd_dispatchers
+#else
+/* everything is left to the scalar code */
+# define sum_int32_t_simd(values, count, sum) 0
+# define sum_int64_t_simd(values, count, sum) 0
+# define sum_uint64_t_simd(values, count, sum) 0
+# define sum_double_simd(values, count, sum) 0
+# define min_int32_t_simd(values, count, result) 0
+# define min_int64_t_simd(values, count, result) 0
+# define min_uint64_t_simd(values, count, result) 0
+# define min_double_simd(values, count, result) 0
+# define max_int32_t_simd(values, count, result) 0
+# define max_int64_t_simd(values, count, result) 0
+# define max_uint64_t_simd(values, count, result) 0
+# define max_double_simd(values, count, result) 0
+# define count_if_int32_t_simd(values, count, op, value, matches) 0
+# define count_if_int64_t_simd(values, count, op, value, matches) 0
+# define count_if_uint64_t_simd(values, count, op, value, matches) 0
+# define count_if_double_simd(values, count, op, value, matches) 0
+#endif /* HAVE_X86_SIMD */
+
+/* ========== public functions ========== */
+
+#define COUNT_SCALAR(operator) \
+    for (; i < count; i++) { \
+        matches += values[i] operator value; \
+    }
+
+#define aggregate(type, sum_type) \
+    sum_type array_sum_## type(const type *values, size_t count) \
+    { \
+        size_t i; \
+        sum_type sum; \
+ \
+        assert(NULL != values || 0 == count); \
+ \
+        sum = 0; \
+        for (i = sum_## type ##_simd(values, count, &sum); i < count; i++) { \
+            sum += values[i]; \
+        } \
+ \
+        return sum; \
+    } \
+ \
+    bool array_min_## type(const type *values, size_t count, type *min) \
+    { \
+        size_t i; \
+        type result; \
+ \
+        assert(NULL != values || 0 == count); \
+        assert(NULL != min); \
+ \
+        if (0 == count) { \
+            return false; \
+        } \
+        if (0 == (i = min_## type ##_simd(values, count, &result))) { \
+            result = values[i++]; \
+        } \
+        for (; i < count; i++) { \
+            if (values[i] < result) { \
+                result = values[i]; \
+            } \
+        } \
+        *min = result; \
+ \
+        return true; \
+    } \
+ \
+    bool array_max_## type(const type *values, size_t count, type *max) \
+    { \
+        size_t i; \
+        type result; \
+ \
+        assert(NULL != values || 0 == count); \
+        assert(NULL != max); \
+ \
+        if (0 == count) { \
+            return false; \
+        } \
+        if (0 == (i = max_## type ##_simd(values, count, &result))) { \
+            result = values[i++]; \
+        } \
+        for (; i < count; i++) { \
+            if (values[i] > result) { \
+                result = values[i]; \
+            } \
+        } \
+        *max = result; \
+ \
+        return true; \
+    } \
+ \
+    size_t array_count_if_## type(const type *values, size_t count, AggregateCmp op, type value) \
+    { \
+        size_t i, matches; \
+ \
+        assert(NULL != values || 0 == count); \
+ \
+        matches = 0; \
+        i = count_if_## type ##_simd(values, count, op, value, &matches); \
+        switch (op) { \
+            case AGGREGATE_EQ: \
+                COUNT_SCALAR(==); \
+                break; \
+            case AGGREGATE_NE: \
+                COUNT_SCALAR(!=); \
+                break; \
+            case AGGREGATE_LT: \
+                COUNT_SCALAR(<); \
+                break; \
+            case AGGREGATE_LE: \
+                COUNT_SCALAR(<=); \
+                break; \
+            case AGGREGATE_GT: \
+                COUNT_SCALAR(>); \
+                break; \
+            case AGGREGATE_GE: \
+                COUNT_SCALAR(>=); \
+                break; \
+        } \
+ \
+        return matches; \
+    }
+
+aggregate(int32_t, int64_t);
+aggregate(int64_t, int64_t);
+aggregate(uint64_t, uint64_t);
+aggregate(double, double);
+
+#undef aggregate
+#undef COUNT_SCALAR
+
+#ifndef WITHOUT_ITERATOR
+/* number of values fetched at once from iterators without span */
+# define AGGREGATE_BATCH_SIZE 64
+
+/**
+ * Traverse *it*: contiguous elements are exposed as *span* (of *span_length* elements)
+ * to *span_block*, the others one by one as *value* to *value_block*
+ */
+# define AGGREGATE_TRAVERSE(it, type, span_block, value_block) \
+    do { \
+        size_t _i, _n; \
+ \
+        iterator_first(it); \
+        if (NULL != (it)->next_span) { \
+            const char *_base; \
+            size_t _element_size; \
+ \
+            while (0 != (_n = iterator_next_span(it, (const void **) &_base, &_element_size))) { \
+                if (sizeof(type) == _element_size) { \
+                    const type *span = (const type *) _base; \
+                    size_t span_length = _n; \
+ \
+                    span_block \
+                } else { \
+                    for (_i = 0; _i < _n; _i++) { \
+                        type value = *((const type *) (_base + _i * _element_size)); \
+ \
+                        value_block \
+                    } \
+                } \
+            } \
+        } else { \
+            void *_values[AGGREGATE_BATCH_SIZE]; \
+ \
+            while (0 != (_n = iterator_next_batch(it, NULL, _values, ARRAY_SIZE(_values)))) { \
+                for (_i = 0; _i < _n; _i++) { \
+                    type value = *((const type *) _values[_i]); \
+ \
+                    value_block \
+                } \
+            } \
+        } \
+    } while (0)
+
+# define iterator_aggregate(type, sum_type) \
+    sum_type iterator_sum_## type(Iterator *it) \
+    { \
+        sum_type sum; \
+ \
+        assert(NULL != it); \
+ \
+        sum = 0; \
+        AGGREGATE_TRAVERSE(it, type, { sum += array_sum_## type(span, span_length); }, { sum += value; }); \
+ \
+        return sum; \
+    } \
+ \
+    bool iterator_min_## type(Iterator *it, type *min) \
+    { \
+        bool any; \
+        type result, candidate; \
+ \
+        assert(NULL != it); \
+        assert(NULL != min); \
+ \
+        any = false; \
+        result = 0; \
+        AGGREGATE_TRAVERSE( \
+            it, type, \
+            { \
+                if (array_min_## type(span, span_length, &candidate) && (!any || candidate < result)) { \
+                    any = true; \
+                    result = candidate; \
+                } \
+            }, \
+            { \
+                if (!any || value < result) { \
+                    any = true; \
+                    result = value; \
+                } \
+            } \
+        ); \
+        if (any) { \
+            *min = result; \
+        } \
+ \
+        return any; \
+    } \
+ \
+    bool iterator_max_## type(Iterator *it, type *max) \
+    { \
+        bool any; \
+        type result, candidate; \
+ \
+        assert(NULL != it); \
+        assert(NULL != max); \
+ \
+        any = false; \
+        result = 0; \
+        AGGREGATE_TRAVERSE( \
+            it, type, \
+            { \
+                if (array_max_## type(span, span_length, &candidate) && (!any || candidate > result)) { \
+                    any = true; \
+                    result = candidate; \
+                } \
+            }, \
+            { \
+                if (!any || value > result) { \
+                    any = true; \
+                    result = value; \
+                } \
+            } \
+        ); \
+        if (any) { \
+            *max = result; \
+        } \
+ \
+        return any; \
+    } \
+ \
+    size_t iterator_count_if_## type(Iterator *it, AggregateCmp op, type x) \
+    { \
+        size_t matches; \
+ \
+        assert(NULL != it); \
+ \
+        matches = 0; \
+        AGGREGATE_TRAVERSE( \
+            it, type, \
+            { matches += array_count_if_## type(span, span_length, op, x); }, \
+            { matches += array_count_if_## type(&value, 1, op, x); } \
+        ); \
+ \
+        return matches; \
+    }
+
+iterator_aggregate(int32_t, int64_t)
+iterator_aggregate(int64_t, int64_t)
+iterator_aggregate(uint64_t, uint64_t)
+iterator_aggregate(double, double)
+
+# undef iterator_aggregate
+# undef AGGREGATE_TRAVERSE
+#endif /* !WITHOUT_ITERATOR */
@@ -0,0 +1,153 @@
+/**
+ * @file iterator/generator.c
+ * @brief write an iterator as a function which yields its values
+ *
+ * A generator is a function resumed, at each step of the iteration, right
+ * after the GENERATOR_YIELD which returned the previous value. There is
+ * no stack switch (these are stackless coroutines, like protothreads): a
+ * step costs a function call and a jump, the counterpart being that local
+ * variables are lost between two calls. Anything which has to survive a
+ * yield lives in the user data instead.
+ *
+ * \code
+ *   typedef struct {
+ *       int a, b;
+ *   } fibonacci_state;
+ *
+ *   static void fibonacci(Generator *g, void *data)
+ *   {
+ *       int tmp;
+ *       fibonacci_state *s;
+ *
+ *       s = (fibonacci_state *) data;
+ *       GENERATOR_BEGIN(g);
+ *       s->a = 0;
+ *       s->b = 1;
+ *       while (s->a < 1000) {
+ *           GENERATOR_YIELD(g, NULL, &s->a);
+ *           tmp = s->a + s->b;
+ *           s->a = s->b;
+ *           s->b = tmp;
+ *       }
+ *       GENERATOR_END(g);
+ *   }
+ *
+ *   int *v;
+ *   Iterator it;
+ *   fibonacci_state s;
+ *
+ *   generator_to_iterator(&it, fibonacci, &s);
+ *   for (iterator_first(&it); iterator_is_valid(&it, NULL, &v); iterator_next(&it)) {
+ *       printf("%d\n", *v);
+ *   }
+ *   iterator_close(&it);
+ * \endcode
+ *
+ * Rules:
+ * - GENERATOR_BEGIN and GENERATOR_END enclose the body of the function
+ * - the code before the first GENERATOR_YIELD is run again by each
+ *   iterator_first: that's where the state is (re)initialized
+ * - at most one GENERATOR_YIELD per line (a yield is identified by its line)
+ * - GENERATOR_YIELD can't be used inside a switch statement of the generator
+ * - GENERATOR_RETURN ends the generator early
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "generator.h"
+
+#ifndef WITHOUT_ITERATOR
+typedef struct {
+    Generator g;
+    GeneratorFunc func;
+    void *data;
+} gs_t /*generator_state*/;
+
+static void generator_iterator_first(const void *UNUSED(collection), void **state)
+{
+    gs_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (gs_t *) *state;
+    s->g.resume = GENERATOR_START;
+    s->g.done = false;
+    s->func(&s->g, s->data);
+}
+
+static void generator_iterator_next(const void *UNUSED(collection), void **state)
+{
+    gs_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (gs_t *) *state;
+    if (!s->g.done) {
+        s->func(&s->g, s->data);
+    }
+}
+
+static bool generator_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    return !((gs_t *) *state)->g.done;
+}
+
+static void generator_iterator_current(const void *UNUSED(collection), void **state, void **key, void **value)
+{
+    gs_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (gs_t *) *state;
+    if (NULL != key) {
+        *key = s->g.key;
+    }
+    if (NULL != value) {
+        *value = s->g.value;
+    }
+}
+
+/**
+ * Initialize an iterator which returns the values yielded by a generator
+ *
+ * @param it the iterator to initialize
+ * @param func the generator
+ * @param data a user data passed as is to *func*, typically where its
+ * state is kept from one call to the next
+ *
+ * @note iterator directions: forward only
+ * @note keys and values are the ones given to GENERATOR_YIELD
+ */
+void generator_to_iterator(Iterator *it, GeneratorFunc func, void *data)
+{
+    gs_t *s;
+
+    assert(NULL != it);
+    assert(NULL != func);
+
+    s = malloc(sizeof(*s));
+    s->func = func;
+    s->data = data;
+    s->g.resume = GENERATOR_START;
+    s->g.done = true;
+    s->g.key = s->g.value = NULL;
+
+    iterator_init(
+        it, NULL, s,
+        generator_iterator_first, NULL,
+        generator_iterator_current,
+        generator_iterator_next, NULL,
+        generator_iterator_is_valid,
+        free,
+        NULL, NULL, NULL
+    );
+}
+#endif /* !WITHOUT_ITERATOR */
@@ -43,12 +43,20 @@
 #include <assert.h>
 #include <stdint.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
 
 #include "attributes.h"
+#include "utils.h"
 #include "iterator.h"
+#include "aggregate.h"
+#include "error.h"
 
 static const Iterator NULL_ITERATOR;
 
+/* number of values fetched at once by the reducers when the iterator has no span */
+#define ITERATOR_BATCH_SIZE 64
+
 /**
  * Initialize an iterator
  *
@@ -98,6 +106,47 @@ void iterator_init(
     it->count = count;
     it->member = member;
     it->delete = delete;
+    it->next_batch = NULL;
+    it->next_span = NULL;
+    it->split = NULL;
+}
+
+/**
+ * Set the optional callback which fetches several elements at once
+ *
+ * It has to copy, from the current position, up to *n* keys into its
+ * third argument (if not `NULL`) and up to *n* values into its fourth
+ * (if not `NULL`), move the current position right after the last one
+ * and return their number (0 when the end is reached).
+ *
+ * @param it the iterator (after iterator_init)
+ * @param next_batch the callback
+ */
+void iterator_set_next_batch(Iterator *it, iterator_next_batch_t next_batch)
+{
+    assert(NULL != it);
+
+    it->next_batch = next_batch;
+}
+
+/**
+ * Set the optional callback which exposes the following elements when
+ * they are contiguous in memory (the values being the addresses of
+ * the elements)
+ *
+ * It has to set its third argument to the address of the current element,
+ * its fourth to the size of an element, move the current position right
+ * after the last contiguous element and return their number (0 when the
+ * end is reached).
+ *
+ * @param it the iterator (after iterator_init)
+ * @param next_span the callback
+ */
+void iterator_set_next_span(Iterator *it, iterator_next_span_t next_span)
+{
+    assert(NULL != it);
+
+    it->next_span = next_span;
 }
 
 /**
@@ -184,6 +233,144 @@ bool _iterator_is_valid(Iterator *it, void **key, void **value)
     return valid;
 }
 
+/**
+ * Set the optional callback which makes an iterator splittable (for the
+ * parallel functions like iterator_par_reduce)
+ *
+ * It has to initialize its last argument as a new and independent iterator
+ * on the i-th (its third argument) of n (its fourth argument) disjoint parts
+ * of the collection. The union of the n parts has to be the whole collection,
+ * in the same order.
+ *
+ * @param it the iterator (after iterator_init)
+ * @param split the callback
+ */
+void iterator_set_split(Iterator *it, iterator_split_t split)
+{
+    assert(NULL != it);
+
+    it->split = split;
+}
+
+/**
+ * Initialize an iterator on a part of the collection of an other
+ *
+ * @param it the iterator to split
+ * @param index the part (from 0 to *parts* - 1)
+ * @param parts the number of parts
+ * @param slice the iterator to initialize on the part *index*, it is
+ * independent of *it* and has to be closed with iterator_close
+ *
+ * @return `false` if *it* is not splittable (*slice* is left untouched)
+ */
+bool iterator_split(Iterator *it, size_t index, size_t parts, Iterator *slice)
+{
+    assert(NULL != it);
+    assert(NULL != slice);
+    assert(index < parts);
+
+    if (NULL == it->split) {
+        return false;
+    }
+    it->split(it->collection, &it->state, index, parts, slice);
+
+    return true;
+}
+
+/**
+ * Helper to implement a *split* callback: compute the bounds of the
+ * part *index* when *length* elements are split in *parts* parts (their
+ * lengths differ at most by one)
+ *
+ * @param length the number of elements to split
+ * @param index the part (from 0 to *parts* - 1)
+ * @param parts the number of parts
+ * @param from the index of the first element of the part
+ * @param to the index after the last element of the part
+ */
+void iterator_split_range(size_t length, size_t index, size_t parts, size_t *from, size_t *to)
+{
+    size_t quotient, remainder;
+
+    assert(index < parts);
+    assert(NULL != from);
+    assert(NULL != to);
+
+    quotient = length / parts;
+    remainder = length % parts;
+    *from = index * quotient + MIN(index, remainder);
+    *to = *from + quotient + (index < remainder);
+}
+
+/**
+ * Fetch up to *n* elements from the current position then move after them
+ *
+ * Falls back on the regular callbacks (one element at a time) if the
+ * iterator doesn't provide a *next_batch* callback.
+ *
+ * @param it the iterator
+ * @param keys an array of (at least) *n* elements to receive the keys (`NULL` to ignore them)
+ * @param values an array of (at least) *n* elements to receive the values (`NULL` to ignore them)
+ * @param n the maximum number of elements to fetch
+ *
+ * @return the number of elements fetched, 0 when the end is reached
+ *
+ * \code
+ *   size_t i, n;
+ *   void *values[64];
+ *
+ *   iterator_first(&it);
+ *   while (0 != (n = iterator_next_batch(&it, NULL, values, ARRAY_SIZE(values)))) {
+ *       for (i = 0; i < n; i++) {
+ *           // use values[i]
+ *       }
+ *   }
+ * \endcode
+ */
+size_t iterator_next_batch(Iterator *it, void **keys, void **values, size_t n)
+{
+    size_t i;
+
+    assert(NULL != it);
+
+    if (NULL != it->next_batch) {
+        return it->next_batch(it->collection, &it->state, keys, values, n);
+    }
+    for (i = 0; i < n && it->valid(it->collection, &it->state); i++) {
+        if (NULL != keys || NULL != values) {
+            it->current(it->collection, &it->state, NULL == keys ? NULL : &keys[i], NULL == values ? NULL : &values[i]);
+        }
+        iterator_next(it);
+    }
+
+    return i;
+}
+
+/**
+ * Get the address of the contiguous elements which follow the current
+ * position (the current one included) then move after them
+ *
+ * @param it the iterator
+ * @param base the address of the current element
+ * @param element_size the size of an element
+ *
+ * @return the number of contiguous elements at *base*, 0 when the end is
+ * reached or if the iterator can't expose contiguous elements (no
+ * *next_span* callback)
+ */
+size_t iterator_next_span(Iterator *it, const void **base, size_t *element_size)
+{
+    assert(NULL != it);
+    assert(NULL != base);
+    assert(NULL != element_size);
+
+    if (NULL == it->next_span) {
+        return 0;
+    }
+
+    return it->next_span(it->collection, &it->state, base, element_size);
+}
+
 /**
  * TODO
  */
@@ -215,10 +402,21 @@ size_t iterator_count(Iterator *it)
     if (NULL != it->count) {
         count = it->count(it->collection);
     } else {
+        size_t n;
+
         count = 0;
-        // TODO: use iterator_reduce ?
-        for (iterator_first(it); iterator_is_valid(it, NULL, NULL); iterator_next(it)) {
-            ++count;
+        iterator_first(it);
+        if (NULL != it->next_span) {
+            const void *base;
+            size_t element_size;
+
+            while (0 != (n = it->next_span(it->collection, &it->state, &base, &element_size))) {
+                count += n;
+            }
+        } else {
+            while (0 != (n = iterator_next_batch(it, NULL, NULL, SIZE_MAX))) {
+                count += n;
+            }
         }
     }
 
@@ -321,6 +519,40 @@ static void array_iterator_prev(const void *UNUSED(collection), void **state)
     s->ptr -= s->element_size;
 }
 
+static size_t array_iterator_next_span(const void *collection, void **state, const void **base, size_t *element_size)
+{
+    as_t *s;
+    size_t n;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    n = 0;
+    s = (as_t *) *state;
+    if (array_iterator_is_valid(collection, state)) {
+        *base = s->ptr;
+        *element_size = s->element_size;
+        n = s->element_count - (s->ptr - CHAR_P(collection)) / s->element_size;
+        s->ptr += n * s->element_size;
+    }
+
+    return n;
+}
+
+static void array_iterator_split(const void *collection, void **state, size_t index, size_t parts, Iterator *slice)
+{
+    as_t *s;
+    size_t from, to;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (as_t *) *state;
+    iterator_split_range(s->element_count, index, parts, &from, &to);
+    array_to_iterator(slice, (void *) (CHAR_P(collection) + from * s->element_size), s->element_size, to - from);
+}
+
 /**
  * Iterate on a "regular" C-array of any type.
  *
@@ -365,6 +597,97 @@ void array_to_iterator(Iterator *it, void *array, size_t element_size, size_t el
         free,
         NULL, NULL, NULL
     );
+    iterator_set_next_span(it, array_iterator_next_span);
+    iterator_set_split(it, array_iterator_split);
+}
+
+/* ========== array of pointers ========== */
+
+static void ptr_array_iterator_current(const void *collection, void **state, void **key, void **value)
+{
+    as_t *s;
+
+    assert(NULL != state);
+
+    s = (as_t *) *state;
+    if (NULL != value) {
+        *value = *(void **) s->ptr;
+    }
+    if (NULL != key) {
+        *((uint64_t *) key) = (s->ptr - CHAR_P(collection)) / sizeof(void *);
+    }
+}
+
+static size_t ptr_array_iterator_next_batch(const void *collection, void **state, void **keys, void **values, size_t n)
+{
+    as_t *s;
+    size_t i, offset;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (as_t *) *state;
+    if (!array_iterator_is_valid(collection, state)) {
+        return 0;
+    }
+    offset = (s->ptr - CHAR_P(collection)) / sizeof(void *);
+    n = MIN(n, s->element_count - offset);
+    if (NULL != values) {
+        memcpy(values, s->ptr, n * sizeof(*values));
+    }
+    if (NULL != keys) {
+        for (i = 0; i < n; i++) {
+            *((uint64_t *) &keys[i]) = offset + i;
+        }
+    }
+    s->ptr += n * sizeof(void *);
+
+    return n;
+}
+
+static void ptr_array_iterator_split(const void *collection, void **state, size_t index, size_t parts, Iterator *slice)
+{
+    size_t from, to;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_split_range(((as_t *) *state)->element_count, index, parts, &from, &to);
+    ptr_array_to_iterator(slice, ((void **) collection) + from, to - from);
+}
+
+/**
+ * Iterate on an array of *element_count* pointers: unlike array_to_iterator,
+ * the values are the pointers themselves, not their addresses.
+ *
+ * @param it the iterator to initialize
+ * @param array the array to iterate on
+ * @param element_count the number of pointers in the array
+ *
+ * @note iterator directions: forward and backward
+ * @note keys (element's index) are typed as uint64_t
+ */
+void ptr_array_to_iterator(Iterator *it, void **array, size_t element_count)
+{
+    as_t *s;
+
+    s = malloc(sizeof(*s));
+    s->ptr = CHAR_P(array);
+    s->element_size = sizeof(*array);
+    s->element_count = element_count;
+
+    iterator_init(
+        it, array, s,
+        array_iterator_first, array_iterator_last,
+        ptr_array_iterator_current,
+        array_iterator_next, array_iterator_prev,
+        array_iterator_is_valid,
+        free,
+        NULL, NULL, NULL
+    );
+    iterator_set_next_batch(it, ptr_array_iterator_next_batch);
+    iterator_set_split(it, ptr_array_iterator_split);
 }
 
 /* ========== NULL terminated (pointers) array ========== */
@@ -581,7 +904,6 @@ bool iterator_all(Iterator *it, FilterFunc callback, const void *user_data)
 }
 
 #if 0
-typedef void (*ApplyFunc)(void *value, const void *data);
 typedef bool (*ApplyWithErrorFunc)(void *value, const void *user_data, char **error);
 
 /**
@@ -671,17 +993,47 @@ bool iterator_max(Iterator *it, CmpFunc cmp, void **max)
 }
 
 /**
- * TODO
+ * Call *callback* on each value of the iterator to accumulate them into *acc*
+ *
+ * The values are fetched by span or batch when the iterator supports it.
+ *
+ * @param it the iterator
+ * @param acc the accumulator passed to *callback*
+ * @param callback the function to call on each value, the traversal stops
+ * as soon as it returns `false`
+ * @param error
+ *
+ * @return `false` if a call to *callback* failed
+ *
+ * @note values are fetched ahead by batches of ITERATOR_BATCH_SIZE: after
+ * a failure, the iterator may have moved further than the failing value
  **/
 bool iterator_reduce(Iterator *it, void *acc, bool (*callback)(void *acc, void *value, char **error), char **error)
 {
     bool ok;
-    void *value;
+    size_t i, n;
 
     assert(NULL != it);
 
-    for (ok = true, iterator_first(it); ok && iterator_is_valid(it, NULL, &value); iterator_next(it)) {
-        ok &= callback(acc, value, error);
+    ok = true;
+    iterator_first(it);
+    if (NULL != it->next_span) {
+        const char *base;
+        size_t element_size;
+
+        while (ok && 0 != (n = it->next_span(it->collection, &it->state, (const void **) &base, &element_size))) {
+            for (i = 0; ok && i < n; i++) {
+                ok &= callback(acc, (void *) (base + i * element_size), error);
+            }
+        }
+    } else {
+        void *values[ITERATOR_BATCH_SIZE];
+
+        while (ok && 0 != (n = iterator_next_batch(it, NULL, values, ARRAY_SIZE(values)))) {
+            for (i = 0; ok && i < n; i++) {
+                ok &= callback(acc, values[i], error);
+            }
+        }
     }
 
     return ok;
@@ -695,7 +1047,11 @@ static bool iterator_sum_callback(void *acc, void *value, char **UNUSED(error))
 }
 
 /**
- * TODO
+ * Compute the sum of the values of an iterator of int64_t
+ *
+ * @param it the iterator
+ *
+ * @return the sum (0 if the iterator is empty)
  **/
 int64_t iterator_sum(Iterator *it)
 {
@@ -704,7 +1060,23 @@ int64_t iterator_sum(Iterator *it)
     assert(NULL != it);
 
     sum = 0;
-    iterator_reduce(it, &sum, iterator_sum_callback, NULL);
+    if (NULL != it->next_span) {
+        size_t i, n, element_size;
+        const char *base;
+
+        iterator_first(it);
+        while (0 != (n = it->next_span(it->collection, &it->state, (const void **) &base, &element_size))) {
+            if (sizeof(int64_t) == element_size) {
+                sum += array_sum_int64_t((const int64_t *) base, n);
+            } else {
+                for (i = 0; i < n; i++) {
+                    sum += *((const int64_t *) (base + i * element_size));
+                }
+            }
+        }
+    } else {
+        iterator_reduce(it, &sum, iterator_sum_callback, NULL);
+    }
 
     return sum;
 }
@@ -717,7 +1089,11 @@ static bool iterator_product_callback(void *acc, void *value, char **UNUSED(erro
 }
 
 /**
- * TODO
+ * Compute the product of the values of an iterator of int64_t
+ *
+ * @param it the iterator
+ *
+ * @return the product (1 if the iterator is empty)
  **/
 int64_t iterator_product(Iterator *it)
 {
@@ -726,46 +1102,1211 @@ int64_t iterator_product(Iterator *it)
     assert(NULL != it);
 
     product = 1;
-    iterator_reduce(it, &product, iterator_product_callback, NULL);
+    if (NULL != it->next_span) {
+        size_t i, n, element_size;
+        const char *base;
+
+        iterator_first(it);
+        while (0 != (n = it->next_span(it->collection, &it->state, (const void **) &base, &element_size))) {
+            if (sizeof(int64_t) == element_size) {
+                for (i = 0; i < n; i++) {
+                    product *= ((const int64_t *) base)[i];
+                }
+            } else {
+                for (i = 0; i < n; i++) {
+                    product *= *((const int64_t *) (base + i * element_size));
+                }
+            }
+        }
+    } else {
+        iterator_reduce(it, &product, iterator_product_callback, NULL);
+    }
 
     return product;
 }
 
-/**
- * TODO
- **/
-void iterator_filter(Iterator *it, FilterFunc callback, const void *data)
+/* ========== parallel reductions ========== */
+
+/* accumulators of the workers are rounded to this size to keep them aligned */
+#define ITERATOR_ACC_ALIGNMENT 16
+
+typedef struct {
+    Iterator slice;
+    void *acc;
+    ReduceFunc fold;
+    char *error;
+    char **errorp;
+    bool ok;
+    bool threaded;
+} prw_t /*par_reduce_worker*/;
+
+static void *iterator_par_reduce_worker(void *arg)
 {
-    void *value;
+    prw_t *w;
 
-    assert(NULL != it);
-    assert(NULL != callback);
+    w = (prw_t *) arg;
+    w->ok = iterator_reduce(&w->slice, w->acc, w->fold, w->errorp);
 
-    for (iterator_first(it); iterator_is_valid(it, NULL, &value); iterator_next(it)) {
-        if (!callback(value, data)) {
-            iterator_delete_current(it);
-        }
-    }
+    return NULL;
 }
 
 /**
- * TODO
+ * Like iterator_reduce but the collection is split in *nthreads* parts
+ * which are reduced in parallel (one thread by part) then their results
+ * are merged into *acc*
+ *
+ * Each thread has its own accumulator, initialized as a copy of *acc*,
+ * so its initial value has to be neutral for *combine* (0 for a sum, 1
+ * for a product, ...). The partial results are combined in the order of
+ * the collection: *combine* only has to be associative.
+ *
+ * If the iterator is not splittable (see iterator_set_split) or if there
+ * is only one thread to use, this is the same as iterator_reduce.
+ *
+ * @param it the iterator (on the whole collection)
+ * @param acc the accumulator (initial value then result)
+ * @param acc_size the size of the accumulator
+ * @param fold the callback to accumulate a value into a partial accumulator
+ * @param combine the callback to merge a partial accumulator into *acc*
+ * @param nthreads the number of threads to use (0 for the number of online processors)
+ * @param error
+ *
+ * @return `false` if a call to *fold* failed (then *acc* is left untouched)
+ *
+ * \code
+ *   static bool fold_sum(void *acc, void *value, char **UNUSED(error)) {
+ *       *((int64_t *) acc) += *((int64_t *) value);
+ *       return true;
+ *   }
+ *
+ *   static void combine_sum(void *acc, const void *partial) {
+ *       *((int64_t *) acc) += *((const int64_t *) partial);
+ *   }
+ *
+ *   int64_t sum;
+ *
+ *   sum = 0;
+ *   darray_to_iterator(&it, &numbers);
+ *   iterator_par_reduce(&it, &sum, sizeof(sum), fold_sum, combine_sum, 0, NULL);
+ *   iterator_close(&it);
+ * \endcode
  **/
-void iterator_reject(Iterator *it, FilterFunc callback, const void *data)
+bool iterator_par_reduce(Iterator *it, void *acc, size_t acc_size, ReduceFunc fold, CombineFunc combine, size_t nthreads, char **error)
 {
-    void *value;
+    bool ok;
+    size_t i, stride;
+    prw_t *workers;
+    pthread_t *threads;
+    char *accs;
 
     assert(NULL != it);
-    assert(NULL != callback);
+    assert(NULL != fold);
+    assert(NULL != combine);
 
-    for (iterator_first(it); iterator_is_valid(it, NULL, &value); iterator_next(it)) {
-        if (callback(value, data)) {
-            iterator_delete_current(it);
+    if (0 == nthreads) {
+        long online;
+
+        online = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = online > 0 ? (size_t) online : 1;
+    }
+    if (NULL == it->split || nthreads < 2) {
+        return iterator_reduce(it, acc, fold, error);
+    }
+    stride = (acc_size + ITERATOR_ACC_ALIGNMENT - 1) & ~((size_t) ITERATOR_ACC_ALIGNMENT - 1);
+    workers = malloc(sizeof(*workers) * nthreads);
+    threads = malloc(sizeof(*threads) * nthreads);
+    accs = malloc(stride * nthreads);
+    if (NULL == workers || NULL == threads || NULL == accs) {
+        free(workers);
+        free(threads);
+        free(accs);
+        // fallback on a sequential reduction
+        return iterator_reduce(it, acc, fold, error);
+    }
+    for (i = 0; i < nthreads; i++) {
+        prw_t *w;
+
+        w = &workers[i];
+        w->acc = accs + i * stride;
+        memcpy(w->acc, acc, acc_size);
+        w->fold = fold;
+        w->error = NULL;
+        w->errorp = NULL == error ? NULL : &w->error;
+        w->ok = true;
+        it->split(it->collection, &it->state, i, nthreads, &w->slice);
+    }
+    // the current thread takes the first part, a thread is started for each other
+    for (i = 1; i < nthreads; i++) {
+        // if the thread can't be created, the part is reduced later by the current thread
+        workers[i].threaded = 0 == pthread_create(&threads[i], NULL, iterator_par_reduce_worker, &workers[i]);
+    }
+    iterator_par_reduce_worker(&workers[0]);
+    for (i = 1; i < nthreads; i++) {
+        if (workers[i].threaded) {
+            pthread_join(threads[i], NULL);
+        } else {
+            iterator_par_reduce_worker(&workers[i]);
+        }
+    }
+    ok = true;
+    for (i = 0; i < nthreads; i++) {
+        ok &= workers[i].ok;
+    }
+    for (i = 0; i < nthreads; i++) {
+        if (ok) {
+            combine(acc, workers[i].acc);
+        }
+        if (NULL != workers[i].error) {
+            // report the first error, discard the others
+            if (NULL != error && NULL == *error) {
+                *error = workers[i].error;
+            } else {
+                error_free(&workers[i].error);
+            }
         }
+        iterator_close(&workers[i].slice);
     }
+    free(workers);
+    free(threads);
+    free(accs);
+
+    return ok;
 }
 
-/* ========== collectable ========== */
+typedef struct {
+    ApplyFunc callback;
+    const void *user_data;
+} pea_t /*par_each_acc*/;
+
+static bool iterator_par_each_fold(void *acc, void *value, char **UNUSED(error))
+{
+    pea_t *a;
+
+    a = (pea_t *) acc;
+    a->callback(value, a->user_data);
+
+    return true;
+}
+
+static void iterator_par_each_combine(void *UNUSED(acc), const void *UNUSED(partial))
+{
+    // NOP
+}
+
+/**
+ * Call *callback* on each value of a collection from *nthreads* threads
+ * (see iterator_par_reduce for the requirements on the iterator)
+ *
+ * @param it the iterator (on the whole collection)
+ * @param callback the function to call on each value
+ * @param user_data a potential user data to transmit to each call to *callback*
+ * @param nthreads the number of threads to use (0 for the number of online processors)
+ *
+ * @note *callback* is called concurrently: it must not modify anything
+ * shared without synchronization
+ **/
+void iterator_par_each(Iterator *it, ApplyFunc callback, const void *user_data, size_t nthreads)
+{
+    pea_t acc;
+
+    assert(NULL != it);
+    assert(NULL != callback);
+
+    acc.callback = callback;
+    acc.user_data = user_data;
+    iterator_par_reduce(it, &acc, sizeof(acc), iterator_par_each_fold, iterator_par_each_combine, nthreads, NULL);
+}
+
+/**
+ * TODO
+ **/
+void iterator_filter(Iterator *it, FilterFunc callback, const void *data)
+{
+    void *value;
+
+    assert(NULL != it);
+    assert(NULL != callback);
+
+    for (iterator_first(it); iterator_is_valid(it, NULL, &value); iterator_next(it)) {
+        if (!callback(value, data)) {
+            iterator_delete_current(it);
+        }
+    }
+}
+
+/**
+ * TODO
+ **/
+void iterator_reject(Iterator *it, FilterFunc callback, const void *data)
+{
+    void *value;
+
+    assert(NULL != it);
+    assert(NULL != callback);
+
+    for (iterator_first(it); iterator_is_valid(it, NULL, &value); iterator_next(it)) {
+        if (callback(value, data)) {
+            iterator_delete_current(it);
+        }
+    }
+}
+
+/* ========== lazy adapters ========== */
+
+/*
+ * All the adapters below are iterators over an other iterator (their source):
+ * they don't copy nor modify anything, each step of the adapter only makes
+ * the steps required on its source(s). Their collection and their state are
+ * the same (allocated) structure and closing an adapter also closes its
+ * source(s) (closing them again, later, is harmless).
+ */
+
+static inline bool source_is_valid(Iterator *source)
+{
+    return source->valid(source->collection, &source->state);
+}
+
+static inline void source_current(Iterator *source, void **key, void **value)
+{
+    source->current(source->collection, &source->state, key, value);
+}
+
+typedef struct {
+    Iterator *source;
+} las_t /*lazy_adapter_state*/;
+
+static void lazy_adapter_close(void *state)
+{
+    assert(NULL != state);
+
+    iterator_close(((las_t *) state)->source);
+    free(state);
+}
+
+static void lazy_adapter_first(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_first(((las_t *) *state)->source);
+}
+
+static void lazy_adapter_last(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_last(((las_t *) *state)->source);
+}
+
+static void lazy_adapter_next(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_next(((las_t *) *state)->source);
+}
+
+static void lazy_adapter_previous(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_previous(((las_t *) *state)->source);
+}
+
+static bool lazy_adapter_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    return source_is_valid(((las_t *) *state)->source);
+}
+
+static void lazy_adapter_current(const void *UNUSED(collection), void **state, void **key, void **value)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    source_current(((las_t *) *state)->source, key, value);
+}
+
+static size_t lazy_adapter_count(const void *collection)
+{
+    assert(NULL != collection);
+
+    return iterator_count(((const las_t *) collection)->source);
+}
+
+/* ===== map ===== */
+
+typedef struct {
+    Iterator *source;
+    MapFunc callback;
+    void *data;
+} mas_t /*map_adapter_state*/;
+
+static void map_iterator_current(const void *UNUSED(collection), void **state, void **key, void **value)
+{
+    mas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (mas_t *) *state;
+    if (NULL == value) {
+        source_current(s->source, key, NULL);
+    } else {
+        void *v;
+
+        source_current(s->source, key, &v);
+        *value = s->callback(v, s->data);
+    }
+}
+
+/**
+ * Initialize an iterator which returns the values of *source* transformed
+ * by *callback*, on the fly.
+ *
+ * @param it the iterator to initialize
+ * @param source the iterator to transform
+ * @param callback the function called on each value, its result is the
+ * value returned by *it* (a projection, like a pointer to a field, or a
+ * pointer to some storage into *data*)
+ * @param data a user data passed as is to *callback*
+ *
+ * @note iterator directions: the same as *source*
+ * @note keys are the ones of *source*
+ *
+ * \code
+ *   static void *name(void *value, void *UNUSED(data)) {
+ *       return &((Person *) value)->name;
+ *   }
+ *
+ *   Iterator people, names;
+ *
+ *   array_to_iterator(&people, persons, sizeof(persons[0]), ARRAY_SIZE(persons));
+ *   iterator_map(&names, &people, name, NULL);
+ *   // use names as any other iterator
+ *   iterator_close(&names); // also closes people
+ * \endcode
+ */
+void iterator_map(Iterator *it, Iterator *source, MapFunc callback, void *data)
+{
+    mas_t *s;
+    bool backward;
+
+    assert(NULL != it);
+    assert(NULL != source);
+    assert(NULL != callback);
+
+    s = malloc(sizeof(*s));
+    s->source = source;
+    s->callback = callback;
+    s->data = data;
+    backward = NULL != source->last && NULL != source->previous;
+
+    iterator_init(
+        it, s, s,
+        NULL == source->first ? NULL : lazy_adapter_first,
+        backward ? lazy_adapter_last : NULL,
+        map_iterator_current,
+        NULL == source->next ? NULL : lazy_adapter_next,
+        backward ? lazy_adapter_previous : NULL,
+        lazy_adapter_is_valid,
+        lazy_adapter_close,
+        lazy_adapter_count, NULL, NULL
+    );
+}
+
+/* ===== filter ===== */
+
+typedef struct {
+    Iterator *source;
+    FilterFunc callback;
+    const void *data;
+} fas_t /*filter_adapter_state*/;
+
+static void filter_iterator_seek(fas_t *s, void (*move)(Iterator *))
+{
+    void *value;
+
+    while (iterator_is_valid(s->source, NULL, &value) && !s->callback(value, s->data)) {
+        move(s->source);
+    }
+}
+
+static void filter_iterator_first(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_first(((fas_t *) *state)->source);
+    filter_iterator_seek((fas_t *) *state, iterator_next);
+}
+
+static void filter_iterator_last(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_last(((fas_t *) *state)->source);
+    filter_iterator_seek((fas_t *) *state, iterator_previous);
+}
+
+static void filter_iterator_next(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_next(((fas_t *) *state)->source);
+    filter_iterator_seek((fas_t *) *state, iterator_next);
+}
+
+static void filter_iterator_previous(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_previous(((fas_t *) *state)->source);
+    filter_iterator_seek((fas_t *) *state, iterator_previous);
+}
+
+/**
+ * Initialize an iterator which only returns the values of *source* for
+ * which *callback* returns `true`.
+ *
+ * Unlike iterator_filter, the underlying collection is not modified.
+ *
+ * @param it the iterator to initialize
+ * @param source the iterator to filter
+ * @param callback the predicate
+ * @param data a user data passed as is to *callback*
+ *
+ * @note iterator directions: the same as *source*
+ * @note keys are the ones of *source*
+ */
+void iterator_filter_lazy(Iterator *it, Iterator *source, FilterFunc callback, const void *data)
+{
+    fas_t *s;
+    bool backward;
+
+    assert(NULL != it);
+    assert(NULL != source);
+    assert(NULL != callback);
+
+    s = malloc(sizeof(*s));
+    s->source = source;
+    s->callback = callback;
+    s->data = data;
+    backward = NULL != source->last && NULL != source->previous;
+
+    iterator_init(
+        it, s, s,
+        NULL == source->first ? NULL : filter_iterator_first,
+        backward ? filter_iterator_last : NULL,
+        lazy_adapter_current,
+        NULL == source->next ? NULL : filter_iterator_next,
+        backward ? filter_iterator_previous : NULL,
+        lazy_adapter_is_valid,
+        lazy_adapter_close,
+        NULL, NULL, NULL
+    );
+}
+
+/* ===== take/skip ===== */
+
+typedef struct {
+    Iterator *source;
+    size_t n;
+    size_t i;
+} tsas_t /*take_skip_adapter_state*/;
+
+static void take_iterator_first(const void *UNUSED(collection), void **state)
+{
+    tsas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (tsas_t *) *state;
+    s->i = 0;
+    iterator_first(s->source);
+}
+
+static void take_iterator_next(const void *UNUSED(collection), void **state)
+{
+    tsas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (tsas_t *) *state;
+    // don't move the source further than needed
+    if (++s->i < s->n) {
+        iterator_next(s->source);
+    }
+}
+
+static bool take_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    tsas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (tsas_t *) *state;
+
+    return s->i < s->n && source_is_valid(s->source);
+}
+
+static size_t take_iterator_count(const void *collection)
+{
+    const tsas_t *s;
+
+    assert(NULL != collection);
+
+    s = (const tsas_t *) collection;
+
+    return MIN(s->n, iterator_count(s->source));
+}
+
+/**
+ * Initialize an iterator which returns, at most, the *n* first values of *source*
+ *
+ * @param it the iterator to initialize
+ * @param source the iterator to truncate
+ * @param n the maximum number of values
+ *
+ * @note iterator directions: forward only
+ * @note keys are the ones of *source*
+ */
+void iterator_take(Iterator *it, Iterator *source, size_t n)
+{
+    tsas_t *s;
+
+    assert(NULL != it);
+    assert(NULL != source);
+
+    s = malloc(sizeof(*s));
+    s->source = source;
+    s->n = n;
+    s->i = 0;
+
+    iterator_init(
+        it, s, s,
+        take_iterator_first, NULL,
+        lazy_adapter_current,
+        take_iterator_next, NULL,
+        take_iterator_is_valid,
+        lazy_adapter_close,
+        take_iterator_count, NULL, NULL
+    );
+}
+
+static void skip_iterator_first(const void *UNUSED(collection), void **state)
+{
+    tsas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (tsas_t *) *state;
+    iterator_first(s->source);
+    for (s->i = 0; s->i < s->n && source_is_valid(s->source); s->i++) {
+        iterator_next(s->source);
+    }
+}
+
+static size_t skip_iterator_count(const void *collection)
+{
+    size_t count;
+    const tsas_t *s;
+
+    assert(NULL != collection);
+
+    s = (const tsas_t *) collection;
+    count = iterator_count(s->source);
+
+    return count > s->n ? count - s->n : 0;
+}
+
+/**
+ * Initialize an iterator which ignores the *n* first values of *source*
+ *
+ * @param it the iterator to initialize
+ * @param source the iterator
+ * @param n the number of values to skip
+ *
+ * @note iterator directions: forward only
+ * @note keys are the ones of *source*
+ */
+void iterator_skip(Iterator *it, Iterator *source, size_t n)
+{
+    tsas_t *s;
+
+    assert(NULL != it);
+    assert(NULL != source);
+
+    s = malloc(sizeof(*s));
+    s->source = source;
+    s->n = n;
+    s->i = 0;
+
+    iterator_init(
+        it, s, s,
+        skip_iterator_first, NULL,
+        lazy_adapter_current,
+        lazy_adapter_next, NULL,
+        lazy_adapter_is_valid,
+        lazy_adapter_close,
+        skip_iterator_count, NULL, NULL
+    );
+}
+
+/* ===== chain/zip ===== */
+
+typedef struct {
+    Iterator *sources[2];
+    size_t active;
+} bas_t /*binary_adapter_state*/;
+
+static void binary_adapter_close(void *state)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+
+    s = (bas_t *) state;
+    iterator_close(s->sources[0]);
+    iterator_close(s->sources[1]);
+    free(s);
+}
+
+static void chain_iterator_first(const void *UNUSED(collection), void **state)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+    s->active = 0;
+    iterator_first(s->sources[0]);
+    if (!source_is_valid(s->sources[0])) {
+        s->active = 1;
+        iterator_first(s->sources[1]);
+    }
+}
+
+static void chain_iterator_last(const void *UNUSED(collection), void **state)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+    s->active = 1;
+    iterator_last(s->sources[1]);
+    if (!source_is_valid(s->sources[1])) {
+        s->active = 0;
+        iterator_last(s->sources[0]);
+    }
+}
+
+static void chain_iterator_next(const void *UNUSED(collection), void **state)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+    iterator_next(s->sources[s->active]);
+    if (0 == s->active && !source_is_valid(s->sources[0])) {
+        s->active = 1;
+        iterator_first(s->sources[1]);
+    }
+}
+
+static void chain_iterator_previous(const void *UNUSED(collection), void **state)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+    iterator_previous(s->sources[s->active]);
+    if (1 == s->active && !source_is_valid(s->sources[1])) {
+        s->active = 0;
+        iterator_last(s->sources[0]);
+    }
+}
+
+static bool chain_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+
+    return source_is_valid(s->sources[s->active]);
+}
+
+static void chain_iterator_current(const void *UNUSED(collection), void **state, void **key, void **value)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+    source_current(s->sources[s->active], key, value);
+}
+
+static size_t chain_iterator_count(const void *collection)
+{
+    const bas_t *s;
+
+    assert(NULL != collection);
+
+    s = (const bas_t *) collection;
+
+    return iterator_count(s->sources[0]) + iterator_count(s->sources[1]);
+}
+
+/**
+ * Initialize an iterator which returns all the values of *first* then
+ * all the ones of *second*.
+ *
+ * @param it the iterator to initialize
+ * @param first the first iterator
+ * @param second the iterator to continue with
+ *
+ * @note iterator directions: forward and backward if both *first* and
+ * *second* allow it else forward only
+ * @note keys are the ones of *first* and *second*
+ */
+void iterator_chain(Iterator *it, Iterator *first, Iterator *second)
+{
+    bas_t *s;
+    bool backward;
+
+    assert(NULL != it);
+    assert(NULL != first);
+    assert(NULL != second);
+
+    s = malloc(sizeof(*s));
+    s->sources[0] = first;
+    s->sources[1] = second;
+    s->active = 0;
+    backward = NULL != first->last && NULL != first->previous && NULL != second->last && NULL != second->previous;
+
+    iterator_init(
+        it, s, s,
+        chain_iterator_first,
+        backward ? chain_iterator_last : NULL,
+        chain_iterator_current,
+        chain_iterator_next,
+        backward ? chain_iterator_previous : NULL,
+        chain_iterator_is_valid,
+        binary_adapter_close,
+        chain_iterator_count, NULL, NULL
+    );
+}
+
+static void zip_iterator_first(const void *UNUSED(collection), void **state)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+    iterator_first(s->sources[0]);
+    iterator_first(s->sources[1]);
+}
+
+static void zip_iterator_next(const void *UNUSED(collection), void **state)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+    iterator_next(s->sources[0]);
+    iterator_next(s->sources[1]);
+}
+
+static bool zip_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+
+    return source_is_valid(s->sources[0]) && source_is_valid(s->sources[1]);
+}
+
+static void zip_iterator_current(const void *UNUSED(collection), void **state, void **key, void **value)
+{
+    bas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (bas_t *) *state;
+    if (NULL != key) {
+        source_current(s->sources[0], NULL, key);
+    }
+    if (NULL != value) {
+        source_current(s->sources[1], NULL, value);
+    }
+}
+
+static size_t zip_iterator_count(const void *collection)
+{
+    const bas_t *s;
+
+    assert(NULL != collection);
+
+    s = (const bas_t *) collection;
+
+    return MIN(iterator_count(s->sources[0]), iterator_count(s->sources[1]));
+}
+
+/**
+ * Initialize an iterator which traverses two iterators in parallel, until
+ * the shortest ends.
+ *
+ * @param it the iterator to initialize
+ * @param left the iterator which provides the keys
+ * @param right the iterator which provides the values
+ *
+ * @note iterator directions: forward only
+ * @note the key is the current value of *left*, the value the current value of *right*
+ *
+ * \code
+ *   int *number, numbers[] = {1, 2, 3};
+ *   const char **name, *names[] = {"one", "two", "three"};
+ *   Iterator its[3];
+ *
+ *   array_to_iterator(&its[0], names, sizeof(names[0]), ARRAY_SIZE(names));
+ *   array_to_iterator(&its[1], numbers, sizeof(numbers[0]), ARRAY_SIZE(numbers));
+ *   iterator_zip(&its[2], &its[0], &its[1]);
+ *   for (iterator_first(&its[2]); iterator_is_valid(&its[2], &name, &number); iterator_next(&its[2])) {
+ *       printf("%s = %d\n", *name, *number);
+ *   }
+ *   iterator_close(&its[2]);
+ * \endcode
+ */
+void iterator_zip(Iterator *it, Iterator *left, Iterator *right)
+{
+    bas_t *s;
+
+    assert(NULL != it);
+    assert(NULL != left);
+    assert(NULL != right);
+
+    s = malloc(sizeof(*s));
+    s->sources[0] = left;
+    s->sources[1] = right;
+    s->active = 0;
+
+    iterator_init(
+        it, s, s,
+        zip_iterator_first, NULL,
+        zip_iterator_current,
+        zip_iterator_next, NULL,
+        zip_iterator_is_valid,
+        binary_adapter_close,
+        zip_iterator_count, NULL, NULL
+    );
+}
+
+/* ===== merge ===== */
+
+typedef struct {
+    Iterator **sources;
+    size_t n;
+    CmpFunc cmp;
+    MergeFunc combine;
+    void *data;
+    // heads[i]/keys[i]: current value/key of sources[i], alive[i]: sources[i] is not exhausted
+    void **heads;
+    void **keys;
+    bool *alive;
+    // tree[0] is the winner (index of the source of the smallest value),
+    // tree[1..n - 1] the losers of each match, leaves being (virtually) at n..2n - 1
+    size_t *tree;
+    // with combine only: the current (combined) value and its key
+    void *value;
+    void *key;
+    bool valid;
+} mgas_t /*merge_adapter_state*/;
+
+static void merge_adapter_close(void *state)
+{
+    size_t i;
+    mgas_t *s;
+
+    assert(NULL != state);
+
+    s = (mgas_t *) state;
+    for (i = 0; i < s->n; i++) {
+        iterator_close(s->sources[i]);
+    }
+    free(s);
+}
+
+static void merge_iterator_fetch(mgas_t *s, size_t i)
+{
+    if ((s->alive[i] = source_is_valid(s->sources[i]))) {
+        s->keys[i] = NULL;
+        source_current(s->sources[i], &s->keys[i], &s->heads[i]);
+    }
+}
+
+/**
+ * Does the head of source a precede the head of source b? (exhausted
+ * sources are beyond everything, ties are broken by source index to keep
+ * the merge stable)
+ */
+static bool merge_iterator_precedes(mgas_t *s, size_t a, size_t b)
+{
+    int cmp;
+
+    if (!s->alive[a] || !s->alive[b]) {
+        return s->alive[a] || (!s->alive[b] && a < b);
+    }
+    cmp = s->cmp(s->heads[a], s->heads[b]);
+
+    return cmp < 0 || (0 == cmp && a < b);
+}
+
+static size_t merge_iterator_build(mgas_t *s, size_t node)
+{
+    size_t left, right;
+
+    if (node >= s->n) {
+        return node - s->n;
+    }
+    left = merge_iterator_build(s, 2 * node);
+    right = merge_iterator_build(s, 2 * node + 1);
+    if (merge_iterator_precedes(s, left, right)) {
+        s->tree[node] = right;
+        return left;
+    } else {
+        s->tree[node] = left;
+        return right;
+    }
+}
+
+/**
+ * Move the winner to its next value then replay its matches, from its
+ * leaf to the root: log2(n) comparisons
+ */
+static void merge_iterator_advance(mgas_t *s)
+{
+    size_t node, winner, tmp;
+
+    winner = s->tree[0];
+    iterator_next(s->sources[winner]);
+    merge_iterator_fetch(s, winner);
+    for (node = (winner + s->n) / 2; node > 0; node /= 2) {
+        if (merge_iterator_precedes(s, s->tree[node], winner)) {
+            tmp = s->tree[node];
+            s->tree[node] = winner;
+            winner = tmp;
+        }
+    }
+    s->tree[0] = winner;
+}
+
+/**
+ * With a combine callback: take the winner then fold into it the
+ * following values which compare equal to it
+ */
+static void merge_iterator_combine(mgas_t *s)
+{
+    if ((s->valid = s->alive[s->tree[0]])) {
+        s->value = s->heads[s->tree[0]];
+        s->key = s->keys[s->tree[0]];
+        merge_iterator_advance(s);
+        while (s->alive[s->tree[0]] && 0 == s->cmp(s->value, s->heads[s->tree[0]])) {
+            s->value = s->combine(s->value, s->heads[s->tree[0]], s->data);
+            merge_iterator_advance(s);
+        }
+    }
+}
+
+static void merge_iterator_first(const void *UNUSED(collection), void **state)
+{
+    size_t i;
+    mgas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (mgas_t *) *state;
+    for (i = 0; i < s->n; i++) {
+        iterator_first(s->sources[i]);
+        merge_iterator_fetch(s, i);
+    }
+    if (s->n > 0) {
+        s->tree[0] = merge_iterator_build(s, 1);
+    }
+    if (NULL != s->combine) {
+        merge_iterator_combine(s);
+    }
+}
+
+static void merge_iterator_next(const void *UNUSED(collection), void **state)
+{
+    mgas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (mgas_t *) *state;
+    if (NULL == s->combine) {
+        merge_iterator_advance(s);
+    } else {
+        merge_iterator_combine(s);
+    }
+}
+
+static bool merge_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    mgas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (mgas_t *) *state;
+
+    return NULL == s->combine ? s->alive[s->tree[0]] : s->valid;
+}
+
+static void merge_iterator_current(const void *UNUSED(collection), void **state, void **key, void **value)
+{
+    mgas_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (mgas_t *) *state;
+    if (NULL != key) {
+        *key = NULL == s->combine ? s->keys[s->tree[0]] : s->key;
+    }
+    if (NULL != value) {
+        *value = NULL == s->combine ? s->heads[s->tree[0]] : s->value;
+    }
+}
+
+static size_t merge_iterator_count(const void *collection)
+{
+    size_t i, count;
+    const mgas_t *s;
+
+    assert(NULL != collection);
+
+    s = (const mgas_t *) collection;
+    for (count = i = 0; i < s->n; i++) {
+        count += iterator_count(s->sources[i]);
+    }
+
+    return count;
+}
+
+/**
+ * Initialize an iterator which merges, lazily, *n* iterators which return
+ * their values in ascending order (according to *cmp*) into a single
+ * ascending sequence.
+ *
+ * The next value is elected by a loser tree: each step costs log2(*n*)
+ * comparisons and nothing is copied nor allocated after this call.
+ *
+ * @param it the iterator to initialize
+ * @param sources an array of *n* pointers to the iterators to merge
+ * @param n the number of iterators in *sources*
+ * @param cmp the function to compare two values (the ones of the sources
+ * have to be already sorted with it)
+ * @param combine (optional) if not `NULL`, consecutive equal values are
+ * returned as a single one: the result of calling *combine* on the first
+ * one (or the previous result of *combine*) and each of the following
+ * duplicates, in turn. To only remove the duplicates, return its first
+ * argument.
+ * @param data a user data passed as is to *combine*
+ *
+ * @note iterator directions: forward only
+ * @note keys are the ones of the sources (with *combine*: the one of the
+ * first of the equal values)
+ * @note equal values from different sources are returned in the order of
+ * *sources* (the merge is stable)
+ * @note with *combine*, the values of the sources have to remain valid
+ * after moving their iterator (which is the case of the iterators on
+ * collections)
+ *
+ * \code
+ *   Iterator its[3], *sources[] = {&its[0], &its[1]};
+ *
+ *   darray_to_iterator(&its[0], &sorted_darray);
+ *   rbtree_to_iterator(&its[1], &tree);
+ *   iterator_merge(&its[2], sources, ARRAY_SIZE(sources), cmp, NULL, NULL);
+ *   for (iterator_first(&its[2]); iterator_is_valid(&its[2], NULL, &v); iterator_next(&its[2])) {
+ *       // ...
+ *   }
+ *   iterator_close(&its[2]); // closes its[0] and its[1] too
+ * \endcode
+ */
+void iterator_merge(Iterator *it, Iterator **sources, size_t n, CmpFunc cmp, MergeFunc combine, void *data)
+{
+    mgas_t *s;
+
+    assert(NULL != it);
+    assert(NULL != sources || 0 == n);
+    assert(NULL != cmp);
+
+    // a single allocation for the state and its arrays (pointers first for alignment)
+    s = malloc(sizeof(*s) + n * (sizeof(*s->sources) + sizeof(*s->heads) + sizeof(*s->keys) + sizeof(*s->tree) + sizeof(*s->alive)) + sizeof(*s->tree) + sizeof(*s->alive));
+    s->sources = (Iterator **) (s + 1);
+    s->heads = (void **) (s->sources + n);
+    s->keys = s->heads + n;
+    // one more element to tree and alive for a single exhausted virtual source when n = 0
+    s->tree = (size_t *) (s->keys + n);
+    s->alive = (bool *) (s->tree + n + 1);
+    memset(s->alive, 0, (n + 1) * sizeof(*s->alive));
+    if (0 != n) {
+        memcpy(s->sources, sources, n * sizeof(*s->sources));
+    }
+    s->n = n;
+    s->cmp = cmp;
+    s->combine = combine;
+    s->data = data;
+    s->value = s->key = NULL;
+    s->valid = false;
+    s->tree[0] = 0;
+
+    iterator_init(
+        it, s, s,
+        merge_iterator_first, NULL,
+        merge_iterator_current,
+        merge_iterator_next, NULL,
+        merge_iterator_is_valid,
+        merge_adapter_close,
+        NULL == combine ? merge_iterator_count : NULL, NULL, NULL
+    );
+}
+
+/* ========== collectable ========== */
 
 /**
  * TODO
@@ -778,23 +2319,104 @@ void collectable_init(Collectable *collectable, void *collection, collectable_in
 
     collectable->collection = collection;
     collectable->into = into;
+    collectable->reserve = NULL;
+    collectable->into_batch = NULL;
+    collectable->into_span = NULL;
 }
 
+/**
+ * Set the optional callback which makes room for a given number of
+ * additional elements before iterator_into inserts them (when the count
+ * of the source is known without traversing it)
+ *
+ * @param collectable the collectable (after collectable_init)
+ * @param reserve the callback
+ */
+void collectable_set_reserve(Collectable *collectable, collectable_reserve_t reserve)
+{
+    assert(NULL != collectable);
+
+    collectable->reserve = reserve;
+}
 
-static bool iterator_into_callback(void *acc, void *value, char **UNUSED(error))
+/**
+ * Set the optional callback which inserts several elements at once
+ *
+ * It receives the arrays of keys and values, as filled by iterator_next_batch,
+ * and their number.
+ *
+ * @param collectable the collectable (after collectable_init)
+ * @param into_batch the callback
+ */
+void collectable_set_into_batch(Collectable *collectable, collectable_into_batch_t into_batch)
 {
-    Collectable *collectable;
+    assert(NULL != collectable);
 
-    collectable = (Collectable *) acc;
-    collectable->into(collectable->collection, NULL/*TODO: key?*/, value);
+    collectable->into_batch = into_batch;
+}
 
-    return true;
+/**
+ * Set the optional callback which inserts contiguous elements at once
+ *
+ * It receives the address of the first element, the size of an element
+ * and their number, as returned by iterator_next_span.
+ *
+ * @param collectable the collectable (after collectable_init)
+ * @param into_span the callback
+ */
+void collectable_set_into_span(Collectable *collectable, collectable_into_span_t into_span)
+{
+    assert(NULL != collectable);
+
+    collectable->into_span = into_span;
 }
 
 /**
- * TODO
+ * Insert all the elements (keys and values) of an iterator into a collection
+ *
+ * The collection is first pre-sized if both the iterator knows its count
+ * and the collectable can reserve room. Then elements are transferred
+ * by spans (if both sides support it: for an array into a DArray, it is
+ * a plain copy), else by batches.
+ *
+ * @param it the source
+ * @param collectable the destination
+ *
+ * @return `true`
  **/
 bool iterator_into(Iterator *it, Collectable *collectable)
 {
-    return iterator_reduce(it, collectable, iterator_into_callback, NULL);
+    size_t i, n;
+
+    assert(NULL != it);
+    assert(NULL != collectable);
+
+    if (NULL != collectable->reserve && NULL != it->count) {
+        collectable->reserve(collectable->collection, it->count(it->collection));
+    }
+    iterator_first(it);
+    if (NULL != collectable->into_span && NULL != it->next_span) {
+        const void *base;
+        size_t element_size;
+
+        while (0 != (n = iterator_next_span(it, &base, &element_size))) {
+            collectable->into_span(collectable->collection, base, element_size, n);
+        }
+    } else {
+        void *keys[ITERATOR_BATCH_SIZE], *values[ITERATOR_BATCH_SIZE];
+
+        // for iterators without keys
+        memset(keys, 0, sizeof(keys));
+        while (0 != (n = iterator_next_batch(it, keys, values, ARRAY_SIZE(values)))) {
+            if (NULL != collectable->into_batch) {
+                collectable->into_batch(collectable->collection, keys, values, n);
+            } else {
+                for (i = 0; i < n; i++) {
+                    collectable->into(collectable->collection, keys[i], values[i]);
+                }
+            }
+        }
+    }
+
+    return true;
 }
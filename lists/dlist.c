@@ -531,6 +531,144 @@ void dlist_remove_tail(DList *list)
     }
 }
 
+static size_t count_range(DListElement *first, DListElement *last)
+{
+    size_t count;
+
+    for (count = 1; first != last; first = first->next) {
+        assert(NULL != first);
+        ++count;
+    }
+
+    return count;
+}
+
+/* unlink the run [first;last] (count elements) from list */
+static void unlink_range(DList *list, DListElement *first, DListElement *last, size_t count)
+{
+    if (NULL == first->prev) {
+        list->head = last->next;
+    } else {
+        first->prev->next = last->next;
+    }
+    if (NULL == last->next) {
+        list->tail = first->prev;
+    } else {
+        last->next->prev = first->prev;
+    }
+    first->prev = last->next = NULL;
+    list->length -= count;
+}
+
+/* link the run [first;last] (count elements) into list before position (NULL to append it) */
+static void link_range_before(DList *list, DListElement *position, DListElement *first, DListElement *last, size_t count)
+{
+    last->next = position;
+    if (NULL == position) {
+        first->prev = list->tail;
+        list->tail = last;
+    } else {
+        first->prev = position->prev;
+        position->prev = last;
+    }
+    if (NULL == first->prev) {
+        list->head = first;
+    } else {
+        first->prev->next = first;
+    }
+    list->length += count;
+}
+
+/**
+ * Moves the elements from *first* to *last* (both included) of *src* into
+ * *dst*, before *position*. Elements are relinked, not copied: nothing is
+ * allocated nor freed and neither dup nor dtor callbacks are called.
+ *
+ * @param dst the list which receives the elements
+ * @param position the element of *dst* before which to insert the moved
+ *   elements (`NULL` to append them to *dst*)
+ * @param src the list to take the elements from (can be *dst* if
+ *   *position* is not part of the [*first*;*last*] range)
+ * @param first the first element of *src* to move
+ * @param last the last element of *src* to move (*first* itself or one of
+ *   its successors)
+ * @param count the number of elements from *first* to *last*, if known,
+ *   else 0
+ *
+ * @note this is O(1) when *count* is given or the whole *src* is moved,
+ *   otherwise O(k) as the k moved elements are walked to count them (to
+ *   maintain the lengths of both lists)
+ */
+void dlist_splice(DList *dst, DListElement *position, DList *src, DListElement *first, DListElement *last, size_t count)
+{
+    assert(NULL != dst);
+    assert(NULL != src);
+    assert(NULL != first);
+    assert(NULL != last);
+    assert(0 == count || count_range(first, last) == count);
+
+    if (0 == count) {
+        if (first == src->head && last == src->tail) {
+            count = src->length;
+        } else {
+            count = count_range(first, last);
+        }
+    }
+    unlink_range(src, first, last, count);
+    link_range_before(dst, position, first, last, count);
+}
+
+/**
+ * Moves, in O(1), all the elements of *src* at the end of *dst*,
+ * *src* is left empty.
+ *
+ * @param dst the list to extend
+ * @param src the list to empty
+ *
+ * @note both lists are expected to have the same dtor (dup is not called)
+ */
+void dlist_concat(DList *dst, DList *src)
+{
+    assert(NULL != dst);
+    assert(NULL != src);
+    assert(dst != src);
+
+    if (NULL != src->head) {
+        link_range_before(dst, NULL, src->head, src->tail, src->length);
+        src->head = src->tail = NULL;
+        src->length = 0;
+    }
+}
+
+/**
+ * Cuts a list in two: the elements following *element* are moved
+ * at the end of *rest*.
+ *
+ * @param list the list to cut
+ * @param element the last element to keep in *list* (`NULL` to move
+ *   all of its elements)
+ * @param rest an initialized list which receives the elements following
+ *   *element*
+ * @param count the number of elements following *element*, if known,
+ *   else 0
+ *
+ * @note this is O(1) when *count* is given or *element* is `NULL`,
+ *   otherwise O(k) as the k moved elements are walked to count them
+ */
+void dlist_cut_after(DList *list, DListElement *element, DList *rest, size_t count)
+{
+    DListElement *first;
+
+    assert(NULL != list);
+    assert(NULL != rest);
+    assert(list != rest);
+
+    first = NULL == element ? list->head : element->next;
+    if (NULL != first) {
+        dlist_splice(rest, NULL, list, first, list->tail, count);
+    }
+}
+
 static DListElement *resolve_position(DList *list, int n)
 {
     int c;
@@ -0,0 +1,399 @@
+/**
+ * @file lists/idlist.c
+ * @brief intrusive double linked list
+ *
+ * Unlike a DList (\ref lists/dlist.c), an intrusive list does not allocate
+ * any node: the user embeds a `DListLink` into its own struct and gets back
+ * the struct from the link with `idlist_entry` (`container_of`). As there is
+ * no allocation at all, none of these functions can fail and an object can
+ * belong to as many lists (or trees/hashtables) as it has links.
+ *
+ * \code
+ *   typedef struct {
+ *       int fd;
+ *       DListLink lru;
+ *   } Connection;
+ *
+ *   IDList lru;
+ *   DListLink *link;
+ *
+ *   idlist_init(&lru);
+ *   idlist_append(&lru, &conn->lru);
+ *   // on activity
+ *   idlist_move_to_tail(&lru, &conn->lru);
+ *   // expire the least recently used one
+ *   if (NULL != (link = idlist_pop_head(&lru))) {
+ *       Connection *oldest = idlist_entry(link, Connection, lru);
+ *       // ...
+ *   }
+ * \endcode
+ *
+ * @note the list does not own the objects: there is no destructor, it is up
+ * to the caller to free them once they are removed from every container.
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "idlist.h"
+
+/**
+ * Initializes an intrusive list
+ *
+ * @param list the list to initialize
+ */
+void idlist_init(IDList *list)
+{
+    assert(NULL != list);
+
+    list->length = 0;
+    list->head = list->tail = NULL;
+}
+
+/**
+ * Get the length of an intrusive list
+ *
+ * @param list the list
+ *
+ * @return the number of elements in the list
+ */
+size_t idlist_length(IDList *list)
+{
+    assert(NULL != list);
+
+    return list->length;
+}
+
+/**
+ * Is the intrusive list empty?
+ *
+ * @param list the list
+ *
+ * @return `true` if *list* is empty else `false`
+ */
+bool idlist_empty(IDList *list)
+{
+    assert(NULL != list);
+
+    return NULL == list->head;
+}
+
+/**
+ * Links *link* at the end of *list*
+ *
+ * @param list the list
+ * @param link the link to add (it must not already be in a list)
+ */
+void idlist_append(IDList *list, DListLink *link)
+{
+    assert(NULL != list);
+    assert(NULL != link);
+
+    link->next = NULL;
+    link->prev = list->tail;
+    if (NULL != list->tail) {
+        list->tail->next = link;
+    } else {
+        list->head = link;
+    }
+    list->tail = link;
+    ++list->length;
+}
+
+/**
+ * Links *link* at the start of *list*
+ *
+ * @param list the list
+ * @param link the link to add (it must not already be in a list)
+ */
+void idlist_prepend(IDList *list, DListLink *link)
+{
+    assert(NULL != list);
+    assert(NULL != link);
+
+    link->prev = NULL;
+    link->next = list->head;
+    if (NULL != list->head) {
+        list->head->prev = link;
+    } else {
+        list->tail = link;
+    }
+    list->head = link;
+    ++list->length;
+}
+
+/**
+ * Links *link* before *sibling*
+ *
+ * @param list the list
+ * @param sibling an element of *list*
+ * @param link the link to add (it must not already be in a list)
+ */
+void idlist_insert_before(IDList *list, DListLink *sibling, DListLink *link)
+{
+    assert(NULL != list);
+    assert(NULL != sibling);
+    assert(NULL != link);
+
+    if (sibling == list->head) {
+        idlist_prepend(list, link);
+    } else {
+        link->next = sibling;
+        link->prev = sibling->prev;
+        sibling->prev->next = link;
+        sibling->prev = link;
+        ++list->length;
+    }
+}
+
+/**
+ * Links *link* after *sibling*
+ *
+ * @param list the list
+ * @param sibling an element of *list*
+ * @param link the link to add (it must not already be in a list)
+ */
+void idlist_insert_after(IDList *list, DListLink *sibling, DListLink *link)
+{
+    assert(NULL != list);
+    assert(NULL != sibling);
+    assert(NULL != link);
+
+    if (sibling == list->tail) {
+        idlist_append(list, link);
+    } else {
+        link->prev = sibling;
+        link->next = sibling->next;
+        sibling->next->prev = link;
+        sibling->next = link;
+        ++list->length;
+    }
+}
+
+/**
+ * Unlinks an element from the list
+ *
+ * @param list the list
+ * @param link the element to remove
+ *
+ * @note the object which embeds *link* is left untouched
+ */
+void idlist_remove_link(IDList *list, DListLink *link)
+{
+    assert(NULL != list);
+    assert(NULL != link);
+
+    if (NULL != link->prev) {
+        link->prev->next = link->next;
+    } else {
+        list->head = link->next;
+    }
+    if (NULL != link->next) {
+        link->next->prev = link->prev;
+    } else {
+        list->tail = link->prev;
+    }
+    link->next = link->prev = NULL;
+    --list->length;
+}
+
+/**
+ * Unlinks and returns the first element of a list
+ *
+ * @param list the list
+ *
+ * @return `NULL` if the list is empty else its former head
+ */
+DListLink *idlist_pop_head(IDList *list)
+{
+    DListLink *link;
+
+    assert(NULL != list);
+
+    if (NULL != (link = list->head)) {
+        idlist_remove_link(list, link);
+    }
+
+    return link;
+}
+
+/**
+ * Unlinks and returns the last element of a list
+ *
+ * @param list the list
+ *
+ * @return `NULL` if the list is empty else its former tail
+ */
+DListLink *idlist_pop_tail(IDList *list)
+{
+    DListLink *link;
+
+    assert(NULL != list);
+
+    if (NULL != (link = list->tail)) {
+        idlist_remove_link(list, link);
+    }
+
+    return link;
+}
+
+/**
+ * Moves an element of a list at its start
+ *
+ * @param list the list
+ * @param link an element of *list*
+ */
+void idlist_move_to_head(IDList *list, DListLink *link)
+{
+    assert(NULL != list);
+    assert(NULL != link);
+
+    if (link != list->head) {
+        idlist_remove_link(list, link);
+        idlist_prepend(list, link);
+    }
+}
+
+/**
+ * Moves an element of a list at its end (the usual "touch" operation
+ * of a LRU)
+ *
+ * @param list the list
+ * @param link an element of *list*
+ */
+void idlist_move_to_tail(IDList *list, DListLink *link)
+{
+    assert(NULL != list);
+    assert(NULL != link);
+
+    if (link != list->tail) {
+        idlist_remove_link(list, link);
+        idlist_append(list, link);
+    }
+}
+
+/**
+ * Find the first element in a list to match according a callback
+ *
+ * @param list the list
+ * @param cmp a callback to compare the current link to *data*, returns 0 on match
+ * @param data the data to be compared to
+ *
+ * @return `NULL` if there is no match else the matching link
+ */
+DListLink *idlist_find_first(IDList *list, DListLinkCmpFunc cmp, const void *data)
+{
+    DListLink *link;
+
+    assert(NULL != list);
+    assert(NULL != cmp);
+
+    idlist_foreach(list, link) {
+        if (0 == cmp(link, data)) {
+            break;
+        }
+    }
+
+    return link;
+}
+
+/**
+ * Find the last element in a list to match according a callback
+ *
+ * @param list the list
+ * @param cmp a callback to compare the current link to *data*, returns 0 on match
+ * @param data the data to be compared to
+ *
+ * @return `NULL` if there is no match else the matching link
+ */
+DListLink *idlist_find_last(IDList *list, DListLinkCmpFunc cmp, const void *data)
+{
+    DListLink *link;
+
+    assert(NULL != list);
+    assert(NULL != cmp);
+
+    idlist_foreach_reverse(list, link) {
+        if (0 == cmp(link, data)) {
+            break;
+        }
+    }
+
+    return link;
+}
+
+#ifndef WITHOUT_ITERATOR
+static void idlist_iterator_first(const void *collection, void **state)
+{
+    assert(NULL != collection);
+    assert(NULL != state);
+
+    *state = ((const IDList *) collection)->head;
+}
+
+static void idlist_iterator_last(const void *collection, void **state)
+{
+    assert(NULL != collection);
+    assert(NULL != state);
+
+    *state = ((const IDList *) collection)->tail;
+}
+
+static bool idlist_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+
+    return NULL != *state;
+}
+
+static void idlist_iterator_current(const void *UNUSED(collection), void **state, void **UNUSED(key), void **value)
+{
+    assert(NULL != state);
+
+    if (NULL != value) {
+        *value = *state;
+    }
+}
+
+static void idlist_iterator_next(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+
+    *state = ((DListLink *) *state)->next;
+}
+
+static void idlist_iterator_previous(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+
+    *state = ((DListLink *) *state)->prev;
+}
+
+/**
+ * Initialize an *Iterator* to loop, in both directions, on the links
+ * of an intrusive list.
+ *
+ * @param it the iterator to initialize
+ * @param list the intrusive list to traverse
+ *
+ * @note iterator directions: forward and backward
+ * @note values are the `DListLink *` (use idlist_entry to get the object)
+ * @note there is no key
+ **/
+void idlist_to_iterator(Iterator *it, IDList *list)
+{
+    assert(NULL != it);
+    assert(NULL != list);
+
+    iterator_init(
+        it, list, NULL,
+        idlist_iterator_first, idlist_iterator_last,
+        idlist_iterator_current,
+        idlist_iterator_next, idlist_iterator_previous,
+        idlist_iterator_is_valid,
+        NULL,
+        (iterator_count_t) idlist_length, NULL, NULL
+    );
+}
+#endif /* !WITHOUT_ITERATOR */
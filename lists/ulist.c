@@ -0,0 +1,740 @@
+/**
+ * @file lists/ulist.c
+ * @brief unrolled (double) linked list
+ *
+ * An unrolled list has the same interface than a double linked list
+ * (see \ref lists/dlist.c) but each node (chunk) stores up to
+ * `ULIST_CHUNK_CAPACITY` data instead of a single one. This divides the
+ * number of allocations by as much and makes traversals mostly sequential
+ * in memory.
+ *
+ * As elements move from a chunk to an other on insertions and removals, a
+ * position (`UListPosition`) is only valid until the next modification of
+ * the list, except for the one given to `ulist_insert_before`,
+ * `ulist_insert_after` and `ulist_remove_link` which is kept up to date.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "ulist.h"
+#include "error.h"
+
+/* chunks which fall below this threshold are merged with their successor (if it fits) */
+#define ULIST_MERGE_THRESHOLD (ULIST_CHUNK_CAPACITY / 4)
+
+/* marks an iterator positioned before the head of the list (after the removal of its first element) */
+#define ULIST_BEFORE_HEAD ((size_t) -1)
+
+#define clone(list, data) \
+    (NULL == (list)->dup ? (data) : (list)->dup(data))
+
+static UListChunk *chunk_new(char **error)
+{
+    UListChunk *chunk;
+
+    if (NULL == (chunk = malloc(sizeof(*chunk)))) {
+        set_malloc_error(error, sizeof(*chunk));
+    } else {
+        chunk->used = 0;
+        chunk->prev = chunk->next = NULL;
+    }
+
+    return chunk;
+}
+
+/* link *chunk* after *sibling* (or at the head of the list if *sibling* is `NULL`) */
+static void chunk_link_after(UList *list, UListChunk *sibling, UListChunk *chunk)
+{
+    chunk->prev = sibling;
+    if (NULL == sibling) {
+        chunk->next = list->head;
+        list->head = chunk;
+    } else {
+        chunk->next = sibling->next;
+        sibling->next = chunk;
+    }
+    if (NULL == chunk->next) {
+        list->tail = chunk;
+    } else {
+        chunk->next->prev = chunk;
+    }
+}
+
+static void chunk_unlink(UList *list, UListChunk *chunk)
+{
+    if (NULL == chunk->prev) {
+        list->head = chunk->next;
+    } else {
+        chunk->prev->next = chunk->next;
+    }
+    if (NULL == chunk->next) {
+        list->tail = chunk->prev;
+    } else {
+        chunk->next->prev = chunk->prev;
+    }
+    free(chunk);
+}
+
+/**
+ * Inserts *data* in *chunk* at *offset* (0 <= *offset* <= chunk->used),
+ * the chunk is splitted in two halves if it is full.
+ */
+static bool ulist_insert_real(UList *list, UListChunk *chunk, size_t offset, void *data, UListPosition *inserted, char **error)
+{
+    assert(offset <= chunk->used);
+
+    if (ULIST_CHUNK_CAPACITY == chunk->used) {
+        UListChunk *new;
+        const size_t half = ULIST_CHUNK_CAPACITY / 2;
+
+        if (NULL == (new = chunk_new(error))) {
+            return false;
+        }
+        chunk_link_after(list, chunk, new);
+        new->used = chunk->used - half;
+        memcpy(new->data, chunk->data + half, new->used * sizeof(*chunk->data));
+        chunk->used = half;
+        if (offset > half) {
+            offset -= half;
+            chunk = new;
+        }
+    }
+    memmove(chunk->data + offset + 1, chunk->data + offset, (chunk->used - offset) * sizeof(*chunk->data));
+    chunk->data[offset] = clone(list, data);
+    ++chunk->used;
+    ++list->length;
+    inserted->chunk = chunk;
+    inserted->offset = offset;
+
+    return true;
+}
+
+/**
+ * Creates (heap allocated) an unrolled linked list
+ *
+ * @param dup
+ * @param dtor
+ * @param error
+ *
+ * @return the dynamic allocated unrolled linked list
+ */
+UList *ulist_new(DupFunc dup, DtorFunc dtor, char **error)
+{
+    UList *list;
+
+    if (NULL == (list = malloc(sizeof(*list)))) {
+        set_malloc_error(error, sizeof(*list));
+    } else {
+        ulist_init(list, dup, dtor);
+    }
+
+    return list;
+}
+
+/**
+ * Initializes a (stack allocated) unrolled linked list
+ *
+ * @param list the unrolled linked list
+ * @param dup
+ * @param dtor
+ */
+void ulist_init(UList *list, DupFunc dup, DtorFunc dtor)
+{
+    assert(NULL != list);
+
+    list->length = 0;
+    list->head = list->tail = NULL;
+    list->dup = dup;
+    list->dtor = dtor;
+}
+
+/**
+ * Get the length of the unrolled linked list *list*
+ * (maintained into the list, its elements are not traversed)
+ *
+ * @param list the list
+ *
+ * @return the number of elements in the list
+ */
+size_t ulist_length(UList *list)
+{
+    assert(NULL != list);
+
+    return list->length;
+}
+
+/**
+ * Is the unrolled linked list empty?
+ *
+ * @param list the unrolled linked list
+ *
+ * @return `true` if *list* is empty else `false`
+ */
+bool ulist_empty(UList *list)
+{
+    assert(NULL != list);
+
+    return NULL == list->head;
+}
+
+/**
+ * Destroy the elements of an unrolled linked list but not
+ * the list itself. Used to clear/empty it before reuse.
+ *
+ * If a destructor was set at the creation of the list,
+ * it will be invoked for each data.
+ *
+ * @param list the list to clear
+ */
+void ulist_clear(UList *list)
+{
+    UListChunk *tmp, *last;
+
+    assert(NULL != list);
+
+    tmp = list->head;
+    while (NULL != tmp) {
+        last = tmp;
+        tmp = tmp->next;
+        if (NULL != list->dtor) {
+            size_t i;
+
+            for (i = 0; i < last->used; i++) {
+                list->dtor(last->data[i]);
+            }
+        }
+        free(last);
+    }
+    list->length = 0;
+    list->head = list->tail = NULL;
+}
+
+/**
+ * Clear and free a dynamic allocated unrolled linked list
+ * (must only be used for a list created by `ulist_new`
+ * else use `ulist_clear` instead).
+ *
+ * @param list the list to destroy
+ */
+void ulist_destroy(UList *list)
+{
+    assert(NULL != list);
+
+    ulist_clear(list);
+    free(list);
+}
+
+/**
+ * Append *data* to *list*
+ *
+ * @param list the unrolled linked list
+ * @param data
+ * @param error
+ *
+ * @return `true` on success, `false` on error (memory allocation failure)
+ */
+bool ulist_append(UList *list, void *data, char **error)
+{
+    UListChunk *chunk;
+
+    assert(NULL != list);
+
+    if (NULL == list->tail || ULIST_CHUNK_CAPACITY == list->tail->used) {
+        // don't split the tail: consecutive appends fill chunks entirely
+        if (NULL == (chunk = chunk_new(error))) {
+            return false;
+        }
+        chunk_link_after(list, list->tail, chunk);
+    } else {
+        chunk = list->tail;
+    }
+    chunk->data[chunk->used++] = clone(list, data);
+    ++list->length;
+
+    return true;
+}
+
+/**
+ * Prepend *data* to *list*
+ *
+ * @param list the unrolled linked list
+ * @param data
+ * @param error
+ *
+ * @return `true` on success, `false` on error (memory allocation failure)
+ */
+bool ulist_prepend(UList *list, void *data, char **error)
+{
+    UListChunk *chunk;
+    UListPosition inserted;
+
+    assert(NULL != list);
+
+    if (NULL == list->head || ULIST_CHUNK_CAPACITY == list->head->used) {
+        if (NULL == (chunk = chunk_new(error))) {
+            return false;
+        }
+        chunk_link_after(list, NULL, chunk);
+    } else {
+        chunk = list->head;
+    }
+
+    return ulist_insert_real(list, chunk, 0, data, &inserted, error);
+}
+
+/**
+ * Inserts data before a specific element in the list
+ *
+ * @param list the unrolled linked list
+ * @param sibling the position of the element before which to insert *data*,
+ *   on success, it is updated to still designate the same element
+ * @param data the data to be added
+ * @param error
+ *
+ * @return `true` on success, `false` on error (memory allocation failure)
+ */
+bool ulist_insert_before(UList *list, UListPosition *sibling, void *data, char **error)
+{
+    UListPosition inserted;
+
+    assert(NULL != list);
+    assert(NULL != sibling);
+    assert(NULL != sibling->chunk);
+
+    if (!ulist_insert_real(list, sibling->chunk, sibling->offset, data, &inserted, error)) {
+        return false;
+    }
+    if (inserted.offset + 1 < inserted.chunk->used) {
+        sibling->chunk = inserted.chunk;
+        sibling->offset = inserted.offset + 1;
+    } else {
+        sibling->chunk = inserted.chunk->next;
+        sibling->offset = 0;
+    }
+
+    return true;
+}
+
+/**
+ * Inserts data after a specific element in the list
+ *
+ * @param list the unrolled linked list
+ * @param sibling the position of the element after which to insert *data*,
+ *   on success, it is updated to still designate the same element
+ * @param data the data to be added
+ * @param error
+ *
+ * @return `true` on success, `false` on error (memory allocation failure)
+ */
+bool ulist_insert_after(UList *list, UListPosition *sibling, void *data, char **error)
+{
+    UListPosition inserted;
+
+    assert(NULL != list);
+    assert(NULL != sibling);
+    assert(NULL != sibling->chunk);
+
+    if (!ulist_insert_real(list, sibling->chunk, sibling->offset + 1, data, &inserted, error)) {
+        return false;
+    }
+    if (inserted.offset > 0) {
+        sibling->chunk = inserted.chunk;
+        sibling->offset = inserted.offset - 1;
+    } else {
+        sibling->chunk = inserted.chunk->prev;
+        sibling->offset = sibling->chunk->used - 1;
+    }
+
+    return true;
+}
+
+/**
+ * Find the first element in a list to match according a callback
+ *
+ * @param list the unrolled linked list
+ * @param cmp a callback to compare datas (data from the current item to *data*)
+ *            returns 0 if both are equals
+ * @param data the data to be compared to
+ * @param position if not `NULL`, receives the position of the matching element
+ *
+ * @return `false` if there is no match
+ */
+bool ulist_find_first(UList *list, CmpFunc cmp, void *data, UListPosition *position)
+{
+    size_t i;
+    UListChunk *chunk;
+
+    assert(NULL != list);
+    assert(NULL != cmp);
+
+    for (chunk = list->head; NULL != chunk; chunk = chunk->next) {
+        for (i = 0; i < chunk->used; i++) {
+            if (0 == cmp(chunk->data[i], data)) {
+                if (NULL != position) {
+                    position->chunk = chunk;
+                    position->offset = i;
+                }
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Find the last element in a list to match according a callback
+ *
+ * @param list the unrolled linked list
+ * @param cmp a callback to compare datas (data from the current item to *data*)
+ *            returns 0 if both are equals
+ * @param data the data to be compared to
+ * @param position if not `NULL`, receives the position of the matching element
+ *
+ * @return `false` if there is no match
+ */
+bool ulist_find_last(UList *list, CmpFunc cmp, void *data, UListPosition *position)
+{
+    size_t i;
+    UListChunk *chunk;
+
+    assert(NULL != list);
+    assert(NULL != cmp);
+
+    for (chunk = list->tail; NULL != chunk; chunk = chunk->prev) {
+        for (i = chunk->used; i-- > 0; ) {
+            if (0 == cmp(chunk->data[i], data)) {
+                if (NULL != position) {
+                    position->chunk = chunk;
+                    position->offset = i;
+                }
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Removes an element from the list
+ *
+ * @param list the unrolled linked list
+ * @param position the position of the element to remove, it is
+ *   updated to designate the element which followed it (its chunk
+ *   is set to `NULL` if it was the last one)
+ *
+ * @note if a destructor has been set it will be called
+ *       to free/clean the removed item(s)
+ */
+void ulist_remove_link(UList *list, UListPosition *position)
+{
+    UListChunk *chunk;
+
+    assert(NULL != list);
+    assert(NULL != position);
+    assert(NULL != position->chunk);
+    assert(position->offset < position->chunk->used);
+
+    chunk = position->chunk;
+    if (NULL != list->dtor) {
+        list->dtor(chunk->data[position->offset]);
+    }
+    --chunk->used;
+    --list->length;
+    memmove(chunk->data + position->offset, chunk->data + position->offset + 1, (chunk->used - position->offset) * sizeof(*chunk->data));
+    if (0 == chunk->used) {
+        position->chunk = chunk->next;
+        position->offset = 0;
+        chunk_unlink(list, chunk);
+    } else {
+        UListChunk *next;
+
+        next = chunk->next;
+        if (chunk->used < ULIST_MERGE_THRESHOLD && NULL != next && chunk->used + next->used <= ULIST_CHUNK_CAPACITY) {
+            memcpy(chunk->data + chunk->used, next->data, next->used * sizeof(*next->data));
+            chunk->used += next->used;
+            chunk_unlink(list, next);
+        }
+        if (position->offset >= chunk->used) {
+            position->chunk = chunk->next;
+            position->offset = 0;
+        }
+    }
+}
+
+/**
+ * Removes data at the head of a list
+ *
+ * @param list the unrolled linked list
+ *
+ * @note if a destructor has been set it will be called
+ *       to free/clean the removed item(s)
+ */
+void ulist_remove_head(UList *list)
+{
+    assert(NULL != list);
+
+    if (NULL != list->head) {
+        UListPosition position = { list->head, 0 };
+
+        ulist_remove_link(list, &position);
+    }
+}
+
+/**
+ * Removes data at the tail of a list
+ *
+ * @param list the unrolled linked list
+ *
+ * @note if a destructor has been set it will be called
+ *       to free/clean the removed item(s)
+ */
+void ulist_remove_tail(UList *list)
+{
+    assert(NULL != list);
+
+    if (NULL != list->tail) {
+        UListPosition position = { list->tail, list->tail->used - 1 };
+
+        ulist_remove_link(list, &position);
+    }
+}
+
+/**
+ * Gets data at a given position into the list
+ *
+ * @param list the unrolled linked list
+ * @param n the position of the item in the list.
+ *          If negative, it is counted from the tail
+ *          of the list (-1 being the last element).
+ * @param data
+ *
+ * @return `false` if *n* is out of bounds else `true`
+ */
+bool ulist_at(UList *list, int n, void **data)
+{
+    size_t index;
+    UListChunk *chunk;
+
+    assert(NULL != list);
+    assert(NULL != data);
+
+    if (n < 0) {
+        if ((size_t) -n > list->length) {
+            return false;
+        }
+        index = (size_t) -n;
+        for (chunk = list->tail; index > chunk->used; chunk = chunk->prev) {
+            index -= chunk->used;
+        }
+        *data = chunk->data[chunk->used - index];
+    } else {
+        if ((size_t) n >= list->length) {
+            return false;
+        }
+        index = (size_t) n;
+        for (chunk = list->head; index >= chunk->used; chunk = chunk->next) {
+            index -= chunk->used;
+        }
+        *data = chunk->data[index];
+    }
+
+    return true;
+}
+
+#ifndef WITHOUT_ITERATOR
+static void ulist_iterator_first(const void *collection, void **state)
+{
+    UListPosition *p;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    p = (UListPosition *) *state;
+    p->chunk = ((const UList *) collection)->head;
+    p->offset = 0;
+}
+
+static void ulist_iterator_last(const void *collection, void **state)
+{
+    UListPosition *p;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    p = (UListPosition *) *state;
+    p->chunk = ((const UList *) collection)->tail;
+    p->offset = NULL == p->chunk ? 0 : p->chunk->used - 1;
+}
+
+static bool ulist_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    return NULL != ((UListPosition *) *state)->chunk;
+}
+
+static void ulist_iterator_current(const void *UNUSED(collection), void **state, void **UNUSED(key), void **value)
+{
+    UListPosition *p;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    p = (UListPosition *) *state;
+    if (NULL != value) {
+        *value = p->chunk->data[p->offset];
+    }
+}
+
+static void ulist_iterator_next(const void *collection, void **state)
+{
+    UListPosition *p;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    p = (UListPosition *) *state;
+    if (NULL == p->chunk) {
+        if (ULIST_BEFORE_HEAD == p->offset) {
+            p->chunk = ((const UList *) collection)->head;
+            p->offset = 0;
+        }
+    } else if (++p->offset >= p->chunk->used) {
+        p->chunk = p->chunk->next;
+        p->offset = 0;
+    }
+}
+
+static void ulist_iterator_previous(const void *UNUSED(collection), void **state)
+{
+    UListPosition *p;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    p = (UListPosition *) *state;
+    if (p->offset > 0) {
+        --p->offset;
+    } else {
+        p->chunk = p->chunk->prev;
+        p->offset = NULL == p->chunk ? 0 : p->chunk->used - 1;
+    }
+}
+
+static void ulist_iterator_delete(const void *collection, void **state)
+{
+    UList *list;
+    UListPosition *p;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    list = (UList *) collection;
+    p = (UListPosition *) *state;
+    ulist_remove_link(list, p);
+    // step back on the previous element for the next call to iterator_next
+    if (NULL == p->chunk) {
+        p->chunk = list->tail;
+        p->offset = NULL == p->chunk ? ULIST_BEFORE_HEAD : p->chunk->used;
+    }
+    if (0 == p->offset) {
+        p->chunk = p->chunk->prev;
+        p->offset = NULL == p->chunk ? ULIST_BEFORE_HEAD : p->chunk->used - 1;
+    } else if (ULIST_BEFORE_HEAD != p->offset) {
+        --p->offset;
+    }
+}
+
+static size_t ulist_iterator_next_batch(const void *collection, void **state, void **UNUSED(keys), void **values, size_t n)
+{
+    size_t count, done;
+    UListPosition *p;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    p = (UListPosition *) *state;
+    if (NULL == p->chunk && ULIST_BEFORE_HEAD == p->offset) {
+        p->chunk = ((const UList *) collection)->head;
+        p->offset = 0;
+    }
+    // copy a whole chunk (or what remains of it) at once
+    for (done = 0; done < n && NULL != p->chunk; done += count) {
+        count = MIN(n - done, p->chunk->used - p->offset);
+        if (NULL != values) {
+            memcpy(values + done, p->chunk->data + p->offset, count * sizeof(*values));
+        }
+        if ((p->offset += count) >= p->chunk->used) {
+            p->chunk = p->chunk->next;
+            p->offset = 0;
+        }
+    }
+
+    return done;
+}
+
+/**
+ * Initialize an *Iterator* to loop, in both directions, on the elements
+ * of an unrolled linked list.
+ *
+ * @param it the iterator to initialize
+ * @param list the unrolled linked list to traverse
+ *
+ * @note iterator directions: forward and backward
+ * @note there is no key
+ **/
+void ulist_to_iterator(Iterator *it, UList *list)
+{
+    UListPosition *p;
+
+    assert(NULL != it);
+    assert(NULL != list);
+
+    p = malloc(sizeof(*p));
+    p->chunk = list->head;
+    p->offset = 0;
+
+    iterator_init(
+        it, list, p,
+        ulist_iterator_first, ulist_iterator_last,
+        ulist_iterator_current,
+        ulist_iterator_next, ulist_iterator_previous,
+        ulist_iterator_is_valid,
+        free,
+        (iterator_count_t) ulist_length, NULL, ulist_iterator_delete
+    );
+    iterator_set_next_batch(it, ulist_iterator_next_batch);
+}
+
+static void ulist_collectable_into(void *collection, void *UNUSED(key), void *value)
+{
+    assert(NULL != collection);
+
+    ulist_append(((UList *) collection), value, NULL);
+}
+
+/**
+ * Initialize a *Collectable* to append, through `iterator_into`, the
+ * values of an iterator at the end of an unrolled linked list.
+ *
+ * @param collectable the collectable to initialize
+ * @param list the unrolled linked list to fill
+ **/
+void ulist_to_collectable(Collectable *collectable, UList *list)
+{
+    assert(NULL != collectable);
+    assert(NULL != list);
+
+    collectable_init(collectable, list, ulist_collectable_into);
+}
+#endif /* !WITHOUT_ITERATOR */
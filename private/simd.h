@@ -0,0 +1,45 @@
+#pragma once
+
+#include "attributes.h"
+
+/**
+ * SIMD helpers: functions are compiled for a given instruction set with
+ * the target attribute then selected at runtime, so the library doesn't
+ * need any -m flag and still runs on any x86 CPU.
+ *
+ * \code
+ *   #ifdef HAVE_X86_SIMD
+ *   static TARGET("avx2") size_t foo_avx2(...) { ... }
+ *   #endif
+ *
+ *   size_t foo(...) {
+ *   #ifdef HAVE_X86_SIMD
+ *       if (CPU_HAS_AVX2()) {
+ *           return foo_avx2(...);
+ *       }
+ *   #endif
+ *       // scalar fallback
+ *   }
+ * \endcode
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && (GCC_VERSION >= 4009 || (defined(__clang__) && __has_builtin(__builtin_cpu_supports)))
+# define HAVE_X86_SIMD 1
+# include <immintrin.h>
+# define TARGET(isa) __attribute__((target(isa)))
+# ifdef __SSE2__
+#  define CPU_HAS_SSE2() 1
+# else
+#  define CPU_HAS_SSE2() __builtin_cpu_supports("sse2")
+# endif /* __SSE2__ */
+# ifdef __SSSE3__
+#  define CPU_HAS_SSSE3() 1
+# else
+#  define CPU_HAS_SSSE3() __builtin_cpu_supports("ssse3")
+# endif /* __SSSE3__ */
+# ifdef __AVX2__
+#  define CPU_HAS_AVX2() 1
+# else
+#  define CPU_HAS_AVX2() __builtin_cpu_supports("avx2")
+# endif /* __AVX2__ */
+#endif /* x86 */
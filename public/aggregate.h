@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    AGGREGATE_EQ, // value == x
+    AGGREGATE_NE, // value != x
+    AGGREGATE_LT, // value < x
+    AGGREGATE_LE, // value <= x
+    AGGREGATE_GT, // value > x
+    AGGREGATE_GE, // value >= x
+} AggregateCmp;
+
+#define aggregate(type, sum_type) \
+    sum_type array_sum_## type(const type *, size_t); \
+    bool array_min_## type(const type *, size_t, type *); \
+    bool array_max_## type(const type *, size_t, type *); \
+    size_t array_count_if_## type(const type *, size_t, AggregateCmp, type)
+
+aggregate(int32_t, int64_t);
+aggregate(int64_t, int64_t);
+aggregate(uint64_t, uint64_t);
+aggregate(double, double);
+
+#undef aggregate
+
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+# define aggregate(type, sum_type) \
+    sum_type iterator_sum_## type(Iterator *); \
+    bool iterator_min_## type(Iterator *, type *); \
+    bool iterator_max_## type(Iterator *, type *); \
+    size_t iterator_count_if_## type(Iterator *, AggregateCmp, type)
+
+aggregate(int32_t, int64_t);
+aggregate(int64_t, int64_t);
+aggregate(uint64_t, uint64_t);
+aggregate(double, double);
+
+# undef aggregate
+#endif /* !WITHOUT_ITERATOR */
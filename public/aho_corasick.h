@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "darray.h"
+
+typedef struct {
+    bool case_insensitive;
+    bool compiled;
+    DArray patterns;
+    DArray bytes;
+    uint16_t classes[256];
+    size_t classes_count;
+    size_t states_count;
+    uint32_t *transitions;
+    uint32_t *outputs;
+    uint32_t *matches;
+    uint32_t *output_links;
+    uint32_t *next_same;
+} AhoCorasick;
+
+typedef struct {
+    const AhoCorasick *ac;
+    uint32_t state;
+    size_t offset;
+} AhoCorasickStream;
+
+typedef bool (*AhoCorasickMatchFunc)(size_t, size_t, size_t, void *);
+
+void aho_corasick_init(AhoCorasick *, bool);
+void aho_corasick_destroy(AhoCorasick *);
+bool aho_corasick_add(AhoCorasick *, const char *, size_t, size_t, char **);
+bool aho_corasick_compile(AhoCorasick *, char **);
+size_t aho_corasick_patterns_count(const AhoCorasick *);
+
+bool aho_corasick_scan(const AhoCorasick *, const char *, size_t, AhoCorasickMatchFunc, void *);
+bool aho_corasick_contains(const AhoCorasick *, const char *, size_t);
+
+void aho_corasick_stream_init(AhoCorasickStream *, const AhoCorasick *);
+bool aho_corasick_stream_feed(AhoCorasickStream *, const char *, size_t, AhoCorasickMatchFunc, void *);
+void aho_corasick_stream_reset(AhoCorasickStream *);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdbool.h>
 
 bool ascii_isupper(int c);
@@ -12,3 +13,6 @@ int ascii_strcasecmp_l(const char *str1, size_t str1_len, const char *str2, size
 int ascii_strncasecmp(const char *str1, const char *str2, size_t n);
 int ascii_strncasecmp_l(const char *str1, size_t str1_len, const char *str2, size_t str2_len, size_t n);
 char *ascii_memcasechr(const char *str, int c, size_t n);
+char *ascii_memcasestr(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len);
+char *ascii_str_tolower(char *str, size_t str_len);
+char *ascii_str_toupper(char *str, size_t str_len);
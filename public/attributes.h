@@ -76,6 +76,18 @@
 # define PRINTF(string_index, first_to_check)
 #endif /* FORMAT,PRINTF */
 
+#if GCC_VERSION || __has_attribute(aligned)
+# define ALIGNED(n) __attribute__((aligned(n)))
+#else
+# define ALIGNED(n)
+#endif /* ALIGNED */
+
+#if GCC_VERSION >= 4008 || __has_attribute(no_sanitize_address)
+# define NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+# define NO_SANITIZE_ADDRESS
+#endif /* NO_SANITIZE_ADDRESS */
+
 #if __has_builtin(__builtin_expect)
 # define EXPECTED(condition)   __builtin_expect(!!(condition), 1)
 # define UNEXPECTED(condition) __builtin_expect(!!(condition), 0)
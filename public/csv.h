@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "darray.h"
+#include "parsenum.h"
+
+typedef enum {
+    CSV_INT64,
+    CSV_UINT64,
+    CSV_DOUBLE,
+    CSV_SPAN,
+    CSV_SKIP,
+} CsvColumnType;
+
+typedef struct {
+    CsvColumnType type;
+    DArray values;
+} CsvColumn;
+
+typedef struct {
+    size_t row;
+    size_t column;
+    size_t offset;
+    ParseNumError error;
+} CsvCellError;
+
+typedef struct {
+    char delimiter;
+    bool header;
+    size_t rows;
+    size_t columns_count;
+    CsvColumn *columns;
+    DArray errors;
+} CsvBatch;
+
+#define csv_batch_column(/*CsvBatch **/ batch, /*size_t*/ column) \
+    (&(batch)->columns[(column)].values)
+
+bool csv_batch_init(CsvBatch *, char, bool, const CsvColumnType *, size_t, char **);
+void csv_batch_destroy(CsvBatch *);
+bool csv_batch_parse(CsvBatch *, const char *, size_t);
+bool csv_batch_parse_parallel(CsvBatch *, const char *, size_t, size_t);
@@ -5,6 +5,7 @@
 #include <stdint.h> /* uint\d+_t */
 
 #include "defs.h"
+#include "aggregate.h"
 
 typedef struct {
     uint8_t *data;
@@ -34,6 +35,19 @@ typedef struct {
 #define darray_top_unsafe(/*DArray **/ da, T) \
     darray_at_unsafe(da, (da)->length - 1, T)
 
+/* T: int32_t, int64_t, uint64_t or double (see aggregate.h) */
+#define darray_sum(/*DArray **/ da, T) \
+    array_sum_## T((const T *) (void *) (da)->data, (da)->length)
+
+#define darray_min(/*DArray **/ da, T, /*T **/ min) \
+    array_min_## T((const T *) (void *) (da)->data, (da)->length, (min))
+
+#define darray_max(/*DArray **/ da, T, /*T **/ max) \
+    array_max_## T((const T *) (void *) (da)->data, (da)->length, (max))
+
+#define darray_count_if(/*DArray **/ da, T, /*AggregateCmp*/ op, /*T*/ x) \
+    array_count_if_## T((const T *) (void *) (da)->data, (da)->length, (op), (x))
+
 void darray_append_all(DArray *, const void * const, size_t);
 bool darray_at(DArray *, unsigned int, void *);
 void darray_clear(DArray *);
@@ -55,4 +69,5 @@ void darray_sort(DArray *, CmpFuncArg, void *);
 # include "iterator.h"
 
 void darray_to_iterator(Iterator *, DArray *);
+void darray_to_collectable(Collectable *, DArray *);
 #endif /* !WITHOUT_ITERATOR */
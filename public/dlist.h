@@ -42,6 +42,10 @@ void dlist_remove_tail(DList *);
 bool dlist_at(DList *, int, void **);
 void dlist_sort(DList *, CmpFunc);
 
+void dlist_concat(DList *, DList *);
+void dlist_cut_after(DList *, DListElement *, DList *, size_t);
+void dlist_splice(DList *, DListElement *, DList *, DListElement *, DListElement *, size_t);
+
 // LIFO operations
 bool dlist_top(DList *, void **);
 bool dlist_pop(DList *, void **);
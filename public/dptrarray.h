@@ -39,4 +39,5 @@ void *dptrarray_to_array(DPtrArray *, bool, bool);
 # include "iterator.h"
 
 void dptrarray_to_iterator(Iterator *, DPtrArray *);
+void dptrarray_to_collectable(Collectable *, DPtrArray *);
 #endif /* !WITHOUT_ITERATOR */
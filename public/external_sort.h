@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "defs.h"
+#include "darray.h"
+
+typedef struct {
+    CmpFunc cmp;
+    size_t element_size;
+    size_t budget;
+    uint8_t *buffer;
+    size_t length;
+    size_t capacity;
+    size_t fanin;
+    DArray runs;
+    size_t count;
+    bool io_error;
+} ExternalSort;
+
+bool external_sort_init(ExternalSort *, size_t, size_t, CmpFunc, char **);
+void external_sort_destroy(ExternalSort *);
+bool external_sort_push(ExternalSort *, const void *, char **);
+bool external_sort_push_all(ExternalSort *, const void *, size_t, char **);
+size_t external_sort_count(ExternalSort *);
+bool external_sort_io_error(ExternalSort *);
+
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+bool external_sort_to_iterator(Iterator *, ExternalSort *, char **);
+#endif /* !WITHOUT_ITERATOR */
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+#define format_integer(type) \
+    char *stpfrom## type(char *, type, const char * const)
+
+format_integer(int8_t);
+format_integer(int16_t);
+format_integer(int32_t);
+format_integer(int64_t);
+format_integer(uint8_t);
+format_integer(uint16_t);
+format_integer(uint32_t);
+format_integer(uint64_t);
+
+#undef format_integer
+
+char *stpfromdouble(char *, double, const char * const);
+char *stpfromfloat(char *, float, const char * const);
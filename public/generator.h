@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+
+typedef struct {
+    int resume;
+    bool done;
+    void *key;
+    void *value;
+} Generator;
+
+typedef void (*GeneratorFunc)(Generator *, void *);
+
+/* value of Generator.resume when the generator is (re)started */
+#define GENERATOR_START 0
+/* value of Generator.resume once the generator has returned */
+#define GENERATOR_FINISHED -1
+
+#define GENERATOR_BEGIN(/*Generator **/ g) \
+    switch ((g)->resume) { \
+        case GENERATOR_START:
+
+#define GENERATOR_YIELD(/*Generator **/ g, /*void **/ k, /*void **/ v) \
+    do { \
+        (g)->resume = __LINE__; \
+        (g)->key = (k); \
+        (g)->value = (v); \
+        return; \
+        case __LINE__: \
+            ; \
+    } while (0)
+
+#define GENERATOR_RETURN(/*Generator **/ g) \
+    do { \
+        (g)->resume = GENERATOR_FINISHED; \
+        (g)->done = true; \
+        return; \
+    } while (0)
+
+#define GENERATOR_END(/*Generator **/ g) \
+        default: \
+            break; \
+    } \
+    (g)->resume = GENERATOR_FINISHED; \
+    (g)->done = true
+
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+void generator_to_iterator(Iterator *, GeneratorFunc, void *);
+#endif /* !WITHOUT_ITERATOR */
@@ -119,4 +119,5 @@ HashTable *hashtable_union(HashTable *, HashTable *, HashTable *, DupFunc, DupFu
 # include "iterator.h"
 
 void hashtable_to_iterator(Iterator *, HashTable *);
+void hashtable_to_collectable(Collectable *, HashTable *);
 #endif /* !WITHOUT_ITERATOR */
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "defs.h"
+#include "utils.h" /* container_of */
+
+typedef struct DListLink
+{
+    struct DListLink *next;
+    struct DListLink *prev;
+} DListLink;
+
+typedef struct
+{
+    size_t length;
+    DListLink *head;
+    DListLink *tail;
+} IDList;
+
+typedef int (*DListLinkCmpFunc)(const DListLink *, const void *);
+
+#define idlist_entry(link, type, member) \
+    container_of(link, type, member)
+
+#define idlist_foreach(list, link) \
+    for ((link) = (list)->head; NULL != (link); (link) = (link)->next)
+
+#define idlist_foreach_reverse(list, link) \
+    for ((link) = (list)->tail; NULL != (link); (link) = (link)->prev)
+
+void idlist_init(IDList *);
+
+void idlist_append(IDList *, DListLink *);
+bool idlist_empty(IDList *);
+DListLink *idlist_find_first(IDList *, DListLinkCmpFunc, const void *);
+DListLink *idlist_find_last(IDList *, DListLinkCmpFunc, const void *);
+void idlist_insert_after(IDList *, DListLink *, DListLink *);
+void idlist_insert_before(IDList *, DListLink *, DListLink *);
+size_t idlist_length(IDList *);
+void idlist_move_to_head(IDList *, DListLink *);
+void idlist_move_to_tail(IDList *, DListLink *);
+DListLink *idlist_pop_head(IDList *);
+DListLink *idlist_pop_tail(IDList *);
+void idlist_prepend(IDList *, DListLink *);
+void idlist_remove_link(IDList *, DListLink *);
+
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+void idlist_to_iterator(Iterator *, IDList *);
+#endif /* !WITHOUT_ITERATOR */
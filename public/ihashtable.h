@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "hashtable.h" /* ht_hash_t, HashFunc */
+#include "utils.h" /* container_of */
+
+typedef struct HashLink {
+    struct HashLink *next;
+    struct HashLink **pprev; /* address of the pointer on us (bucket or previous link) */
+    ht_hash_t hash;
+} HashLink;
+
+/* tells if the object which embeds the link has the given key */
+typedef bool (*HashLinkEqualFunc)(ht_key_t, const HashLink *);
+
+typedef struct {
+    HashLink **buckets;
+    HashFunc hf;
+    HashLinkEqualFunc ef;
+    size_t capacity;
+    size_t count;
+    ht_hash_t mask;
+} IHashTable;
+
+#define ihashtable_entry(link, type, member) \
+    container_of(link, type, member)
+
+bool ihashtable_init(IHashTable *, size_t, HashFunc, HashLinkEqualFunc, char **);
+void ihashtable_destroy(IHashTable *);
+void ihashtable_clear(IHashTable *);
+size_t ihashtable_size(IHashTable *);
+
+HashLink *_ihashtable_get(IHashTable *, ht_key_t);
+HashLink *_ihashtable_quick_get(IHashTable *, ht_hash_t, ht_key_t);
+HashLink *_ihashtable_put(IHashTable *, ht_key_t, HashLink *);
+HashLink *_ihashtable_quick_put(IHashTable *, ht_hash_t, ht_key_t, HashLink *);
+void ihashtable_remove(IHashTable *, HashLink *);
+
+#define ihashtable_get(ht, k) \
+    _ihashtable_get(ht, (ht_key_t) k)
+
+#define ihashtable_quick_get(ht, h, k) \
+    _ihashtable_quick_get(ht, h, (ht_key_t) k)
+
+#define ihashtable_put(ht, k, l) \
+    _ihashtable_put(ht, (ht_key_t) k, l)
+
+#define ihashtable_quick_put(ht, h, k, l) \
+    _ihashtable_quick_put(ht, h, (ht_key_t) k, l)
+
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+void ihashtable_to_iterator(Iterator *, IHashTable *);
+#endif /* !WITHOUT_ITERATOR */
@@ -3,6 +3,8 @@
 #include <stdbool.h>
 #include "defs.h"
 
+typedef struct _Iterator Iterator;
+
 typedef void (*iterator_first_t)(const void *, void **);
 typedef void (*iterator_last_t)(const void *, void **);
 typedef void (*iterator_current_t)(const void *, void **, void **, void **);
@@ -15,7 +17,9 @@ typedef size_t (*iterator_count_t)(const void *);
 typedef bool (*iterator_member_t)(const void *, void *);
 typedef void (*iterator_delete_current_t)(const void *, void **);
 
-typedef struct _Iterator Iterator;
+typedef size_t (*iterator_next_batch_t)(const void *, void **, void **, void **, size_t);
+typedef size_t (*iterator_next_span_t)(const void *, void **, const void **, size_t *);
+typedef void (*iterator_split_t)(const void *, void **, size_t, size_t, Iterator *);
 
 struct _Iterator {
     void *state;
@@ -30,6 +34,9 @@ struct _Iterator {
     iterator_count_t count;
     iterator_member_t member;
     iterator_delete_current_t delete;
+    iterator_next_batch_t next_batch;
+    iterator_next_span_t next_span;
+    iterator_split_t split;
 };
 
 /* <TEST> */
@@ -37,13 +44,22 @@ typedef struct _Collectable Collectable;
 
 typedef void (*collectable_into_t)(void *, void *, void *); // TODO: return bool + char **error ?
 // typedef void (*collectable_close_t)(void *);
+typedef void (*collectable_reserve_t)(void *, size_t);
+typedef void (*collectable_into_batch_t)(void *, void **, void **, size_t);
+typedef void (*collectable_into_span_t)(void *, const void *, size_t, size_t);
 
 struct _Collectable {
     void *collection;
     collectable_into_t into;
+    collectable_reserve_t reserve;
+    collectable_into_batch_t into_batch;
+    collectable_into_span_t into_span;
 };
 
 void collectable_init(Collectable *, void *, collectable_into_t);
+void collectable_set_reserve(Collectable *, collectable_reserve_t);
+void collectable_set_into_batch(Collectable *, collectable_into_batch_t);
+void collectable_set_into_span(Collectable *, collectable_into_span_t);
 bool iterator_into(Iterator *, Collectable *);
 /* </TEST> */
 
@@ -72,7 +88,17 @@ void iterator_previous(Iterator *);
 bool _iterator_is_valid(Iterator *, void **, void **);
 void iterator_close(Iterator *);
 
+void iterator_set_next_batch(Iterator *, iterator_next_batch_t);
+void iterator_set_next_span(Iterator *, iterator_next_span_t);
+size_t iterator_next_batch(Iterator *, void **, void **, size_t);
+size_t iterator_next_span(Iterator *, const void **, size_t *);
+
+void iterator_set_split(Iterator *, iterator_split_t);
+bool iterator_split(Iterator *, size_t, size_t, Iterator *);
+void iterator_split_range(size_t, size_t, size_t, size_t *, size_t *);
+
 void array_to_iterator(Iterator *, void *, size_t, size_t);
+void ptr_array_to_iterator(Iterator *, void **, size_t);
 void null_terminated_ptr_array_to_iterator(Iterator *, void **);
 void null_sentineled_field_terminated_array_to_iterator(Iterator *, void *, size_t, size_t);
 
@@ -80,13 +106,29 @@ bool iterator_empty(Iterator *);
 size_t iterator_count(Iterator *);
 
 typedef bool (*FilterFunc)(const void *, const void *);
+typedef void (*ApplyFunc)(void *, const void *);
+typedef bool (*ReduceFunc)(void *, void *, char **);
+typedef void (*CombineFunc)(void *, const void *);
 
 bool iterator_any(Iterator *, FilterFunc, const void *);
 bool iterator_all(Iterator *, FilterFunc, const void *);
 bool iterator_at(Iterator *, int, void **);
 bool iterator_max(Iterator *, CmpFunc, void **);
-bool iterator_reduce(Iterator *, void *, bool (*)(void *, void *, char **), char **);
+bool iterator_reduce(Iterator *, void *, ReduceFunc, char **);
+bool iterator_par_reduce(Iterator *, void *, size_t, ReduceFunc, CombineFunc, size_t, char **);
+void iterator_par_each(Iterator *, ApplyFunc, const void *, size_t);
 int64_t iterator_sum(Iterator *);
 int64_t iterator_product(Iterator *);
 void iterator_filter(Iterator *, FilterFunc, const void *);
 void iterator_reject(Iterator *, FilterFunc, const void *);
+
+typedef void *(*MapFunc)(void *, void *);
+typedef void *(*MergeFunc)(void *, void *, void *);
+
+void iterator_map(Iterator *, Iterator *, MapFunc, void *);
+void iterator_filter_lazy(Iterator *, Iterator *, FilterFunc, const void *);
+void iterator_take(Iterator *, Iterator *, size_t);
+void iterator_skip(Iterator *, Iterator *, size_t);
+void iterator_chain(Iterator *, Iterator *, Iterator *);
+void iterator_zip(Iterator *, Iterator *, Iterator *);
+void iterator_merge(Iterator *, Iterator **, size_t, CmpFunc, MergeFunc, void *);
@@ -3,3 +3,5 @@
 #include <stddef.h>
 
 int memcmp_l(const char *, size_t, const char *, size_t);
+int memcmp_l_prefix(const char *, size_t, const char *, size_t, size_t *);
+size_t memcmp_prefix(const char *, const char *, size_t);
@@ -1,3 +1,24 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef struct {
+    size_t critical;
+    size_t period;
+    bool periodic;
+} MemStrFactorization;
+
+typedef struct {
+    const char *needle;
+    size_t needle_len;
+    MemStrFactorization forward;
+    MemStrFactorization backward;
+} MemStrNeedle;
+
 char *memstr(const char *, const char *, size_t, const char * const);
+char *memrstr(const char *, const char *, size_t, const char * const);
+
+void memstr_compile(MemStrNeedle *, const char *, size_t);
+char *memstr_compiled(const MemStrNeedle *, const char *, const char * const);
+char *memrstr_compiled(const MemStrNeedle *, const char *, const char * const);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "attributes.h"
+#include "utils.h" /* CACHE_LINE_SIZE */
+
+typedef struct {
+    atomic_size_t sequence;
+    void *data;
+} MPMCCell;
+
+typedef struct {
+    MPMCCell *buffer;
+    size_t mask;
+    /* producers and consumers each have their own cache line */
+    atomic_size_t enqueue_pos ALIGNED(CACHE_LINE_SIZE);
+    atomic_size_t dequeue_pos ALIGNED(CACHE_LINE_SIZE);
+} MPMCQueue;
+
+bool mpmc_queue_init(MPMCQueue *, size_t, char **);
+void mpmc_queue_destroy(MPMCQueue *);
+size_t mpmc_queue_capacity(MPMCQueue *);
+size_t mpmc_queue_length(MPMCQueue *);
+
+bool mpmc_queue_enqueue(MPMCQueue *, void *);
+size_t mpmc_queue_enqueue_batch(MPMCQueue *, void * const *, size_t);
+bool mpmc_queue_dequeue(MPMCQueue *, void **);
+size_t mpmc_queue_dequeue_batch(MPMCQueue *, void **, size_t);
+
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+void mpmc_queue_to_iterator(Iterator *, MPMCQueue *);
+#endif /* !WITHOUT_ITERATOR */
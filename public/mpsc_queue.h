@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "attributes.h"
+#include "utils.h" /* CACHE_LINE_SIZE */
+
+typedef struct MPSCNode {
+    struct MPSCNode * _Atomic next;
+    void *data;
+} MPSCNode;
+
+typedef struct {
+    /* where producers push (the last node) */
+    MPSCNode * _Atomic head ALIGNED(CACHE_LINE_SIZE);
+    /* where the consumer pops (a dummy node, the first value is in its successor) */
+    MPSCNode *tail ALIGNED(CACHE_LINE_SIZE);
+} MPSCQueue;
+
+bool mpsc_queue_init(MPSCQueue *, char **);
+void mpsc_queue_destroy(MPSCQueue *);
+size_t mpsc_queue_length(MPSCQueue *);
+
+bool mpsc_queue_enqueue(MPSCQueue *, void *, char **);
+bool mpsc_queue_enqueue_batch(MPSCQueue *, void * const *, size_t, char **);
+bool mpsc_queue_dequeue(MPSCQueue *, void **);
+size_t mpsc_queue_dequeue_batch(MPSCQueue *, void **, size_t);
+
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+void mpsc_queue_to_iterator(Iterator *, MPSCQueue *);
+#endif /* !WITHOUT_ITERATOR */
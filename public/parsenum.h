@@ -35,3 +35,12 @@ parse_unsigned(uint32_t, UINT32_MAX);
 parse_unsigned(uint64_t, UINT64_MAX);
 
 #undef parse_unsigned
+
+#define parse_float(type) \
+    ParseNumError strto## type(const char *, char **, type *, type *, type *); \
+    ParseNumError strnto## type(const char *, const char * const, char **, type *, type *, type *)
+
+parse_float(double);
+parse_float(float);
+
+#undef parse_float
@@ -1,5 +1,40 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
+#include "memstr.h"
+
+typedef struct {
+    const char *ptr;
+    size_t len;
+} StrSpan;
+
+typedef enum {
+    STR_TOKENIZER_CHAR,
+    STR_TOKENIZER_SET,
+    STR_TOKENIZER_STRING,
+} StrTokenizerKind;
+
+typedef struct {
+    const char *position;
+    const char *end;
+    bool no_empty;
+    bool done;
+    StrTokenizerKind kind;
+    char separator;
+    const char *set;
+    size_t set_len;
+    uint8_t set_bitmap[256 / 8];
+    MemStrNeedle needle;
+} StrTokenizer;
+
 size_t str_split(char, char *, char ***, bool);
+
+void str_tokenizer_init_char(StrTokenizer *, const char *, size_t, char, bool);
+void str_tokenizer_init_set(StrTokenizer *, const char *, size_t, const char *, size_t, bool);
+void str_tokenizer_init_string(StrTokenizer *, const char *, size_t, const char *, size_t, bool);
+bool str_tokenizer_next(StrTokenizer *, StrSpan *);
+size_t str_tokenizer_split(StrTokenizer *, StrSpan *, size_t);
+const char *str_tokenizer_rest(const StrTokenizer *, size_t *);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdbool.h>
+
+#include "attributes.h"
+#include "str_split.h"
+
+#ifndef STRBUF_INLINE_SIZE
+# define STRBUF_INLINE_SIZE 64
+#endif /* !STRBUF_INLINE_SIZE */
+
+typedef struct {
+    char *ptr;
+    size_t length;
+    size_t allocated;
+    char inline_buffer[STRBUF_INLINE_SIZE];
+} StrBuf;
+
+/* the current trailing \0, where _sp functions have to start writing */
+#define strbuf_end(/*StrBuf **/ sb) \
+    ((sb)->ptr + (sb)->length)
+
+/* the to_limit/buffer_end argument of _sp functions */
+#define strbuf_limit(/*StrBuf **/ sb) \
+    ((const char *) (sb)->ptr + (sb)->allocated)
+
+void strbuf_init(StrBuf *);
+void strbuf_destroy(StrBuf *);
+void strbuf_clear(StrBuf *);
+void strbuf_shrink(StrBuf *);
+bool strbuf_reserve(StrBuf *, size_t, char **);
+void strbuf_set_end(StrBuf *, const char *);
+char *strbuf_steal(StrBuf *, size_t *, char **);
+
+bool strbuf_append_char(StrBuf *, char, char **);
+bool strbuf_append_string(StrBuf *, const char *, char **);
+bool strbuf_append_string_len(StrBuf *, const char *, size_t, char **);
+bool strbuf_append_span(StrBuf *, const StrSpan *, char **);
+bool strbuf_insert_string_len(StrBuf *, size_t, const char *, size_t, char **);
+bool strbuf_concat(StrBuf *, char **, ...) SENTINEL;
+bool strbuf_append_printf(StrBuf *, char **, const char *, ...) PRINTF(3, 4);
+bool strbuf_append_vprintf(StrBuf *, char **, const char *, va_list);
+
+#define strbuf_append_number(type) \
+    bool strbuf_append_## type(StrBuf *, type, char **)
+
+strbuf_append_number(int8_t);
+strbuf_append_number(int16_t);
+strbuf_append_number(int32_t);
+strbuf_append_number(int64_t);
+strbuf_append_number(uint8_t);
+strbuf_append_number(uint16_t);
+strbuf_append_number(uint32_t);
+strbuf_append_number(uint64_t);
+strbuf_append_number(double);
+strbuf_append_number(float);
+
+#undef strbuf_append_number
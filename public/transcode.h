@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h> /* size_t */
+#include <stdint.h>
+
+#include "unicode.h"
+
+size_t utf8_to_utf16_length(const char *, size_t);
+size_t utf8_to_utf32_length(const char *, size_t);
+size_t utf8_to_latin1_length(const char *, size_t);
+size_t utf16le_to_utf8_length(const uint16_t *, size_t);
+size_t utf16be_to_utf8_length(const uint16_t *, size_t);
+size_t utf32_to_utf8_length(const uint32_t *, size_t);
+size_t latin1_to_utf8_length(const char *, size_t);
+
+UnicodeError utf8_to_utf16le(const char *, size_t, uint16_t *, size_t, size_t *, size_t *);
+UnicodeError utf8_to_utf16be(const char *, size_t, uint16_t *, size_t, size_t *, size_t *);
+UnicodeError utf8_to_utf32(const char *, size_t, uint32_t *, size_t, size_t *, size_t *);
+UnicodeError utf8_to_latin1(const char *, size_t, char *, size_t, size_t *, size_t *);
+UnicodeError utf16le_to_utf8(const uint16_t *, size_t, char *, size_t, size_t *, size_t *);
+UnicodeError utf16be_to_utf8(const uint16_t *, size_t, char *, size_t, size_t *, size_t *);
+UnicodeError utf32_to_utf8(const uint32_t *, size_t, char *, size_t, size_t *, size_t *);
+UnicodeError latin1_to_utf8(const char *, size_t, char *, size_t, size_t *, size_t *);
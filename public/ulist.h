@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "defs.h"
+
+#ifndef ULIST_CHUNK_CAPACITY
+/* 29 pointers + prev/next/used = 256 bytes on LP64 (4 cache lines) */
+# define ULIST_CHUNK_CAPACITY 29
+#endif /* !ULIST_CHUNK_CAPACITY */
+
+typedef struct UListChunk
+{
+    struct UListChunk *next;
+    struct UListChunk *prev;
+    size_t used;
+    void *data[ULIST_CHUNK_CAPACITY];
+} UListChunk;
+
+typedef struct
+{
+    UListChunk *chunk;
+    size_t offset;
+} UListPosition;
+
+typedef struct
+{
+    size_t length;
+    DupFunc dup;
+    DtorFunc dtor;
+    UListChunk *head;
+    UListChunk *tail;
+} UList;
+
+void ulist_init(UList *, DupFunc, DtorFunc);
+UList *ulist_new(DupFunc, DtorFunc, char **);
+
+void ulist_clear(UList *);
+void ulist_destroy(UList *);
+
+bool ulist_append(UList *, void *, char **);
+bool ulist_empty(UList *);
+bool ulist_find_first(UList *, CmpFunc, void *, UListPosition *);
+bool ulist_find_last(UList *, CmpFunc, void *, UListPosition *);
+bool ulist_insert_after(UList *, UListPosition *, void *, char **);
+bool ulist_insert_before(UList *, UListPosition *, void *, char **);
+size_t ulist_length(UList *);
+bool ulist_prepend(UList *, void *, char **);
+void ulist_remove_head(UList *);
+void ulist_remove_link(UList *, UListPosition *);
+void ulist_remove_tail(UList *);
+
+bool ulist_at(UList *, int, void **);
+
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+void ulist_to_iterator(Iterator *, UList *);
+void ulist_to_collectable(Collectable *, UList *);
+#endif /* !WITHOUT_ITERATOR */
@@ -7,6 +7,21 @@
 
 #define UTF8_MAX_CU_LENGTH 8
 
+typedef struct {
+    int state;
+    size_t offset;
+    size_t lead_offset;
+} Utf8Validator;
+
+/*
+ * On error, utf8_check (errp) and the validator (offset) both designate the
+ * first byte which can't be accepted: the invalid byte itself or, when the
+ * string ends in the middle of a code point (UNI_ERR_TRUNCATED), the lead
+ * byte of this incomplete code point
+ */
 bool utf8_check(const char *, size_t, const char **);
+void utf8_validator_init(Utf8Validator *);
+UnicodeError utf8_validator_feed(Utf8Validator *, const char *, size_t, size_t *);
+UnicodeError utf8_validator_finish(Utf8Validator *, size_t *);
 size_t utf8_read_cp(const uint8_t *, const uint8_t * const, codepoint *);
 size_t utf8_write_cp(codepoint, uint8_t *, const uint8_t * const);
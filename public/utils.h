@@ -1,5 +1,11 @@
 #pragma once
 
+#include <stddef.h> /* offsetof */
+
+#ifndef CACHE_LINE_SIZE
+# define CACHE_LINE_SIZE 64
+#endif /* !CACHE_LINE_SIZE */
+
 #define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
 #define STR_LEN(str)      (ARRAY_SIZE(str) - 1)
 #define STR_SIZE(str)     (ARRAY_SIZE(str))
@@ -20,3 +26,6 @@
 
 #define UNSET_FLAG(value, flag) \
     ((value) &= ~(flag))
+
+#define container_of(ptr, type, member) \
+    ((type *) ((char *) (ptr) - offsetof(type, member)))
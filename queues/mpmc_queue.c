@@ -0,0 +1,328 @@
+/**
+ * @file queues/mpmc_queue.c
+ * @brief bounded lock-free multi-producers/multi-consumers queue
+ *
+ * A ring buffer of a power of 2 capacity where each cell carries a sequence
+ * number (Dmitry Vyukov's algorithm): a producer (or consumer) only has to
+ * win a compare and swap on the enqueue (dequeue) position to own a cell,
+ * then publishes it by an atomic store of its sequence. Producers and
+ * consumers never touch the same counter, nor the same cache line, and
+ * nothing is allocated after the initialization.
+ *
+ * \code
+ *   MPMCQueue q;
+ *   void *job;
+ *
+ *   mpmc_queue_init(&q, 1024, NULL);
+ *   // in producers
+ *   while (!mpmc_queue_enqueue(&q, job)) {
+ *       // full: retry later, drop, ...
+ *   }
+ *   // in consumers
+ *   if (mpmc_queue_dequeue(&q, &job)) {
+ *       // process job
+ *   }
+ *   mpmc_queue_destroy(&q);
+ * \endcode
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "nearest_power.h"
+#include "mpmc_queue.h"
+#include "error.h"
+
+/**
+ * Initialize a bounded queue
+ *
+ * @param q the queue to initialize
+ * @param capacity the maximum number of elements in the queue (rounded up
+ *   to the nearest power of 2, 2 at least)
+ * @param error
+ *
+ * @return `false` on error (memory allocation failure)
+ */
+bool mpmc_queue_init(MPMCQueue *q, size_t capacity, char **error)
+{
+    size_t i;
+
+    assert(NULL != q);
+
+    capacity = nearest_power(capacity, 2);
+    if (NULL == (q->buffer = malloc(sizeof(*q->buffer) * capacity))) {
+        set_malloc_error(error, sizeof(*q->buffer) * capacity);
+        return false;
+    }
+    for (i = 0; i < capacity; i++) {
+        atomic_init(&q->buffer[i].sequence, i);
+    }
+    q->mask = capacity - 1;
+    atomic_init(&q->enqueue_pos, 0);
+    atomic_init(&q->dequeue_pos, 0);
+
+    return true;
+}
+
+/**
+ * Free the memory used by a queue
+ *
+ * @param q the queue
+ *
+ * @note the elements still in the queue are lost
+ */
+void mpmc_queue_destroy(MPMCQueue *q)
+{
+    assert(NULL != q);
+
+    free(q->buffer);
+    q->buffer = NULL;
+}
+
+/**
+ * Get the capacity of a queue
+ *
+ * @param q the queue
+ *
+ * @return the maximum number of elements which can be queued
+ */
+size_t mpmc_queue_capacity(MPMCQueue *q)
+{
+    assert(NULL != q);
+
+    return q->mask + 1;
+}
+
+/**
+ * Get the number of elements in a queue
+ *
+ * @param q the queue
+ *
+ * @return the number of elements in the queue
+ *
+ * @note with concurrent producers or consumers, this is only a snapshot:
+ *   cells claimed but not yet written (or read) are counted as queued
+ */
+size_t mpmc_queue_length(MPMCQueue *q)
+{
+    size_t enqueue_pos, dequeue_pos;
+
+    assert(NULL != q);
+
+    // dequeue_pos never exceeds enqueue_pos, reading it first prevents an underflow
+    dequeue_pos = atomic_load_explicit(&q->dequeue_pos, memory_order_acquire);
+    enqueue_pos = atomic_load_explicit(&q->enqueue_pos, memory_order_acquire);
+
+    return MIN(enqueue_pos - dequeue_pos, q->mask + 1);
+}
+
+/**
+ * Claim up to *n* consecutive cells for which sequence - position = *offset*
+ * (0 for producers: cells are free, 1 for consumers: cells are filled)
+ *
+ * @note *n* has to be greater than 0
+ */
+static size_t mpmc_queue_claim(MPMCQueue *q, atomic_size_t *position, size_t offset, size_t n, size_t *from)
+{
+    size_t pos, i, seq;
+
+    assert(n > 0);
+
+    seq = 0; // always set by the first iteration of the inner loop
+    pos = atomic_load_explicit(position, memory_order_relaxed);
+    while (true) {
+        for (i = 0; i < n; i++) {
+            seq = atomic_load_explicit(&q->buffer[(pos + i) & q->mask].sequence, memory_order_acquire);
+            if (seq != pos + i + offset) {
+                break;
+            }
+        }
+        if (0 == i) {
+            if ((intptr_t) (seq - (pos + offset)) < 0) {
+                // full (for producers) or empty (for consumers)
+                return 0;
+            }
+            // an other thread claimed this position in the meantime, reload it
+            pos = atomic_load_explicit(position, memory_order_relaxed);
+        } else if (atomic_compare_exchange_weak_explicit(position, &pos, pos + i, memory_order_relaxed, memory_order_relaxed)) {
+            *from = pos;
+            return i;
+        }
+        // else pos has been updated by atomic_compare_exchange_weak_explicit
+    }
+}
+
+/**
+ * Push up to *n* values at once into the queue
+ *
+ * @param q the queue
+ * @param values the values to enqueue
+ * @param n the number of values
+ *
+ * @return the number of values actually enqueued (less than *n* if the
+ *   queue became full), they are always the *n* first ones
+ */
+size_t mpmc_queue_enqueue_batch(MPMCQueue *q, void * const *values, size_t n)
+{
+    size_t done, from, i, count;
+
+    assert(NULL != q);
+    assert(NULL != values || 0 == n);
+
+    for (done = 0; done < n; done += count) {
+        if (0 == (count = mpmc_queue_claim(q, &q->enqueue_pos, 0, n - done, &from))) {
+            break;
+        }
+        for (i = 0; i < count; i++) {
+            MPMCCell *cell;
+
+            cell = &q->buffer[(from + i) & q->mask];
+            cell->data = values[done + i];
+            atomic_store_explicit(&cell->sequence, from + i + 1, memory_order_release);
+        }
+    }
+
+    return done;
+}
+
+/**
+ * Push a value into the queue
+ *
+ * @param q the queue
+ * @param value the value to enqueue
+ *
+ * @return `false` if the queue is full
+ */
+bool mpmc_queue_enqueue(MPMCQueue *q, void *value)
+{
+    return 1 == mpmc_queue_enqueue_batch(q, &value, 1);
+}
+
+/**
+ * Pop up to *n* values at once from the queue
+ *
+ * @param q the queue
+ * @param values an array of (at least) *n* elements which receives the dequeued values
+ * @param n the maximum number of values to dequeue
+ *
+ * @return the number of values dequeued (0 if the queue is empty)
+ */
+size_t mpmc_queue_dequeue_batch(MPMCQueue *q, void **values, size_t n)
+{
+    size_t done, from, i, count;
+
+    assert(NULL != q);
+    assert(NULL != values || 0 == n);
+
+    for (done = 0; done < n; done += count) {
+        if (0 == (count = mpmc_queue_claim(q, &q->dequeue_pos, 1, n - done, &from))) {
+            break;
+        }
+        for (i = 0; i < count; i++) {
+            MPMCCell *cell;
+
+            cell = &q->buffer[(from + i) & q->mask];
+            values[done + i] = cell->data;
+            // make the cell available for the producer of the next turn
+            atomic_store_explicit(&cell->sequence, from + i + q->mask + 1, memory_order_release);
+        }
+    }
+
+    return done;
+}
+
+/**
+ * Pop a value from the queue
+ *
+ * @param q the queue
+ * @param value where to store the dequeued value
+ *
+ * @return `false` if the queue is empty
+ */
+bool mpmc_queue_dequeue(MPMCQueue *q, void **value)
+{
+    assert(NULL != value);
+
+    return 1 == mpmc_queue_dequeue_batch(q, value, 1);
+}
+
+#ifndef WITHOUT_ITERATOR
+typedef struct {
+    void *value;
+    bool valid;
+} mqs_t /*mpmc_queue_state*/;
+
+static void mpmc_queue_iterator_next(const void *collection, void **state)
+{
+    mqs_t *s;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (mqs_t *) *state;
+    s->valid = mpmc_queue_dequeue((MPMCQueue *) collection, &s->value);
+}
+
+static size_t mpmc_queue_iterator_count(const void *collection)
+{
+    assert(NULL != collection);
+
+    return mpmc_queue_length((MPMCQueue *) collection);
+}
+
+static bool mpmc_queue_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    return ((mqs_t *) *state)->valid;
+}
+
+static void mpmc_queue_iterator_current(const void *UNUSED(collection), void **state, void **UNUSED(key), void **value)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    if (NULL != value) {
+        *value = ((mqs_t *) *state)->value;
+    }
+}
+
+/**
+ * Initialize an *Iterator* to drain a queue: each step dequeues a value,
+ * the iteration ends when the queue is (momentarily) empty.
+ *
+ * @param it the iterator to initialize
+ * @param q the queue to drain
+ *
+ * @note iterator directions: forward only (iterator_first dequeues the first value)
+ * @note there is no key
+ * @note iterating dequeues the values, but iterator_count and iterator_empty
+ *   don't (they rely on mpmc_queue_length)
+ **/
+void mpmc_queue_to_iterator(Iterator *it, MPMCQueue *q)
+{
+    mqs_t *s;
+
+    assert(NULL != it);
+    assert(NULL != q);
+
+    s = malloc(sizeof(*s));
+    s->value = NULL;
+    s->valid = false;
+
+    iterator_init(
+        it, q, s,
+        mpmc_queue_iterator_next, NULL,
+        mpmc_queue_iterator_current,
+        mpmc_queue_iterator_next, NULL,
+        mpmc_queue_iterator_is_valid,
+        free,
+        mpmc_queue_iterator_count, NULL, NULL
+    );
+}
+#endif /* !WITHOUT_ITERATOR */
@@ -0,0 +1,329 @@
+/**
+ * @file queues/mpsc_queue.c
+ * @brief unbounded lock-free multi-producers/single-consumer queue
+ *
+ * A linked list with a dummy node (Dmitry Vyukov's algorithm): producers
+ * only perform an atomic exchange on the head of the queue to link a new
+ * node, the consumer, on the other end, does not need any atomic read-modify-write
+ * operation at all.
+ *
+ * \code
+ *   MPSCQueue q;
+ *   void *event;
+ *
+ *   mpsc_queue_init(&q, NULL);
+ *   // in any thread
+ *   mpsc_queue_enqueue(&q, event, NULL);
+ *   // in the (single) consumer thread
+ *   while (mpsc_queue_dequeue(&q, &event)) {
+ *       // process event
+ *   }
+ *   mpsc_queue_destroy(&q);
+ * \endcode
+ *
+ * @note a producer preempted between the exchange of the head and the
+ * link of its node to its predecessor makes the queue look momentarily
+ * empty to the consumer from this point (the following values become
+ * available as soon as the link is done).
+ */
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "mpsc_queue.h"
+#include "error.h"
+
+static MPSCNode *mpsc_node_new(void *data, char **error)
+{
+    MPSCNode *n;
+
+    if (NULL == (n = malloc(sizeof(*n)))) {
+        set_malloc_error(error, sizeof(*n));
+    } else {
+        n->data = data;
+        atomic_init(&n->next, NULL);
+    }
+
+    return n;
+}
+
+/**
+ * Initialize an unbounded queue
+ *
+ * @param q the queue to initialize
+ * @param error
+ *
+ * @return `false` on error (memory allocation failure)
+ */
+bool mpsc_queue_init(MPSCQueue *q, char **error)
+{
+    MPSCNode *dummy;
+
+    assert(NULL != q);
+
+    if (NULL == (dummy = mpsc_node_new(NULL, error))) {
+        return false;
+    }
+    atomic_init(&q->head, dummy);
+    q->tail = dummy;
+
+    return true;
+}
+
+/**
+ * Free the memory used by a queue
+ *
+ * @param q the queue
+ *
+ * @note the values still in the queue are lost (but their nodes are freed)
+ */
+void mpsc_queue_destroy(MPSCQueue *q)
+{
+    void *value;
+
+    assert(NULL != q);
+
+    while (mpsc_queue_dequeue(q, &value))
+        ;
+    free(q->tail);
+    q->tail = NULL;
+    atomic_store_explicit(&q->head, NULL, memory_order_relaxed);
+}
+
+/**
+ * Publish the chain of nodes first -> ... -> last at once
+ */
+static void mpsc_queue_push(MPSCQueue *q, MPSCNode *first, MPSCNode *last)
+{
+    MPSCNode *prev;
+
+    prev = atomic_exchange_explicit(&q->head, last, memory_order_acq_rel);
+    // from here, up to the store below, the consumer can't see further than prev
+    atomic_store_explicit(&prev->next, first, memory_order_release);
+}
+
+/**
+ * Push a value into the queue
+ *
+ * @param q the queue
+ * @param value the value to enqueue
+ * @param error
+ *
+ * @return `false` on error (memory allocation failure)
+ */
+bool mpsc_queue_enqueue(MPSCQueue *q, void *value, char **error)
+{
+    MPSCNode *n;
+
+    assert(NULL != q);
+
+    if (NULL == (n = mpsc_node_new(value, error))) {
+        return false;
+    }
+    mpsc_queue_push(q, n, n);
+
+    return true;
+}
+
+/**
+ * Push *n* values into the queue with a single atomic operation: they
+ * are consecutive in the queue, not interleaved with the values of the
+ * other producers.
+ *
+ * @param q the queue
+ * @param values the values to enqueue
+ * @param n the number of values
+ * @param error
+ *
+ * @return `false` on error (memory allocation failure), in this case
+ * none of the values is enqueued
+ */
+bool mpsc_queue_enqueue_batch(MPSCQueue *q, void * const *values, size_t n, char **error)
+{
+    size_t i;
+    MPSCNode *first, *last, *node;
+
+    assert(NULL != q);
+    assert(NULL != values || 0 == n);
+
+    first = last = NULL;
+    for (i = 0; i < n; i++) {
+        if (NULL == (node = mpsc_node_new(values[i], error))) {
+            while (NULL != first) {
+                node = atomic_load_explicit(&first->next, memory_order_relaxed);
+                free(first);
+                first = node;
+            }
+            return false;
+        }
+        if (NULL == first) {
+            first = node;
+        } else {
+            atomic_store_explicit(&last->next, node, memory_order_relaxed);
+        }
+        last = node;
+    }
+    if (NULL != first) {
+        mpsc_queue_push(q, first, last);
+    }
+
+    return true;
+}
+
+/**
+ * Pop a value from the queue
+ *
+ * @param q the queue
+ * @param value where to store the dequeued value
+ *
+ * @return `false` if the queue is empty
+ *
+ * @note this function must only be called by a single thread at a time
+ */
+bool mpsc_queue_dequeue(MPSCQueue *q, void **value)
+{
+    MPSCNode *tail, *next;
+
+    assert(NULL != q);
+    assert(NULL != value);
+
+    tail = q->tail;
+    if (NULL == (next = atomic_load_explicit(&tail->next, memory_order_acquire))) {
+        return false;
+    }
+    // next becomes the new dummy node
+    *value = next->data;
+    q->tail = next;
+    free(tail);
+
+    return true;
+}
+
+/**
+ * Pop up to *n* values from the queue
+ *
+ * @param q the queue
+ * @param values an array of (at least) *n* elements which receives the dequeued values
+ * @param n the maximum number of values to dequeue
+ *
+ * @return the number of values dequeued (0 if the queue is empty)
+ *
+ * @note this function must only be called by a single thread at a time
+ */
+size_t mpsc_queue_dequeue_batch(MPSCQueue *q, void **values, size_t n)
+{
+    size_t i;
+
+    assert(NULL != values || 0 == n);
+
+    for (i = 0; i < n && mpsc_queue_dequeue(q, &values[i]); i++)
+        ;
+
+    return i;
+}
+
+/**
+ * Get the number of elements in a queue
+ *
+ * @param q the queue
+ *
+ * @return the number of elements in the queue
+ *
+ * @note this is O(n): the nodes are walked to count them
+ * @note this function must only be called by the consumer thread, values
+ *   concurrently enqueued may or may not be counted
+ */
+size_t mpsc_queue_length(MPSCQueue *q)
+{
+    size_t length;
+    MPSCNode *node;
+
+    assert(NULL != q);
+
+    length = 0;
+    for (node = atomic_load_explicit(&q->tail->next, memory_order_acquire); NULL != node; node = atomic_load_explicit(&node->next, memory_order_acquire)) {
+        ++length;
+    }
+
+    return length;
+}
+
+#ifndef WITHOUT_ITERATOR
+typedef struct {
+    void *value;
+    bool valid;
+} mqs_t /*mpsc_queue_state*/;
+
+static void mpsc_queue_iterator_next(const void *collection, void **state)
+{
+    mqs_t *s;
+
+    assert(NULL != collection);
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (mqs_t *) *state;
+    s->valid = mpsc_queue_dequeue((MPSCQueue *) collection, &s->value);
+}
+
+static size_t mpsc_queue_iterator_count(const void *collection)
+{
+    assert(NULL != collection);
+
+    return mpsc_queue_length((MPSCQueue *) collection);
+}
+
+static bool mpsc_queue_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    return ((mqs_t *) *state)->valid;
+}
+
+static void mpsc_queue_iterator_current(const void *UNUSED(collection), void **state, void **UNUSED(key), void **value)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    if (NULL != value) {
+        *value = ((mqs_t *) *state)->value;
+    }
+}
+
+/**
+ * Initialize an *Iterator* to drain a queue: each step dequeues a value,
+ * the iteration ends when the queue is (momentarily) empty.
+ *
+ * @param it the iterator to initialize
+ * @param q the queue to drain
+ *
+ * @note iterator directions: forward only (iterator_first dequeues the first value)
+ * @note there is no key
+ * @note iterating dequeues the values, but iterator_count and iterator_empty
+ *   don't (they rely on mpsc_queue_length)
+ * @note only the consumer thread can use this iterator
+ **/
+void mpsc_queue_to_iterator(Iterator *it, MPSCQueue *q)
+{
+    mqs_t *s;
+
+    assert(NULL != it);
+    assert(NULL != q);
+
+    s = malloc(sizeof(*s));
+    s->value = NULL;
+    s->valid = false;
+
+    iterator_init(
+        it, q, s,
+        mpsc_queue_iterator_next, NULL,
+        mpsc_queue_iterator_current,
+        mpsc_queue_iterator_next, NULL,
+        mpsc_queue_iterator_is_valid,
+        free,
+        mpsc_queue_iterator_count, NULL, NULL
+    );
+}
+#endif /* !WITHOUT_ITERATOR */
@@ -0,0 +1,577 @@
+/**
+ * @file rbtree/irbtree.c
+ * @brief intrusive red black tree
+ *
+ * The nodes of the tree are `RBTreeLink` embedded into the objects
+ * themselves: inserting or removing an element never allocates (nor frees)
+ * memory. Get the object back from a link with `irbtree_entry` (`container_of`).
+ *
+ * \code
+ *   typedef struct {
+ *       int fd;
+ *       time_t deadline;
+ *       RBTreeLink by_deadline;
+ *   } Connection;
+ *
+ *   static int deadline_cmp(const void *key, const RBTreeLink *link) {
+ *       time_t a = *(const time_t *) key, b = irbtree_entry(link, const Connection, by_deadline)->deadline;
+ *       return (a > b) - (a < b);
+ *   }
+ *
+ *   IRBTree timeouts;
+ *   RBTreeLink *link;
+ *
+ *   irbtree_init(&timeouts, deadline_cmp);
+ *   irbtree_insert(&timeouts, IRBTREE_INSERT_ALLOW_DUP_KEY, &conn->deadline, &conn->by_deadline);
+ *   // expire connections
+ *   while (NULL != (link = irbtree_first(&timeouts)) && irbtree_entry(link, Connection, by_deadline)->deadline <= now) {
+ *       irbtree_remove(&timeouts, link);
+ *       // ...
+ *   }
+ * \endcode
+ *
+ * @note the tree embeds its own sentinel, an initialized IRBTree must not be moved
+ * (copied) in memory
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "utils.h"
+#include "irbtree.h"
+
+typedef enum {
+    BLACK = 0,
+    RED   = 1
+} RBTreeColor;
+
+#define NIL(tree) \
+    (&(tree)->nil)
+
+/* convert the sentinel to NULL for the public API */
+#define PUBLIC(tree, link) \
+    ((link) == NIL(tree) ? NULL : (link))
+
+/**
+ * Initialize an intrusive red black tree
+ *
+ * @param tree the tree to initialize
+ * @param cmp_func the callback to compare a key to an element of the tree
+ */
+void irbtree_init(IRBTree *tree, RBTreeLinkCmpFunc cmp_func) /* NONNULL() */
+{
+    assert(NULL != tree);
+    assert(NULL != cmp_func);
+
+    tree->nil.left = tree->nil.right = tree->nil.parent = NIL(tree);
+    tree->nil.color = BLACK;
+    tree->root = tree->first = tree->last = NIL(tree);
+    tree->count = 0;
+    tree->cmp_func = cmp_func;
+}
+
+/**
+ * Get the number of elements in the tree
+ *
+ * @param tree the tree
+ *
+ * @return its number of elements
+ */
+size_t irbtree_count(IRBTree *tree) /* NONNULL() */
+{
+    assert(NULL != tree);
+
+    return tree->count;
+}
+
+/**
+ * Is the tree empty?
+ *
+ * @param tree the tree
+ *
+ * @return true if the tree does not contain any element
+ */
+bool irbtree_empty(IRBTree *tree) /* NONNULL() */
+{
+    assert(NULL != tree);
+
+    return NIL(tree) == tree->root;
+}
+
+static void irbtree_rotate_left(IRBTree *tree, RBTreeLink *node) /* NONNULL() */
+{
+    RBTreeLink *p;
+
+    p = node->right;
+    node->right = p->left;
+    if (p->left != NIL(tree)) {
+        p->left->parent = node;
+    }
+    p->parent = node->parent;
+    if (node->parent == NIL(tree)) {
+        tree->root = p;
+    } else if (node == node->parent->left) {
+        node->parent->left = p;
+    } else {
+        node->parent->right = p;
+    }
+    p->left = node;
+    node->parent = p;
+}
+
+static void irbtree_rotate_right(IRBTree *tree, RBTreeLink *node) /* NONNULL() */
+{
+    RBTreeLink *p;
+
+    p = node->left;
+    node->left = p->right;
+    if (p->right != NIL(tree)) {
+        p->right->parent = node;
+    }
+    p->parent = node->parent;
+    if (node->parent == NIL(tree)) {
+        tree->root = p;
+    } else if (node == node->parent->right) {
+        node->parent->right = p;
+    } else {
+        node->parent->left = p;
+    }
+    p->right = node;
+    node->parent = p;
+}
+
+static RBTreeLink *irbtree_min(IRBTree *tree, RBTreeLink *node) /* NONNULL() */
+{
+    while (node->left != NIL(tree)) {
+        node = node->left;
+    }
+
+    return node;
+}
+
+static RBTreeLink *irbtree_max(IRBTree *tree, RBTreeLink *node) /* NONNULL() */
+{
+    while (node->right != NIL(tree)) {
+        node = node->right;
+    }
+
+    return node;
+}
+
+static RBTreeLink *irbtree_next_real(IRBTree *tree, RBTreeLink *node) /* NONNULL() */
+{
+    if (node->right != NIL(tree)) {
+        return irbtree_min(tree, node->right);
+    } else {
+        RBTreeLink *y;
+
+        y = node->parent;
+        while (y != NIL(tree) && node == y->right) {
+            node = y;
+            y = y->parent;
+        }
+
+        return y;
+    }
+}
+
+static RBTreeLink *irbtree_previous_real(IRBTree *tree, RBTreeLink *node) /* NONNULL() */
+{
+    if (node->left != NIL(tree)) {
+        return irbtree_max(tree, node->left);
+    } else {
+        RBTreeLink *y;
+
+        y = node->parent;
+        while (y != NIL(tree) && node == y->left) {
+            node = y;
+            y = y->parent;
+        }
+
+        return y;
+    }
+}
+
+/**
+ * Get the least element of the tree
+ *
+ * @param tree the tree
+ *
+ * @return `NULL` if the tree is empty
+ */
+RBTreeLink *irbtree_first(IRBTree *tree) /* NONNULL() */
+{
+    assert(NULL != tree);
+
+    return PUBLIC(tree, tree->first);
+}
+
+/**
+ * Get the greatest element of the tree
+ *
+ * @param tree the tree
+ *
+ * @return `NULL` if the tree is empty
+ */
+RBTreeLink *irbtree_last(IRBTree *tree) /* NONNULL() */
+{
+    assert(NULL != tree);
+
+    return PUBLIC(tree, tree->last);
+}
+
+/**
+ * Get the in-order successor of an element
+ *
+ * @param tree the tree
+ * @param link an element of *tree*
+ *
+ * @return `NULL` if *link* is the greatest element of the tree
+ */
+RBTreeLink *irbtree_next(IRBTree *tree, RBTreeLink *link) /* NONNULL() */
+{
+    assert(NULL != tree);
+    assert(NULL != link);
+
+    return PUBLIC(tree, irbtree_next_real(tree, link));
+}
+
+/**
+ * Get the in-order predecessor of an element
+ *
+ * @param tree the tree
+ * @param link an element of *tree*
+ *
+ * @return `NULL` if *link* is the least element of the tree
+ */
+RBTreeLink *irbtree_previous(IRBTree *tree, RBTreeLink *link) /* NONNULL() */
+{
+    assert(NULL != tree);
+    assert(NULL != link);
+
+    return PUBLIC(tree, irbtree_previous_real(tree, link));
+}
+
+/**
+ * Insert an element into the tree
+ *
+ * @param tree the tree
+ * @param flags a mask of the following options:
+ *   - IRBTREE_INSERT_ALLOW_DUP_KEY: insert *link* even if an element with the same key
+ *     already exists (it is placed after the existing ones)
+ * @param key the key of the object which embeds *link*
+ * @param link the link to insert (it must not already be in a tree)
+ *
+ * @return `NULL` if *link* was inserted else the element of the tree which already
+ * has the same key (*link* is not inserted)
+ */
+RBTreeLink *irbtree_insert(IRBTree *tree, uint32_t flags, const void *key, RBTreeLink *link) /* NONNULL(1, 4) */
+{
+    int cmp;
+    RBTreeLink *y, *x, *new;
+    bool leftmost, rightmost;
+
+    assert(NULL != tree);
+    assert(NULL != link);
+
+    y = NIL(tree);
+    x = tree->root;
+    cmp = 0;
+    leftmost = rightmost = true;
+    while (x != NIL(tree)) {
+        y = x;
+        cmp = tree->cmp_func(key, x);
+        if (0 == cmp && !HAS_FLAG(flags, IRBTREE_INSERT_ALLOW_DUP_KEY)) {
+            return x;
+        } else if (cmp < 0) {
+            x = x->left;
+            rightmost = false;
+        } else /*if (cmp >= 0)*/ {
+            x = x->right;
+            leftmost = false;
+        }
+    }
+    new = link;
+    new->parent = y;
+    new->left = NIL(tree);
+    new->right = NIL(tree);
+    new->color = RED;
+    if (y == NIL(tree)) {
+        tree->root = new;
+    } else if (cmp < 0) {
+        y->left = new;
+    } else {
+        y->right = new;
+    }
+    if (leftmost) {
+        tree->first = new;
+    }
+    if (rightmost) {
+        tree->last = new;
+    }
+    ++tree->count;
+
+    while (RED == new->parent->color) {
+        if (new->parent == new->parent->parent->left) {
+            y = new->parent->parent->right;
+            if (RED == y->color) {
+                new->parent->color = BLACK;
+                y->color = BLACK;
+                new->parent->parent->color = RED;
+                new = new->parent->parent;
+            } else {
+                if (new == new->parent->right) {
+                    new = new->parent;
+                    irbtree_rotate_left(tree, new);
+                }
+                new->parent->color = BLACK;
+                new->parent->parent->color = RED;
+                irbtree_rotate_right(tree, new->parent->parent);
+            }
+        } else /*if (new->parent == new->parent->parent->right)*/ {
+            y = new->parent->parent->left;
+            if (RED == y->color) {
+                new->parent->color = BLACK;
+                y->color = BLACK;
+                new->parent->parent->color = RED;
+                new = new->parent->parent;
+            } else {
+                if (new == new->parent->left) {
+                    new = new->parent;
+                    irbtree_rotate_right(tree, new);
+                }
+                new->parent->color = BLACK;
+                new->parent->parent->color = RED;
+                irbtree_rotate_left(tree, new->parent->parent);
+            }
+        }
+    }
+    tree->root->color = BLACK;
+
+    return NULL;
+}
+
+/**
+ * Look for an element from its key
+ *
+ * @param tree the tree
+ * @param key the key to look for
+ *
+ * @return `NULL` if there is no element with this key
+ *
+ * @note if duplicate keys are allowed, the returned element is any of those
+ */
+RBTreeLink *irbtree_lookup(IRBTree *tree, const void *key) /* NONNULL(1) */
+{
+    int cmp;
+    RBTreeLink *x;
+
+    assert(NULL != tree);
+
+    x = tree->root;
+    while (x != NIL(tree)) {
+        if (0 == (cmp = tree->cmp_func(key, x))) {
+            return x;
+        } else if (cmp < 0) {
+            x = x->left;
+        } else /*if (cmp > 0)*/ {
+            x = x->right;
+        }
+    }
+
+    return NULL;
+}
+
+static void irbtree_transplante(IRBTree *tree, RBTreeLink *u, RBTreeLink *v) /* NONNULL() */
+{
+    if (u->parent == NIL(tree)) {
+        tree->root = v;
+    } else if (u == u->parent->left) {
+        u->parent->left = v;
+    } else {
+        u->parent->right = v;
+    }
+    v->parent = u->parent;
+}
+
+/**
+ * Unlink an element from the tree
+ *
+ * @param tree the tree
+ * @param z the element to remove
+ *
+ * @note the object which embeds *z* is left untouched
+ */
+void irbtree_remove(IRBTree *tree, RBTreeLink *z) /* NONNULL() */
+{
+    int ycolor;
+    RBTreeLink *y, *x, *w;
+
+    assert(NULL != tree);
+    assert(NULL != z);
+
+    if (z == tree->first) {
+        tree->first = irbtree_next_real(tree, z);
+    }
+    if (z == tree->last) {
+        tree->last = irbtree_previous_real(tree, z);
+    }
+    y = z;
+    ycolor = y->color;
+    if (z->left == NIL(tree)) {
+        x = z->right;
+        irbtree_transplante(tree, z, z->right);
+    } else if (z->right == NIL(tree)) {
+        x = z->left;
+        irbtree_transplante(tree, z, z->left);
+    } else {
+        y = irbtree_min(tree, z->right);
+        ycolor = y->color;
+        x = y->right;
+        if (y->parent == z) {
+            x->parent = y;
+        } else {
+            irbtree_transplante(tree, y, y->right);
+            y->right = z->right;
+            y->right->parent = y;
+        }
+        irbtree_transplante(tree, z, y);
+        y->left = z->left;
+        y->left->parent = y;
+        y->color = z->color;
+    }
+    if (BLACK == ycolor) {
+        while (x != tree->root && BLACK == x->color) {
+            if (x == x->parent->left) {
+                w = x->parent->right;
+                if (RED == w->color) {
+                    w->color = BLACK;
+                    x->parent->color = RED;
+                    irbtree_rotate_left(tree, x->parent);
+                    w = x->parent->right;
+                }
+                if (BLACK == w->left->color && BLACK == w->right->color) {
+                    w->color = RED;
+                    x = x->parent;
+                } else {
+                    if (BLACK == w->right->color) {
+                        w->left->color = BLACK;
+                        w->color = RED;
+                        irbtree_rotate_right(tree, w);
+                        w = x->parent->right;
+                    }
+                    w->color = x->parent->color;
+                    x->parent->color = BLACK;
+                    w->right->color = BLACK;
+                    irbtree_rotate_left(tree, x->parent);
+                    x = tree->root;
+                }
+            } else {
+                w = x->parent->left;
+                if (RED == w->color) {
+                    w->color = BLACK;
+                    x->parent->color = RED;
+                    irbtree_rotate_right(tree, x->parent);
+                    w = x->parent->left;
+                }
+                if (BLACK == w->right->color && BLACK == w->left->color) {
+                    w->color = RED;
+                    x = x->parent;
+                } else {
+                    if (BLACK == w->left->color) {
+                        w->right->color = BLACK;
+                        w->color = RED;
+                        irbtree_rotate_left(tree, w);
+                        w = x->parent->left;
+                    }
+                    w->color = x->parent->color;
+                    x->parent->color = BLACK;
+                    w->left->color = BLACK;
+                    irbtree_rotate_right(tree, x->parent);
+                    x = tree->root;
+                }
+            }
+        }
+        x->color = BLACK;
+    }
+    z->left = z->right = z->parent = NULL;
+    --tree->count;
+}
+
+#ifndef WITHOUT_ITERATOR
+static void irbtree_iterator_first(const void *collection, void **state)
+{
+    assert(NULL != collection);
+    assert(NULL != state);
+
+    *state = irbtree_first((IRBTree *) collection);
+}
+
+static void irbtree_iterator_last(const void *collection, void **state)
+{
+    assert(NULL != collection);
+    assert(NULL != state);
+
+    *state = irbtree_last((IRBTree *) collection);
+}
+
+static bool irbtree_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+
+    return NULL != *state;
+}
+
+static void irbtree_iterator_current(const void *UNUSED(collection), void **state, void **UNUSED(key), void **value)
+{
+    assert(NULL != state);
+
+    if (NULL != value) {
+        *value = *state;
+    }
+}
+
+static void irbtree_iterator_next(const void *collection, void **state)
+{
+    assert(NULL != collection);
+    assert(NULL != state);
+
+    *state = irbtree_next((IRBTree *) collection, (RBTreeLink *) *state);
+}
+
+static void irbtree_iterator_previous(const void *collection, void **state)
+{
+    assert(NULL != collection);
+    assert(NULL != state);
+
+    *state = irbtree_previous((IRBTree *) collection, (RBTreeLink *) *state);
+}
+
+/**
+ * Initialize an *Iterator* to traverse, in order and in both directions,
+ * the links of an intrusive red black tree.
+ *
+ * @param it the iterator to initialize
+ * @param tree the tree to traverse
+ *
+ * @note iterator directions: forward and backward
+ * @note values are the `RBTreeLink *` (use irbtree_entry to get the object)
+ * @note there is no key
+ **/
+void irbtree_to_iterator(Iterator *it, IRBTree *tree)
+{
+    assert(NULL != it);
+    assert(NULL != tree);
+
+    iterator_init(
+        it, tree, NULL,
+        irbtree_iterator_first, irbtree_iterator_last,
+        irbtree_iterator_current,
+        irbtree_iterator_next, irbtree_iterator_previous,
+        irbtree_iterator_is_valid,
+        NULL,
+        (iterator_count_t) irbtree_count, NULL, NULL
+    );
+}
+#endif /* !WITHOUT_ITERATOR */
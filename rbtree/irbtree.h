@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h> /* uint\d+_t */
+
+#include "attributes.h"
+#include "utils.h" /* container_of */
+
+#define IRBTREE_INSERT_ALLOW_DUP_KEY (1<<2)
+
+typedef struct RBTreeLink
+{
+    struct RBTreeLink *left;
+    struct RBTreeLink *right;
+    struct RBTreeLink *parent;
+    int color;
+} RBTreeLink;
+
+/* compares a key to the one of the object which embeds the link */
+typedef int (*RBTreeLinkCmpFunc)(const void *, const RBTreeLink *);
+
+typedef struct
+{
+    RBTreeLink nil;
+    RBTreeLink *root;
+    RBTreeLink *first;
+    RBTreeLink *last;
+    size_t count;
+    RBTreeLinkCmpFunc cmp_func;
+} IRBTree;
+
+#define irbtree_entry(link, type, member) \
+    container_of(link, type, member)
+
+void irbtree_init(IRBTree *, RBTreeLinkCmpFunc) NONNULL();
+size_t irbtree_count(IRBTree *) NONNULL();
+bool irbtree_empty(IRBTree *) NONNULL();
+RBTreeLink *irbtree_first(IRBTree *) NONNULL();
+RBTreeLink *irbtree_insert(IRBTree *, uint32_t, const void *, RBTreeLink *) NONNULL(1, 4);
+RBTreeLink *irbtree_last(IRBTree *) NONNULL();
+RBTreeLink *irbtree_lookup(IRBTree *, const void *) NONNULL(1);
+RBTreeLink *irbtree_next(IRBTree *, RBTreeLink *) NONNULL();
+RBTreeLink *irbtree_previous(IRBTree *, RBTreeLink *) NONNULL();
+void irbtree_remove(IRBTree *, RBTreeLink *) NONNULL();
+
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+void irbtree_to_iterator(Iterator *, IRBTree *);
+#endif /* !WITHOUT_ITERATOR */
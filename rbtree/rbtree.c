@@ -699,6 +699,33 @@ void rbtree_traverse(RBTree *tree, TraverseMode mode, TravFunc trav_func) /* NON
     }
 }
 
+#ifndef WITHOUT_ITERATOR
+static void rbtree_collectable_into(void *collection, void *key, void *value)
+{
+    assert(NULL != collection);
+
+    rbtree_insert((RBTree *) collection, 0, key, value, NULL);
+}
+
+/**
+ * Initialize a *Collectable* to insert, through `iterator_into`, the keys
+ * and values of an iterator into a tree
+ *
+ * @param collectable the collectable to initialize
+ * @param tree the tree to fill
+ *
+ * @note nodes are allocated one by one: there is nothing to reserve
+ * @note a value replaces the previous one of the same key
+ **/
+void rbtree_to_collectable(Collectable *collectable, RBTree *tree)
+{
+    assert(NULL != collectable);
+    assert(NULL != tree);
+
+    collectable_init(collectable, tree, rbtree_collectable_into);
+}
+#endif /* !WITHOUT_ITERATOR */
+
 #if 0
 #if defined(MAINTAIN_FIRST_LAST) && !defined(WITHOUT_ITERATOR)
 static void rbtree_iterator_first(const void *collection, void **state)
@@ -35,6 +35,12 @@ bool rbtree_remove(RBTree *, const void *, bool) NONNULL(1);
 bool rbtree_replace(RBTree *, const void *, void *, bool) NONNULL(1);
 void rbtree_traverse(RBTree *, TraverseMode, TravFunc) NONNULL();
 
+#ifndef WITHOUT_ITERATOR
+# include "iterator.h"
+
+void rbtree_to_collectable(Collectable *, RBTree *);
+#endif /* !WITHOUT_ITERATOR */
+
 #if 0
 #if defined(MAINTAIN_FIRST_LAST) && !defined(WITHOUT_ITERATOR)
 #include "iterator.h"
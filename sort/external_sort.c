@@ -0,0 +1,539 @@
+/**
+ * @file sort/external_sort.c
+ * @brief sort of fixed-size records which don't (all) fit in memory
+ *
+ * Records are accumulated in a buffer of a fixed size (the memory budget).
+ * Each time it is full, it is sorted and written (spilled) as a run into a
+ * temporary file. Once all records are pushed, the sorted runs are merged,
+ * on the fly, by the iterator.
+ *
+ * The number of runs merged at once (the fan-in) is bounded, by the budget
+ * (each run needs a read buffer of a reasonable size) and by the maximum
+ * number of open files: when the fan-in is reached, the most recent runs
+ * of the same size class are merged (in the memory of the buffer, then
+ * empty) into a larger run. The number of passes on the data grows
+ * logarithmically with the number of runs.
+ *
+ * \code
+ *   Iterator it;
+ *   Record *r, record;
+ *   ExternalSort es;
+ *
+ *   // sort with (at most) 512 MB of memory
+ *   external_sort_init(&es, sizeof(record), 512 * 1024 * 1024, record_cmp, NULL);
+ *   while (read_record(input, &record)) {
+ *       if (!external_sort_push(&es, &record, &error)) {
+ *           // ...
+ *       }
+ *   }
+ *   if (external_sort_to_iterator(&it, &es, &error)) {
+ *       for (iterator_first(&it); iterator_is_valid(&it, NULL, &r); iterator_next(&it)) {
+ *           // records come in ascending order
+ *       }
+ *       iterator_close(&it);
+ *   }
+ *   external_sort_destroy(&es);
+ * \endcode
+ *
+ * @note runs are written into anonymous temporary files (tmpfile(3): in
+ * P_tmpdir, usually /tmp) which are removed when closed, even on crash
+ * @note records are written and read back as is: they must not contain
+ * pointers to memory which doesn't outlive the sort
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "external_sort.h"
+#include "error.h"
+
+/* the minimum size, in bytes, of the read buffer of a run being merged */
+#define EXTERNAL_SORT_MIN_READ_SIZE (64 * 1024)
+
+typedef struct {
+    FILE *fp;
+    /* the number of merges the records of the run went through */
+    size_t level;
+} esr_t /*external_sort_run*/;
+
+static void external_sort_run_close(void *data)
+{
+    fclose(((esr_t *) data)->fp);
+}
+
+#ifndef WITHOUT_ITERATOR
+static bool external_sort_cascade(ExternalSort *, char **);
+#endif /* !WITHOUT_ITERATOR */
+
+/**
+ * Initialize an external sort
+ *
+ * @param es the external sort to initialize
+ * @param element_size the size, in bytes, of a record
+ * @param budget the maximum amount of memory, in bytes, to hold records
+ * (the size of a run, at least two records)
+ * @param cmp the function to compare two records
+ * @param error
+ *
+ * @return `false` on error (memory allocation failure)
+ */
+bool external_sort_init(ExternalSort *es, size_t element_size, size_t budget, CmpFunc cmp, char **error)
+{
+    long open_max;
+
+    assert(NULL != es);
+    assert(NULL != cmp);
+    assert(element_size > 0);
+
+    es->cmp = cmp;
+    es->element_size = element_size;
+    es->capacity = MAX(budget / element_size, 2);
+    es->budget = es->capacity * element_size;
+    es->fanin = es->budget / MAX(EXTERNAL_SORT_MIN_READ_SIZE, element_size);
+    // leave at least half of the file descriptors to the rest of the program
+    if ((open_max = sysconf(_SC_OPEN_MAX)) > 0) {
+        es->fanin = MIN(es->fanin, (size_t) open_max / 2);
+    }
+    // each merged run needs at least a record of the buffer
+    es->fanin = MIN(MAX(es->fanin, 2), es->capacity);
+    es->length = es->count = 0;
+    es->io_error = false;
+    if (NULL == (es->buffer = malloc(es->budget))) {
+        set_malloc_error(error, es->budget);
+        return false;
+    }
+    darray_init(&es->runs, external_sort_run_close, sizeof(esr_t));
+
+    return true;
+}
+
+/**
+ * Free the memory used by an external sort and remove its temporary files
+ *
+ * @param es the external sort
+ *
+ * @note iterators created by external_sort_to_iterator have to be closed before
+ */
+void external_sort_destroy(ExternalSort *es)
+{
+    assert(NULL != es);
+
+    free(es->buffer);
+    es->buffer = NULL;
+    darray_destroy(&es->runs);
+}
+
+/**
+ * Sort the buffered records and write them as a new run
+ */
+static bool external_sort_spill(ExternalSort *es, char **error)
+{
+    esr_t run;
+
+    if (NULL == (run.fp = tmpfile())) {
+        set_system_error(error, "tmpfile(3) failed");
+        return false;
+    }
+    qsort(es->buffer, es->length, es->element_size, es->cmp);
+    if (es->length != fwrite(es->buffer, es->element_size, es->length, run.fp) || 0 != fflush(run.fp)) {
+        set_system_error(error, "failed to write %zu records to temporary file", es->length);
+        fclose(run.fp);
+        return false;
+    }
+    run.level = 0;
+    darray_push(&es->runs, &run);
+    es->length = 0;
+
+#ifndef WITHOUT_ITERATOR
+    return external_sort_cascade(es, error);
+#else
+    return true;
+#endif /* !WITHOUT_ITERATOR */
+}
+
+/**
+ * Add records to sort
+ *
+ * @param es the external sort
+ * @param records an array of *n* records
+ * @param n the number of records
+ * @param error
+ *
+ * @return `false` on error (temporary file creation, writing or reading
+ * back for an intermediate merge failed), in this case, the records of
+ * the current run, including the ones just pushed, are lost
+ *
+ * @note no record can be added once external_sort_to_iterator has been called
+ */
+bool external_sort_push_all(ExternalSort *es, const void *records, size_t n, char **error)
+{
+    size_t chunk;
+    const uint8_t *r;
+
+    assert(NULL != es);
+    assert(NULL != es->buffer);
+    assert(NULL != records || 0 == n);
+
+    r = (const uint8_t *) records;
+    while (n > 0) {
+        if (es->length == es->capacity && !external_sort_spill(es, error)) {
+            es->length = 0;
+            return false;
+        }
+        chunk = MIN(n, es->capacity - es->length);
+        memcpy(es->buffer + es->length * es->element_size, r, chunk * es->element_size);
+        es->length += chunk;
+        es->count += chunk;
+        r += chunk * es->element_size;
+        n -= chunk;
+    }
+
+    return true;
+}
+
+/**
+ * Add a record to sort
+ *
+ * @param es the external sort
+ * @param record the record to copy
+ * @param error
+ *
+ * @return `false` on error (see external_sort_push_all)
+ */
+bool external_sort_push(ExternalSort *es, const void *record, char **error)
+{
+    return external_sort_push_all(es, record, 1, error);
+}
+
+/**
+ * Get the number of records pushed so far
+ *
+ * @param es the external sort
+ *
+ * @return the number of records
+ */
+size_t external_sort_count(ExternalSort *es)
+{
+    assert(NULL != es);
+
+    return es->count;
+}
+
+/**
+ * Check if reading back a run failed
+ *
+ * @param es the external sort
+ *
+ * @return `true` if an iteration ended prematurely because of a read error
+ */
+bool external_sort_io_error(ExternalSort *es)
+{
+    assert(NULL != es);
+
+    return es->io_error;
+}
+
+#ifndef WITHOUT_ITERATOR
+typedef struct {
+    FILE *fp;
+    bool *io_error;
+    size_t element_size;
+    size_t capacity;
+    size_t length;
+    size_t position;
+    uint8_t *buffer;
+} rrs_t /*run_reader_state*/;
+
+static void run_iterator_fill(rrs_t *s)
+{
+    s->position = 0;
+    s->length = fread(s->buffer, s->element_size, s->capacity, s->fp);
+    if (s->length < s->capacity && ferror(s->fp)) {
+        *s->io_error = true;
+    }
+}
+
+static void run_iterator_first(const void *UNUSED(collection), void **state)
+{
+    rrs_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (rrs_t *) *state;
+    rewind(s->fp);
+    run_iterator_fill(s);
+}
+
+static void run_iterator_next(const void *UNUSED(collection), void **state)
+{
+    rrs_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (rrs_t *) *state;
+    if (++s->position >= s->length && s->length == s->capacity) {
+        run_iterator_fill(s);
+    }
+}
+
+static bool run_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    rrs_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (rrs_t *) *state;
+
+    return s->position < s->length;
+}
+
+static void run_iterator_current(const void *UNUSED(collection), void **state, void **UNUSED(key), void **value)
+{
+    rrs_t *s;
+
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    s = (rrs_t *) *state;
+    if (NULL != value) {
+        *value = s->buffer + s->position * s->element_size;
+    }
+}
+
+typedef struct {
+    Iterator merge;
+    Iterator sources[];
+} esms_t /*external_sort_merge_state*/;
+
+static void merge_iterator_first(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_first(&((esms_t *) *state)->merge);
+}
+
+static void merge_iterator_next(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_next(&((esms_t *) *state)->merge);
+}
+
+static bool merge_iterator_is_valid(const void *UNUSED(collection), void **state)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    return iterator_is_valid(&((esms_t *) *state)->merge, NULL, NULL);
+}
+
+static void merge_iterator_current(const void *UNUSED(collection), void **state, void **UNUSED(key), void **value)
+{
+    assert(NULL != state);
+    assert(NULL != *state);
+
+    iterator_is_valid(&((esms_t *) *state)->merge, NULL, value);
+}
+
+static void merge_iterator_close(void *state)
+{
+    assert(NULL != state);
+
+    // also closes the sources
+    iterator_close(&((esms_t *) state)->merge);
+    free(state);
+}
+
+/**
+ * Merge the runs [*from*;runs.length[, their read buffers sharing the
+ * (empty) buffer of the external sort
+ */
+static esms_t *external_sort_merge_new(ExternalSort *es, size_t from, char **error)
+{
+    esms_t *m;
+    Iterator **sources;
+    size_t i, n, capacity;
+
+    assert(0 == es->length);
+    assert(from < es->runs.length);
+
+    n = es->runs.length - from;
+    assert(n <= es->capacity);
+    capacity = es->capacity / n;
+    if (NULL == (m = malloc(sizeof(*m) + n * sizeof(*m->sources)))) {
+        set_malloc_error(error, sizeof(*m) + n * sizeof(*m->sources));
+        return NULL;
+    }
+    if (NULL == (sources = malloc(n * sizeof(*sources)))) {
+        set_malloc_error(error, n * sizeof(*sources));
+        free(m);
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        rrs_t *s;
+
+        if (NULL == (s = malloc(sizeof(*s)))) {
+            set_malloc_error(error, sizeof(*s));
+            while (i-- > 0) {
+                iterator_close(&m->sources[i]);
+            }
+            free(sources);
+            free(m);
+            return NULL;
+        }
+        s->fp = darray_at_unsafe(&es->runs, from + i, esr_t).fp;
+        s->io_error = &es->io_error;
+        s->element_size = es->element_size;
+        s->capacity = capacity;
+        s->length = s->position = 0;
+        s->buffer = es->buffer + i * capacity * es->element_size;
+        iterator_init(
+            &m->sources[i], es, s,
+            run_iterator_first, NULL,
+            run_iterator_current,
+            run_iterator_next, NULL,
+            run_iterator_is_valid,
+            free,
+            NULL, NULL, NULL
+        );
+        sources[i] = &m->sources[i];
+    }
+    iterator_merge(&m->merge, sources, n, es->cmp, NULL, NULL);
+    free(sources);
+
+    return m;
+}
+
+/**
+ * Replace the runs [*from*;runs.length[ by a single one
+ */
+static bool external_sort_merge_runs(ExternalSort *es, size_t from, char **error)
+{
+    bool ok;
+    void *record;
+    esms_t *m;
+    esr_t run;
+
+    if (NULL == (run.fp = tmpfile())) {
+        set_system_error(error, "tmpfile(3) failed");
+        return false;
+    }
+    if (NULL == (m = external_sort_merge_new(es, from, error))) {
+        fclose(run.fp);
+        return false;
+    }
+    ok = true;
+    for (iterator_first(&m->merge); ok && iterator_is_valid(&m->merge, NULL, &record); iterator_next(&m->merge)) {
+        ok = 1 == fwrite(record, es->element_size, 1, run.fp);
+    }
+    merge_iterator_close(m);
+    if (!ok || 0 != fflush(run.fp)) {
+        set_system_error(error, "failed to write merged runs to temporary file");
+        fclose(run.fp);
+        return false;
+    }
+    if (es->io_error) {
+        set_generic_error(error, "failed to read back a run to merge it");
+        fclose(run.fp);
+        return false;
+    }
+    // levels are non-increasing from the first run to the last
+    run.level = darray_at_unsafe(&es->runs, from, esr_t).level + 1;
+    // close the merged runs (the last ones)
+    darray_set_size(&es->runs, from);
+    darray_push(&es->runs, &run);
+
+    return true;
+}
+
+/**
+ * Merge runs until there are less of them than the fan-in
+ *
+ * The last runs of the same level (the most recent ones) are merged
+ * together. If the last run is the only one of its level, it is merged
+ * with the runs of the level below it.
+ */
+static bool external_sort_cascade(ExternalSort *es, char **error)
+{
+    size_t from, last;
+
+    while (es->runs.length >= es->fanin) {
+        last = es->runs.length - 1;
+        for (from = last; from > 0 && darray_at_unsafe(&es->runs, from - 1, esr_t).level == darray_at_unsafe(&es->runs, last, esr_t).level; from--)
+            ;
+        if (from == last) {
+            for (--from; from > 0 && darray_at_unsafe(&es->runs, from - 1, esr_t).level == darray_at_unsafe(&es->runs, last - 1, esr_t).level; from--)
+                ;
+        }
+        if (!external_sort_merge_runs(es, from, error)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Initialize an iterator which returns the sorted records
+ *
+ * If all the records fit in the budget, they are sorted and returned
+ * from memory. Else, the last run is spilled and the memory of the buffer
+ * is shared between the read buffers of the runs (less than the fan-in)
+ * which are merged by an iterator_merge.
+ *
+ * @param it the iterator to initialize
+ * @param es the external sort
+ * @param error
+ *
+ * @return `false` on error (spilling the last run or allocating the
+ * states of the readers failed)
+ *
+ * @note iterator directions: forward only
+ * @note there is no key
+ * @note the record returned by the iterator is only valid until the next move
+ * @note the iteration ends prematurely if a run can't be read back, check
+ * external_sort_io_error after the iteration
+ */
+bool external_sort_to_iterator(Iterator *it, ExternalSort *es, char **error)
+{
+    esms_t *m;
+
+    assert(NULL != it);
+    assert(NULL != es);
+
+    // everything holds in memory: no I/O at all
+    if (0 == es->runs.length) {
+        qsort(es->buffer, es->length, es->element_size, es->cmp);
+        array_to_iterator(it, es->buffer, es->element_size, es->length);
+        return true;
+    }
+    if (es->length > 0 && !external_sort_spill(es, error)) {
+        return false;
+    }
+    if (NULL == (m = external_sort_merge_new(es, 0, error))) {
+        return false;
+    }
+
+    iterator_init(
+        it, es, m,
+        merge_iterator_first, NULL,
+        merge_iterator_current,
+        merge_iterator_next, NULL,
+        merge_iterator_is_valid,
+        merge_iterator_close,
+        NULL, NULL, NULL
+    );
+
+    return true;
+}
+#endif /* !WITHOUT_ITERATOR */
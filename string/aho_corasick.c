@@ -0,0 +1,443 @@
+/**
+ * @file string/aho_corasick.c
+ * @brief search for many patterns at once in a single pass (Aho-Corasick)
+ *
+ * The patterns are first registered, each with an identifier of your
+ * choice, then compiled into an automaton which finds all their
+ * occurrences, overlapping or not, by reading each byte of the haystack
+ * only once, whatever the number of patterns.
+ *
+ * \code
+ *   AhoCorasick ac;
+ *
+ *   static bool on_match(size_t id, size_t offset, size_t length, void *data)
+ *   {
+ *       printf("pattern %zu found at [%zu;%zu[\n", id, offset, offset + length);
+ *
+ *       return true; // false to stop the search
+ *   }
+ *
+ *   aho_corasick_init(&ac, true);
+ *   aho_corasick_add(&ac, "he", STR_LEN("he"), 1, NULL);
+ *   aho_corasick_add(&ac, "she", STR_LEN("she"), 2, NULL);
+ *   aho_corasick_add(&ac, "hers", STR_LEN("hers"), 3, NULL);
+ *   if (aho_corasick_compile(&ac, &error)) {
+ *       // reports 2 at [1;4[, 1 at [2;4[ then 3 at [2;6[
+ *       aho_corasick_scan(&ac, "uSHErs", STR_LEN("uSHErs"), on_match, NULL);
+ *   }
+ *   aho_corasick_destroy(&ac);
+ * \endcode
+ *
+ * The automaton is a complete DFA (the failure links are resolved at
+ * compile time, so each byte costs exactly one transition) stored as a
+ * single dense table of 32 bits states. Its rows are indexed by byte
+ * classes instead of bytes: all the bytes which don't appear in any
+ * pattern (and, when case insensitive, the two cases of a letter) share
+ * the same class, which keeps rows short for real pattern sets.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "ascii.h"
+#include "error.h"
+#include "aho_corasick.h"
+
+#define NONE UINT32_MAX
+
+typedef struct {
+    size_t id;
+    size_t offset;
+    size_t length;
+} acp_t /*aho_corasick_pattern*/;
+
+/**
+ * Initialize a set of patterns
+ *
+ * @param ac the matcher to initialize
+ * @param case_insensitive `true` to ignore the case of ASCII letters
+ * (see ascii_tolower) in both patterns and haystacks
+ */
+void aho_corasick_init(AhoCorasick *ac, bool case_insensitive)
+{
+    assert(NULL != ac);
+
+    ac->compiled = false;
+    ac->case_insensitive = case_insensitive;
+    darray_init(&ac->patterns, NULL, sizeof(acp_t));
+    darray_init_custom(&ac->bytes, NULL, sizeof(char), 1024, 1024);
+    memset(ac->classes, 0, sizeof(ac->classes));
+    ac->classes_count = ac->states_count = 0;
+    ac->transitions = ac->outputs = ac->matches = ac->output_links = ac->next_same = NULL;
+}
+
+/**
+ * Free the memory used by a matcher
+ *
+ * @param ac the matcher
+ */
+void aho_corasick_destroy(AhoCorasick *ac)
+{
+    assert(NULL != ac);
+
+    darray_destroy(&ac->patterns);
+    darray_destroy(&ac->bytes);
+    free(ac->transitions);
+    free(ac->outputs);
+    free(ac->matches);
+    free(ac->output_links);
+    free(ac->next_same);
+    ac->transitions = ac->outputs = ac->matches = ac->output_links = ac->next_same = NULL;
+}
+
+/**
+ * Register a pattern to search for
+ *
+ * @param ac the matcher
+ * @param pattern the pattern (it is copied)
+ * @param pattern_len its length, in bytes
+ * @param id the identifier reported on matches of this pattern (several
+ * patterns may share the same identifier)
+ * @param error
+ *
+ * @return `false` if the pattern is empty or the matcher already compiled
+ */
+bool aho_corasick_add(AhoCorasick *ac, const char *pattern, size_t pattern_len, size_t id, char **error)
+{
+    acp_t p;
+
+    assert(NULL != ac);
+    assert(NULL != pattern || 0 == pattern_len);
+
+    if (ac->compiled) {
+        set_generic_error(error, "patterns can't be added once compiled");
+        return false;
+    }
+    if (0 == pattern_len) {
+        set_generic_error(error, "pattern #%zu is empty", id);
+        return false;
+    }
+    p.id = id;
+    p.offset = ac->bytes.length;
+    p.length = pattern_len;
+    darray_append_all(&ac->bytes, pattern, pattern_len);
+    darray_push(&ac->patterns, &p);
+
+    return true;
+}
+
+/**
+ * Get the number of registered patterns
+ *
+ * @param ac the matcher
+ *
+ * @return the number of patterns
+ */
+size_t aho_corasick_patterns_count(const AhoCorasick *ac)
+{
+    assert(NULL != ac);
+
+    return ac->patterns.length;
+}
+
+/**
+ * Build the automaton from the registered patterns
+ *
+ * @param ac the matcher
+ * @param error
+ *
+ * @return `false` on error (memory allocation failure or too many states)
+ */
+bool aho_corasick_compile(AhoCorasick *ac, char **error)
+{
+    acp_t *p;
+    uint32_t *fail, *queue;
+    size_t i, j, k, max_states, head, tail;
+
+    assert(NULL != ac);
+    assert(!ac->compiled);
+
+    // byte classes: 0 for bytes which are not part of any pattern
+    k = 1;
+    memset(ac->classes, 0, sizeof(ac->classes));
+    for (i = 0; i < ac->bytes.length; i++) {
+        int c;
+
+        c = (unsigned char) ac->bytes.data[i];
+        if (ac->case_insensitive) {
+            c = ascii_tolower(c);
+        }
+        if (0 == ac->classes[c]) {
+            ac->classes[c] = k++;
+        }
+    }
+    if (ac->case_insensitive) {
+        for (i = 0; i < ARRAY_SIZE(ac->classes); i++) {
+            ac->classes[i] = ac->classes[ascii_tolower((int) i)];
+        }
+    }
+    ac->classes_count = k;
+
+    // at worst, one state per byte of pattern plus the root
+    max_states = ac->bytes.length + 1;
+    if (max_states >= NONE) {
+        set_generic_error(error, "too many states (%zu)", max_states);
+        return false;
+    }
+    fail = queue = NULL;
+    if (NULL == (ac->transitions = calloc(max_states * k, sizeof(*ac->transitions)))) {
+        set_calloc_error(error, max_states * k, sizeof(*ac->transitions));
+        goto failure;
+    }
+    if (NULL == (ac->outputs = malloc(max_states * sizeof(*ac->outputs)))) {
+        set_malloc_error(error, max_states * sizeof(*ac->outputs));
+        goto failure;
+    }
+    if (NULL == (ac->matches = malloc(max_states * sizeof(*ac->matches)))) {
+        set_malloc_error(error, max_states * sizeof(*ac->matches));
+        goto failure;
+    }
+    if (NULL == (ac->output_links = malloc(max_states * sizeof(*ac->output_links)))) {
+        set_malloc_error(error, max_states * sizeof(*ac->output_links));
+        goto failure;
+    }
+    if (NULL == (ac->next_same = malloc(MAX(ac->patterns.length, 1) * sizeof(*ac->next_same)))) {
+        set_malloc_error(error, MAX(ac->patterns.length, 1) * sizeof(*ac->next_same));
+        goto failure;
+    }
+    if (NULL == (fail = malloc(max_states * sizeof(*fail)))) {
+        set_malloc_error(error, max_states * sizeof(*fail));
+        goto failure;
+    }
+    if (NULL == (queue = malloc(max_states * sizeof(*queue)))) {
+        set_malloc_error(error, max_states * sizeof(*queue));
+        goto failure;
+    }
+
+    // trie (0, the root, is never a child so it also stands for "no transition" until completion)
+    for (i = 0; i < max_states; i++) {
+        ac->outputs[i] = NONE;
+    }
+    ac->states_count = 1;
+    p = (acp_t *) ac->patterns.data;
+    // backward so that patterns ending on the same state are chained in their registration order
+    for (i = ac->patterns.length; i-- > 0; ) {
+        uint32_t s, *t;
+
+        s = 0;
+        for (j = 0; j < p[i].length; j++) {
+            t = &ac->transitions[s * k + ac->classes[(unsigned char) ac->bytes.data[p[i].offset + j]]];
+            if (0 == *t) {
+                *t = ac->states_count++;
+            }
+            s = *t;
+        }
+        ac->next_same[i] = ac->outputs[s];
+        ac->outputs[s] = i;
+    }
+
+    // breadth first traversal to set failure links and complete the transitions
+    head = tail = 0;
+    fail[0] = 0;
+    ac->matches[0] = ac->output_links[0] = NONE;
+    for (j = 0; j < k; j++) {
+        uint32_t t;
+
+        if (0 != (t = ac->transitions[j])) {
+            fail[t] = 0;
+            queue[tail++] = t;
+        }
+    }
+    while (head < tail) {
+        uint32_t s, f;
+
+        s = queue[head++];
+        f = fail[s];
+        // fail[s] is closer to the root than s, so its row is already complete
+        ac->output_links[s] = ac->matches[f];
+        ac->matches[s] = NONE != ac->outputs[s] ? s : ac->output_links[s];
+        for (j = 0; j < k; j++) {
+            uint32_t t;
+
+            if (0 == (t = ac->transitions[s * k + j])) {
+                ac->transitions[s * k + j] = ac->transitions[f * k + j];
+            } else {
+                fail[t] = ac->transitions[f * k + j];
+                queue[tail++] = t;
+            }
+        }
+    }
+    free(fail);
+    free(queue);
+
+    // give back what was reserved for states shared by common prefixes
+    if (ac->states_count < max_states) {
+        uint32_t *tmp;
+
+        if (NULL != (tmp = realloc(ac->transitions, ac->states_count * k * sizeof(*ac->transitions)))) {
+            ac->transitions = tmp;
+        }
+    }
+    darray_destroy(&ac->bytes);
+    ac->compiled = true;
+
+    return true;
+
+failure:
+    free(fail);
+    free(queue);
+    free(ac->transitions);
+    free(ac->outputs);
+    free(ac->matches);
+    free(ac->output_links);
+    free(ac->next_same);
+    ac->transitions = ac->outputs = ac->matches = ac->output_links = ac->next_same = NULL;
+
+    return false;
+}
+
+/**
+ * Initialize a search on a haystack which comes in several parts
+ *
+ * Matches which span over two (or more) consecutive parts are found, as
+ * if the parts had been concatenated, and offsets are relative to the
+ * start of the whole haystack.
+ *
+ * @param s the stream to initialize
+ * @param ac the compiled matcher (it must outlive the stream)
+ */
+void aho_corasick_stream_init(AhoCorasickStream *s, const AhoCorasick *ac)
+{
+    assert(NULL != s);
+    assert(NULL != ac);
+    assert(ac->compiled);
+
+    s->ac = ac;
+    s->state = 0;
+    s->offset = 0;
+}
+
+/**
+ * Restart a stream as if nothing had been fed to it
+ *
+ * @param s the stream
+ */
+void aho_corasick_stream_reset(AhoCorasickStream *s)
+{
+    assert(NULL != s);
+
+    s->state = 0;
+    s->offset = 0;
+}
+
+/**
+ * Search the next part of the haystack
+ *
+ * @param s the stream
+ * @param buffer the part of the haystack
+ * @param buffer_len its length, in bytes
+ * @param callback the function to call for each match with, in this
+ * order: the identifier of the pattern, the offset of its first byte
+ * (it may belong to a previous part), its length and *data*. If it
+ * returns `false`, the search stops (the remaining matches of this
+ * byte, if any, are not reported)
+ * @param data user data to pass to *callback*
+ *
+ * @return `false` if the search was stopped by *callback*
+ *
+ * @note matches are reported in the order of their end, for a same end,
+ * from the longest to the shortest pattern, then in the order patterns
+ * were added
+ */
+bool aho_corasick_stream_feed(AhoCorasickStream *s, const char *buffer, size_t buffer_len, AhoCorasickMatchFunc callback, void *data)
+{
+    size_t i, k;
+    uint32_t state;
+    const AhoCorasick *ac;
+    const uint32_t *transitions, *matches;
+
+    assert(NULL != s);
+    assert(NULL != callback);
+    assert(NULL != buffer || 0 == buffer_len);
+
+    ac = s->ac;
+    state = s->state;
+    k = ac->classes_count;
+    matches = ac->matches;
+    transitions = ac->transitions;
+    for (i = 0; i < buffer_len; i++) {
+        state = transitions[state * k + ac->classes[(unsigned char) buffer[i]]];
+        if (UNEXPECTED(NONE != matches[state])) {
+            uint32_t u, j;
+            const acp_t *p;
+
+            for (u = matches[state]; NONE != u; u = ac->output_links[u]) {
+                for (j = ac->outputs[u]; NONE != j; j = ac->next_same[j]) {
+                    p = &((const acp_t *) ac->patterns.data)[j];
+                    if (!callback(p->id, s->offset + i + 1 - p->length, p->length, data)) {
+                        s->state = state;
+                        s->offset += i + 1;
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    s->state = state;
+    s->offset += buffer_len;
+
+    return true;
+}
+
+/**
+ * Search all occurrences of the patterns in a haystack
+ *
+ * @param ac the compiled matcher
+ * @param haystack the string to search in
+ * @param haystack_len its length, in bytes
+ * @param callback the function to call for each match (see aho_corasick_stream_feed)
+ * @param data user data to pass to *callback*
+ *
+ * @return `false` if the search was stopped by *callback*
+ */
+bool aho_corasick_scan(const AhoCorasick *ac, const char *haystack, size_t haystack_len, AhoCorasickMatchFunc callback, void *data)
+{
+    AhoCorasickStream s;
+
+    aho_corasick_stream_init(&s, ac);
+
+    return aho_corasick_stream_feed(&s, haystack, haystack_len, callback, data);
+}
+
+/**
+ * Check if a haystack contains any of the patterns
+ *
+ * @param ac the compiled matcher
+ * @param haystack the string to search in
+ * @param haystack_len its length, in bytes
+ *
+ * @return `true` if at least one pattern was found
+ */
+bool aho_corasick_contains(const AhoCorasick *ac, const char *haystack, size_t haystack_len)
+{
+    size_t i, k;
+    uint32_t state;
+
+    assert(NULL != ac);
+    assert(ac->compiled);
+    assert(NULL != haystack || 0 == haystack_len);
+
+    state = 0;
+    k = ac->classes_count;
+    for (i = 0; i < haystack_len; i++) {
+        state = ac->transitions[state * k + ac->classes[(unsigned char) haystack[i]]];
+        if (NONE != ac->matches[state]) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -1,5 +1,10 @@
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "attributes.h"
 #include "utils.h"
+#include "simd.h"
 #include "ascii.h"
 
 static const unsigned char lower[] = {
@@ -60,56 +65,311 @@ int ascii_tolower(int c)
     return (int) lower[(unsigned char) c];
 }
 
-#if 1
-int ascii_memcasecmp(const char *str1, const char *str2, size_t n)
+
+/*
+ * Bulk functions work on blocks of 32 (AVX2), 16 (SSE2) or 8 (SWAR: a
+ * uint64_t) bytes at a time. The case of a whole block is changed by
+ * flipping the 0x20 bit of the bytes in the range [lo, lo + 25] ('a' to
+ * 'z' or 'A' to 'Z').
+ *
+ * The kernels share the same contract: they only process whole blocks
+ * and return the offset of the first byte of interest (a difference,
+ * an occurrence, ...) or, if none was found, the offset of the first
+ * byte they didn't process. So they can be chained, from the widest to
+ * the narrowest, and a byte by byte loop finishes the job.
+ */
+
+#define ONES UINT64_C(0x0101010101010101)
+#define HIGHS (ONES * 0x80)
+
+static inline uint64_t swar_load(const char *p)
 {
-    int c1, c2;
+    uint64_t w;
 
-    if (str1 != str2) {
-        while (0 != n--) {
-            c1 = ascii_toupper(*(unsigned char *) str1++);
-            c2 = ascii_toupper(*(unsigned char *) str2++);
-            if (c1 != c2) {
-                return c1 - c2;
-            }
+    memcpy(&w, p, sizeof(w));
+
+    return w;
+}
+
+static inline uint64_t swar_flip(uint64_t x, unsigned char lo)
+{
+    uint64_t y, in;
+
+    // no carry can cross a byte: the high bit of each byte is cleared then set back by the additions
+    y = x & ~HIGHS;
+    in = (y + ONES * (0x80 - lo)) & ~(y + ONES * (0x80 - lo - 26)) & ~x & HIGHS;
+
+    return x ^ (in >> 2);
+}
+
+static inline bool swar_has_zero(uint64_t x)
+{
+    return 0 != ((x - ONES) & ~x & HIGHS);
+}
+
+static size_t casecmp_swar(const char *str1, const char *str2, size_t n, bool nul)
+{
+    size_t i;
+    uint64_t a, b;
+
+    for (i = 0; i + sizeof(a) <= n; i += sizeof(a)) {
+        a = swar_load(str1 + i);
+        b = swar_load(str2 + i);
+        if (swar_flip(a, 'a') != swar_flip(b, 'a') || (nul && swar_has_zero(a))) {
+            break;
         }
     }
 
-    return 0;
+    return i;
+}
+
+static size_t casechr_swar(const char *str, int c, size_t n)
+{
+    size_t i;
+    uint64_t uc;
+
+    uc = ONES * (unsigned char) ascii_toupper(c);
+    for (i = 0; i + sizeof(uc) <= n; i += sizeof(uc)) {
+        if (swar_has_zero(swar_flip(swar_load(str + i), 'a') ^ uc)) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+static size_t convert_swar(char *str, size_t n, unsigned char lo)
+{
+    size_t i;
+    uint64_t w;
+
+    for (i = 0; i + sizeof(w) <= n; i += sizeof(w)) {
+        w = swar_flip(swar_load(str + i), lo);
+        memcpy(str + i, &w, sizeof(w));
+    }
+
+    return i;
+}
+
+#ifdef HAVE_X86_SIMD
+/*
+ * The string functions don't know the length of their arguments and
+ * read them by blocks as long as a block doesn't cross a page boundary:
+ * the bytes after the '\0' may not belong to the string but can't fault.
+ */
+# define MIN_PAGE_SIZE 4096
+# define PAGE_SAFE(p, width) \
+    ((((uintptr_t) (p)) & (MIN_PAGE_SIZE - 1)) <= MIN_PAGE_SIZE - (width))
+
+# define FULL_MASK(width) \
+    ((uint32_t) ((UINT64_C(1) << (width)) - 1))
+
+# define KERNELS(name, isa, vector, width, SET1, LOAD, STORE, CMPEQ, CMPGT, ADD, AND, XOR, MOVEMASK) \
+    static inline TARGET(isa) vector flip_## name(vector x, unsigned char lo) \
+    { \
+        /* lo <= x <= lo + 25 <=> x + 0x80 - lo < -128 + 26 (signed) */ \
+        return XOR(x, AND(CMPGT(SET1(-128 + 26), ADD(x, SET1((char) (0x80 - lo)))), SET1(0x20))); \
+    } \
+ \
+    static inline TARGET(isa) uint32_t casediff_## name(vector a, vector b, bool nul) \
+    { \
+        uint32_t mask; \
+ \
+        mask = ~((uint32_t) MOVEMASK(CMPEQ(flip_## name(a, 'a'), flip_## name(b, 'a')))) & FULL_MASK(width); \
+        if (nul) { \
+            mask |= (uint32_t) MOVEMASK(CMPEQ(a, SET1(0))); \
+        } \
+ \
+        return mask; \
+    } \
+ \
+    static TARGET(isa) size_t casecmp_## name(const char *str1, const char *str2, size_t n, bool nul) \
+    { \
+        size_t i; \
+        uint32_t mask; \
+ \
+        for (i = 0; i + width <= n; i += width) { \
+            if (0 != (mask = casediff_## name(LOAD(str1 + i), LOAD(str2 + i), nul))) { \
+                return i + __builtin_ctz(mask); \
+            } \
+        } \
+ \
+        return i; \
+    } \
+ \
+    /* unlike the others, returns n if nothing was found */ \
+    static NO_SANITIZE_ADDRESS TARGET(isa) size_t strcasecmp_## name(const char *str1, const char *str2, size_t n) \
+    { \
+        size_t i; \
+        uint32_t mask; \
+ \
+        for (i = 0; i < n; ) { \
+            if (i + width <= n && PAGE_SAFE(str1 + i, width) && PAGE_SAFE(str2 + i, width)) { \
+                if (0 != (mask = casediff_## name(LOAD(str1 + i), LOAD(str2 + i), true))) { \
+                    return i + __builtin_ctz(mask); \
+                } \
+                i += width; \
+            } else if ('\0' == str1[i] || ascii_toupper(str1[i]) != ascii_toupper(str2[i])) { \
+                return i; \
+            } else { \
+                ++i; \
+            } \
+        } \
+ \
+        return n; \
+    } \
+ \
+    static TARGET(isa) size_t casechr_## name(const char *str, int c, size_t n) \
+    { \
+        size_t i; \
+        vector uc; \
+        uint32_t mask; \
+ \
+        uc = SET1((char) ascii_toupper(c)); \
+        for (i = 0; i + width <= n; i += width) { \
+            if (0 != (mask = (uint32_t) MOVEMASK(CMPEQ(flip_## name(LOAD(str + i), 'a'), uc)))) { \
+                return i + __builtin_ctz(mask); \
+            } \
+        } \
+ \
+        return i; \
+    } \
+ \
+    /* positions are filtered on their first and last bytes then the ones in between are compared */ \
+    static TARGET(isa) size_t casestr_## name(const char *haystack, size_t n, const char *needle, size_t m) \
+    { \
+        size_t i; \
+        uint32_t mask; \
+        vector first, last; \
+ \
+        first = SET1((char) ascii_toupper(needle[0])); \
+        last = SET1((char) ascii_toupper(needle[m - 1])); \
+        for (i = 0; i + m - 1 + width <= n; i += width) { \
+            mask = (uint32_t) MOVEMASK(AND( \
+                CMPEQ(flip_## name(LOAD(haystack + i), 'a'), first), \
+                CMPEQ(flip_## name(LOAD(haystack + i + m - 1), 'a'), last) \
+            )); \
+            while (0 != mask) { \
+                size_t bit; \
+ \
+                bit = __builtin_ctz(mask); \
+                if (m <= 2 || 0 == ascii_memcasecmp(haystack + i + bit + 1, needle + 1, m - 2)) { \
+                    return i + bit; \
+                } \
+                mask &= mask - 1; \
+            } \
+        } \
+ \
+        return i; \
+    } \
+ \
+    static TARGET(isa) size_t convert_## name(char *str, size_t n, unsigned char lo) \
+    { \
+        size_t i; \
+ \
+        for (i = 0; i + width <= n; i += width) { \
+            STORE(str + i, flip_## name(LOAD(str + i), lo)); \
+        } \
+ \
+        return i; \
+    }
+
+# define LOAD_SSE2(p) _mm_loadu_si128((const __m128i *) (const void *) (p))
+# define LOAD_AVX2(p) _mm256_loadu_si256((const __m256i *) (const void *) (p))
+# define STORE_SSE2(p, x) _mm_storeu_si128((__m128i *) (void *) (p), (x))
+# define STORE_AVX2(p, x) _mm256_storeu_si256((__m256i *) (void *) (p), (x))
+
+KERNELS(sse2, "sse2", __m128i, 16, _mm_set1_epi8, LOAD_SSE2, STORE_SSE2, _mm_cmpeq_epi8, _mm_cmpgt_epi8, _mm_add_epi8, _mm_and_si128, _mm_xor_si128, _mm_movemask_epi8)
+KERNELS(avx2, "avx2", __m256i, 32, _mm256_set1_epi8, LOAD_AVX2, STORE_AVX2, _mm256_cmpeq_epi8, _mm256_cmpgt_epi8, _mm256_add_epi8, _mm256_and_si256, _mm256_xor_si256, _mm256_movemask_epi8)
+
+# undef KERNELS
+#endif /* HAVE_X86_SIMD */
+
+static size_t casecmp_blocks(const char *str1, const char *str2, size_t n, bool nul)
+{
+    size_t i;
+
+    i = 0;
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_AVX2()) {
+        i = casecmp_avx2(str1, str2, n, nul);
+    }
+    if (CPU_HAS_SSE2()) {
+        i += casecmp_sse2(str1 + i, str2 + i, n - i, nul);
+    }
+#endif /* HAVE_X86_SIMD */
+
+    return i + casecmp_swar(str1 + i, str2 + i, n - i, nul);
+}
+
+/*
+ * Offset of the first difference (case aside) or '\0' of str1 in the n
+ * first bytes of '\0'-terminated strings, n if there is none.
+ */
+static size_t strcasecmp_blocks(const char *str1, const char *str2, size_t n)
+{
+    size_t i;
+
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_AVX2()) {
+        return strcasecmp_avx2(str1, str2, n);
+    } else if (CPU_HAS_SSE2()) {
+        return strcasecmp_sse2(str1, str2, n);
+    }
+#endif /* HAVE_X86_SIMD */
+    for (i = 0; i < n; i++) {
+        if ('\0' == str1[i] || ascii_toupper(str1[i]) != ascii_toupper(str2[i])) {
+            break;
+        }
+    }
+
+    return i;
 }
-#else
+
+static size_t convert_blocks(char *str, size_t n, unsigned char lo)
+{
+    size_t i;
+
+    i = 0;
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_AVX2()) {
+        i = convert_avx2(str, n, lo);
+    }
+    if (CPU_HAS_SSE2()) {
+        i += convert_sse2(str + i, n - i, lo);
+    }
+#endif /* HAVE_X86_SIMD */
+
+    return i + convert_swar(str + i, n - i, lo);
+}
+
 int ascii_memcasecmp(const char *str1, const char *str2, size_t n)
 {
-    if (str1 != str2) {
-        for (; 0 != n; n--) {
-            int c1, c2;
+    size_t i;
+    int c1, c2;
 
-            c1 = ascii_toupper(*(unsigned char *) str1++);
-            c2 = ascii_toupper(*(unsigned char *) str2++);
+    if (str1 != str2) {
+        for (i = casecmp_blocks(str1, str2, n, false); i < n; i++) {
+            c1 = ascii_toupper(str1[i]);
+            c2 = ascii_toupper(str2[i]);
             if (c1 != c2) {
-                return (unsigned char) c1 - (unsigned char) c2;
+                return c1 - c2;
             }
         }
     }
 
     return 0;
 }
-#endif
 
 int ascii_strcasecmp(const char *str1, const char *str2)
 {
-    int c1, c2;
+    size_t i;
 
     if (str1 != str2) {
-        do {
-            if ('\0' == *str1) {
-                return 0;
-            }
-            c1 = ascii_toupper(*(unsigned char *) str1++);
-            c2 = ascii_toupper(*(unsigned char *) str2++);
-        } while (c1 == c2);
-
-        return c1 - c2;
+        i = strcasecmp_blocks(str1, str2, SIZE_MAX);
+        if ('\0' != str1[i]) {
+            return ascii_toupper(str1[i]) - ascii_toupper(str2[i]);
+        }
     }
 
     return 0;
@@ -119,23 +379,10 @@ int ascii_strcasecmp_l(
     const char *str1, size_t str1_len,
     const char *str2, size_t str2_len
 ) {
-    int c1, c2;
-
-    if (str1 != str2) {
-        size_t min_len;
+    int ret;
 
-        if (str2_len < str1_len) {
-            min_len = str2_len;
-        } else {
-            min_len = str1_len;
-        }
-        while (0 != min_len--) {
-            c1 = ascii_toupper(*(unsigned char *) str1++);
-            c2 = ascii_toupper(*(unsigned char *) str2++);
-            if (c1 != c2) {
-                return c1 - c2;
-            }
-        }
+    if (str1 != str2 && 0 != (ret = ascii_memcasecmp(str1, str2, MIN(str1_len, str2_len)))) {
+        return ret;
     }
 
     return str1_len - str2_len;
@@ -143,18 +390,13 @@ int ascii_strcasecmp_l(
 
 int ascii_strncasecmp(const char *str1, const char *str2, size_t n)
 {
-    int c1, c2;
+    size_t i;
 
     if (str1 != str2 && n > 0) {
-        do {
-            if ('\0' == *str1) {
-                return 0;
-            }
-            c1 = ascii_toupper(*(unsigned char *) str1++);
-            c2 = ascii_toupper(*(unsigned char *) str2++);
-        } while (c1 == c2 && 0 != --n);
-
-        return (unsigned char) c1 - (unsigned char) c2;
+        i = strcasecmp_blocks(str1, str2, n);
+        if (i < n && '\0' != str1[i]) {
+            return ascii_toupper(str1[i]) - ascii_toupper(str2[i]);
+        }
     }
 
     return 0;
@@ -165,21 +407,18 @@ int ascii_strncasecmp_l(
     const char *str2, size_t str2_len,
     size_t n
 ) {
-    int c1, c2;
+    size_t i, min_len;
 
     if (str1 != str2 && n > 0) {
-        size_t min_len;
-
-        min_len =  MIN(n, MIN(str1_len, str2_len));
-        do {
-            if ('\0' == *str1) {
-                return 0;
+        min_len = MIN(n, MIN(str1_len, str2_len));
+        for (i = casecmp_blocks(str1, str2, min_len, true); i < min_len; i++) {
+            if ('\0' == str1[i]) {
+                break;
             }
-            c1 = ascii_toupper(*(unsigned char *) str1++);
-            c2 = ascii_toupper(*(unsigned char *) str2++);
-        } while (c1 == c2 && 0 != --min_len);
-
-        return (unsigned char) c1 - (unsigned char) c2;
+            if (ascii_toupper(str1[i]) != ascii_toupper(str2[i])) {
+                return ascii_toupper(str1[i]) - ascii_toupper(str2[i]);
+            }
+        }
     }
 
     return 0;
@@ -187,13 +426,107 @@ int ascii_strncasecmp_l(
 
 char *ascii_memcasechr(const char *str, int c, size_t n)
 {
+    size_t i;
     int uc;
 
-    for (uc = ascii_toupper((unsigned char) c); 0 != n; n--, str++) {
-        if (uc == ascii_toupper(*(const unsigned char *) str)) {
-            return (char *) str;
+    i = 0;
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_AVX2()) {
+        i = casechr_avx2(str, c, n);
+    }
+    if (CPU_HAS_SSE2()) {
+        i += casechr_sse2(str + i, c, n - i);
+    }
+#endif /* HAVE_X86_SIMD */
+    i += casechr_swar(str + i, c, n - i);
+    for (uc = ascii_toupper(c); i < n; i++) {
+        if (uc == ascii_toupper(str[i])) {
+            return (char *) str + i;
         }
     }
 
     return NULL;
 }
+
+/**
+ * Find the first occurrence of a string in an other one, ignoring
+ * the case of ASCII letters
+ *
+ * @param haystack the string to search in
+ * @param haystack_len the length of *haystack*
+ * @param needle the substring to look for
+ * @param needle_len the length of *needle*
+ *
+ * @return a pointer to the first match found of *needle* in *haystack* else `NULL` if not found
+ *
+ * @note it is intended for short needles: in the worst case (a lot of
+ * partial matches), the search is in O(haystack_len * needle_len)
+ */
+char *ascii_memcasestr(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len)
+{
+    size_t i;
+    const char *p, *l;
+
+    if (0 == needle_len) {
+        return (char *) haystack;
+    }
+    if (needle_len > haystack_len) {
+        return NULL;
+    }
+    i = 0;
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_AVX2()) {
+        i = casestr_avx2(haystack, haystack_len, needle, needle_len);
+    }
+    if (CPU_HAS_SSE2()) {
+        i += casestr_sse2(haystack + i, haystack_len - i, needle, needle_len);
+    }
+#endif /* HAVE_X86_SIMD */
+    // the remaining positions: jump from a first byte to the next one
+    l = haystack + haystack_len - needle_len; // last possible position to find a match
+    for (p = haystack + i; p <= l && NULL != (p = ascii_memcasechr(p, needle[0], l - p + 1)); p++) {
+        if (0 == ascii_memcasecmp(p + 1, needle + 1, needle_len - 1)) {
+            return (char *) p;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Convert, in place, the ASCII uppercase letters of a string to lowercase
+ *
+ * @param str the string to modify
+ * @param str_len its length
+ *
+ * @return *str*
+ */
+char *ascii_str_tolower(char *str, size_t str_len)
+{
+    size_t i;
+
+    for (i = convert_blocks(str, str_len, 'A'); i < str_len; i++) {
+        str[i] = ascii_tolower(str[i]);
+    }
+
+    return str;
+}
+
+/**
+ * Convert, in place, the ASCII lowercase letters of a string to uppercase
+ *
+ * @param str the string to modify
+ * @param str_len its length
+ *
+ * @return *str*
+ */
+char *ascii_str_toupper(char *str, size_t str_len)
+{
+    size_t i;
+
+    for (i = convert_blocks(str, str_len, 'a'); i < str_len; i++) {
+        str[i] = ascii_toupper(str[i]);
+    }
+
+    return str;
+}
@@ -0,0 +1,418 @@
+/**
+ * @file string/csv.c
+ * @brief columnar parsing of delimited (CSV, TSV...) numeric text
+ *
+ * A CsvBatch is given a schema (the type of each column) and parses a
+ * whole buffer at once, straight into a DArray per column: the numbers
+ * are read by the strnto* functions where they lie, in a single pass, and
+ * the delimiter is just expected where they end.
+ *
+ * \code
+ *   size_t i;
+ *   CsvBatch batch;
+ *   CsvColumnType schema[] = { CSV_INT64, CSV_SPAN, CSV_DOUBLE };
+ *
+ *   if (!csv_batch_init(&batch, ',', true, schema, ARRAY_SIZE(schema), &error)) {
+ *       // ...
+ *   }
+ *   if (!csv_batch_parse_parallel(&batch, buffer, buffer_len, 0)) {
+ *       for (i = 0; i < batch.errors.length; i++) {
+ *           CsvCellError *e;
+ *
+ *           e = &darray_at_unsafe(&batch.errors, i, CsvCellError);
+ *           fprintf(stderr, "row %zu, column %zu (offset %zu): error %d\n", e->row, e->column, e->offset, e->error);
+ *       }
+ *   }
+ *   for (i = 0; i < batch.rows; i++) {
+ *       int64_t id;
+ *       double amount;
+ *
+ *       id = darray_at_unsafe(csv_batch_column(&batch, 0), i, int64_t);
+ *       amount = darray_at_unsafe(csv_batch_column(&batch, 2), i, double);
+ *       // ...
+ *   }
+ *   csv_batch_destroy(&batch);
+ * \endcode
+ *
+ * Format:
+ * - lines end by "\n" or "\r\n" (the last one may be unterminated), empty lines are ignored
+ * - fields are separated by a single byte and are not trimmed
+ * - integers are in base 10, with an optional sign
+ * - quoting is not supported: the delimiter can't appear inside a field
+ *
+ * Each column always gets a value for each row, to keep them aligned. A
+ * cell in error is stored as 0 (or an empty span) and described in the
+ * errors (a DArray of CsvCellError) by its row, its column, the offset in
+ * the buffer of the faulty byte (the beginning of the cell if the whole
+ * cell is wrong) and a ParseNumError:
+ * - PARSE_NUM_ERR_NO_DIGIT_FOUND: empty cell or missing cell (the line has less fields than the schema)
+ * - PARSE_NUM_ERR_NON_DIGIT_FOUND: unexpected character (eg "x1" or "1x", in any numeric column)
+ * - PARSE_NUM_ERR_TOO_SMALL, PARSE_NUM_ERR_TOO_LARGE: the number doesn't fit in 64 bits
+ *   (a negative number in a CSV_UINT64 column is PARSE_NUM_ERR_TOO_SMALL)
+ *
+ * Fields beyond the schema are ignored.
+ *
+ * @note CSV_SPAN columns hold StrSpan which point into the parsed buffer:
+ * it has to outlive them
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "csv.h"
+#include "str_split.h"
+#include "error.h"
+
+/* below this size, a chunk is not worth a thread */
+#define CSV_MIN_CHUNK_SIZE (64 * 1024)
+
+static const size_t element_sizes[] = {
+    [ CSV_INT64 ] = sizeof(int64_t),
+    [ CSV_UINT64 ] = sizeof(uint64_t),
+    [ CSV_DOUBLE ] = sizeof(double),
+    [ CSV_SPAN ] = sizeof(StrSpan),
+    [ CSV_SKIP ] = 0,
+};
+
+/**
+ * Initialize a batch
+ *
+ * @param batch the batch to initialize
+ * @param delimiter the byte which separates the fields
+ * @param header `true` to skip the first line of the first parsed buffer
+ * @param schema the type of each column
+ * @param columns_count the number of elements of *schema* (0 to only count the rows)
+ * @param error the error to set if the initialization fails (columns can't be allocated)
+ *
+ * @return `false` on failure
+ */
+bool csv_batch_init(CsvBatch *batch, char delimiter, bool header, const CsvColumnType *schema, size_t columns_count, char **error)
+{
+    size_t i;
+
+    assert(NULL != batch);
+    assert(NULL != schema || 0 == columns_count);
+
+    batch->rows = 0;
+    batch->header = header;
+    batch->delimiter = delimiter;
+    batch->columns_count = columns_count;
+    batch->columns = NULL;
+    if (0 != columns_count && NULL == (batch->columns = malloc(sizeof(*batch->columns) * columns_count))) {
+        set_malloc_error(error, sizeof(*batch->columns) * columns_count);
+        return false;
+    }
+    for (i = 0; i < columns_count; i++) {
+        assert(schema[i] >= CSV_INT64 && schema[i] <= CSV_SKIP);
+        batch->columns[i].type = schema[i];
+        if (CSV_SKIP != schema[i]) {
+            darray_init(&batch->columns[i].values, NULL, element_sizes[schema[i]]);
+        }
+    }
+    darray_init(&batch->errors, NULL, sizeof(CsvCellError));
+
+    return true;
+}
+
+/**
+ * Free memory used by a batch
+ *
+ * @param batch the batch to free
+ */
+void csv_batch_destroy(CsvBatch *batch)
+{
+    size_t i;
+
+    assert(NULL != batch);
+
+    for (i = 0; i < batch->columns_count; i++) {
+        if (CSV_SKIP != batch->columns[i].type) {
+            darray_destroy(&batch->columns[i].values);
+        }
+    }
+    free(batch->columns);
+    darray_destroy(&batch->errors);
+}
+
+static inline void csv_cell_error(CsvBatch *batch, size_t column, const char *buffer, const char *position, ParseNumError err)
+{
+    CsvCellError e;
+
+    e.row = batch->rows;
+    e.column = column;
+    e.offset = position - buffer;
+    e.error = err;
+    darray_append(&batch->errors, &e);
+}
+
+/* parses the lines in [from ; to[, offsets are relative to buffer */
+static void csv_parse_lines(CsvBatch *batch, const char *buffer, const char *from, const char * const to)
+{
+    size_t i;
+    char *endptr;
+    const char *p, *line, *line_end, *newline;
+
+    for (line = from; line < to; line = newline + 1) {
+        if (NULL == (newline = memchr(line, '\n', to - line))) {
+            newline = to;
+        }
+        line_end = newline;
+        if (line_end > line && '\r' == line_end[-1]) {
+            --line_end;
+        }
+        if (line_end == line) {
+            continue;
+        }
+        if (batch->header) {
+            batch->header = false;
+            continue;
+        }
+        p = line;
+        for (i = 0; i < batch->columns_count; i++) {
+            CsvColumn *column;
+            ParseNumError err;
+            union {
+                int64_t i64;
+                uint64_t u64;
+                double d;
+                StrSpan span;
+            } value;
+
+            column = &batch->columns[i];
+            // the previous field was the last one of the line
+            if (p > line_end) {
+                if (CSV_SKIP != column->type) {
+                    memset(&value, 0, sizeof(value));
+                    if (CSV_SPAN == column->type) {
+                        value.span.ptr = line_end;
+                    }
+                    darray_append(&column->values, &value);
+                    csv_cell_error(batch, i, buffer, line_end, PARSE_NUM_ERR_NO_DIGIT_FOUND);
+                }
+                continue;
+            }
+            switch (column->type) {
+                case CSV_SPAN:
+                case CSV_SKIP:
+                    if (NULL == (endptr = memchr(p, batch->delimiter, line_end - p))) {
+                        endptr = (char *) line_end;
+                    }
+                    if (CSV_SPAN == column->type) {
+                        value.span.ptr = p;
+                        value.span.len = endptr - p;
+                        darray_append(&column->values, &value);
+                    }
+                    p = endptr + 1;
+                    continue;
+                case CSV_INT64:
+                    err = strntoint64_t(p, line_end, &endptr, 10, NULL, NULL, &value.i64);
+                    break;
+                case CSV_UINT64:
+                    err = strntouint64_t(p, line_end, &endptr, 10, NULL, NULL, &value.u64);
+                    // strntouint64_t, as strtoull, negates the value
+                    if ('-' == *p && (PARSE_NUM_NO_ERR == err || PARSE_NUM_ERR_NON_DIGIT_FOUND == err) && 0 != value.u64) {
+                        err = PARSE_NUM_ERR_TOO_SMALL;
+                    }
+                    break;
+                case CSV_DOUBLE:
+                    err = strntodouble(p, line_end, &endptr, NULL, NULL, &value.d);
+                    // no number but the cell is not empty (eg "x1"): as for integers, the first byte which can't be part of one is at fault
+                    if (PARSE_NUM_ERR_NO_DIGIT_FOUND == err && endptr < line_end && batch->delimiter != *endptr) {
+                        err = PARSE_NUM_ERR_NON_DIGIT_FOUND;
+                    }
+                    break;
+                default:
+                    assert(false);
+                    return;
+            }
+            // stopping on the delimiter is the expected end of a number (if there is at least a digit before it)
+            if (PARSE_NUM_ERR_NON_DIGIT_FOUND == err && endptr < line_end && batch->delimiter == *endptr) {
+                if (CSV_DOUBLE == column->type || (endptr > p && endptr[-1] >= '0' && endptr[-1] <= '9')) {
+                    err = PARSE_NUM_NO_ERR;
+                } else {
+                    err = PARSE_NUM_ERR_NO_DIGIT_FOUND;
+                }
+            }
+            if (PARSE_NUM_NO_ERR != err) {
+                csv_cell_error(batch, i, buffer, PARSE_NUM_ERR_NON_DIGIT_FOUND == err ? endptr : p, err);
+                memset(&value, 0, sizeof(value));
+                if (endptr < line_end && batch->delimiter != *endptr) {
+                    if (NULL == (endptr = memchr(endptr, batch->delimiter, line_end - endptr))) {
+                        endptr = (char *) line_end;
+                    }
+                }
+            }
+            darray_append(&column->values, &value);
+            p = endptr + 1;
+        }
+        ++batch->rows;
+    }
+}
+
+/**
+ * Parse a buffer and append its rows to the columns
+ *
+ * Can be called several times to parse a file buffer after buffer as
+ * long as each of them ends on a line boundary.
+ *
+ * @param batch the batch
+ * @param buffer the text to parse
+ * @param buffer_len the length of *buffer*
+ *
+ * @return `false` if at least an error was found in *buffer* (see batch->errors)
+ */
+bool csv_batch_parse(CsvBatch *batch, const char *buffer, size_t buffer_len)
+{
+    size_t errors_count;
+
+    assert(NULL != batch);
+    assert(NULL != buffer || 0 == buffer_len);
+
+    errors_count = batch->errors.length;
+    csv_parse_lines(batch, buffer, buffer, buffer + buffer_len);
+
+    return errors_count == batch->errors.length;
+}
+
+typedef struct {
+    CsvBatch *batch;
+    const char *buffer;
+    const char *from;
+    const char *to;
+    bool threaded;
+} cpw_t /*csv_parse_worker*/;
+
+static void *csv_parse_worker(void *arg)
+{
+    cpw_t *w;
+
+    w = (cpw_t *) arg;
+    csv_parse_lines(w->batch, w->buffer, w->from, w->to);
+
+    return NULL;
+}
+
+/**
+ * Parse a buffer, as csv_batch_parse, but with several threads: the buffer
+ * is split in chunks, on line boundaries, parsed into separate columns
+ * then appended, in order, to those of the batch
+ *
+ * @param batch the batch
+ * @param buffer the text to parse
+ * @param buffer_len the length of *buffer*
+ * @param nthreads the maximum number of threads to use (0 for the number of online
+ * processors). Less are used for small buffers.
+ *
+ * @return `false` if at least an error was found in *buffer* (see batch->errors)
+ *
+ * @note if memory or threads can't be allocated, the buffer (or the chunks
+ * concerned) is parsed by the current thread
+ */
+bool csv_batch_parse_parallel(CsvBatch *batch, const char *buffer, size_t buffer_len, size_t nthreads)
+{
+    size_t i, j, c, errors_count;
+    const char *from;
+    cpw_t *workers;
+    pthread_t *threads;
+    CsvBatch *batches;
+    CsvColumnType *schema;
+
+    assert(NULL != batch);
+    assert(NULL != buffer || 0 == buffer_len);
+
+    if (0 == nthreads) {
+        long online;
+
+        online = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = online > 0 ? (size_t) online : 1;
+    }
+    nthreads = MIN(nthreads, buffer_len / CSV_MIN_CHUNK_SIZE);
+    if (nthreads < 2) {
+        return csv_batch_parse(batch, buffer, buffer_len);
+    }
+    errors_count = batch->errors.length;
+    workers = malloc(sizeof(*workers) * nthreads);
+    threads = malloc(sizeof(*threads) * nthreads);
+    batches = malloc(sizeof(*batches) * nthreads);
+    schema = 0 == batch->columns_count ? NULL : malloc(sizeof(*schema) * batch->columns_count);
+    if (NULL == workers || NULL == threads || NULL == batches || (NULL == schema && 0 != batch->columns_count)) {
+        free(workers);
+        free(threads);
+        free(batches);
+        free(schema);
+        return csv_batch_parse(batch, buffer, buffer_len);
+    }
+    for (c = 0; c < batch->columns_count; c++) {
+        schema[c] = batch->columns[c].type;
+    }
+    // the first chunk is parsed by the current thread, directly into the batch
+    from = buffer;
+    for (i = 0; i < nthreads; i++) {
+        const char *to;
+
+        if (i == nthreads - 1) {
+            to = buffer + buffer_len;
+        } else {
+            to = buffer + buffer_len / nthreads * (i + 1);
+            if (to < from) {
+                to = from;
+            }
+            if (NULL == (to = memchr(to, '\n', buffer + buffer_len - to))) {
+                to = buffer + buffer_len;
+            } else {
+                ++to;
+            }
+        }
+        workers[i].batch = 0 == i ? batch : &batches[i];
+        workers[i].buffer = buffer;
+        workers[i].from = from;
+        workers[i].to = to;
+        workers[i].threaded = false;
+        from = to;
+    }
+    for (i = 1; i < nthreads; i++) {
+        if (csv_batch_init(&batches[i], batch->delimiter, false, schema, batch->columns_count, NULL)) {
+            workers[i].threaded = 0 == pthread_create(&threads[i], NULL, csv_parse_worker, &workers[i]);
+            if (!workers[i].threaded) {
+                csv_batch_destroy(&batches[i]);
+            }
+        }
+        // without a thread, the chunk is parsed later by the current thread, in order
+        if (!workers[i].threaded) {
+            workers[i].batch = batch;
+        }
+    }
+    csv_parse_worker(&workers[0]);
+    for (i = 1; i < nthreads; i++) {
+        CsvBatch *b;
+
+        if (!workers[i].threaded) {
+            csv_parse_worker(&workers[i]);
+            continue;
+        }
+        pthread_join(threads[i], NULL);
+        b = workers[i].batch;
+        for (c = 0; c < batch->columns_count; c++) {
+            if (CSV_SKIP != batch->columns[c].type) {
+                darray_append_all(&batch->columns[c].values, b->columns[c].values.data, b->columns[c].values.length);
+            }
+        }
+        for (j = 0; j < b->errors.length; j++) {
+            darray_at_unsafe(&b->errors, j, CsvCellError).row += batch->rows;
+        }
+        darray_append_all(&batch->errors, b->errors.data, b->errors.length);
+        batch->rows += b->rows;
+        csv_batch_destroy(b);
+    }
+    free(workers);
+    free(threads);
+    free(batches);
+    free(schema);
+
+    return errors_count == batch->errors.length;
+}
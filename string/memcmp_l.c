@@ -1,4 +1,134 @@
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "simd.h"
+#include "memcmp_l.h"
+
+/*
+ * The first difference is searched 32 (AVX2), 16 (SSE2) or 8 (a
+ * uint64_t) bytes at a time: the bytes of a block are compared all at
+ * once and the offset of the first different one is given by the
+ * position of the lowest bit set in the resulting mask. Each kernel
+ * returns this offset or, if the blocks are all equal, the offset of
+ * the first byte it didn't compare so the narrower one picks up from
+ * there.
+ */
+
+#ifdef HAVE_X86_SIMD
+# define MISMATCH(name, isa, vector, width, LOAD, CMPEQ, MOVEMASK) \
+    static TARGET(isa) size_t mismatch_## name(const char *str1, const char *str2, size_t n) \
+    { \
+        size_t i; \
+        uint32_t mask; \
+ \
+        for (i = 0; i + width <= n; i += width) { \
+            mask = ~((uint32_t) MOVEMASK(CMPEQ(LOAD(str1 + i), LOAD(str2 + i)))) & (uint32_t) ((UINT64_C(1) << width) - 1); \
+            if (0 != mask) { \
+                return i + __builtin_ctz(mask); \
+            } \
+        } \
+ \
+        return i; \
+    }
+
+# define LOAD_SSE2(p) _mm_loadu_si128((const __m128i *) (const void *) (p))
+# define LOAD_AVX2(p) _mm256_loadu_si256((const __m256i *) (const void *) (p))
+
+MISMATCH(sse2, "sse2", __m128i, 16, LOAD_SSE2, _mm_cmpeq_epi8, _mm_movemask_epi8)
+MISMATCH(avx2, "avx2", __m256i, 32, LOAD_AVX2, _mm256_cmpeq_epi8, _mm256_movemask_epi8)
+
+# undef MISMATCH
+#endif /* HAVE_X86_SIMD */
+
+static size_t mismatch_swar(const char *str1, const char *str2, size_t n)
+{
+    size_t i;
+    uint64_t a, b;
+
+    for (i = 0; i + sizeof(a) <= n; i += sizeof(a)) {
+        memcpy(&a, str1 + i, sizeof(a));
+        memcpy(&b, str2 + i, sizeof(b));
+        if (a != b) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && __has_builtin(__builtin_ctzll)
+            return i + __builtin_ctzll(a ^ b) / 8;
+#else
+            break;
+#endif
+        }
+    }
+
+    return i;
+}
+
+/**
+ * Get the length of the common prefix of two strings
+ *
+ * @param str1 the first string
+ * @param str2 the second string
+ * @param n the number of bytes to compare (both strings have to be at least that long)
+ *
+ * @return the offset of the first byte which differs, *n* if the *n*
+ * first bytes are the same
+ */
+size_t memcmp_prefix(const char *str1, const char *str2, size_t n)
+{
+    size_t i;
+
+    i = 0;
+    if (str1 == str2) {
+        return n;
+    }
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_AVX2()) {
+        i = mismatch_avx2(str1, str2, n);
+    }
+    if (CPU_HAS_SSE2()) {
+        i += mismatch_sse2(str1 + i, str2 + i, n - i);
+    }
+#endif /* HAVE_X86_SIMD */
+    for (i += mismatch_swar(str1 + i, str2 + i, n - i); i < n && str1[i] == str2[i]; i++)
+        ;
+
+    return i;
+}
+
+/**
+ * Compare two substrings and get the length of their common prefix
+ *
+ * When the strings of a sorted structure are compared to a same key,
+ * the comparisons can start after the prefix the key is known to share
+ * with both bounds of the range searched.
+ *
+ * @param str1 the first of the two substrings to compare
+ * @param str1_len its length
+ * @param str2 the second of the two substrings to compare
+ * @param str2_len its length
+ * @param prefix_len if not `NULL`, receives the number of leading bytes
+ * both substrings have in common
+ *
+ * @return same as memcmp_l
+ */
+int memcmp_l_prefix(
+    const char *str1, size_t str1_len,
+    const char *str2, size_t str2_len,
+    size_t *prefix_len
+) {
+    size_t i, min_len;
+
+    min_len = MIN(str1_len, str2_len);
+    i = memcmp_prefix(str1, str2, min_len);
+    if (NULL != prefix_len) {
+        *prefix_len = i;
+    }
+    if (i < min_len) {
+        return (unsigned char) str1[i] - (unsigned char) str2[i];
+    }
+
+    return str1_len - str2_len;
+}
 
 /**
  * Compare two substrings.
@@ -19,21 +149,5 @@ int memcmp_l(
     const char *str1, size_t str1_len,
     const char *str2, size_t str2_len
 ) {
-    if (str1 != str2) {
-        size_t min_len;
-
-        if (str2_len < str1_len) {
-            min_len = str2_len;
-        } else {
-            min_len = str1_len;
-        }
-        while (0 != min_len--) {
-            if (*str1 != *str2) {
-                return (unsigned char) *str1 - (unsigned char) *str2;
-            }
-            ++str1, ++str2;
-        }
-    }
-
-    return str1_len - str2_len;
+    return memcmp_l_prefix(str1, str1_len, str2, str2_len, NULL);
 }
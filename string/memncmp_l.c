@@ -1,6 +1,7 @@
 #include <stddef.h> /* size_t */
 
 #include "utils.h" /* MIN */
+#include "memcmp_l.h" /* memcmp_prefix */
 
 /**
  * XXX
@@ -19,14 +20,11 @@ int memncmp_l(
     size_t n
 ) {
     if (str1 != str2 && 0 != n) {
-        size_t min_len;
+        size_t i, min_len;
 
         min_len =  MIN(n, MIN(str1_len, str2_len));
-        while (0 != min_len--) {
-            if (*str1 != *str2) {
-                return *(const unsigned char *) str1 - *(const unsigned char *) str2;
-            }
-            ++str1, ++str2;
+        if ((i = memcmp_prefix(str1, str2, min_len)) < min_len) {
+            return (unsigned char) str1[i] - (unsigned char) str2[i];
         }
 
         return MIN(n, str1_len) - MIN(n, str2_len);
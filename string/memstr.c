@@ -1,4 +1,368 @@
+#define _GNU_SOURCE /* memrchr */
+#include <stdint.h>
 #include <string.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "simd.h"
+#include "memstr.h"
+
+/*
+ * Needles up to this length are searched by filtering the candidate
+ * positions on their first and last bytes (16 or 32 positions at once
+ * with SSE2/AVX2) then comparing the bytes in between; longer needles
+ * by the Two-Way algorithm (Crochemore-Perrin), which is linear in the
+ * worst case and doesn't need any table.
+ */
+#define MEMSTR_SHORT_NEEDLE 32
+
+/* ========== Two-Way ========== */
+
+/*
+ * The backward search is the forward one on the reversed needle and
+ * haystack: AT hides the direction.
+ */
+#define FORWARD(s, len, i) ((unsigned char) (s)[(i)])
+#define BACKWARD(s, len, i) ((unsigned char) (s)[(len) - 1 - (i)])
+
+#define two_way(direction, AT) \
+    static size_t two_way_maximal_suffix_## direction(const char *needle, size_t m, bool reversed, size_t *period) \
+    { \
+        size_t max_suffix, j, k, p; \
+        unsigned char a, b; \
+ \
+        max_suffix = SIZE_MAX; \
+        j = 0; \
+        k = p = 1; \
+        while (j + k < m) { \
+            a = AT(needle, m, j + k); \
+            b = AT(needle, m, max_suffix + k); \
+            if (reversed ? b < a : a < b) { \
+                j += k; \
+                k = 1; \
+                p = j - max_suffix; \
+            } else if (a == b) { \
+                if (k != p) { \
+                    ++k; \
+                } else { \
+                    j += p; \
+                    k = 1; \
+                } \
+            } else { \
+                max_suffix = j++; \
+                k = p = 1; \
+            } \
+        } \
+        *period = p; \
+ \
+        return max_suffix; \
+    } \
+ \
+    static void two_way_factorize_## direction(MemStrFactorization *f, const char *needle, size_t m) \
+    { \
+        size_t i, suffix, suffix_rev, period, period_rev; \
+ \
+        /* the critical factorization is given by the longest of the maximal suffixes for both orderings */ \
+        suffix = two_way_maximal_suffix_## direction(needle, m, false, &period); \
+        suffix_rev = two_way_maximal_suffix_## direction(needle, m, true, &period_rev); \
+        if (suffix_rev + 1 < suffix + 1) { \
+            f->critical = suffix + 1; \
+            f->period = period; \
+        } else { \
+            f->critical = suffix_rev + 1; \
+            f->period = period_rev; \
+        } \
+        /* is needle[0..critical) a suffix of needle[0..critical + period)? */ \
+        for (i = 0; i < f->critical && AT(needle, m, i) == AT(needle, m, i + f->period); i++) \
+            ; \
+        if (!(f->periodic = i == f->critical)) { \
+            f->period = MAX(f->critical, m - f->critical) + 1; \
+        } \
+    } \
+ \
+    /* return the offset of the first match (in the direction of the search) or SIZE_MAX */ \
+    static size_t two_way_search_## direction(const MemStrFactorization *f, const char *needle, size_t m, const char *haystack, size_t n) \
+    { \
+        size_t i, j, memory; \
+ \
+        j = memory = 0; \
+        while (j <= n - m) { \
+            /* right half first, skipping what is known to match (memory) */ \
+            i = MAX(f->critical, memory); \
+            while (i < m && AT(needle, m, i) == AT(haystack, n, i + j)) { \
+                ++i; \
+            } \
+            if (i < m) { \
+                j += i - f->critical + 1; \
+                memory = 0; \
+            } else { \
+                /* then the left half, from right to left */ \
+                i = f->critical; \
+                while (i > memory && AT(needle, m, i - 1) == AT(haystack, n, i - 1 + j)) { \
+                    --i; \
+                } \
+                if (i <= memory) { \
+                    return j; \
+                } \
+                j += f->period; \
+                /* for a periodic needle, the period we shift by is known to match */ \
+                memory = f->periodic ? m - f->period : 0; \
+            } \
+        } \
+ \
+        return SIZE_MAX; \
+    }
+
+two_way(forward, FORWARD)
+two_way(backward, BACKWARD)
+
+#undef two_way
+
+/* ========== first/last byte filter ========== */
+
+#ifdef HAVE_X86_SIMD
+/*
+ * Each function returns the number of positions it examined, from the
+ * start (forward) or the end (backward) of the haystack, and sets *match*
+ * if one of them matches. The remaining positions are left to the scalar code.
+ */
+
+# define FILTER_FORWARD(name, isa, vector, width, set1, load, cmpeq, and, movemask) \
+    static TARGET(isa) size_t name(const char *haystack, size_t n, const char *needle, size_t m, const char **match) \
+    { \
+        size_t i, positions; \
+        vector first, last; \
+ \
+        first = set1(needle[0]); \
+        last = set1(needle[m - 1]); \
+        positions = n - m + 1; \
+        for (i = 0; i + width <= positions; i += width) { \
+            uint32_t mask; \
+ \
+            mask = (uint32_t) movemask(and(cmpeq(first, load(haystack + i)), cmpeq(last, load(haystack + i + m - 1)))); \
+            while (0 != mask) { \
+                size_t p; \
+ \
+                p = i + __builtin_ctz(mask); \
+                if (0 == memcmp(haystack + p + 1, needle + 1, m - 2)) { \
+                    *match = haystack + p; \
+                    return p + 1; \
+                } \
+                mask &= mask - 1; \
+            } \
+        } \
+ \
+        return i; \
+    }
+
+# define FILTER_BACKWARD(name, isa, vector, width, set1, load, cmpeq, and, movemask) \
+    static TARGET(isa) size_t name(const char *haystack, size_t n, const char *needle, size_t m, const char **match) \
+    { \
+        size_t i, positions; \
+        vector first, last; \
+ \
+        first = set1(needle[0]); \
+        last = set1(needle[m - 1]); \
+        positions = n - m + 1; \
+        /* [positions - i - width, positions - i) is the block of positions examined */ \
+        for (i = 0; i + width <= positions; i += width) { \
+            uint32_t mask; \
+            const char *block; \
+ \
+            block = haystack + positions - i - width; \
+            mask = (uint32_t) movemask(and(cmpeq(first, load(block)), cmpeq(last, load(block + m - 1)))); \
+            while (0 != mask) { \
+                size_t bit; \
+ \
+                bit = 31 - __builtin_clz(mask); \
+                if (0 == memcmp(block + bit + 1, needle + 1, m - 2)) { \
+                    *match = block + bit; \
+                    return i + width - bit; \
+                } \
+                mask &= ~(UINT32_C(1) << bit); \
+            } \
+        } \
+ \
+        return i; \
+    }
+
+# define LOAD_SSE2(p) _mm_loadu_si128((const __m128i *) (p))
+# define LOAD_AVX2(p) _mm256_loadu_si256((const __m256i *) (p))
+
+FILTER_FORWARD(memstr_sse2, "sse2", __m128i, 16, _mm_set1_epi8, LOAD_SSE2, _mm_cmpeq_epi8, _mm_and_si128, _mm_movemask_epi8)
+FILTER_FORWARD(memstr_avx2, "avx2", __m256i, 32, _mm256_set1_epi8, LOAD_AVX2, _mm256_cmpeq_epi8, _mm256_and_si256, _mm256_movemask_epi8)
+FILTER_BACKWARD(memrstr_sse2, "sse2", __m128i, 16, _mm_set1_epi8, LOAD_SSE2, _mm_cmpeq_epi8, _mm_and_si128, _mm_movemask_epi8)
+FILTER_BACKWARD(memrstr_avx2, "avx2", __m256i, 32, _mm256_set1_epi8, LOAD_AVX2, _mm256_cmpeq_epi8, _mm256_and_si256, _mm256_movemask_epi8)
+
+# undef FILTER_FORWARD
+# undef FILTER_BACKWARD
+#endif /* HAVE_X86_SIMD */
+
+static const char *memstr_short(const char *haystack, size_t n, const char *needle, size_t m)
+{
+    size_t done;
+    const char *p, *l;
+#ifdef HAVE_X86_SIMD
+    const char *match;
+#endif /* HAVE_X86_SIMD */
+
+    assert(m >= 2 && m <= n);
+
+    done = 0;
+#ifdef HAVE_X86_SIMD
+    match = NULL;
+    if (CPU_HAS_AVX2()) {
+        done = memstr_avx2(haystack, n, needle, m, &match);
+    } else if (CPU_HAS_SSE2()) {
+        done = memstr_sse2(haystack, n, needle, m, &match);
+    }
+    if (NULL != match) {
+        return match;
+    }
+#endif /* HAVE_X86_SIMD */
+    // the remaining positions: jump from a first byte to the next one
+    l = haystack + n - m; // last possible position to find a match
+    for (p = haystack + done; p <= l && NULL != (p = memchr(p, needle[0], l - p + 1)); p++) {
+        if (0 == memcmp(p + 1, needle + 1, m - 1)) {
+            return p;
+        }
+    }
+
+    return NULL;
+}
+
+static const char *memrstr_short(const char *haystack, size_t n, const char *needle, size_t m)
+{
+    size_t done, positions;
+    const char *p;
+#ifdef HAVE_X86_SIMD
+    const char *match;
+#endif /* HAVE_X86_SIMD */
+
+    assert(m >= 2 && m <= n);
+
+    done = 0;
+#ifdef HAVE_X86_SIMD
+    match = NULL;
+    if (CPU_HAS_AVX2()) {
+        done = memrstr_avx2(haystack, n, needle, m, &match);
+    } else if (CPU_HAS_SSE2()) {
+        done = memrstr_sse2(haystack, n, needle, m, &match);
+    }
+    if (NULL != match) {
+        return match;
+    }
+#endif /* HAVE_X86_SIMD */
+    // the remaining positions are [0, positions)
+    positions = n - m + 1 - done;
+    while (positions > 0 && NULL != (p = memrchr(haystack, needle[0], positions))) {
+        if (0 == memcmp(p + 1, needle + 1, m - 1)) {
+            return p;
+        }
+        positions = p - haystack;
+    }
+
+    return NULL;
+}
+
+/* ========== public functions ========== */
+
+/**
+ * Prepare a needle for repeated searches (memstr_compiled and memrstr_compiled)
+ *
+ * @param compiled the structure to initialize
+ * @param needle the substring to look for
+ * @param needle_len the length of *needle*
+ *
+ * @note *needle* is not copied: it has to outlive *compiled*
+ */
+void memstr_compile(MemStrNeedle *compiled, const char *needle, size_t needle_len)
+{
+    assert(NULL != compiled);
+    assert(NULL != needle || 0 == needle_len);
+
+    compiled->needle = needle;
+    compiled->needle_len = needle_len;
+    if (needle_len > MEMSTR_SHORT_NEEDLE) {
+        two_way_factorize_forward(&compiled->forward, needle, needle_len);
+        two_way_factorize_backward(&compiled->backward, needle, needle_len);
+    }
+}
+
+static const char *memstr_search(const MemStrNeedle *compiled, const char *haystack, size_t n)
+{
+    size_t m, offset;
+
+    m = compiled->needle_len;
+    if (m > n) {
+        return NULL;
+    } else if (0 == m) {
+        return haystack;
+    } else if (1 == m) {
+        return memchr(haystack, compiled->needle[0], n);
+    } else if (m <= MEMSTR_SHORT_NEEDLE) {
+        return memstr_short(haystack, n, compiled->needle, m);
+    } else if (SIZE_MAX == (offset = two_way_search_forward(&compiled->forward, compiled->needle, m, haystack, n))) {
+        return NULL;
+    } else {
+        return haystack + offset;
+    }
+}
+
+static const char *memrstr_search(const MemStrNeedle *compiled, const char *haystack, size_t n)
+{
+    size_t m, offset;
+
+    m = compiled->needle_len;
+    if (m > n) {
+        return NULL;
+    } else if (0 == m) {
+        return haystack + n;
+    } else if (1 == m) {
+        return memrchr(haystack, compiled->needle[0], n);
+    } else if (m <= MEMSTR_SHORT_NEEDLE) {
+        return memrstr_short(haystack, n, compiled->needle, m);
+    } else if (SIZE_MAX == (offset = two_way_search_backward(&compiled->backward, compiled->needle, m, haystack, n))) {
+        return NULL;
+    } else {
+        return haystack + n - m - offset;
+    }
+}
+
+/**
+ * Find the first occurrence of a precompiled needle in a string
+ *
+ * @param compiled the needle, as prepared by memstr_compile
+ * @param haystack the string to search in
+ * @param haystack_end a pointer after the last byte of haystack
+ *
+ * @return a pointer to the first match found of the needle in *haystack* else `NULL` if not found
+ */
+char *memstr_compiled(const MemStrNeedle *compiled, const char *haystack, const char * const haystack_end)
+{
+    assert(NULL != compiled);
+    assert(haystack <= haystack_end);
+
+    return (char *) memstr_search(compiled, haystack, haystack_end - haystack);
+}
+
+/**
+ * Find the last occurrence of a precompiled needle in a string
+ *
+ * @param compiled the needle, as prepared by memstr_compile
+ * @param haystack the string to search in
+ * @param haystack_end a pointer after the last byte of haystack
+ *
+ * @return a pointer to the last match found of the needle in *haystack* else `NULL` if not found
+ */
+char *memrstr_compiled(const MemStrNeedle *compiled, const char *haystack, const char * const haystack_end)
+{
+    assert(NULL != compiled);
+    assert(haystack <= haystack_end);
+
+    return (char *) memrstr_search(compiled, haystack, haystack_end - haystack);
+}
 
 /**
  * Find the first occurrence of a string in an other one
@@ -9,25 +373,46 @@
  * @param haystack_end a pointer after the last byte of haystack (eg: `haystack + strlen(haystack)` - if *haystack* is `'\0'`-terminated)
  *
  * @return a pointer to the first match found of *needle* in *haystack* else `NULL` if not found
+ *
+ * @note to search the same needle several times, use memstr_compile and
+ * memstr_compiled: the preprocessing of long needles is then done once
  */
 char *memstr(const char *haystack, const char *needle, size_t needle_len, const char * const haystack_end)
 {
-    if (needle_len <= (size_t) (haystack_end - haystack)) {
-        if (0 == needle_len) {
-            return (char *) haystack;
-        } else if (1 == needle_len) {
-            return (char *) memchr(haystack, (int) needle[0], haystack_end - haystack);
-        } else {
-            const char *p;
-            const char * const l = haystack_end - needle_len; // last possible position to find a match
-
-            for (p = haystack; p <= l; p++) {
-                if (*p == needle[0] && 0 == memcmp(needle + 1, p + 1, needle_len - 1)) {
-                    return (char *) p;
-                }
-            }
-        }
+    MemStrNeedle compiled;
+
+    assert(haystack <= haystack_end);
+
+    compiled.needle = needle;
+    compiled.needle_len = needle_len;
+    if (needle_len > MEMSTR_SHORT_NEEDLE && needle_len <= (size_t) (haystack_end - haystack)) {
+        two_way_factorize_forward(&compiled.forward, needle, needle_len);
     }
 
-    return NULL;
+    return (char *) memstr_search(&compiled, haystack, haystack_end - haystack);
+}
+
+/**
+ * Find the last occurrence of a string in an other one
+ *
+ * @param haystack the string to search in
+ * @param needle the substring to look for
+ * @param needle_len the length of *needle*
+ * @param haystack_end a pointer after the last byte of haystack
+ *
+ * @return a pointer to the last match found of *needle* in *haystack* else `NULL` if not found
+ */
+char *memrstr(const char *haystack, const char *needle, size_t needle_len, const char * const haystack_end)
+{
+    MemStrNeedle compiled;
+
+    assert(haystack <= haystack_end);
+
+    compiled.needle = needle;
+    compiled.needle_len = needle_len;
+    if (needle_len > MEMSTR_SHORT_NEEDLE && needle_len <= (size_t) (haystack_end - haystack)) {
+        two_way_factorize_backward(&compiled.backward, needle, needle_len);
+    }
+
+    return (char *) memrstr_search(&compiled, haystack, haystack_end - haystack);
 }
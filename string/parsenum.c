@@ -1,8 +1,10 @@
+#include <stddef.h>
 #include <stdbool.h>
 #include <string.h>
 #include <limits.h>
 #include <stdint.h>
 
+#include "attributes.h"
 #include "parsenum.h"
 
 /**
@@ -25,6 +27,69 @@
  *   the number is valid but is out of user limits
  **/
 
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+# define ONES UINT64_C(0x0101010101010101)
+# define HIGHS (ONES * 0x80)
+
+/* the high bit of each byte of x which is in [lo ; lo + count[ */
+# define IN_RANGE(x, lo, count) \
+    ((((x) & ~HIGHS) + ONES * (0x80 - (lo))) & ~(((x) & ~HIGHS) + ONES * (0x80 - (lo) - (count))) & ~(x) & HIGHS)
+
+/*
+ * Numbers in base 10 and 16 are read 8 digits at a time as long as the
+ * accumulator can't exceed *limit*: the digits are loaded in a uint64_t,
+ * the first one in the lowest byte, then adjacent digits are merged by
+ * pairs, pairs of pairs and so on, with a multiplication and a shift.
+ * The byte by byte loop then finishes the job and handles the overflows.
+ */
+static const char *parse_8_digits_at_once(const char *s, const char * const end, int base, uint64_t limit, uint64_t *acc)
+{
+    uint64_t w, alpha, scale, cut;
+
+    if (10 == base) {
+        scale = UINT64_C(100000000);
+    } else if (16 == base) {
+        scale = UINT64_C(1) << 32;
+    } else {
+        return s;
+    }
+    if (limit < scale - 1) {
+        return s;
+    }
+    cut = (limit - (scale - 1)) / scale;
+    while (end - s >= (ptrdiff_t) sizeof(w) && *acc <= cut) {
+        memcpy(&w, s, sizeof(w));
+        if (10 == base) {
+            if (HIGHS != IN_RANGE(w, '0', 10)) {
+                break;
+            }
+            w &= ONES * 0x0F;
+            w = (w * 10 + (w >> 8)) & UINT64_C(0x00FF00FF00FF00FF);
+            w = (w * 100 + (w >> 16)) & UINT64_C(0x0000FFFF0000FFFF);
+            w = (w * 10000 + (w >> 32)) & UINT64_C(0x00000000FFFFFFFF);
+        } else {
+            alpha = IN_RANGE(w | (ONES * 0x20), 'a', 6);
+            if (HIGHS != (IN_RANGE(w, '0', 10) | alpha)) {
+                break;
+            }
+            w = (w & (ONES * 0x0F)) + (alpha >> 7) * 9;
+            w = ((w << 4) + (w >> 8)) & UINT64_C(0x00FF00FF00FF00FF);
+            w = ((w << 8) + (w >> 16)) & UINT64_C(0x0000FFFF0000FFFF);
+            w = ((w << 16) + (w >> 32)) & UINT64_C(0x00000000FFFFFFFF);
+        }
+        *acc = *acc * scale + w;
+        s += sizeof(w);
+    }
+
+    return s;
+}
+
+# undef IN_RANGE
+#else
+/* digits have to be in the opposite order: always take the byte by byte loop */
+# define parse_8_digits_at_once(s, end, base, limit, acc) (s)
+#endif /* little endian */
+
 #define parse_signed(type, unsigned_type, value_type_min, value_type_max) \
     ParseNumError strto## type(const char *nptr, char **endptr, int base, type *min, type *max, type *ret) { \
         return strnto## type(nptr, nptr + strlen(nptr), endptr, base, min, max, ret); \
@@ -32,58 +97,56 @@
  \
     ParseNumError strnto## type(const char *nptr, const char * const end, char **endptr, int base, type *min, type *max, type *ret) { \
         char c; \
-        char ***spp; \
         bool negative; \
+        uint64_t fast; \
+        const char *s, *p; \
         int any, cutlim; \
         ParseNumError err; \
         unsigned_type cutoff, acc; \
  \
+        s = nptr; \
         acc = any = 0; \
         negative = false; \
         err = PARSE_NUM_NO_ERR; \
-        if (NULL == endptr) { \
-            char **sp; \
- \
-            sp = (char **) &nptr; \
-            spp = &sp; \
-        } else { \
-            spp = &endptr; \
-            *endptr = (char *) nptr; \
-        } \
-        if (**spp < end) { \
-            if ('-' == ***spp) { \
-                ++**spp; \
+        if (s < end) { \
+            if ('-' == *s) { \
+                ++s; \
                 negative = true; \
-            } else { \
-                negative = false; \
-                if ('+' == ***spp) { \
-                    ++**spp; \
-                } \
+            } else if ('+' == *s) { \
+                ++s; \
             } \
-            if ((0 == base || 2 == base) && '0' == ***spp && (end - **spp) > 1 && ('b' == (**spp)[1] || 'B' == (**spp)[1])) { \
-                **spp += 2; \
+            if ((0 == base || 2 == base) && (end - s) > 1 && '0' == s[0] && ('b' == s[1] || 'B' == s[1])) { \
+                s += 2; \
                 base = 2; \
             } \
-            if ((0 == base || 16 == base) && '0' == ***spp && (end - **spp) > 1 && ('x' == (**spp)[1] || 'X' == (**spp)[1])) { \
-                **spp += 2; \
+            if ((0 == base || 16 == base) && (end - s) > 1 && '0' == s[0] && ('x' == s[1] || 'X' == s[1])) { \
+                s += 2; \
                 base = 16; \
             } \
             if (0 == base) { \
-                base = '0' == ***spp ? 8 : 10; \
+                base = s < end && '0' == *s ? 8 : 10; \
             } \
             if (base < 2 || base > 36) { \
+                if (NULL != endptr) { \
+                    *endptr = (char *) s; \
+                } \
                 return PARSE_NUM_ERR_INVALID_BASE; \
             } \
             cutoff = negative ? (unsigned_type) - (value_type_min + value_type_max) + value_type_max : value_type_max; \
+            fast = 0; \
+            p = parse_8_digits_at_once(s, end, base, cutoff, &fast); \
+            any = p > s; \
+            acc = (unsigned_type) fast; \
+            s = p; \
             cutlim = cutoff % base; \
             cutoff /= base; \
-            while (**spp < end) { \
-                if (***spp >= '0' && ***spp <= '9') { \
-                    c = ***spp - '0'; \
-                } else if (base > 10 && ***spp >= 'A' && ***spp <= 'Z') { \
-                    c = ***spp - 'A' - 10; \
-                } else if (base > 10 && ***spp >= 'a' && ***spp <= 'z') { \
-                    c = ***spp - 'a' - 10; \
+            while (s < end) { \
+                if (*s >= '0' && *s <= '9') { \
+                    c = *s - '0'; \
+                } else if (base > 10 && *s >= 'A' && *s <= 'Z') { \
+                    c = *s - 'A' + 10; \
+                } else if (base > 10 && *s >= 'a' && *s <= 'z') { \
+                    c = *s - 'a' + 10; \
                 } else { \
                     err = PARSE_NUM_ERR_NON_DIGIT_FOUND; \
                     break; \
@@ -99,9 +162,12 @@
                     acc *= base; \
                     acc += c; \
                 } \
-                ++**spp; \
+                ++s; \
             } \
         } \
+        if (NULL != endptr) { \
+            *endptr = (char *) s; \
+        } \
         if (any < 0) { \
             if (negative) { \
                 *ret = value_type_min; \
@@ -143,57 +209,55 @@ parse_signed(int64_t, uint64_t, INT64_MIN, INT64_MAX);
  \
     ParseNumError strnto## type(const char *nptr, const char * const end, char **endptr, int base, type *min, type *max, type *ret) { \
         char c; \
-        char ***spp; \
         bool negative; \
+        uint64_t fast; \
+        const char *s, *p; \
         int any, cutlim; \
         type cutoff, acc; \
         ParseNumError err; \
  \
+        s = nptr; \
         acc = any = 0; \
         negative = false; \
         err = PARSE_NUM_NO_ERR; \
-        if (NULL == endptr) { \
-            char **sp; \
- \
-            sp = (char **) &nptr; \
-            spp = &sp; \
-        } else { \
-            spp = &endptr; \
-            *endptr = (char *) nptr; \
-        } \
-        if (**spp < end) { \
-            if ('-' == ***spp) { \
-                ++**spp; \
+        if (s < end) { \
+            if ('-' == *s) { \
+                ++s; \
                 negative = true; \
-            } else { \
-                negative = false; \
-                if ('+' == ***spp) { \
-                    ++**spp; \
-                } \
+            } else if ('+' == *s) { \
+                ++s; \
             } \
-            if ((0 == base || 2 == base) && '0' == ***spp && (end - **spp) > 1 && ('b' == (**spp)[1] || 'B' == (**spp)[1])) { \
-                **spp += 2; \
+            if ((0 == base || 2 == base) && (end - s) > 1 && '0' == s[0] && ('b' == s[1] || 'B' == s[1])) { \
+                s += 2; \
                 base = 2; \
             } \
-            if ((0 == base || 16 == base) && '0' == ***spp && (end - **spp) > 1 && ('x' == (**spp)[1] || 'X' == (**spp)[1])) { \
-                **spp += 2; \
+            if ((0 == base || 16 == base) && (end - s) > 1 && '0' == s[0] && ('x' == s[1] || 'X' == s[1])) { \
+                s += 2; \
                 base = 16; \
             } \
             if (0 == base) { \
-                base = '0' == ***spp ? 8 : 10; \
+                base = s < end && '0' == *s ? 8 : 10; \
             } \
             if (base < 2 || base > 36) { \
+                if (NULL != endptr) { \
+                    *endptr = (char *) s; \
+                } \
                 return PARSE_NUM_ERR_INVALID_BASE; \
             } \
+            fast = 0; \
+            p = parse_8_digits_at_once(s, end, base, value_type_max, &fast); \
+            any = p > s; \
+            acc = (type) fast; \
+            s = p; \
             cutoff = value_type_max / base; \
             cutlim = value_type_max % base; \
-            while (**spp < end) { \
-                if (***spp >= '0' && ***spp <= '9') { \
-                    c = ***spp - '0'; \
-                } else if (base > 10 && ***spp >= 'A' && ***spp <= 'Z') { \
-                    c = ***spp - 'A' - 10; \
-                } else if (base > 10 && ***spp >= 'a' && ***spp <= 'z') { \
-                    c = ***spp - 'a' - 10; \
+            while (s < end) { \
+                if (*s >= '0' && *s <= '9') { \
+                    c = *s - '0'; \
+                } else if (base > 10 && *s >= 'A' && *s <= 'Z') { \
+                    c = *s - 'A' + 10; \
+                } else if (base > 10 && *s >= 'a' && *s <= 'z') { \
+                    c = *s - 'a' + 10; \
                 } else { \
                     err = PARSE_NUM_ERR_NON_DIGIT_FOUND; \
                     break; \
@@ -209,9 +273,12 @@ parse_signed(int64_t, uint64_t, INT64_MIN, INT64_MAX);
                     acc *= base; \
                     acc += c; \
                 } \
-                ++**spp; \
+                ++s; \
             } \
         } \
+        if (NULL != endptr) { \
+            *endptr = (char *) s; \
+        } \
         if (any < 0) { \
             *ret = value_type_max; \
             return PARSE_NUM_ERR_TOO_LARGE; \
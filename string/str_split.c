@@ -1,7 +1,10 @@
 #include <stddef.h>
 #include <stdlib.h> /* malloc */
+#include <string.h>
 #include <assert.h>
 
+#include "attributes.h"
+#include "simd.h"
 #include "str_split.h"
 
 size_t str_split(char separator, char *string, char ***parts, bool no_empty)
@@ -48,3 +51,254 @@ size_t str_split(char separator, char *string, char ***parts, bool no_empty)
 
     return i;
 }
+
+/*
+ * Tokenizer: the same splitting without any allocation nor modification
+ * of the input. Tokens are spans (a pointer and a length) into the
+ * string, returned one by one by str_tokenizer_next or by batches into
+ * an array of the caller with str_tokenizer_split.
+ *
+ * \code
+ *   StrSpan token;
+ *   StrTokenizer t;
+ *
+ *   str_tokenizer_init_set(&t, line, line_len, " \t", STR_LEN(" \t"), true);
+ *   while (str_tokenizer_next(&t, &token)) {
+ *       printf("%.*s\n", (int) token.len, token.ptr);
+ *   }
+ * \endcode
+ *
+ * A single separator is searched with memchr, a multi-byte one with
+ * memstr and a set of separators 32 (AVX2) or 16 (SSE2) bytes at a time
+ * (if it has no more than STR_TOKENIZER_SIMD_SET bytes) else with a
+ * bitmap.
+ */
+
+#define STR_TOKENIZER_SIMD_SET 8
+
+#ifdef HAVE_X86_SIMD
+# define FIND_SET(name, isa, vector, width, SET1, LOAD, CMPEQ, OR, MOVEMASK) \
+    static TARGET(isa) size_t find_set_## name(const char *string, size_t n, const char *set, size_t set_len) \
+    { \
+        size_t i, j; \
+        uint32_t mask; \
+        vector x, found, separators[STR_TOKENIZER_SIMD_SET]; \
+ \
+        for (j = 0; j < set_len; j++) { \
+            separators[j] = SET1(set[j]); \
+        } \
+        for (i = 0; i + width <= n; i += width) { \
+            x = LOAD(string + i); \
+            found = CMPEQ(x, separators[0]); \
+            for (j = 1; j < set_len; j++) { \
+                found = OR(found, CMPEQ(x, separators[j])); \
+            } \
+            if (0 != (mask = (uint32_t) MOVEMASK(found))) { \
+                return i + __builtin_ctz(mask); \
+            } \
+        } \
+ \
+        return i; \
+    }
+
+# define LOAD_SSE2(p) _mm_loadu_si128((const __m128i *) (const void *) (p))
+# define LOAD_AVX2(p) _mm256_loadu_si256((const __m256i *) (const void *) (p))
+
+FIND_SET(sse2, "sse2", __m128i, 16, _mm_set1_epi8, LOAD_SSE2, _mm_cmpeq_epi8, _mm_or_si128, _mm_movemask_epi8)
+FIND_SET(avx2, "avx2", __m256i, 32, _mm256_set1_epi8, LOAD_AVX2, _mm256_cmpeq_epi8, _mm256_or_si256, _mm256_movemask_epi8)
+
+# undef FIND_SET
+#endif /* HAVE_X86_SIMD */
+
+#define BITMAP_TEST(bitmap, c) \
+    (0 != ((bitmap)[(unsigned char) (c) / 8] & (1 << ((unsigned char) (c) % 8))))
+
+static const char *str_tokenizer_find_set(const StrTokenizer *t, const char *string, size_t n)
+{
+    size_t i;
+
+    i = 0;
+#ifdef HAVE_X86_SIMD
+    if (t->set_len <= STR_TOKENIZER_SIMD_SET) {
+        if (CPU_HAS_AVX2()) {
+            i = find_set_avx2(string, n, t->set, t->set_len);
+        }
+        if (CPU_HAS_SSE2()) {
+            i += find_set_sse2(string + i, n - i, t->set, t->set_len);
+        }
+    }
+#endif /* HAVE_X86_SIMD */
+    for (; i < n; i++) {
+        if (BITMAP_TEST(t->set_bitmap, string[i])) {
+            return string + i;
+        }
+    }
+
+    return NULL;
+}
+
+static void str_tokenizer_init(StrTokenizer *t, StrTokenizerKind kind, const char *string, size_t string_len, bool no_empty)
+{
+    assert(NULL != t);
+    assert(NULL != string || 0 == string_len);
+
+    t->kind = kind;
+    t->position = string;
+    t->end = string + string_len;
+    t->no_empty = no_empty;
+    t->done = false;
+}
+
+/**
+ * Initialize a tokenizer to split a string on a single character
+ *
+ * @param t the tokenizer to initialize
+ * @param string the string to split (not modified, it has to outlive the tokens)
+ * @param string_len the length of *string*
+ * @param separator the character which separates tokens
+ * @param no_empty `true` to skip empty tokens (leading, trailing and
+ * consecutive separators). Else an empty string is a single empty token
+ */
+void str_tokenizer_init_char(StrTokenizer *t, const char *string, size_t string_len, char separator, bool no_empty)
+{
+    str_tokenizer_init(t, STR_TOKENIZER_CHAR, string, string_len, no_empty);
+    t->separator = separator;
+}
+
+/**
+ * Initialize a tokenizer to split a string on any character of a set
+ *
+ * @param t the tokenizer to initialize
+ * @param string the string to split (not modified, it has to outlive the tokens)
+ * @param string_len the length of *string*
+ * @param set the characters which separate tokens (it has to outlive the tokenizer)
+ * @param set_len the number of characters in *set* (at least 1)
+ * @param no_empty `true` to skip empty tokens (see str_tokenizer_init_char)
+ */
+void str_tokenizer_init_set(StrTokenizer *t, const char *string, size_t string_len, const char *set, size_t set_len, bool no_empty)
+{
+    size_t i;
+
+    assert(NULL != set);
+    assert(set_len > 0);
+
+    str_tokenizer_init(t, STR_TOKENIZER_SET, string, string_len, no_empty);
+    t->set = set;
+    t->set_len = set_len;
+    memset(t->set_bitmap, 0, sizeof(t->set_bitmap));
+    for (i = 0; i < set_len; i++) {
+        t->set_bitmap[(unsigned char) set[i] / 8] |= 1 << ((unsigned char) set[i] % 8);
+    }
+}
+
+/**
+ * Initialize a tokenizer to split a string on a multi-byte separator
+ *
+ * @param t the tokenizer to initialize
+ * @param string the string to split (not modified, it has to outlive the tokens)
+ * @param string_len the length of *string*
+ * @param separator the string which separates tokens (it has to outlive the tokenizer)
+ * @param separator_len the length of *separator* (at least 1)
+ * @param no_empty `true` to skip empty tokens (see str_tokenizer_init_char)
+ */
+void str_tokenizer_init_string(StrTokenizer *t, const char *string, size_t string_len, const char *separator, size_t separator_len, bool no_empty)
+{
+    assert(NULL != separator);
+    assert(separator_len > 0);
+
+    str_tokenizer_init(t, STR_TOKENIZER_STRING, string, string_len, no_empty);
+    memstr_compile(&t->needle, separator, separator_len);
+}
+
+/**
+ * Get the next token
+ *
+ * @param t the tokenizer
+ * @param token where to put the token, as a span of the string
+ *
+ * @return `false` if there is no more token (*token* is left untouched)
+ */
+bool str_tokenizer_next(StrTokenizer *t, StrSpan *token)
+{
+    size_t separator_len;
+    const char *separator;
+
+    assert(NULL != t);
+    assert(NULL != token);
+
+    while (!t->done) {
+        separator = NULL;
+        separator_len = 1;
+        switch (t->kind) {
+            case STR_TOKENIZER_CHAR:
+                separator = memchr(t->position, t->separator, t->end - t->position);
+                break;
+            case STR_TOKENIZER_SET:
+                separator = str_tokenizer_find_set(t, t->position, t->end - t->position);
+                break;
+            case STR_TOKENIZER_STRING:
+                separator = memstr_compiled(&t->needle, t->position, t->end);
+                separator_len = t->needle.needle_len;
+                break;
+        }
+        token->ptr = t->position;
+        if (NULL == separator) {
+            token->len = t->end - t->position;
+            t->position = t->end;
+            t->done = true;
+        } else {
+            token->len = separator - t->position;
+            t->position = separator + separator_len;
+        }
+        if (!t->no_empty || token->len > 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Get the next tokens, as many as the array can hold
+ *
+ * @param t the tokenizer
+ * @param tokens the array to fill
+ * @param tokens_len the capacity, in tokens, of the array
+ *
+ * @return the number of tokens put in *tokens*, less than *tokens_len* if
+ * the end of the string was reached. If it is *tokens_len*, the function
+ * can be called again (reusing the same array) to get the next ones.
+ */
+size_t str_tokenizer_split(StrTokenizer *t, StrSpan *tokens, size_t tokens_len)
+{
+    size_t n;
+
+    assert(NULL != tokens || 0 == tokens_len);
+
+    for (n = 0; n < tokens_len && str_tokenizer_next(t, &tokens[n]); n++)
+        ;
+
+    return n;
+}
+
+/**
+ * Get what remains to split, eg to split at most N times
+ *
+ * @param t the tokenizer
+ * @param rest_len the length of the rest
+ *
+ * @return the rest of the string, `NULL` once the last token was returned
+ */
+const char *str_tokenizer_rest(const StrTokenizer *t, size_t *rest_len)
+{
+    assert(NULL != t);
+    assert(NULL != rest_len);
+
+    if (t->done) {
+        *rest_len = 0;
+        return NULL;
+    }
+    *rest_len = t->end - t->position;
+
+    return t->position;
+}
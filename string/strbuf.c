@@ -0,0 +1,496 @@
+/**
+ * @file string/strbuf.c
+ * @brief growable string (builder) with amortized appends
+ *
+ * A StrBuf keeps track of the length of its string, so appends cost no
+ * rescan, and its capacity is doubled when it is exhausted, so appending
+ * is linear overall. Short strings stay in a small buffer inside the
+ * StrBuf itself: nothing is allocated until they exceed STRBUF_INLINE_SIZE
+ * bytes (trailing `\0` included).
+ *
+ * \code
+ *   StrBuf sb;
+ *   char *error;
+ *
+ *   error = NULL;
+ *   strbuf_init(&sb);
+ *   if (
+ *       !strbuf_append_string(&sb, "{\"id\":", &error)
+ *       || !strbuf_append_uint64_t(&sb, id, &error)
+ *       || !strbuf_append_printf(&sb, &error, ",\"name\":\"%s\"}", name)
+ *   ) {
+ *       // out of memory
+ *   }
+ *   send(fd, sb.ptr, sb.length, 0);
+ *   strbuf_destroy(&sb);
+ * \endcode
+ *
+ * The string is always `\0` terminated and the `_sp` functions can write
+ * directly at its end, with strbuf_end and strbuf_limit as their output
+ * buffer and its limit:
+ * \code
+ *   char *w;
+ *
+ *   if (NULL == (w = stpcpy_sp(strbuf_end(&sb), home, strbuf_limit(&sb)))) {
+ *       if (!strbuf_reserve(&sb, strlen(home), &error)) {
+ *           // out of memory
+ *       }
+ *       w = stpcpy_sp(strbuf_end(&sb), home, strbuf_limit(&sb));
+ *   }
+ *   strbuf_set_end(&sb, w);
+ * \endcode
+ *
+ * @note as *ptr* may point into the StrBuf itself, a StrBuf must not be
+ * copied (by value) nor moved
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "nearest_power.h"
+#include "strbuf.h"
+#include "formatnum.h"
+#include "error.h"
+
+#define STRBUF_IS_INLINE(sb) \
+    ((sb)->ptr == (sb)->inline_buffer)
+
+/**
+ * Initialize a string buffer to an empty string
+ *
+ * @param sb the buffer to initialize
+ */
+void strbuf_init(StrBuf *sb)
+{
+    assert(NULL != sb);
+
+    sb->ptr = sb->inline_buffer;
+    sb->length = 0;
+    sb->allocated = STRBUF_INLINE_SIZE;
+    *sb->ptr = '\0';
+}
+
+/**
+ * Free memory used by a string buffer
+ *
+ * @param sb the buffer to free
+ */
+void strbuf_destroy(StrBuf *sb)
+{
+    assert(NULL != sb);
+
+    if (!STRBUF_IS_INLINE(sb)) {
+        free(sb->ptr);
+    }
+    strbuf_init(sb);
+}
+
+/**
+ * Empty a string buffer without releasing its memory
+ *
+ * @param sb the buffer to clear
+ */
+void strbuf_clear(StrBuf *sb)
+{
+    assert(NULL != sb);
+
+    sb->length = 0;
+    *sb->ptr = '\0';
+}
+
+/**
+ * Release the memory a string buffer doesn't use: its string goes back
+ * inside the StrBuf if it is short enough, else the allocation is
+ * reduced to the string
+ *
+ * @param sb the buffer to shrink
+ *
+ * @note if realloc(3) fails, the buffer keeps its larger allocation
+ */
+void strbuf_shrink(StrBuf *sb)
+{
+    char *ptr;
+
+    assert(NULL != sb);
+
+    if (STRBUF_IS_INLINE(sb)) {
+        return;
+    }
+    if (sb->length < STRBUF_INLINE_SIZE) {
+        memcpy(sb->inline_buffer, sb->ptr, sb->length + 1);
+        free(sb->ptr);
+        sb->ptr = sb->inline_buffer;
+        sb->allocated = STRBUF_INLINE_SIZE;
+    } else if (sb->allocated > sb->length + 1 && NULL != (ptr = realloc(sb->ptr, sb->length + 1))) {
+        sb->ptr = ptr;
+        sb->allocated = sb->length + 1;
+    }
+}
+
+static bool strbuf_grow(StrBuf *sb, size_t additional, char **error)
+{
+    char *ptr;
+    size_t allocated;
+
+    if (additional >= SIZE_MAX - sb->length) {
+        set_generic_error(error, "string length overflow (%zu + %zu)", sb->length, additional);
+        return false;
+    }
+    allocated = nearest_power(sb->length + additional + 1, 2 * STRBUF_INLINE_SIZE);
+    if (allocated < sb->length + additional + 1) {
+        allocated = sb->length + additional + 1;
+    }
+    if (STRBUF_IS_INLINE(sb)) {
+        if (NULL != (ptr = malloc(allocated))) {
+            memcpy(ptr, sb->ptr, sb->length + 1);
+        }
+    } else {
+        ptr = realloc(sb->ptr, allocated);
+    }
+    if (NULL == ptr) {
+        set_malloc_error(error, allocated);
+        return false;
+    }
+    sb->ptr = ptr;
+    sb->allocated = allocated;
+
+    return true;
+}
+
+static inline bool strbuf_ensure(StrBuf *sb, size_t additional, char **error)
+{
+    return EXPECTED(sb->allocated - sb->length > additional) || strbuf_grow(sb, additional, error);
+}
+
+/**
+ * Ensure that at least *additional* bytes can be appended to a string
+ * buffer (trailing `\0` excluded) without any (re)allocation
+ *
+ * @param sb the buffer
+ * @param additional the number of bytes
+ * @param error the error to set if the memory can't be allocated
+ *
+ * @return `false` on failure (the string is left unchanged)
+ */
+bool strbuf_reserve(StrBuf *sb, size_t additional, char **error)
+{
+    assert(NULL != sb);
+
+    // discard what a failed _sp function may have written after the string
+    sb->ptr[sb->length] = '\0';
+
+    return strbuf_ensure(sb, additional, error);
+}
+
+/**
+ * Set the end of the string of a buffer after an external write (by a
+ * `_sp` function between strbuf_end and strbuf_limit)
+ *
+ * @param sb the buffer
+ * @param end the new position of the trailing `\0` of the string
+ */
+void strbuf_set_end(StrBuf *sb, const char *end)
+{
+    assert(NULL != sb);
+    assert(end >= sb->ptr && end < strbuf_limit(sb));
+    assert('\0' == *end);
+
+    sb->length = end - sb->ptr;
+}
+
+/**
+ * Take the ownership of the string of a buffer: it has to be freed with
+ * free(3). The buffer is reset to an empty string.
+ *
+ * @param sb the buffer
+ * @param length if not `NULL`, receives the length of the string
+ * @param error the error to set if the memory can't be allocated (when
+ * the string was still short enough to be inside the StrBuf)
+ *
+ * @return `NULL` on failure (the buffer is left unchanged)
+ */
+char *strbuf_steal(StrBuf *sb, size_t *length, char **error)
+{
+    char *ptr;
+
+    assert(NULL != sb);
+
+    if (STRBUF_IS_INLINE(sb)) {
+        if (NULL == (ptr = malloc(sb->length + 1))) {
+            set_malloc_error(error, sb->length + 1);
+            return NULL;
+        }
+        memcpy(ptr, sb->ptr, sb->length + 1);
+    } else {
+        ptr = sb->ptr;
+    }
+    if (NULL != length) {
+        *length = sb->length;
+    }
+    strbuf_init(sb);
+
+    return ptr;
+}
+
+/**
+ * Append a single character to a string buffer
+ *
+ * @param sb the buffer
+ * @param c the character to append
+ * @param error the error to set if the memory can't be allocated
+ *
+ * @return `false` on failure (the buffer is left unchanged)
+ */
+bool strbuf_append_char(StrBuf *sb, char c, char **error)
+{
+    assert(NULL != sb);
+
+    if (!strbuf_ensure(sb, 1, error)) {
+        return false;
+    }
+    sb->ptr[sb->length++] = c;
+    sb->ptr[sb->length] = '\0';
+
+    return true;
+}
+
+/**
+ * Append the *string_len* first bytes of a string to a string buffer
+ *
+ * @param sb the buffer
+ * @param string the string to append
+ * @param string_len its length
+ * @param error the error to set if the memory can't be allocated
+ *
+ * @return `false` on failure (the buffer is left unchanged)
+ */
+bool strbuf_append_string_len(StrBuf *sb, const char *string, size_t string_len, char **error)
+{
+    assert(NULL != sb);
+    assert(NULL != string || 0 == string_len);
+
+    if (!strbuf_ensure(sb, string_len, error)) {
+        return false;
+    }
+    if (0 != string_len) {
+        memcpy(sb->ptr + sb->length, string, string_len);
+    }
+    sb->length += string_len;
+    sb->ptr[sb->length] = '\0';
+
+    return true;
+}
+
+/**
+ * Insert the *string_len* first bytes of a string into a string buffer
+ *
+ * @param sb the buffer
+ * @param position the offset where to insert *string* (at most the length
+ * of the buffer, which is then the same as appending)
+ * @param string the string to insert (it must not point into the buffer itself)
+ * @param string_len its length
+ * @param error the error to set if the memory can't be allocated
+ *
+ * @return `false` on failure (the buffer is left unchanged)
+ */
+bool strbuf_insert_string_len(StrBuf *sb, size_t position, const char *string, size_t string_len, char **error)
+{
+    assert(NULL != sb);
+    assert(position <= sb->length);
+    assert(NULL != string || 0 == string_len);
+
+    if (!strbuf_ensure(sb, string_len, error)) {
+        return false;
+    }
+    if (0 != string_len) {
+        // the trailing \0 is moved too
+        memmove(sb->ptr + position + string_len, sb->ptr + position, sb->length - position + 1);
+        memcpy(sb->ptr + position, string, string_len);
+        sb->length += string_len;
+    }
+
+    return true;
+}
+
+/**
+ * Append a (`\0` terminated) string to a string buffer
+ *
+ * @param sb the buffer
+ * @param string the string to append
+ * @param error the error to set if the memory can't be allocated
+ *
+ * @return `false` on failure (the buffer is left unchanged)
+ */
+bool strbuf_append_string(StrBuf *sb, const char *string, char **error)
+{
+    assert(NULL != string);
+
+    return strbuf_append_string_len(sb, string, strlen(string), error);
+}
+
+/**
+ * Append a span (from a StrTokenizer for example) to a string buffer
+ *
+ * @param sb the buffer
+ * @param span the span to append
+ * @param error the error to set if the memory can't be allocated
+ *
+ * @return `false` on failure (the buffer is left unchanged)
+ */
+bool strbuf_append_span(StrBuf *sb, const StrSpan *span, char **error)
+{
+    assert(NULL != span);
+
+    return strbuf_append_string_len(sb, span->ptr, span->len, error);
+}
+
+/**
+ * Append several strings to a string buffer, the growable
+ * counterpart of str_vconcat_s
+ *
+ * \code
+ *  strbuf_concat(&sb, &error, "abc", "def", "ghi", NULL);
+ * \endcode
+ *
+ * @param sb the buffer
+ * @param error the error to set if the memory can't be allocated
+ * @param ... a `NULL`-terminated list of strings to append
+ *
+ * @return `false` on failure (the buffer is left unchanged)
+ */
+bool strbuf_concat(StrBuf *sb, char **error, ...) /* SENTINEL */
+{
+    size_t length;
+    va_list ap;
+    const char *s;
+
+    assert(NULL != sb);
+
+    length = 0;
+    va_start(ap, error);
+    while (NULL != (s = va_arg(ap, const char *))) {
+        length += strlen(s);
+    }
+    va_end(ap);
+    if (!strbuf_ensure(sb, length, error)) {
+        return false;
+    }
+    va_start(ap, error);
+    while (NULL != (s = va_arg(ap, const char *))) {
+        size_t s_len;
+
+        s_len = strlen(s);
+        memcpy(sb->ptr + sb->length, s, s_len);
+        sb->length += s_len;
+    }
+    va_end(ap);
+    sb->ptr[sb->length] = '\0';
+
+    return true;
+}
+
+/**
+ * Append a formatted string to a string buffer, as vsprintf(3)
+ *
+ * @param sb the buffer
+ * @param error the error to set if the memory can't be allocated
+ * @param format the format string
+ * @param ap the arguments
+ *
+ * @return `false` on failure (the buffer is left unchanged)
+ */
+bool strbuf_append_vprintf(StrBuf *sb, char **error, const char *format, va_list ap)
+{
+    int len;
+    va_list aq;
+
+    assert(NULL != sb);
+    assert(NULL != format);
+
+    // first attempt in the remaining space, which is usually large enough
+    va_copy(aq, ap);
+    len = vsnprintf(sb->ptr + sb->length, sb->allocated - sb->length, format, aq);
+    va_end(aq);
+    if (len < 0) {
+        sb->ptr[sb->length] = '\0';
+        set_generic_error(error, "vsnprintf(3) failed on \"%s\"", format);
+        return false;
+    }
+    if ((size_t) len >= sb->allocated - sb->length) {
+        sb->ptr[sb->length] = '\0';
+        if (!strbuf_ensure(sb, (size_t) len, error)) {
+            return false;
+        }
+        vsnprintf(sb->ptr + sb->length, sb->allocated - sb->length, format, ap);
+    }
+    sb->length += (size_t) len;
+
+    return true;
+}
+
+/**
+ * Append a formatted string to a string buffer, as sprintf(3)
+ *
+ * @param sb the buffer
+ * @param error the error to set if the memory can't be allocated
+ * @param format the format string
+ * @param ... the arguments
+ *
+ * @return `false` on failure (the buffer is left unchanged)
+ */
+bool strbuf_append_printf(StrBuf *sb, char **error, const char *format, ...)
+{
+    bool ok;
+    va_list ap;
+
+    va_start(ap, format);
+    ok = strbuf_append_vprintf(sb, error, format, ap);
+    va_end(ap);
+
+    return ok;
+}
+
+/**
+ * Append the decimal representation of a number to a string buffer
+ * (see stpfrom* functions of formatnum.c)
+ *
+ * @param sb the buffer
+ * @param value the number to append
+ * @param error the error to set if the memory can't be allocated
+ *
+ * @return `false` on failure (the buffer is left unchanged)
+ */
+#define strbuf_append_number(type, max_length) \
+    bool strbuf_append_## type(StrBuf *sb, type value, char **error) \
+    { \
+        char *end; \
+ \
+        assert(NULL != sb); \
+ \
+        if (!strbuf_ensure(sb, max_length, error)) { \
+            return false; \
+        } \
+        end = stpfrom## type(strbuf_end(sb), value, strbuf_limit(sb)); \
+        assert(NULL != end); \
+        sb->length = end - sb->ptr; \
+ \
+        return true; \
+    }
+
+strbuf_append_number(int8_t, STR_LEN("-128"))
+strbuf_append_number(int16_t, STR_LEN("-32768"))
+strbuf_append_number(int32_t, STR_LEN("-2147483648"))
+strbuf_append_number(int64_t, STR_LEN("-9223372036854775808"))
+strbuf_append_number(uint8_t, STR_LEN("255"))
+strbuf_append_number(uint16_t, STR_LEN("65535"))
+strbuf_append_number(uint32_t, STR_LEN("4294967295"))
+strbuf_append_number(uint64_t, STR_LEN("18446744073709551615"))
+strbuf_append_number(double, STR_LEN("-2.2250738585072014e-308"))
+strbuf_append_number(float, STR_LEN("-1.17549435e-38"))
+
+#undef strbuf_append_number
@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "ascii.h"
+#include "aho_corasick.h"
+#include "error.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+typedef struct {
+    size_t id;
+    size_t offset;
+    size_t length;
+} Match;
+
+typedef struct {
+    Match matches[2048];
+    size_t count;
+    /* stop the search after this number of matches (0: never) */
+    size_t limit;
+} Matches;
+
+static bool on_match(size_t id, size_t offset, size_t length, void *data)
+{
+    Matches *m;
+
+    m = (Matches *) data;
+    TEST_ASSERT_TRUE(m->count < ARRAY_SIZE(m->matches));
+    m->matches[m->count].id = id;
+    m->matches[m->count].offset = offset;
+    m->matches[m->count].length = length;
+    ++m->count;
+
+    return 0 == m->limit || m->count < m->limit;
+}
+
+static bool bytes_equal(const char *a, const char *b, size_t n, bool case_insensitive)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (case_insensitive ? ascii_tolower((unsigned char) a[i]) != ascii_tolower((unsigned char) b[i]) : a[i] != b[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * The expected matches, in the documented order: by end, then from the
+ * longest to the shortest pattern, then in the order patterns were added
+ */
+static void naive_scan(const char * const *patterns, size_t patterns_count, bool case_insensitive, const char *haystack, size_t haystack_len, Matches *expected)
+{
+    size_t end, i, length, max_length;
+
+    expected->count = 0;
+    max_length = 0;
+    for (i = 0; i < patterns_count; i++) {
+        max_length = MAX(max_length, strlen(patterns[i]));
+    }
+    for (end = 1; end <= haystack_len; end++) {
+        for (length = MIN(max_length, end); length > 0; length--) {
+            for (i = 0; i < patterns_count; i++) {
+                if (strlen(patterns[i]) == length && bytes_equal(haystack + end - length, patterns[i], length, case_insensitive)) {
+                    TEST_ASSERT_TRUE(expected->count < ARRAY_SIZE(expected->matches));
+                    expected->matches[expected->count].id = i;
+                    expected->matches[expected->count].offset = end - length;
+                    expected->matches[expected->count].length = length;
+                    ++expected->count;
+                }
+            }
+        }
+    }
+}
+
+static void assert_matches_equal(const Matches *expected, const Matches *actual)
+{
+    size_t i;
+
+    TEST_ASSERT_EQUAL_UINT(expected->count, actual->count);
+    for (i = 0; i < expected->count; i++) {
+        TEST_ASSERT_EQUAL_UINT(expected->matches[i].id, actual->matches[i].id);
+        TEST_ASSERT_EQUAL_UINT(expected->matches[i].offset, actual->matches[i].offset);
+        TEST_ASSERT_EQUAL_UINT(expected->matches[i].length, actual->matches[i].length);
+    }
+}
+
+/* compile *patterns* (pattern i has the identifier i) and compare scan, contains and streams of all chunk sizes to naive_scan */
+static void assert_scan(const char * const *patterns, size_t patterns_count, bool case_insensitive, const char *haystack)
+{
+    size_t i, chunk, haystack_len;
+    Matches expected, actual;
+    AhoCorasick ac;
+    AhoCorasickStream s;
+
+    haystack_len = strlen(haystack);
+    aho_corasick_init(&ac, case_insensitive);
+    for (i = 0; i < patterns_count; i++) {
+        TEST_ASSERT_TRUE(aho_corasick_add(&ac, patterns[i], strlen(patterns[i]), i, NULL));
+    }
+    TEST_ASSERT_EQUAL_UINT(patterns_count, aho_corasick_patterns_count(&ac));
+    TEST_ASSERT_TRUE(aho_corasick_compile(&ac, NULL));
+    naive_scan(patterns, patterns_count, case_insensitive, haystack, haystack_len, &expected);
+
+    actual.count = actual.limit = 0;
+    TEST_ASSERT_TRUE(aho_corasick_scan(&ac, haystack, haystack_len, on_match, &actual));
+    assert_matches_equal(&expected, &actual);
+    TEST_ASSERT_EQUAL(0 != expected.count, aho_corasick_contains(&ac, haystack, haystack_len));
+
+    // in chunks: matches spanning their boundaries are found, with offsets relative to the whole haystack
+    aho_corasick_stream_init(&s, &ac);
+    for (chunk = 1; chunk <= haystack_len; chunk++) {
+        aho_corasick_stream_reset(&s);
+        actual.count = 0;
+        for (i = 0; i < haystack_len; i += chunk) {
+            TEST_ASSERT_TRUE(aho_corasick_stream_feed(&s, haystack + i, MIN(chunk, haystack_len - i), on_match, &actual));
+        }
+        assert_matches_equal(&expected, &actual);
+    }
+
+    // stopping the search
+    if (expected.count > 1) {
+        actual.count = 0;
+        actual.limit = 2;
+        TEST_ASSERT_FALSE(aho_corasick_scan(&ac, haystack, haystack_len, on_match, &actual));
+        TEST_ASSERT_EQUAL_UINT(2, actual.count);
+    }
+
+    aho_corasick_destroy(&ac);
+}
+
+void test_aho_corasick_overlaps(void)
+{
+    // the classic example, patterns are suffixes of others
+    {
+        const char * const patterns[] = { "he", "she", "his", "hers" };
+
+        assert_scan(patterns, ARRAY_SIZE(patterns), false, "ushers");
+        assert_scan(patterns, ARRAY_SIZE(patterns), false, "ahishershehishe");
+        assert_scan(patterns, ARRAY_SIZE(patterns), false, "USHERS");
+    }
+    // prefixes of each other
+    {
+        const char * const patterns[] = { "a", "ab", "abc", "abcd", "bc", "c" };
+
+        assert_scan(patterns, ARRAY_SIZE(patterns), false, "abcdabcabxabcd");
+    }
+    // self-overlapping and duplicate patterns
+    {
+        const char * const patterns[] = { "aa", "aaa", "aa", "aba" };
+
+        assert_scan(patterns, ARRAY_SIZE(patterns), false, "aaaaabababaa");
+    }
+    // no match at all
+    {
+        const char * const patterns[] = { "xyz", "zz" };
+
+        assert_scan(patterns, ARRAY_SIZE(patterns), false, "abcdefghijklmnopqrstuvwxy");
+        assert_scan(patterns, ARRAY_SIZE(patterns), false, "");
+    }
+}
+
+void test_aho_corasick_case_insensitive(void)
+{
+    Matches actual;
+    AhoCorasick ac;
+    const char * const patterns[] = { "He", "sHE", "his", "HERS", "a\xC9" };
+
+    assert_scan(patterns, ARRAY_SIZE(patterns), true, "uSHErs hIs HeRs");
+    // only ASCII letters are folded
+    assert_scan(patterns, ARRAY_SIZE(patterns), true, "A\xC9 a\xE9 A\xE9");
+    // the case matters when not insensitive
+    aho_corasick_init(&ac, false);
+    TEST_ASSERT_TRUE(aho_corasick_add(&ac, "he", STR_LEN("he"), 7, NULL));
+    TEST_ASSERT_TRUE(aho_corasick_compile(&ac, NULL));
+    actual.count = actual.limit = 0;
+    TEST_ASSERT_TRUE(aho_corasick_scan(&ac, "HE hE He he", STR_LEN("HE hE He he"), on_match, &actual));
+    TEST_ASSERT_EQUAL_UINT(1, actual.count);
+    TEST_ASSERT_EQUAL_UINT(7, actual.matches[0].id);
+    TEST_ASSERT_EQUAL_UINT(9, actual.matches[0].offset);
+    TEST_ASSERT_FALSE(aho_corasick_contains(&ac, "HE hE He", STR_LEN("HE hE He")));
+    aho_corasick_destroy(&ac);
+}
+
+void test_aho_corasick_random(void)
+{
+    uint32_t seed;
+    size_t round, i, j;
+    char storage[8][6], haystack[64];
+    const char *patterns[ARRAY_SIZE(storage)];
+
+    seed = 42;
+    for (round = 0; round < 50; round++) {
+        for (i = 0; i < ARRAY_SIZE(storage); i++) {
+            size_t length;
+
+            seed = seed * 1103515245 + 12345;
+            length = 1 + (seed >> 16) % (sizeof(storage[i]) - 1);
+            for (j = 0; j < length; j++) {
+                seed = seed * 1103515245 + 12345;
+                storage[i][j] = "abAB"[(seed >> 16) % (round % 2 ? 4 : 2)];
+            }
+            storage[i][length] = '\0';
+            patterns[i] = storage[i];
+        }
+        for (j = 0; j < sizeof(haystack) - 1; j++) {
+            seed = seed * 1103515245 + 12345;
+            haystack[j] = "abAB"[(seed >> 16) % 4];
+        }
+        haystack[j] = '\0';
+        assert_scan(patterns, ARRAY_SIZE(patterns), false, haystack);
+        assert_scan(patterns, ARRAY_SIZE(patterns), true, haystack);
+    }
+}
+
+void test_aho_corasick_empty(void)
+{
+    char *error;
+    Matches actual;
+    AhoCorasick ac;
+    AhoCorasickStream s;
+
+    // no pattern at all
+    aho_corasick_init(&ac, false);
+    TEST_ASSERT_TRUE(aho_corasick_compile(&ac, NULL));
+    TEST_ASSERT_EQUAL_UINT(0, aho_corasick_patterns_count(&ac));
+    actual.count = actual.limit = 0;
+    TEST_ASSERT_TRUE(aho_corasick_scan(&ac, "abc", STR_LEN("abc"), on_match, &actual));
+    TEST_ASSERT_EQUAL_UINT(0, actual.count);
+    TEST_ASSERT_FALSE(aho_corasick_contains(&ac, "abc", STR_LEN("abc")));
+    TEST_ASSERT_FALSE(aho_corasick_contains(&ac, NULL, 0));
+    aho_corasick_stream_init(&s, &ac);
+    TEST_ASSERT_TRUE(aho_corasick_stream_feed(&s, NULL, 0, on_match, &actual));
+    TEST_ASSERT_EQUAL_UINT(0, actual.count);
+    // no pattern can be added once compiled
+    error = NULL;
+    TEST_ASSERT_FALSE(aho_corasick_add(&ac, "a", STR_LEN("a"), 0, &error));
+    TEST_ASSERT_NOT_NULL(error);
+    error_free(&error);
+    aho_corasick_destroy(&ac);
+
+    // an empty pattern is refused
+    aho_corasick_init(&ac, false);
+    error = NULL;
+    TEST_ASSERT_FALSE(aho_corasick_add(&ac, "", 0, 0, &error));
+    TEST_ASSERT_NOT_NULL(error);
+    error_free(&error);
+    TEST_ASSERT_EQUAL_UINT(0, aho_corasick_patterns_count(&ac));
+    aho_corasick_destroy(&ac);
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_aho_corasick_overlaps, 145);
+    RUN_TEST(test_aho_corasick_case_insensitive, 176);
+    RUN_TEST(test_aho_corasick_random, 198);
+    RUN_TEST(test_aho_corasick_empty, 229);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
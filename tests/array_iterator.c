@@ -1,10 +1,15 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #include "unity/unity.h"
 
+#include "attributes.h"
 #include "utils.h"
 #include "iterator.h"
+#include "aggregate.h"
+#include "generator.h"
+#include "darray.h"
 
 void setUp(void)
 {
@@ -58,6 +63,273 @@ void test_string_array_to_iterator(void)
     iterator_close(&it);
 }
 
+static int values[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+static bool is_even(const void *value, const void *UNUSED(data))
+{
+    return 0 == *((const int *) value) % 2;
+}
+
+static void *square(void *value, void *data)
+{
+    int *result;
+
+    result = (int *) data;
+    *result = *((int *) value) * *((int *) value);
+
+    return result;
+}
+
+void test_lazy_adapters(void)
+{
+    int *v, *k, square_value;
+    size_t i;
+    Iterator its[9];
+    const int expected[] = {4, 16, 36, 1, 2};
+
+    // (squares of the even values of values[1:])[:3] followed by numbers[:2]
+    array_to_iterator(&its[0], values, sizeof(values[0]), ARRAY_SIZE(values));
+    iterator_skip(&its[1], &its[0], 1);
+    iterator_filter_lazy(&its[2], &its[1], is_even, NULL);
+    iterator_map(&its[3], &its[2], square, &square_value);
+    iterator_take(&its[4], &its[3], 3);
+    array_to_iterator(&its[5], numbers, sizeof(numbers[0]), 2);
+    iterator_chain(&its[6], &its[4], &its[5]);
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(expected), iterator_count(&its[6]));
+    for (i = 0, iterator_first(&its[6]); iterator_is_valid(&its[6], NULL, &v); i++, iterator_next(&its[6])) {
+        TEST_ASSERT_EQUAL_INT(expected[i], *v);
+    }
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(expected), i);
+    // the source is untouched
+    TEST_ASSERT_EQUAL_INT(1, values[0]);
+
+    // zipped with values
+    array_to_iterator(&its[7], values, sizeof(values[0]), ARRAY_SIZE(values));
+    iterator_zip(&its[8], &its[7], &its[6]);
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(expected), iterator_count(&its[8]));
+    for (i = 0, iterator_first(&its[8]); iterator_is_valid(&its[8], &k, &v); i++, iterator_next(&its[8])) {
+        TEST_ASSERT_EQUAL_INT(values[i], *k);
+        TEST_ASSERT_EQUAL_INT(expected[i], *v);
+    }
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(expected), i);
+    iterator_close(&its[8]);
+}
+
+void test_iterator_batch(void)
+{
+    size_t n;
+    int *v[4];
+    const void *base;
+    size_t element_size;
+    Iterator it, filter;
+    int64_t big[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+
+    array_to_iterator(&it, big, sizeof(big[0]), ARRAY_SIZE(big));
+    TEST_ASSERT_EQUAL_INT64(55, iterator_sum(&it));
+    TEST_ASSERT_EQUAL_INT64(3628800, iterator_product(&it));
+    iterator_first(&it);
+    iterator_next(&it);
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(big) - 1, iterator_next_span(&it, &base, &element_size));
+    TEST_ASSERT_EQUAL_PTR(&big[1], base);
+    TEST_ASSERT_EQUAL_UINT(sizeof(big[0]), element_size);
+    TEST_ASSERT_EQUAL_UINT(0, iterator_next_span(&it, &base, &element_size));
+    iterator_close(&it);
+
+    // no span nor batch callback: fallback on the regular callbacks
+    array_to_iterator(&it, values, sizeof(values[0]), ARRAY_SIZE(values));
+    iterator_filter_lazy(&filter, &it, is_even, NULL);
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(values) / 2, iterator_count(&filter));
+    iterator_first(&filter);
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(v), n = iterator_next_batch(&filter, NULL, (void **) v, ARRAY_SIZE(v)));
+    TEST_ASSERT_EQUAL_INT(2, *v[0]);
+    TEST_ASSERT_EQUAL_INT(8, *v[3]);
+    TEST_ASSERT_EQUAL_UINT(1, n = iterator_next_batch(&filter, NULL, (void **) v, ARRAY_SIZE(v)));
+    TEST_ASSERT_EQUAL_INT(10, *v[0]);
+    TEST_ASSERT_EQUAL_UINT(0, n = iterator_next_batch(&filter, NULL, (void **) v, ARRAY_SIZE(v)));
+    iterator_close(&filter);
+}
+
+static bool fold_sum(void *acc, void *value, char **UNUSED(error))
+{
+    *((int64_t *) acc) += *((const int *) value);
+
+    return true;
+}
+
+static void combine_sum(void *acc, const void *partial)
+{
+    *((int64_t *) acc) += *((const int64_t *) partial);
+}
+
+void test_iterator_par_reduce(void)
+{
+    int64_t sum;
+    size_t nthreads;
+    Iterator it, slice;
+
+    array_to_iterator(&it, values, sizeof(values[0]), ARRAY_SIZE(values));
+    TEST_ASSERT_TRUE(iterator_split(&it, 2, 3, &slice));
+    // 10 elements in 3 parts: 4 + 3 + 3
+    TEST_ASSERT_EQUAL_UINT(3, iterator_count(&slice));
+    iterator_close(&slice);
+    // more threads than elements is fine too
+    for (nthreads = 1; nthreads <= ARRAY_SIZE(values) + 2; nthreads++) {
+        sum = 0;
+        TEST_ASSERT_TRUE(iterator_par_reduce(&it, &sum, sizeof(sum), fold_sum, combine_sum, nthreads, NULL));
+        TEST_ASSERT_EQUAL_INT64(55, sum);
+    }
+    iterator_close(&it);
+}
+
+void test_iterator_aggregate(void)
+{
+    size_t i;
+    Iterator it;
+    int32_t min, max, numbers[37];
+
+    // long enough to involve the vectorized kernels and their scalar tail
+    for (i = 0; i < ARRAY_SIZE(numbers); i++) {
+        numbers[i] = (int32_t) (i % 2 ? i : -i) * 10000000;
+    }
+    TEST_ASSERT_EQUAL_INT64(-180000000, array_sum_int32_t(numbers, ARRAY_SIZE(numbers)));
+    TEST_ASSERT_TRUE(array_min_int32_t(numbers, ARRAY_SIZE(numbers), &min));
+    TEST_ASSERT_EQUAL_INT32(-360000000, min);
+    TEST_ASSERT_TRUE(array_max_int32_t(numbers, ARRAY_SIZE(numbers), &max));
+    TEST_ASSERT_EQUAL_INT32(350000000, max);
+    TEST_ASSERT_FALSE(array_min_int32_t(numbers, 0, &min));
+    TEST_ASSERT_EQUAL_UINT(19, array_count_if_int32_t(numbers, ARRAY_SIZE(numbers), AGGREGATE_LE, 0));
+    TEST_ASSERT_EQUAL_UINT(36, array_count_if_int32_t(numbers, ARRAY_SIZE(numbers), AGGREGATE_NE, 0));
+
+    // the iterator gives the same results
+    array_to_iterator(&it, numbers, sizeof(numbers[0]), ARRAY_SIZE(numbers));
+    TEST_ASSERT_EQUAL_INT64(-180000000, iterator_sum_int32_t(&it));
+    TEST_ASSERT_TRUE(iterator_max_int32_t(&it, &max));
+    TEST_ASSERT_EQUAL_INT32(350000000, max);
+    TEST_ASSERT_EQUAL_UINT(18, iterator_count_if_int32_t(&it, AGGREGATE_GT, 0));
+    iterator_close(&it);
+}
+
+static int int_cmp(const void *a, const void *b)
+{
+    return *((const int *) a) - *((const int *) b);
+}
+
+static void *count_duplicates(void *first, void *UNUSED(duplicate), void *data)
+{
+    ++*((int *) data);
+
+    return first;
+}
+
+void test_iterator_merge(void)
+{
+    int *v, duplicates;
+    size_t i;
+    Iterator its[4], *sources[] = {&its[0], &its[1], &its[2]};
+    int odds[] = {1, 3, 5, 7}, evens[] = {2, 4, 6}, primes[] = {2, 3, 5, 7, 11};
+    const int expected[] = {1, 2, 2, 3, 3, 4, 5, 5, 6, 7, 7, 11}, distinct[] = {1, 2, 3, 4, 5, 6, 7, 11};
+
+    array_to_iterator(&its[0], odds, sizeof(odds[0]), ARRAY_SIZE(odds));
+    array_to_iterator(&its[1], evens, sizeof(evens[0]), ARRAY_SIZE(evens));
+    array_to_iterator(&its[2], primes, sizeof(primes[0]), ARRAY_SIZE(primes));
+    iterator_merge(&its[3], sources, ARRAY_SIZE(sources), int_cmp, NULL, NULL);
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(expected), iterator_count(&its[3]));
+    for (i = 0, iterator_first(&its[3]); iterator_is_valid(&its[3], NULL, &v); i++, iterator_next(&its[3])) {
+        TEST_ASSERT_EQUAL_INT(expected[i], *v);
+    }
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(expected), i);
+    iterator_close(&its[3]);
+
+    // with duplicates removed
+    duplicates = 0;
+    array_to_iterator(&its[0], odds, sizeof(odds[0]), ARRAY_SIZE(odds));
+    array_to_iterator(&its[1], evens, sizeof(evens[0]), ARRAY_SIZE(evens));
+    array_to_iterator(&its[2], primes, sizeof(primes[0]), ARRAY_SIZE(primes));
+    iterator_merge(&its[3], sources, ARRAY_SIZE(sources), int_cmp, count_duplicates, &duplicates);
+    for (i = 0, iterator_first(&its[3]); iterator_is_valid(&its[3], NULL, &v); i++, iterator_next(&its[3])) {
+        TEST_ASSERT_EQUAL_INT(distinct[i], *v);
+    }
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(distinct), i);
+    TEST_ASSERT_EQUAL_INT(4, duplicates);
+    iterator_close(&its[3]);
+
+    // nothing to merge
+    iterator_merge(&its[3], NULL, 0, int_cmp, NULL, NULL);
+    TEST_ASSERT_TRUE(iterator_empty(&its[3]));
+    iterator_close(&its[3]);
+}
+
+typedef struct {
+    int a, b;
+    size_t n;
+} fibonacci_state;
+
+static void fibonacci(Generator *g, void *data)
+{
+    int tmp;
+    fibonacci_state *s;
+
+    s = (fibonacci_state *) data;
+    GENERATOR_BEGIN(g);
+    s->a = 0;
+    s->b = 1;
+    while (true) {
+        if (0 == s->n--) {
+            GENERATOR_RETURN(g);
+        }
+        GENERATOR_YIELD(g, NULL, &s->a);
+        tmp = s->a + s->b;
+        s->a = s->b;
+        s->b = tmp;
+    }
+    GENERATOR_END(g);
+}
+
+void test_generator(void)
+{
+    int *v;
+    size_t i;
+    Iterator it;
+    fibonacci_state s;
+    const int expected[] = {0, 1, 1, 2, 3, 5, 8, 13};
+
+    s.n = ARRAY_SIZE(expected);
+    generator_to_iterator(&it, fibonacci, &s);
+    for (i = 0, iterator_first(&it); iterator_is_valid(&it, NULL, &v); i++, iterator_next(&it)) {
+        TEST_ASSERT_EQUAL_INT(expected[i], *v);
+    }
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(expected), i);
+    // iterator_first restarts the generator
+    s.n = 3;
+    TEST_ASSERT_EQUAL_UINT(3, iterator_count(&it));
+    iterator_close(&it);
+}
+
+void test_darray_collectable(void)
+{
+    DArray da;
+    Collectable c;
+    Iterator it, filter;
+
+    darray_init(&da, NULL, sizeof(int));
+    darray_to_collectable(&c, &da);
+    // by span (a copy of the whole array)
+    array_to_iterator(&it, values, sizeof(values[0]), ARRAY_SIZE(values));
+    TEST_ASSERT_TRUE(iterator_into(&it, &c));
+    iterator_close(&it);
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(values), da.length);
+    TEST_ASSERT_EQUAL_INT_ARRAY(values, da.data, ARRAY_SIZE(values));
+    // by batch (no span, nor count, for a filter)
+    array_to_iterator(&it, values, sizeof(values[0]), ARRAY_SIZE(values));
+    iterator_filter_lazy(&filter, &it, is_even, NULL);
+    TEST_ASSERT_TRUE(iterator_into(&filter, &c));
+    iterator_close(&filter);
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(values) + ARRAY_SIZE(values) / 2, da.length);
+    TEST_ASSERT_EQUAL_INT(2, darray_at_unsafe(&da, ARRAY_SIZE(values), int));
+    TEST_ASSERT_EQUAL_INT(10, darray_top_unsafe(&da, int));
+    darray_destroy(&da);
+}
+
 char MessageBuffer[50];
 
 static void runTest(UnityTestFunction test)
@@ -83,8 +355,15 @@ int main(void)
     Unity.TestFile = __FILE__;
     UnityBegin();
 
-    RUN_TEST(test_int_array_to_iterator, 19);
-    RUN_TEST(test_string_array_to_iterator, 41);
+    RUN_TEST(test_int_array_to_iterator, 24);
+    RUN_TEST(test_string_array_to_iterator, 46);
+    RUN_TEST(test_lazy_adapters, 83);
+    RUN_TEST(test_iterator_batch, 118);
+    RUN_TEST(test_iterator_par_reduce, 164);
+    RUN_TEST(test_iterator_aggregate, 184);
+    RUN_TEST(test_iterator_merge, 224);
+    RUN_TEST(test_generator, 288);
+    RUN_TEST(test_darray_collectable, 308);
 
     return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
 }
@@ -0,0 +1,317 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "ascii.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/* ========== scalar references (a byte at a time) ========== */
+
+static int scalar_toupper(int c)
+{
+    c = (unsigned char) c;
+
+    return c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c;
+}
+
+static int scalar_tolower(int c)
+{
+    c = (unsigned char) c;
+
+    return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+static int scalar_memcasecmp(const char *str1, const char *str2, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (scalar_toupper(str1[i]) != scalar_toupper(str2[i])) {
+            return scalar_toupper(str1[i]) - scalar_toupper(str2[i]);
+        }
+    }
+
+    return 0;
+}
+
+/* a '\0' in str1 ends the comparison (as equal) */
+static int scalar_strncasecmp(const char *str1, const char *str2, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n && '\0' != str1[i]; i++) {
+        if (scalar_toupper(str1[i]) != scalar_toupper(str2[i])) {
+            return scalar_toupper(str1[i]) - scalar_toupper(str2[i]);
+        }
+    }
+
+    return 0;
+}
+
+static const char *scalar_memcasechr(const char *str, int c, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (scalar_toupper(str[i]) == scalar_toupper(c)) {
+            return str + i;
+        }
+    }
+
+    return NULL;
+}
+
+static const char *scalar_memcasestr(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len)
+{
+    size_t i;
+
+    for (i = 0; i + needle_len <= haystack_len; i++) {
+        if (0 == scalar_memcasecmp(haystack + i, needle, needle_len)) {
+            return haystack + i;
+        }
+    }
+
+    return NULL;
+}
+
+/* ========== helpers ========== */
+
+static uint32_t seed;
+
+static unsigned int next_random(void)
+{
+    seed = seed * 1103515245 + 12345;
+
+    return seed >> 16;
+}
+
+/* letters, the bytes around them, and their counterparts above 0x80 (which must not be folded) */
+static const char alphabet[] = "aAbBzZyY@[`{09 \x80\xC1\xE1\xC2\xE2\xDA\xFA\xDB\xFB\xFF\x7F";
+
+static void random_string(char *str, size_t len, bool with_nul)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        if (with_nul && 0 == next_random() % 16) {
+            str[i] = '\0';
+        } else {
+            str[i] = alphabet[next_random() % STR_LEN(alphabet)];
+        }
+    }
+}
+
+/* swap the case of the ASCII letters only */
+static void swap_case(char *str, size_t len)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        if (scalar_toupper(str[i]) != (unsigned char) str[i]) {
+            str[i] = scalar_toupper(str[i]);
+        } else {
+            str[i] = scalar_tolower(str[i]);
+        }
+    }
+}
+
+static size_t page_size;
+
+/*
+ * A page followed by an inaccessible one: a string which ends at the
+ * end of the first page is followed by a guard page and any read past
+ * it faults
+ */
+static char *guarded_page_new(void)
+{
+    char *p;
+
+    page_size = sysconf(_SC_PAGESIZE);
+    p = mmap(NULL, 2 * page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    TEST_ASSERT_TRUE(MAP_FAILED != p);
+    TEST_ASSERT_EQUAL_INT(0, mprotect(p + page_size, page_size, PROT_NONE));
+
+    return p;
+}
+
+static void guarded_page_free(char *p)
+{
+    munmap(p, 2 * page_size);
+}
+
+/* ========== tests ========== */
+
+void test_ascii_case_bytes(void)
+{
+    int c;
+
+    for (c = 0; c < 256; c++) {
+        TEST_ASSERT_EQUAL_INT(scalar_toupper(c), ascii_toupper(c));
+        TEST_ASSERT_EQUAL_INT(scalar_tolower(c), ascii_tolower(c));
+        TEST_ASSERT_EQUAL_INT(scalar_toupper(c), ascii_toupper((char) c));
+    }
+}
+
+void test_ascii_case_conversion(void)
+{
+    int c;
+    size_t offset, len, i;
+    char all[256], buffer[300], expected[300];
+
+    for (c = 0; c < 256; c++) {
+        all[c] = (char) c;
+    }
+    // every byte value at every position relative to the blocks
+    for (offset = 0; offset < 33; offset++) {
+        for (len = 0; len <= sizeof(buffer) - offset - 1; len += 1 + len / 16) {
+            for (i = 0; i < sizeof(buffer); i++) {
+                buffer[i] = all[(i + offset * 7) % 256];
+            }
+            memcpy(expected, buffer, sizeof(buffer));
+            for (i = offset; i < offset + len; i++) {
+                expected[i] = scalar_tolower(expected[i]);
+            }
+            TEST_ASSERT_EQUAL_PTR(buffer + offset, ascii_str_tolower(buffer + offset, len));
+            // the bytes outside [offset;offset+len[ are untouched
+            TEST_ASSERT_EQUAL_MEMORY(expected, buffer, sizeof(buffer));
+            for (i = offset; i < offset + len; i++) {
+                expected[i] = scalar_toupper(expected[i]);
+            }
+            TEST_ASSERT_EQUAL_PTR(buffer + offset, ascii_str_toupper(buffer + offset, len));
+            TEST_ASSERT_EQUAL_MEMORY(expected, buffer, sizeof(buffer));
+        }
+    }
+}
+
+void test_ascii_case_compare(void)
+{
+    size_t len, k, round;
+    char *page1, *page2;
+
+    seed = 42;
+    page1 = guarded_page_new();
+    page2 = guarded_page_new();
+    for (round = 0; round < 20; round++) {
+        for (len = 0; len <= 80; len++) {
+            char *s1, *s2;
+
+            // lengths bounded: the strings end right before the guard page
+            s1 = page1 + page_size - len;
+            s2 = page2 + page_size - len;
+            random_string(s1, len, 1 == round % 2);
+            memcpy(s2, s1, len);
+            swap_case(s2, len);
+            for (k = 0; k <= len; k++) {
+                if (k < len) {
+                    // a difference at k (if it isn't one of case only)
+                    s2[k] = alphabet[next_random() % STR_LEN(alphabet)];
+                }
+                TEST_ASSERT_EQUAL_INT(scalar_memcasecmp(s1, s2, len), ascii_memcasecmp(s1, s2, len));
+                TEST_ASSERT_EQUAL_INT(scalar_memcasecmp(s2, s1, len), ascii_memcasecmp(s2, s1, len));
+                TEST_ASSERT_EQUAL_INT(scalar_strncasecmp(s1, s2, len), ascii_strncasecmp_l(s1, len, s2, len, len));
+                TEST_ASSERT_EQUAL_INT(scalar_strncasecmp(s1, s2, k), ascii_strncasecmp_l(s1, len, s2, len, k));
+                TEST_ASSERT_EQUAL_INT(scalar_strncasecmp(s1, s2, len - k), ascii_strncasecmp_l(s1, len - k, s2, len, SIZE_MAX));
+                if (0 != len) {
+                    int expected;
+
+                    // a proper prefix is lesser
+                    expected = scalar_memcasecmp(s1, s2, len - 1);
+                    TEST_ASSERT_EQUAL_INT(0 == expected ? 1 : expected, ascii_strcasecmp_l(s1, len, s2, len - 1));
+                    TEST_ASSERT_EQUAL_INT(0 == expected ? -1 : expected, ascii_strcasecmp_l(s1, len - 1, s2, len));
+                }
+                TEST_ASSERT_EQUAL_INT(scalar_memcasecmp(s1, s2, len), ascii_strcasecmp_l(s1, len, s2, len));
+                memcpy(s2, s1, len);
+                swap_case(s2, len);
+            }
+        }
+    }
+
+    // '\0'-terminated strings, the '\0' being the last byte before the guard page
+    for (round = 0; round < 20; round++) {
+        for (len = 0; len <= 80; len++) {
+            char *s1, *s2;
+
+            s1 = page1 + page_size - len - 1;
+            s2 = page2 + page_size - len - 1;
+            random_string(s1, len, false);
+            s1[len] = '\0';
+            memcpy(s2, s1, len + 1);
+            swap_case(s2, len);
+            for (k = 0; k <= len; k++) {
+                TEST_ASSERT_EQUAL_INT(scalar_strncasecmp(s1, s2, SIZE_MAX), ascii_strcasecmp(s1, s2));
+                TEST_ASSERT_EQUAL_INT(scalar_strncasecmp(s2, s1, SIZE_MAX), ascii_strcasecmp(s2, s1));
+                TEST_ASSERT_EQUAL_INT(scalar_strncasecmp(s1, s2, k), ascii_strncasecmp(s1, s2, k));
+                TEST_ASSERT_EQUAL_INT(scalar_strncasecmp(s1, s2, SIZE_MAX), ascii_strncasecmp(s1, s2, SIZE_MAX));
+                if (k < len) {
+                    s2[k] = alphabet[next_random() % STR_LEN(alphabet)];
+                }
+            }
+        }
+    }
+    guarded_page_free(page1);
+    guarded_page_free(page2);
+}
+
+void test_ascii_case_search(void)
+{
+    char *page;
+    size_t len, i, m, round;
+
+    seed = 1234;
+    page = guarded_page_new();
+    for (round = 0; round < 10; round++) {
+        for (len = 0; len <= 80; len++) {
+            char *h;
+
+            h = page + page_size - len;
+            random_string(h, len, 1 == round % 2);
+            for (i = 0; i < STR_LEN(alphabet); i++) {
+                TEST_ASSERT_EQUAL_PTR(scalar_memcasechr(h, alphabet[i], len), ascii_memcasechr(h, alphabet[i], len));
+            }
+            TEST_ASSERT_EQUAL_PTR(scalar_memcasechr(h, '\0', len), ascii_memcasechr(h, '\0', len));
+            for (m = 0; m <= MIN(len, (size_t) 6); m++) {
+                char needle[6];
+
+                // a needle taken from the end of the haystack, so there is at least one match
+                memcpy(needle, h + len - m, m);
+                swap_case(needle, m);
+                TEST_ASSERT_EQUAL_PTR(scalar_memcasestr(h, len, needle, m), ascii_memcasestr(h, len, needle, m));
+                random_string(needle, m, false);
+                TEST_ASSERT_EQUAL_PTR(scalar_memcasestr(h, len, needle, m), ascii_memcasestr(h, len, needle, m));
+            }
+        }
+    }
+    guarded_page_free(page);
+
+    // bytes above 0x80 are not letters: 0xC9 is not the uppercase of 0xE9
+    TEST_ASSERT_NULL(ascii_memcasechr("\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9\xE9", 0xC9, 18));
+    TEST_ASSERT_NULL(ascii_memcasestr("\xE9t\xE9\xE9t\xE9\xE9t\xE9\xE9t\xE9\xE9t\xE9\xE9t\xE9", 18, "\xC9T\xC9", 3));
+    TEST_ASSERT_TRUE(0 != ascii_strcasecmp("\xE9t\xE9\xE9t\xE9\xE9t\xE9\xE9t\xE9\xE9t\xE9\xE9t\xE9", "\xC9T\xC9\xC9T\xC9\xC9T\xC9\xC9T\xC9\xC9T\xC9\xC9T\xC9"));
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_ascii_case_bytes, 158);
+    RUN_TEST(test_ascii_case_conversion, 169);
+    RUN_TEST(test_ascii_case_compare, 200);
+    RUN_TEST(test_ascii_case_search, 269);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "csv.h"
+#include "str_split.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+typedef struct {
+    size_t row;
+    size_t column;
+    /* offset in the line */
+    size_t offset;
+    ParseNumError error;
+} ExpectedError;
+
+/* join the lines, with a "\n" after each of them */
+static char *join_lines(const char * const *lines, size_t lines_count, size_t *starts, size_t *buffer_len)
+{
+    size_t i, len;
+    char *buffer;
+
+    for (len = i = 0; i < lines_count; i++) {
+        len += strlen(lines[i]) + 1;
+    }
+    buffer = malloc(len);
+    for (len = i = 0; i < lines_count; i++) {
+        starts[i] = len;
+        memcpy(buffer + len, lines[i], strlen(lines[i]));
+        len += strlen(lines[i]);
+        buffer[len++] = '\n';
+    }
+    *buffer_len = len;
+
+    return buffer;
+}
+
+static void assert_errors(const CsvBatch *batch, const size_t *starts, const ExpectedError *expected, size_t expected_count)
+{
+    size_t i;
+
+    TEST_ASSERT_EQUAL_UINT(expected_count, batch->errors.length);
+    for (i = 0; i < expected_count; i++) {
+        const CsvCellError *e;
+
+        e = &darray_at_unsafe(&batch->errors, i, CsvCellError);
+        TEST_ASSERT_EQUAL_UINT(expected[i].row, e->row);
+        TEST_ASSERT_EQUAL_UINT(expected[i].column, e->column);
+        TEST_ASSERT_EQUAL_UINT(starts[expected[i].row] + expected[i].offset, e->offset);
+        TEST_ASSERT_EQUAL_INT(expected[i].error, e->error);
+    }
+}
+
+/* the columns, rows and errors of both batches are the same */
+static void assert_batches_equal(const CsvBatch *expected, const CsvBatch *actual)
+{
+    size_t i;
+
+    TEST_ASSERT_EQUAL_UINT(expected->rows, actual->rows);
+    TEST_ASSERT_EQUAL_UINT(expected->columns_count, actual->columns_count);
+    for (i = 0; i < expected->columns_count; i++) {
+        const DArray *e, *a;
+
+        if (CSV_SKIP == expected->columns[i].type) {
+            continue;
+        }
+        e = &expected->columns[i].values;
+        a = &actual->columns[i].values;
+        TEST_ASSERT_EQUAL_UINT(expected->rows, e->length);
+        TEST_ASSERT_EQUAL_UINT(e->length, a->length);
+        if (0 != e->length) {
+            // StrSpan have no padding, spans of both point into the same buffer
+            TEST_ASSERT_EQUAL_MEMORY(e->data, a->data, e->length * e->element_size);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT(expected->errors.length, actual->errors.length);
+    for (i = 0; i < expected->errors.length; i++) {
+        const CsvCellError *e, *a;
+
+        e = &darray_at_unsafe(&expected->errors, i, CsvCellError);
+        a = &darray_at_unsafe(&actual->errors, i, CsvCellError);
+        TEST_ASSERT_EQUAL_UINT(e->row, a->row);
+        TEST_ASSERT_EQUAL_UINT(e->column, a->column);
+        TEST_ASSERT_EQUAL_UINT(e->offset, a->offset);
+        TEST_ASSERT_EQUAL_INT(e->error, a->error);
+    }
+}
+
+void test_csv_error_codes(void)
+{
+    char *buffer;
+    CsvBatch batch;
+    size_t buffer_len, starts[6];
+    const CsvColumnType schema[] = { CSV_INT64, CSV_UINT64, CSV_DOUBLE, CSV_SPAN };
+    const char * const lines[] = {
+        "1,2,3.5,a",
+        "x1,2,x1,b",
+        ",,,",
+        "1x,-1,1.5y,c",
+        "9223372036854775808,18446744073709551616,1e999,d",
+        "-9223372036854775809,1",
+    };
+    const ExpectedError expected[] = {
+        // a non-empty cell without any number is at fault from its first byte, whatever its type
+        { 1, 0, STR_LEN(""), PARSE_NUM_ERR_NON_DIGIT_FOUND },
+        { 1, 2, STR_LEN("x1,2,"), PARSE_NUM_ERR_NON_DIGIT_FOUND },
+        // empty cells
+        { 2, 0, STR_LEN(""), PARSE_NUM_ERR_NO_DIGIT_FOUND },
+        { 2, 1, STR_LEN(","), PARSE_NUM_ERR_NO_DIGIT_FOUND },
+        { 2, 2, STR_LEN(",,"), PARSE_NUM_ERR_NO_DIGIT_FOUND },
+        // trailing garbage
+        { 3, 0, STR_LEN("1"), PARSE_NUM_ERR_NON_DIGIT_FOUND },
+        { 3, 1, STR_LEN("1x,"), PARSE_NUM_ERR_TOO_SMALL },
+        { 3, 2, STR_LEN("1x,-1,1.5"), PARSE_NUM_ERR_NON_DIGIT_FOUND },
+        // out of range
+        { 4, 0, STR_LEN(""), PARSE_NUM_ERR_TOO_LARGE },
+        { 4, 1, STR_LEN("9223372036854775808,"), PARSE_NUM_ERR_TOO_LARGE },
+        { 4, 2, STR_LEN("9223372036854775808,18446744073709551616,"), PARSE_NUM_ERR_TOO_LARGE },
+        { 5, 0, STR_LEN(""), PARSE_NUM_ERR_TOO_SMALL },
+        // missing cells
+        { 5, 2, STR_LEN("-9223372036854775809,1"), PARSE_NUM_ERR_NO_DIGIT_FOUND },
+        { 5, 3, STR_LEN("-9223372036854775809,1"), PARSE_NUM_ERR_NO_DIGIT_FOUND },
+    };
+
+    buffer = join_lines(lines, ARRAY_SIZE(lines), starts, &buffer_len);
+    TEST_ASSERT_TRUE(csv_batch_init(&batch, ',', false, schema, ARRAY_SIZE(schema), NULL));
+    TEST_ASSERT_FALSE(csv_batch_parse(&batch, buffer, buffer_len));
+    TEST_ASSERT_EQUAL_UINT(ARRAY_SIZE(lines), batch.rows);
+    assert_errors(&batch, starts, expected, ARRAY_SIZE(expected));
+    // a cell in error is 0, the others keep their value
+    TEST_ASSERT_EQUAL_INT64(1, darray_at_unsafe(csv_batch_column(&batch, 0), 0, int64_t));
+    TEST_ASSERT_EQUAL_INT64(0, darray_at_unsafe(csv_batch_column(&batch, 0), 1, int64_t));
+    TEST_ASSERT_EQUAL_UINT64(2, darray_at_unsafe(csv_batch_column(&batch, 1), 1, uint64_t));
+    TEST_ASSERT_TRUE(3.5 == darray_at_unsafe(csv_batch_column(&batch, 2), 0, double));
+    TEST_ASSERT_TRUE(0.0 == darray_at_unsafe(csv_batch_column(&batch, 2), 1, double));
+    TEST_ASSERT_EQUAL_UINT64(1, darray_at_unsafe(csv_batch_column(&batch, 1), 5, uint64_t));
+    TEST_ASSERT_EQUAL_UINT(1, darray_at_unsafe(csv_batch_column(&batch, 3), 3, StrSpan).len);
+    TEST_ASSERT_EQUAL_UINT(0, darray_at_unsafe(csv_batch_column(&batch, 3), 2, StrSpan).len);
+    TEST_ASSERT_EQUAL_UINT(0, darray_at_unsafe(csv_batch_column(&batch, 3), 5, StrSpan).len);
+    csv_batch_destroy(&batch);
+    free(buffer);
+}
+
+void test_csv_lines(void)
+{
+    CsvBatch batch;
+    const CsvColumnType schema[] = { CSV_INT64, CSV_SKIP, CSV_DOUBLE };
+    const char buffer[] = "id;name;amount\r\n1;a;1.5\r\n\r\n\n2;b;-2;extra\n3;c;3e2";
+
+    TEST_ASSERT_TRUE(csv_batch_init(&batch, ';', true, schema, ARRAY_SIZE(schema), NULL));
+    // the last line has no final newline, empty lines and the header are skipped, "\r\n" as "\n"
+    TEST_ASSERT_TRUE(csv_batch_parse(&batch, buffer, STR_LEN(buffer)));
+    TEST_ASSERT_EQUAL_UINT(3, batch.rows);
+    TEST_ASSERT_EQUAL_INT64(1, darray_at_unsafe(csv_batch_column(&batch, 0), 0, int64_t));
+    TEST_ASSERT_EQUAL_INT64(2, darray_at_unsafe(csv_batch_column(&batch, 0), 1, int64_t));
+    TEST_ASSERT_EQUAL_INT64(3, darray_at_unsafe(csv_batch_column(&batch, 0), 2, int64_t));
+    TEST_ASSERT_TRUE(1.5 == darray_at_unsafe(csv_batch_column(&batch, 2), 0, double));
+    TEST_ASSERT_TRUE(-2.0 == darray_at_unsafe(csv_batch_column(&batch, 2), 1, double));
+    TEST_ASSERT_TRUE(300.0 == darray_at_unsafe(csv_batch_column(&batch, 2), 2, double));
+    // the header is only the first line of the first buffer
+    TEST_ASSERT_FALSE(csv_batch_parse(&batch, "x;y;z\n", STR_LEN("x;y;z\n")));
+    TEST_ASSERT_EQUAL_UINT(4, batch.rows);
+    csv_batch_destroy(&batch);
+
+    // an unterminated number at the very end of the buffer
+    TEST_ASSERT_TRUE(csv_batch_init(&batch, ',', false, schema, 1, NULL));
+    TEST_ASSERT_TRUE(csv_batch_parse(&batch, "7\n8", STR_LEN("7\n8")));
+    TEST_ASSERT_EQUAL_UINT(2, batch.rows);
+    TEST_ASSERT_EQUAL_INT64(8, darray_at_unsafe(csv_batch_column(&batch, 0), 1, int64_t));
+    TEST_ASSERT_TRUE(csv_batch_parse(&batch, "", 0));
+    TEST_ASSERT_EQUAL_UINT(2, batch.rows);
+    csv_batch_destroy(&batch);
+
+    // no column: only count the rows
+    TEST_ASSERT_TRUE(csv_batch_init(&batch, ',', false, NULL, 0, NULL));
+    TEST_ASSERT_TRUE(csv_batch_parse(&batch, buffer, STR_LEN(buffer)));
+    TEST_ASSERT_EQUAL_UINT(4, batch.rows);
+    csv_batch_destroy(&batch);
+}
+
+void test_csv_parallel(void)
+{
+    char *buffer;
+    size_t i, nthreads, buffer_len, buffer_size;
+    CsvBatch serial, parallel;
+    const CsvColumnType schema[] = { CSV_INT64, CSV_UINT64, CSV_DOUBLE, CSV_SPAN, CSV_SKIP };
+
+    // large enough for 4 chunks of CSV_MIN_CHUNK_SIZE at least
+    buffer_size = 1024 * 1024;
+    buffer = malloc(buffer_size);
+    buffer_len = 0;
+    for (i = 0; buffer_len + 128 < buffer_size; i++) {
+        if (0 == i % 50) {
+            // an empty line
+            buffer[buffer_len++] = '\n';
+        } else if (0 == i % 97) {
+            // some errors (including a missing cell), their rows have to be shifted
+            buffer_len += sprintf(buffer + buffer_len, "%zu,x%zu,%zu.5y\n", i, i, i);
+        } else {
+            buffer_len += sprintf(buffer + buffer_len, "%zu,%zu,-%zu.25,name%zu,skipped%s", i, i * 3, i, i, 0 == i % 31 ? "\r\n" : "\n");
+        }
+    }
+    // the last line has no final newline
+    buffer_len += sprintf(buffer + buffer_len, "%zu,%zu,%zu", i, i, i);
+
+    TEST_ASSERT_TRUE(csv_batch_init(&serial, ',', true, schema, ARRAY_SIZE(schema), NULL));
+    TEST_ASSERT_FALSE(csv_batch_parse(&serial, buffer, buffer_len));
+    TEST_ASSERT_TRUE(serial.rows > 1000);
+    TEST_ASSERT_TRUE(serial.errors.length > 0);
+    for (nthreads = 0; nthreads <= 5; nthreads++) {
+        TEST_ASSERT_TRUE(csv_batch_init(&parallel, ',', true, schema, ARRAY_SIZE(schema), NULL));
+        TEST_ASSERT_FALSE(csv_batch_parse_parallel(&parallel, buffer, buffer_len, nthreads));
+        assert_batches_equal(&serial, &parallel);
+        csv_batch_destroy(&parallel);
+    }
+    csv_batch_destroy(&serial);
+
+    // no column
+    TEST_ASSERT_TRUE(csv_batch_init(&serial, ',', false, NULL, 0, NULL));
+    TEST_ASSERT_TRUE(csv_batch_init(&parallel, ',', false, NULL, 0, NULL));
+    TEST_ASSERT_TRUE(csv_batch_parse(&serial, buffer, buffer_len));
+    TEST_ASSERT_TRUE(csv_batch_parse_parallel(&parallel, buffer, buffer_len, 4));
+    assert_batches_equal(&serial, &parallel);
+    csv_batch_destroy(&serial);
+    csv_batch_destroy(&parallel);
+
+    free(buffer);
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_csv_error_codes, 101);
+    RUN_TEST(test_csv_lines, 156);
+    RUN_TEST(test_csv_parallel, 193);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
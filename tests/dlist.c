@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "dlist.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/* fill *list* with the values [from;to[ */
+static void fill(DList *list, intptr_t from, intptr_t to)
+{
+    intptr_t i;
+
+    dlist_init(list, NULL, NULL);
+    for (i = from; i < to; i++) {
+        TEST_ASSERT_TRUE(dlist_append(list, (void *) i, NULL));
+    }
+}
+
+static DListElement *element_at(DList *list, size_t n)
+{
+    DListElement *el;
+
+    for (el = list->head; 0 != n--; el = el->next)
+        ;
+
+    return el;
+}
+
+/* check the content of *list*, in both directions, against the count values which follow */
+static void assert_list(DList *list, size_t count, ...)
+{
+    size_t i;
+    va_list ap;
+    intptr_t expected[32];
+    DListElement *el;
+
+    va_start(ap, count);
+    for (i = 0; i < count; i++) {
+        expected[i] = va_arg(ap, int);
+    }
+    va_end(ap);
+    TEST_ASSERT_EQUAL_UINT(count, dlist_length(list));
+    TEST_ASSERT_EQUAL(0 == count, dlist_empty(list));
+    for (i = 0, el = list->head; NULL != el; i++, el = el->next) {
+        TEST_ASSERT_TRUE(i < count);
+        TEST_ASSERT_EQUAL_INT(expected[i], (intptr_t) el->data);
+        TEST_ASSERT_TRUE(el->prev == (0 == i ? NULL : element_at(list, i - 1)));
+    }
+    TEST_ASSERT_EQUAL_UINT(count, i);
+    for (el = list->tail; NULL != el; el = el->prev) {
+        TEST_ASSERT_EQUAL_INT(expected[--i], (intptr_t) el->data);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, i);
+}
+
+void test_dlist_splice(void)
+{
+    size_t count;
+    DList a, b;
+
+    // with and without the number of moved elements
+    for (count = 0; count <= 3; count += 3) {
+        // a partial run into the middle of an other list
+        fill(&a, 0, 6);
+        fill(&b, 10, 13);
+        dlist_splice(&b, element_at(&b, 1), &a, element_at(&a, 2), element_at(&a, 4), count);
+        assert_list(&a, 3, 0, 1, 5);
+        assert_list(&b, 6, 10, 2, 3, 4, 11, 12);
+        dlist_clear(&a);
+        dlist_clear(&b);
+
+        // the head of a list at the end of an other
+        fill(&a, 0, 6);
+        fill(&b, 10, 13);
+        dlist_splice(&b, NULL, &a, a.head, element_at(&a, 2), count);
+        assert_list(&a, 3, 3, 4, 5);
+        assert_list(&b, 6, 10, 11, 12, 0, 1, 2);
+        dlist_clear(&a);
+        dlist_clear(&b);
+
+        // the tail of a list at the head of an empty one
+        fill(&a, 0, 6);
+        dlist_init(&b, NULL, NULL);
+        dlist_splice(&b, NULL, &a, element_at(&a, 3), a.tail, count);
+        assert_list(&a, 3, 0, 1, 2);
+        assert_list(&b, 3, 3, 4, 5);
+        dlist_clear(&a);
+        dlist_clear(&b);
+
+        // inside the same list: move [3;5] before its head
+        fill(&a, 0, 6);
+        dlist_splice(&a, a.head, &a, element_at(&a, 3), a.tail, count);
+        assert_list(&a, 6, 3, 4, 5, 0, 1, 2);
+        dlist_clear(&a);
+    }
+
+    // a whole list, single element
+    fill(&a, 0, 1);
+    fill(&b, 10, 12);
+    dlist_splice(&b, b.head, &a, a.head, a.tail, 0);
+    assert_list(&a, 0);
+    assert_list(&b, 3, 0, 10, 11);
+    dlist_clear(&b);
+}
+
+void test_dlist_concat(void)
+{
+    DList a, b;
+
+    fill(&a, 0, 2);
+    fill(&b, 2, 5);
+    dlist_concat(&a, &b);
+    assert_list(&a, 5, 0, 1, 2, 3, 4);
+    assert_list(&b, 0);
+
+    // from an empty list
+    dlist_concat(&a, &b);
+    assert_list(&a, 5, 0, 1, 2, 3, 4);
+
+    // to an empty list
+    dlist_concat(&b, &a);
+    assert_list(&a, 0);
+    assert_list(&b, 5, 0, 1, 2, 3, 4);
+    TEST_ASSERT_TRUE(dlist_append(&a, (void *) 42, NULL));
+    assert_list(&a, 1, 42);
+    dlist_clear(&a);
+    dlist_clear(&b);
+}
+
+void test_dlist_cut_after(void)
+{
+    DList a, rest;
+
+    // in the middle, with and without the number of moved elements
+    fill(&a, 0, 5);
+    dlist_init(&rest, NULL, NULL);
+    dlist_cut_after(&a, element_at(&a, 1), &rest, 3);
+    assert_list(&a, 2, 0, 1);
+    assert_list(&rest, 3, 2, 3, 4);
+    dlist_cut_after(&rest, rest.head, &a, 0);
+    assert_list(&rest, 1, 2);
+    assert_list(&a, 4, 0, 1, 3, 4);
+
+    // after the tail: nothing to move
+    dlist_cut_after(&a, a.tail, &rest, 0);
+    assert_list(&a, 4, 0, 1, 3, 4);
+    assert_list(&rest, 1, 2);
+
+    // NULL: everything moves
+    dlist_cut_after(&a, NULL, &rest, 0);
+    assert_list(&a, 0);
+    assert_list(&rest, 5, 2, 0, 1, 3, 4);
+
+    // an empty list
+    dlist_cut_after(&a, NULL, &rest, 0);
+    assert_list(&a, 0);
+    assert_list(&rest, 5, 2, 0, 1, 3, 4);
+    dlist_clear(&rest);
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_dlist_splice, 68);
+    RUN_TEST(test_dlist_concat, 118);
+    RUN_TEST(test_dlist_cut_after, 142);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
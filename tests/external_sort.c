@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "external_sort.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+typedef struct {
+    uint32_t key;
+    uint32_t payload;
+} Record;
+
+static int record_cmp(const void *a, const void *b)
+{
+    const Record *ra, *rb;
+
+    ra = (const Record *) a;
+    rb = (const Record *) b;
+
+    return (ra->key > rb->key) - (ra->key < rb->key);
+}
+
+/* a permutation of [0;n[ when n and 7919 are coprime */
+static uint32_t shuffle(size_t i, size_t n)
+{
+    return (uint32_t) ((i * 7919 + 13) % n);
+}
+
+/*
+ * sort the n records of the permutation with the given budget (and fan-in,
+ * if not 0) and check the result
+ */
+static void assert_sorts(size_t n, size_t budget, size_t fanin, bool expect_runs)
+{
+    size_t i;
+    char *error;
+    Record r, *v;
+    uint32_t expected;
+    Iterator it;
+    ExternalSort es;
+
+    error = NULL;
+    TEST_ASSERT_TRUE(external_sort_init(&es, sizeof(r), budget, record_cmp, &error));
+    if (0 != fanin) {
+        // each merged run still needs a record of the buffer
+        TEST_ASSERT_TRUE(fanin <= es.capacity);
+        es.fanin = fanin;
+    }
+    for (i = 0; i < n; i++) {
+        r.key = shuffle(i, n) / 2;
+        r.payload = ~r.key;
+        TEST_ASSERT_TRUE(external_sort_push(&es, &r, &error));
+    }
+    TEST_ASSERT_EQUAL_UINT(n, external_sort_count(&es));
+    TEST_ASSERT_TRUE(external_sort_to_iterator(&it, &es, &error));
+    TEST_ASSERT_EQUAL(expect_runs, es.runs.length > 0);
+    // never more runs than the fan-in, which is the limit of open files
+    TEST_ASSERT_TRUE(es.runs.length < es.fanin);
+    for (i = 0, iterator_first(&it); iterator_is_valid(&it, NULL, &v); i++, iterator_next(&it)) {
+        TEST_ASSERT_TRUE(i < n);
+        // each key is present twice (keys are halves of a permutation)
+        expected = (uint32_t) (i / 2);
+        TEST_ASSERT_EQUAL_UINT32(expected, v->key);
+        TEST_ASSERT_EQUAL_UINT32(~expected, v->payload);
+    }
+    TEST_ASSERT_EQUAL_UINT(n, i);
+    TEST_ASSERT_FALSE(external_sort_io_error(&es));
+    iterator_close(&it);
+    external_sort_destroy(&es);
+    TEST_ASSERT_NULL(error);
+}
+
+void test_external_sort_in_memory(void)
+{
+    assert_sorts(0, 1024, 0, false);
+    assert_sorts(100, 100 * sizeof(Record), 0, false);
+}
+
+void test_external_sort_cascade(void)
+{
+    // a tiny budget: runs of 8 records and a fan-in of 2
+    assert_sorts(10000, 8 * sizeof(Record), 0, true);
+    // the smallest budget (2 records), 5000 runs
+    assert_sorts(10000, 1, 0, true);
+    // a fan-in of 4 (read buffers of 64 KB at least)
+    assert_sorts(1000000, 4 * 64 * 1024, 0, true);
+    // a fan-in of 24 (more runs than the initial capacity of their array)
+    // and runs of 24 records: 1000 runs, enough for runs of three levels
+    // (the first merge of merged runs happens after about 23 * 23 runs)
+    assert_sorts(24 * 1000, 24 * sizeof(Record), 24, true);
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_external_sort_in_memory, 85);
+    RUN_TEST(test_external_sort_cascade, 91);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
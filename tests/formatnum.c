@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "unity/unity.h"
+
+#include "utils.h"
+#include "formatnum.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+#define UT(type, value, expected) \
+    do { \
+        char *w, buffer[32]; \
+ \
+        w = stpfrom## type(buffer, value, buffer + ARRAY_SIZE(buffer)); \
+        if (NULL == w || 0 != strcmp(buffer, expected)) { \
+            printf("stpfrom%s: \"%s\" written (\"%s\" expected)\n", #type, buffer, expected); \
+        } \
+        TEST_ASSERT(NULL != w); \
+        TEST_ASSERT(0 == strcmp(buffer, expected)); \
+        TEST_ASSERT(w == buffer + STR_LEN(expected)); \
+        /* exactly the needed size */ \
+        TEST_ASSERT(buffer + STR_LEN(expected) == stpfrom## type(buffer, value, buffer + STR_SIZE(expected))); \
+        /* one byte short */ \
+        TEST_ASSERT(NULL == stpfrom## type(buffer, value, buffer + STR_LEN(expected))); \
+        TEST_ASSERT('\0' == buffer[0]); \
+    } while (0);
+
+void test_integers(void)
+{
+    UT(int8_t, 0, "0");
+    UT(int8_t, INT8_MIN, "-128");
+    UT(int8_t, INT8_MAX, "127");
+    UT(uint8_t, UINT8_MAX, "255");
+    UT(int16_t, INT16_MIN, "-32768");
+    UT(uint16_t, 10000, "10000");
+    UT(int32_t, -99, "-99");
+    UT(int32_t, INT32_MIN, "-2147483648");
+    UT(uint32_t, UINT32_MAX, "4294967295");
+    UT(int64_t, INT64_MIN, "-9223372036854775808");
+    UT(int64_t, INT64_MAX, "9223372036854775807");
+    UT(uint64_t, UINT64_MAX, "18446744073709551615");
+    UT(uint64_t, UINT64_C(10000000000000000000), "10000000000000000000");
+    UT(uint64_t, UINT64_C(9999999999999999999), "9999999999999999999");
+}
+
+void test_floats(void)
+{
+    UT(double, 0.0, "0");
+    UT(double, -0.0, "-0");
+    UT(double, 1.0, "1");
+    UT(double, 0.1, "0.1");
+    UT(double, 0.3, "0.3");
+    UT(double, -123.456, "-123.456");
+    UT(double, 0.0001, "0.0001");
+    UT(double, 0.00001, "1e-05");
+    UT(double, 1e16, "10000000000000000");
+    UT(double, 1e17, "1e+17");
+    UT(double, 1e23, "1e+23");
+    UT(double, 9007199254740993.0, "9007199254740992");
+    UT(double, 5e-324, "5e-324");
+    UT(double, 2.2250738585072014e-308, "2.2250738585072014e-308");
+    UT(double, 1.7976931348623157e308, "1.7976931348623157e+308");
+    UT(double, 1.0 / 0.0, "inf");
+    UT(double, -1.0 / 0.0, "-inf");
+    UT(float, 0.1f, "0.1");
+    UT(float, 16777216.0f, "16777216");
+    UT(float, 1e9f, "1e+09");
+    UT(float, 1e-45f, "1e-45");
+    UT(float, 3.4028235e38f, "3.4028235e+38");
+}
+
+char MessageBuffer[50];
+
+static void runTest(UnityTestFunction test)
+{
+    if (TEST_PROTECT()) {
+        setUp();
+        test();
+    }
+    if (TEST_PROTECT() && !TEST_IS_IGNORED) {
+        tearDown();
+    }
+}
+
+void resetTest(void)
+{
+    tearDown();
+    setUp();
+}
+
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_integers, 37);
+    RUN_TEST(test_floats, 55);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "iterator.h"
+#include "hashtable.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+#define N 100
+
+/* a permutation of [0;N[ (N and 37 being coprime) which doesn't follow the bucket order */
+#define SHUFFLE(i) \
+    ((uintptr_t) (((i) * 37 + 11) % N))
+
+static void hashtable_fill(HashTable *ht)
+{
+    size_t i;
+
+    hashtable_init(ht, 0, value_hash, value_equal, NULL, NULL, NULL);
+    for (i = 0; i < N; i++) {
+        TEST_ASSERT_TRUE(hashtable_put(ht, 0, SHUFFLE(i), SHUFFLE(i) + 1, NULL));
+    }
+}
+
+void test_hashtable_iterator(void)
+{
+    size_t i;
+    void *k, *v;
+    Iterator it;
+    HashTable ht;
+
+    hashtable_fill(&ht);
+    hashtable_to_iterator(&it, &ht);
+    TEST_ASSERT_EQUAL_UINT(N, iterator_count(&it));
+    // insertion order, in both directions
+    for (i = 0, iterator_first(&it); iterator_is_valid(&it, &k, &v); i++, iterator_next(&it)) {
+        TEST_ASSERT_EQUAL_UINT(SHUFFLE(i), (uintptr_t) k);
+        TEST_ASSERT_EQUAL_UINT(SHUFFLE(i) + 1, (uintptr_t) v);
+    }
+    TEST_ASSERT_EQUAL_UINT(N, i);
+    for (iterator_last(&it); iterator_is_valid(&it, &k, NULL); iterator_previous(&it)) {
+        TEST_ASSERT_EQUAL_UINT(SHUFFLE(--i), (uintptr_t) k);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, i);
+    iterator_close(&it);
+    hashtable_destroy(&ht);
+}
+
+static void assert_slices_follow_insertion_order(HashTable *ht, const uintptr_t *expected, size_t expected_count)
+{
+    void *k;
+    size_t i, index, parts;
+    Iterator it, slice;
+
+    hashtable_to_iterator(&it, ht);
+    for (parts = 1; parts <= expected_count + 2; parts++) {
+        i = 0;
+        for (index = 0; index < parts; index++) {
+            size_t from, to;
+
+            TEST_ASSERT_TRUE(iterator_split(&it, index, parts, &slice));
+            iterator_split_range(expected_count, index, parts, &from, &to);
+            TEST_ASSERT_EQUAL_UINT(i, from);
+            for (iterator_first(&slice); iterator_is_valid(&slice, &k, NULL); iterator_next(&slice)) {
+                TEST_ASSERT_TRUE(i < to);
+                TEST_ASSERT_EQUAL_UINT(expected[i], (uintptr_t) k);
+                ++i;
+            }
+            TEST_ASSERT_EQUAL_UINT(to, i);
+            iterator_close(&slice);
+        }
+        TEST_ASSERT_EQUAL_UINT(expected_count, i);
+    }
+    iterator_close(&it);
+}
+
+static bool fold_sum(void *acc, void *value, char **UNUSED(error))
+{
+    *((uintptr_t *) acc) += (uintptr_t) value;
+
+    return true;
+}
+
+static void combine_sum(void *acc, const void *partial)
+{
+    *((uintptr_t *) acc) += *((const uintptr_t *) partial);
+}
+
+void test_hashtable_iterator_split(void)
+{
+    size_t i, count;
+    uintptr_t sum, expected[N];
+    Iterator it;
+    HashTable ht;
+
+    hashtable_init(&ht, 0, value_hash, value_equal, NULL, NULL, NULL);
+    assert_slices_follow_insertion_order(&ht, expected, 0);
+    hashtable_destroy(&ht);
+
+    hashtable_fill(&ht);
+    for (i = 0; i < N; i++) {
+        expected[i] = SHUFFLE(i);
+    }
+    assert_slices_follow_insertion_order(&ht, expected, N);
+
+    // with holes
+    for (i = 0, count = 0; i < N; i++) {
+        if (0 == i % 3) {
+            TEST_ASSERT_TRUE(hashtable_delete(&ht, SHUFFLE(i), false));
+        } else {
+            expected[count++] = SHUFFLE(i);
+        }
+    }
+    assert_slices_follow_insertion_order(&ht, expected, count);
+
+    sum = 0;
+    hashtable_to_iterator(&it, &ht);
+    TEST_ASSERT_TRUE(iterator_par_reduce(&it, &sum, sizeof(sum), fold_sum, combine_sum, 4, NULL));
+    iterator_close(&it);
+    for (i = 0; i < count; i++) {
+        sum -= expected[i] + 1;
+    }
+    TEST_ASSERT_EQUAL_UINT(0, sum);
+    hashtable_destroy(&ht);
+}
+
+void test_hashtable_collectable(void)
+{
+    size_t i;
+    void *v;
+    Iterator it;
+    Collectable c;
+    HashTable src, dst;
+
+    hashtable_fill(&src);
+    hashtable_init(&dst, 0, value_hash, value_equal, NULL, NULL, NULL);
+    for (i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(hashtable_put(&dst, 0, i * N, i, NULL));
+    }
+    hashtable_put(&dst, 0, 0, 42, NULL);
+    // the source is counted: buckets are reserved up front for all of its values
+    hashtable_to_iterator(&it, &src);
+    TEST_ASSERT_EQUAL_UINT(N, iterator_count(&it));
+    hashtable_to_collectable(&c, &dst);
+    TEST_ASSERT_TRUE(iterator_into(&it, &c));
+    iterator_close(&it);
+    TEST_ASSERT_EQUAL_UINT(N + 9, hashtable_size(&dst));
+    TEST_ASSERT_TRUE(dst.capacity > hashtable_size(&dst));
+    for (i = 0; i < N; i++) {
+        TEST_ASSERT_TRUE(hashtable_get(&dst, i, &v));
+        TEST_ASSERT_EQUAL_UINT(i + 1, (uintptr_t) v);
+    }
+    for (i = 1; i < 10; i++) {
+        TEST_ASSERT_TRUE(hashtable_get(&dst, i * N, &v));
+        TEST_ASSERT_EQUAL_UINT(i, (uintptr_t) v);
+    }
+    // the same keys again: their values are replaced, the (re)hashed table stays consistent
+    hashtable_to_iterator(&it, &src);
+    TEST_ASSERT_TRUE(iterator_into(&it, &c));
+    iterator_close(&it);
+    TEST_ASSERT_EQUAL_UINT(N + 9, hashtable_size(&dst));
+    for (i = 0; i < N; i++) {
+        TEST_ASSERT_TRUE(hashtable_get(&dst, i, &v));
+        TEST_ASSERT_EQUAL_UINT(i + 1, (uintptr_t) v);
+    }
+    hashtable_destroy(&dst);
+    hashtable_destroy(&src);
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_hashtable_iterator, 37);
+    RUN_TEST(test_hashtable_iterator_split, 101);
+    RUN_TEST(test_hashtable_collectable, 139);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
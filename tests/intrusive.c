@@ -0,0 +1,327 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "idlist.h"
+#include "ihashtable.h"
+#include "rbtree/irbtree.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+#define N 1000
+
+typedef struct {
+    int value;
+    DListLink list_link;
+    RBTreeLink tree_link;
+    HashLink hash_link;
+} Element;
+
+static Element elements[N];
+
+/* a permutation of [0;N[ (N and 7 being coprime) */
+#define SHUFFLE(i) \
+    ((int) (((i) * 7 + 3) % N))
+
+static void elements_init(void)
+{
+    int i;
+
+    memset(elements, 0, sizeof(elements));
+    for (i = 0; i < N; i++) {
+        elements[i].value = i;
+    }
+}
+
+static void assert_idlist(IDList *list, const int *expected, size_t expected_count)
+{
+    size_t i;
+    void *v;
+    Iterator it;
+    DListLink *link;
+
+    TEST_ASSERT_EQUAL_UINT(expected_count, idlist_length(list));
+    TEST_ASSERT_EQUAL(0 == expected_count, idlist_empty(list));
+    i = 0;
+    idlist_foreach(list, link) {
+        TEST_ASSERT_TRUE(i < expected_count);
+        TEST_ASSERT_EQUAL_INT(expected[i], idlist_entry(link, Element, list_link)->value);
+        ++i;
+    }
+    TEST_ASSERT_EQUAL_UINT(expected_count, i);
+    idlist_foreach_reverse(list, link) {
+        --i;
+        TEST_ASSERT_EQUAL_INT(expected[i], idlist_entry(link, Element, list_link)->value);
+    }
+    idlist_to_iterator(&it, list);
+    for (i = 0, iterator_first(&it); iterator_is_valid(&it, NULL, &v); i++, iterator_next(&it)) {
+        TEST_ASSERT_EQUAL_INT(expected[i], idlist_entry(v, Element, list_link)->value);
+    }
+    TEST_ASSERT_EQUAL_UINT(expected_count, i);
+    for (iterator_last(&it); iterator_is_valid(&it, NULL, &v); iterator_previous(&it)) {
+        --i;
+        TEST_ASSERT_EQUAL_INT(expected[i], idlist_entry(v, Element, list_link)->value);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, i);
+    iterator_close(&it);
+}
+
+static int element_value_cmp(const DListLink *link, const void *data)
+{
+    return idlist_entry(link, const Element, list_link)->value - *(const int *) data;
+}
+
+void test_idlist(void)
+{
+    int key;
+    IDList list;
+
+    elements_init();
+    idlist_init(&list);
+    assert_idlist(&list, NULL, 0);
+    TEST_ASSERT_NULL(idlist_pop_head(&list));
+    TEST_ASSERT_NULL(idlist_pop_tail(&list));
+
+    idlist_append(&list, &elements[2].list_link);
+    idlist_prepend(&list, &elements[0].list_link);
+    idlist_append(&list, &elements[4].list_link);
+    idlist_insert_after(&list, &elements[0].list_link, &elements[1].list_link);
+    idlist_insert_before(&list, &elements[4].list_link, &elements[3].list_link);
+    idlist_insert_after(&list, &elements[4].list_link, &elements[5].list_link);
+    {
+        const int expected[] = { 0, 1, 2, 3, 4, 5 };
+
+        assert_idlist(&list, expected, ARRAY_SIZE(expected));
+    }
+
+    key = 3;
+    TEST_ASSERT_EQUAL_PTR(&elements[3].list_link, idlist_find_first(&list, element_value_cmp, &key));
+    TEST_ASSERT_EQUAL_PTR(&elements[3].list_link, idlist_find_last(&list, element_value_cmp, &key));
+    key = 42;
+    TEST_ASSERT_NULL(idlist_find_first(&list, element_value_cmp, &key));
+
+    idlist_remove_link(&list, &elements[2].list_link);
+    idlist_move_to_head(&list, &elements[4].list_link);
+    idlist_move_to_tail(&list, &elements[0].list_link);
+    {
+        const int expected[] = { 4, 1, 3, 5, 0 };
+
+        assert_idlist(&list, expected, ARRAY_SIZE(expected));
+    }
+
+    TEST_ASSERT_EQUAL_PTR(&elements[4].list_link, idlist_pop_head(&list));
+    TEST_ASSERT_EQUAL_PTR(&elements[0].list_link, idlist_pop_tail(&list));
+    idlist_remove_link(&list, &elements[1].list_link);
+    idlist_remove_link(&list, &elements[5].list_link);
+    {
+        const int expected[] = { 3 };
+
+        assert_idlist(&list, expected, ARRAY_SIZE(expected));
+    }
+    idlist_remove_link(&list, &elements[3].list_link);
+    assert_idlist(&list, NULL, 0);
+}
+
+static int element_tree_cmp(const void *key, const RBTreeLink *link)
+{
+    int a, b;
+
+    a = *(const int *) key;
+    b = irbtree_entry(link, const Element, tree_link)->value;
+
+    return (a > b) - (a < b);
+}
+
+static void assert_irbtree_sorted(IRBTree *tree, size_t expected_count)
+{
+    int previous;
+    size_t i;
+    void *v;
+    Iterator it;
+    RBTreeLink *link;
+
+    TEST_ASSERT_EQUAL_UINT(expected_count, irbtree_count(tree));
+    TEST_ASSERT_EQUAL(0 == expected_count, irbtree_empty(tree));
+    previous = -1;
+    for (i = 0, link = irbtree_first(tree); NULL != link; i++, link = irbtree_next(tree, link)) {
+        TEST_ASSERT_TRUE(previous <= irbtree_entry(link, Element, tree_link)->value);
+        previous = irbtree_entry(link, Element, tree_link)->value;
+    }
+    TEST_ASSERT_EQUAL_UINT(expected_count, i);
+    for (link = irbtree_last(tree); NULL != link; link = irbtree_previous(tree, link)) {
+        --i;
+    }
+    TEST_ASSERT_EQUAL_UINT(0, i);
+    irbtree_to_iterator(&it, tree);
+    TEST_ASSERT_EQUAL_UINT(expected_count, iterator_count(&it));
+    for (iterator_first(&it), link = irbtree_first(tree); iterator_is_valid(&it, NULL, &v); iterator_next(&it), link = irbtree_next(tree, link)) {
+        TEST_ASSERT_EQUAL_PTR(link, v);
+    }
+    TEST_ASSERT_NULL(link);
+    iterator_close(&it);
+}
+
+void test_irbtree(void)
+{
+    int i, key;
+    IRBTree tree;
+    Element dup;
+    RBTreeLink *link;
+
+    elements_init();
+    irbtree_init(&tree, element_tree_cmp);
+    assert_irbtree_sorted(&tree, 0);
+    TEST_ASSERT_NULL(irbtree_first(&tree));
+    TEST_ASSERT_NULL(irbtree_last(&tree));
+
+    for (i = 0; i < N; i++) {
+        Element *e;
+
+        e = &elements[SHUFFLE(i)];
+        TEST_ASSERT_NULL(irbtree_insert(&tree, 0, &e->value, &e->tree_link));
+    }
+    assert_irbtree_sorted(&tree, N);
+    TEST_ASSERT_EQUAL_INT(0, irbtree_entry(irbtree_first(&tree), Element, tree_link)->value);
+    TEST_ASSERT_EQUAL_INT(N - 1, irbtree_entry(irbtree_last(&tree), Element, tree_link)->value);
+
+    // a duplicate key is refused unless IRBTREE_INSERT_ALLOW_DUP_KEY, then placed after the existing one
+    memset(&dup, 0, sizeof(dup));
+    dup.value = 500;
+    TEST_ASSERT_EQUAL_PTR(&elements[500].tree_link, irbtree_insert(&tree, 0, &dup.value, &dup.tree_link));
+    TEST_ASSERT_NULL(irbtree_insert(&tree, IRBTREE_INSERT_ALLOW_DUP_KEY, &dup.value, &dup.tree_link));
+    TEST_ASSERT_EQUAL_PTR(&dup.tree_link, irbtree_next(&tree, &elements[500].tree_link));
+    assert_irbtree_sorted(&tree, N + 1);
+    irbtree_remove(&tree, &dup.tree_link);
+
+    for (i = 0; i < N; i++) {
+        key = i;
+        link = irbtree_lookup(&tree, &key);
+        TEST_ASSERT_NOT_NULL(link);
+        // container_of round-trip
+        TEST_ASSERT_EQUAL_PTR(&elements[i], irbtree_entry(link, Element, tree_link));
+    }
+    key = N;
+    TEST_ASSERT_NULL(irbtree_lookup(&tree, &key));
+
+    // remove the odd values
+    for (i = 0; i < N; i++) {
+        if (0 != (SHUFFLE(i) & 1)) {
+            irbtree_remove(&tree, &elements[SHUFFLE(i)].tree_link);
+        }
+    }
+    assert_irbtree_sorted(&tree, N / 2);
+    for (i = 0, link = irbtree_first(&tree); NULL != link; i += 2, link = irbtree_next(&tree, link)) {
+        TEST_ASSERT_EQUAL_INT(i, irbtree_entry(link, Element, tree_link)->value);
+    }
+    for (i = 0; i < N; i += 2) {
+        irbtree_remove(&tree, &elements[i].tree_link);
+    }
+    assert_irbtree_sorted(&tree, 0);
+}
+
+static bool element_hash_equal(ht_key_t key, const HashLink *link)
+{
+    return (int) key == ihashtable_entry(link, const Element, hash_link)->value;
+}
+
+static void assert_ihashtable(IHashTable *ht, const bool *present)
+{
+    int i;
+    size_t count;
+    void *v;
+    Iterator it;
+    bool seen[N];
+
+    for (count = 0, i = 0; i < N; i++) {
+        count += present[i];
+        if (present[i]) {
+            TEST_ASSERT_EQUAL_PTR(&elements[i].hash_link, ihashtable_get(ht, i));
+        } else {
+            TEST_ASSERT_NULL(ihashtable_get(ht, i));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT(count, ihashtable_size(ht));
+    // each element is visited exactly once
+    memset(seen, 0, sizeof(seen));
+    ihashtable_to_iterator(&it, ht);
+    TEST_ASSERT_EQUAL_UINT(count, iterator_count(&it));
+    for (iterator_first(&it); iterator_is_valid(&it, NULL, &v); iterator_next(&it)) {
+        Element *e;
+
+        e = ihashtable_entry(v, Element, hash_link);
+        TEST_ASSERT_TRUE(e >= elements && e < elements + N);
+        TEST_ASSERT_TRUE(present[e->value]);
+        TEST_ASSERT_FALSE(seen[e->value]);
+        seen[e->value] = true;
+        --count;
+    }
+    TEST_ASSERT_EQUAL_UINT(0, count);
+    iterator_close(&it);
+}
+
+void test_ihashtable(void)
+{
+    int i;
+    IHashTable ht;
+    Element dup;
+    bool present[N];
+
+    elements_init();
+    memset(present, 0, sizeof(present));
+    // start small to go through several growths
+    TEST_ASSERT_TRUE(ihashtable_init(&ht, 0, NULL, element_hash_equal, NULL));
+    assert_ihashtable(&ht, present);
+
+    for (i = 0; i < N; i++) {
+        int v;
+
+        v = SHUFFLE(i);
+        TEST_ASSERT_NULL(ihashtable_put(&ht, v, &elements[v].hash_link));
+        present[v] = true;
+    }
+    assert_ihashtable(&ht, present);
+
+    memset(&dup, 0, sizeof(dup));
+    dup.value = 42;
+    TEST_ASSERT_EQUAL_PTR(&elements[42].hash_link, ihashtable_put(&ht, dup.value, &dup.hash_link));
+    TEST_ASSERT_EQUAL_PTR(&elements[42], ihashtable_entry(ihashtable_get(&ht, 42), Element, hash_link));
+
+    for (i = 0; i < N; i += 3) {
+        ihashtable_remove(&ht, &elements[i].hash_link);
+        present[i] = false;
+    }
+    assert_ihashtable(&ht, present);
+
+    // a removed link can be inserted again
+    TEST_ASSERT_NULL(ihashtable_put(&ht, 0, &elements[0].hash_link));
+    present[0] = true;
+    assert_ihashtable(&ht, present);
+
+    ihashtable_clear(&ht);
+    memset(present, 0, sizeof(present));
+    assert_ihashtable(&ht, present);
+    ihashtable_destroy(&ht);
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_idlist, 85);
+    RUN_TEST(test_irbtree, 175);
+    RUN_TEST(test_ihashtable, 273);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
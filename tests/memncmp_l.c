@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "unity/unity.h"
 
@@ -34,6 +35,74 @@ void test_memncmp_l(void)
     TEST_ASSERT(memncmp_l("ab", 2, "abc", 3, 2) == 0);
 }
 
+void test_memcmp_prefix(void)
+{
+    size_t i, n;
+    char str1[80], str2[80];
+
+    // zero length
+    TEST_ASSERT_EQUAL_UINT(0, memcmp_prefix("", "", 0));
+    TEST_ASSERT_EQUAL_UINT(0, memcmp_prefix("a", "b", 0));
+    // equal inputs
+    TEST_ASSERT_EQUAL_UINT(3, memcmp_prefix("abc", "abc", 3));
+        // a proper prefix: only the first n bytes are compared
+    TEST_ASSERT_EQUAL_UINT(2, memcmp_prefix("abc", "abd", 2));
+    // a differing byte before the end
+    TEST_ASSERT_EQUAL_UINT(0, memcmp_prefix("abc", "xbc", 3));
+    TEST_ASSERT_EQUAL_UINT(1, memcmp_prefix("abc", "axc", 3));
+    TEST_ASSERT_EQUAL_UINT(1, memcmp_prefix("a\x80", "a\x7F", 2));
+
+    // every length and every position of the difference, around the blocks of 8, 16 and 32 bytes
+    memset(str1, 'a', sizeof(str1));
+    TEST_ASSERT_EQUAL_UINT(sizeof(str1), memcmp_prefix(str1, str1, sizeof(str1)));
+    for (n = 0; n <= sizeof(str1); n++) {
+        memset(str2, 'a', sizeof(str2));
+        TEST_ASSERT_EQUAL_UINT(n, memcmp_prefix(str1, str2, n));
+        for (i = 0; i < n; i++) {
+            str2[i] = 'b';
+            TEST_ASSERT_EQUAL_UINT(i, memcmp_prefix(str1, str2, n));
+            // a difference after the first one does not matter
+            if (i + 1 < n) {
+                str2[n - 1] = 'c';
+                TEST_ASSERT_EQUAL_UINT(i, memcmp_prefix(str1, str2, n));
+                str2[n - 1] = 'a';
+            }
+            str2[i] = 'a';
+        }
+    }
+}
+
+void test_memcmp_l_prefix(void)
+{
+    size_t prefix_len;
+
+    // zero lengths
+    TEST_ASSERT(memcmp_l_prefix("", 0, "", 0, &prefix_len) == 0);
+    TEST_ASSERT_EQUAL_UINT(0, prefix_len);
+    TEST_ASSERT(memcmp_l_prefix("", 0, "abc", 3, &prefix_len) < 0);
+    TEST_ASSERT_EQUAL_UINT(0, prefix_len);
+    TEST_ASSERT(memcmp_l_prefix("abc", 3, "", 0, &prefix_len) > 0);
+    TEST_ASSERT_EQUAL_UINT(0, prefix_len);
+    // equal inputs
+    TEST_ASSERT(memcmp_l_prefix("abc", 3, "abc", 3, &prefix_len) == 0);
+    TEST_ASSERT_EQUAL_UINT(3, prefix_len);
+    // a proper prefix
+    TEST_ASSERT(memcmp_l_prefix("ab", 2, "abc", 3, &prefix_len) < 0);
+    TEST_ASSERT_EQUAL_UINT(2, prefix_len);
+    TEST_ASSERT(memcmp_l_prefix("abc", 3, "ab", 2, &prefix_len) > 0);
+    TEST_ASSERT_EQUAL_UINT(2, prefix_len);
+    // a differing byte before the end of the prefix
+    TEST_ASSERT(memcmp_l_prefix("abc", 3, "abd", 3, &prefix_len) < 0);
+    TEST_ASSERT_EQUAL_UINT(2, prefix_len);
+    TEST_ASSERT(memcmp_l_prefix("axc", 3, "ab", 2, &prefix_len) > 0);
+    TEST_ASSERT_EQUAL_UINT(1, prefix_len);
+    // bytes are compared as unsigned
+    TEST_ASSERT(memcmp_l_prefix("a\x80", 2, "a\x7F", 2, &prefix_len) > 0);
+    TEST_ASSERT_EQUAL_UINT(1, prefix_len);
+    // prefix_len is optional
+    TEST_ASSERT(memcmp_l_prefix("ab", 2, "abc", 3, NULL) < 0);
+}
+
 char MessageBuffer[50];
 
 static void runTest(UnityTestFunction test)
@@ -59,8 +128,10 @@ int main(void)
     Unity.TestFile = __FILE__;
     UnityBegin();
 
-    RUN_TEST(test_memcmp_l, 14);
-    RUN_TEST(test_memncmp_l, 24);
+    RUN_TEST(test_memcmp_l, 18);
+    RUN_TEST(test_memncmp_l, 28);
+    RUN_TEST(test_memcmp_prefix, 38);
+    RUN_TEST(test_memcmp_l_prefix, 75);
 
     return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
 }
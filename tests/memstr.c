@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "memstr.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static uint32_t seed;
+
+static uint32_t next_random(void)
+{
+    seed = seed * 1103515245 + 12345;
+
+    return seed >> 16;
+}
+
+static const char *naive_memstr(const char *haystack, size_t n, const char *needle, size_t m)
+{
+    size_t i;
+
+    for (i = 0; i + m <= n; i++) {
+        if (0 == memcmp(haystack + i, needle, m)) {
+            return haystack + i;
+        }
+    }
+
+    return NULL;
+}
+
+static const char *naive_memrstr(const char *haystack, size_t n, const char *needle, size_t m)
+{
+    size_t i;
+
+    for (i = n - m + 1; m <= n && i-- > 0; ) {
+        if (0 == memcmp(haystack + i, needle, m)) {
+            return haystack + i;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Compare the 4 searches to the naive ones. The haystack is copied in a
+ * buffer of its exact size to catch (with ASan) any read past its end.
+ */
+static void assert_search(const char *haystack, size_t n, const char *needle, size_t m)
+{
+    char *h;
+    MemStrNeedle compiled;
+
+    h = malloc(MAX(n, (size_t) 1));
+    memcpy(h, haystack, n);
+    memstr_compile(&compiled, needle, m);
+    TEST_ASSERT_EQUAL_PTR(naive_memstr(h, n, needle, m), memstr(h, needle, m, h + n));
+    TEST_ASSERT_EQUAL_PTR(naive_memrstr(h, n, needle, m), memrstr(h, needle, m, h + n));
+    TEST_ASSERT_EQUAL_PTR(naive_memstr(h, n, needle, m), memstr_compiled(&compiled, h, h + n));
+    TEST_ASSERT_EQUAL_PTR(naive_memrstr(h, n, needle, m), memrstr_compiled(&compiled, h, h + n));
+    free(h);
+}
+
+static const char *needles[] = {
+    "",
+    "a",
+    "b",
+    "ab",
+    "ba",
+    "aaab",
+    "abab",
+    "baaa",
+    "abcab",
+    "aabaabaaab",
+    // the longest needle searched by the first/last byte filter
+    "abababababababababababababababab",
+    // Two-Way
+    "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab",
+    "abababababababababababababababababab",
+    "baaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+    "abbabaabbaababbabaababbaabbabaababbaabbabaab",
+    "aabaabaabaabaabaabaabaabaabaabaabaabaabaabaabaabaabaabaabaabaabaab",
+};
+
+void test_memstr_edge_cases(void)
+{
+    size_t i, n;
+    char haystack[80];
+
+    memset(haystack, 'a', sizeof(haystack));
+    for (i = 0; i < ARRAY_SIZE(needles); i++) {
+        size_t m;
+
+        m = strlen(needles[i]);
+        // haystacks shorter than, as long as and longer than the needle, around the vector widths
+        for (n = 0; n <= sizeof(haystack); n++) {
+            assert_search(haystack, n, needles[i], m);
+            // a match at the very end (and start) of the haystack
+            if (m <= n) {
+                char *h;
+
+                h = malloc(MAX(n, (size_t) 1));
+                memset(h, 'c', n);
+                memcpy(h + n - m, needles[i], m);
+                assert_search(h, n, needles[i], m);
+                if (0 != m) {
+                    TEST_ASSERT_EQUAL_PTR(h + n - m, naive_memrstr(h, n, needles[i], m));
+                }
+                memset(h, 'c', n);
+                memcpy(h, needles[i], m);
+                assert_search(h, n, needles[i], m);
+                free(h);
+            }
+        }
+    }
+
+    // empty needle: at the start for memstr, at the end for memrstr
+    TEST_ASSERT_EQUAL_PTR(haystack, memstr(haystack, "", 0, haystack + 10));
+    TEST_ASSERT_EQUAL_PTR(haystack + 10, memrstr(haystack, "", 0, haystack + 10));
+    TEST_ASSERT_EQUAL_PTR(haystack, memstr(haystack, "", 0, haystack));
+    TEST_ASSERT_EQUAL_PTR(haystack, memrstr(haystack, "", 0, haystack));
+}
+
+void test_memstr_random(void)
+{
+    char haystack[300];
+    size_t i, j, n, round;
+
+    seed = 42;
+    for (round = 0; round < 40; round++) {
+        // a small alphabet for a lot of partial matches
+        for (j = 0; j < sizeof(haystack); j++) {
+            haystack[j] = "abc"[next_random() % (round < 20 ? 2 : 3)];
+        }
+        for (i = 0; i < ARRAY_SIZE(needles); i++) {
+            for (n = 0; n <= 70; n++) {
+                assert_search(haystack, n, needles[i], strlen(needles[i]));
+            }
+            assert_search(haystack, sizeof(haystack), needles[i], strlen(needles[i]));
+        }
+        // needles taken from the haystack itself
+        for (i = 0; i < 20; i++) {
+            size_t from, m;
+
+            m = 1 + next_random() % 64;
+            from = next_random() % (sizeof(haystack) - m);
+            for (n = from + m; n <= sizeof(haystack); n += 1 + next_random() % 16) {
+                assert_search(haystack, n, haystack + from, m);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_memstr_edge_cases, 95);
+    RUN_TEST(test_memstr_random, 134);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -70,6 +70,45 @@ UT(zero_in_front_as_decimal, uint32_t, "0123456789", 123456789, PARSE_NUM_NO_ERR
 UT(zero_in_front_as_auto, int32_t, "0123456789", 01234567, PARSE_NUM_ERR_NON_DIGIT_FOUND, 0, 0, 0, STR_LEN("012345678") - 1);
 UT(zero_in_front_as_auto, uint32_t, "0123456789", 01234567, PARSE_NUM_ERR_NON_DIGIT_FOUND, 0, 0, 0, STR_LEN("012345678") - 1);
 
+UT(eight_digits, int32_t, "12345678", 12345678, PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("12345678"));
+UT(eight_digits, int64_t, "12345678", 12345678, PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("12345678"));
+UT(eight_digits, uint64_t, "12345678", 12345678, PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("12345678"));
+UT(sixteen_digits, int64_t, "1234567890123456", INT64_C(1234567890123456), PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("1234567890123456"));
+UT(sixteen_digits, uint64_t, "-1234567890123456", (uint64_t) INT64_C(-1234567890123456), PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("-1234567890123456"));
+UT(twenty_digits, uint64_t, "01234567890123456789", UINT64_C(1234567890123456789), PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("01234567890123456789"));
 
+UT(exact_max, int32_t, "2147483647", INT32_MAX, PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("2147483647"));
+UT(exact_min, int32_t, "-2147483648", INT32_MIN, PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("-2147483648"));
+UT(max_plus_one, int32_t, "2147483648", INT32_MAX, PARSE_NUM_ERR_TOO_LARGE, 10, 0, 0, STR_LEN("2147483648"));
+UT(min_minus_one, int32_t, "-2147483649", INT32_MIN, PARSE_NUM_ERR_TOO_SMALL, 10, 0, 0, STR_LEN("-2147483649"));
+UT(exact_max, int64_t, "9223372036854775807", INT64_MAX, PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("9223372036854775807"));
+UT(exact_min, int64_t, "-9223372036854775808", INT64_MIN, PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("-9223372036854775808"));
+UT(max_plus_one, int64_t, "9223372036854775808", INT64_MAX, PARSE_NUM_ERR_TOO_LARGE, 10, 0, 0, STR_LEN("9223372036854775808"));
+UT(min_minus_one, int64_t, "-9223372036854775809", INT64_MIN, PARSE_NUM_ERR_TOO_SMALL, 10, 0, 0, STR_LEN("-9223372036854775809"));
+UT(far_too_large, int64_t, "92233720368547758070000", INT64_MAX, PARSE_NUM_ERR_TOO_LARGE, 10, 0, 0, STR_LEN("92233720368547758070000"));
+UT(exact_max, uint64_t, "18446744073709551615", UINT64_MAX, PARSE_NUM_NO_ERR, 10, 0, 0, STR_LEN("18446744073709551615"));
+UT(max_plus_one, uint64_t, "18446744073709551616", UINT64_MAX, PARSE_NUM_ERR_TOO_LARGE, 10, 0, 0, STR_LEN("18446744073709551616"));
+UT(far_too_large, uint64_t, "184467440737095516150000", UINT64_MAX, PARSE_NUM_ERR_TOO_LARGE, 10, 0, 0, STR_LEN("184467440737095516150000"));
+
+UT(hex_upper, int32_t, "7FFFFFFF", INT32_MAX, PARSE_NUM_NO_ERR, 16, 0, 0, STR_LEN("7FFFFFFF"));
+UT(hex_lower, int32_t, "0x7fffffff", INT32_MAX, PARSE_NUM_NO_ERR, 0, 0, 0, STR_LEN("0x7fffffff"));
+UT(hex_max_plus_one, int32_t, "80000000", INT32_MAX, PARSE_NUM_ERR_TOO_LARGE, 16, 0, 0, STR_LEN("80000000"));
+UT(hex_upper, int64_t, "0X7FFFFFFFFFFFFFFF", INT64_MAX, PARSE_NUM_NO_ERR, 0, 0, 0, STR_LEN("0X7FFFFFFFFFFFFFFF"));
+UT(hex_lower, int64_t, "7fffffffffffffff", INT64_MAX, PARSE_NUM_NO_ERR, 16, 0, 0, STR_LEN("7fffffffffffffff"));
+UT(hex_exact_min, int64_t, "-0x8000000000000000", INT64_MIN, PARSE_NUM_NO_ERR, 16, 0, 0, STR_LEN("-0x8000000000000000"));
+UT(hex_max_plus_one, int64_t, "0x8000000000000000", INT64_MAX, PARSE_NUM_ERR_TOO_LARGE, 16, 0, 0, STR_LEN("0x8000000000000000"));
+UT(hex_upper, uint64_t, "FFFFFFFFFFFFFFFF", UINT64_MAX, PARSE_NUM_NO_ERR, 16, 0, 0, STR_LEN("FFFFFFFFFFFFFFFF"));
+UT(hex_lower, uint64_t, "0xffffffffffffffff", UINT64_MAX, PARSE_NUM_NO_ERR, 0, 0, 0, STR_LEN("0xffffffffffffffff"));
+UT(hex_mixed_case, uint64_t, "DeadBeefCafeBabe", UINT64_C(0xDEADBEEFCAFEBABE), PARSE_NUM_NO_ERR, 16, 0, 0, STR_LEN("DeadBeefCafeBabe"));
+UT(hex_max_plus_one, uint64_t, "0x10000000000000000", UINT64_MAX, PARSE_NUM_ERR_TOO_LARGE, 16, 0, 0, STR_LEN("0x10000000000000000"));
+
+UT(non_digit_in_first_block, int32_t, "1234/678", 1234, PARSE_NUM_ERR_NON_DIGIT_FOUND, 10, 0, 0, STR_LEN("1234/") - 1);
+UT(non_digit_in_first_block, int64_t, "1234:678", 1234, PARSE_NUM_ERR_NON_DIGIT_FOUND, 10, 0, 0, STR_LEN("1234:") - 1);
+UT(non_digit_in_first_block, uint64_t, "1234" "\xB0" "5678", 1234, PARSE_NUM_ERR_NON_DIGIT_FOUND, 10, 0, 0, STR_LEN("1234\xB0") - 1);
+UT(non_digit_in_second_block, int64_t, "12345678901a345678", INT64_C(12345678901), PARSE_NUM_ERR_NON_DIGIT_FOUND, 10, 0, 0, STR_LEN("12345678901a") - 1);
+UT(non_digit_in_second_block, uint64_t, "1234567890123456 7", UINT64_C(1234567890123456), PARSE_NUM_ERR_NON_DIGIT_FOUND, 10, 0, 0, STR_LEN("1234567890123456 ") - 1);
+UT(hex_non_digit_in_block, int64_t, "abcdef`0", 0xABCDEF, PARSE_NUM_ERR_NON_DIGIT_FOUND, 16, 0, 0, STR_LEN("abcdef`") - 1);
+UT(hex_non_digit_in_block, uint64_t, "0123456789abcdeg", UINT64_C(0x0123456789ABCDE), PARSE_NUM_ERR_NON_DIGIT_FOUND, 16, 0, 0, STR_LEN("0123456789abcdeg") - 1);
+UT(hex_non_digit_after_block, uint64_t, "DEADBEEF@", UINT64_C(0xDEADBEEF), PARSE_NUM_ERR_NON_DIGIT_FOUND, 16, 0, 0, STR_LEN("DEADBEEF@") - 1);
 
 UT(unary_minus_unsigned, uint8_t, "-1", UINT8_MAX, PARSE_NUM_NO_ERR, 0, 0, 0, STR_LEN("-1"));
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <inttypes.h>
 
 #include "parsenum.h"
 #include "utils.h"
@@ -16,6 +17,16 @@ void tearDown(void)
 {
 }
 
+/* print the values with the modifier matching the signedness of their type */
+#define PRINT_VALUE_MISMATCH(type, string, v, expected_value) \
+    do { \
+        if ((type) -1 < (type) 1) { \
+            printf("parse_%s(%s): %" PRIi64 " parsed (%" PRIi64 " expected)\n", #type, string, (int64_t) (v), (int64_t) (expected_value)); \
+        } else { \
+            printf("parse_%s(%s): %" PRIu64 " parsed (%" PRIu64 " expected)\n", #type, string, (uint64_t) (v), (uint64_t) (type) (expected_value)); \
+        } \
+    } while (0)
+
 #define UT(name, type, strval, expected_value, expected_return, base, _min, _max, stopoffset) \
     void test_strtonX_##name##_##type(void) { \
         ParseNumError x; \
@@ -44,8 +55,7 @@ void tearDown(void)
         } \
         TEST_ASSERT(x == expected_return); \
         if (v != expected_value) { \
-            /* TODO: PRIi8 vs PRIu8 modifier */ \
-            printf("parse_%s(%s): %d parsed (%d expected)\n", #type, string, v, expected_value); \
+            PRINT_VALUE_MISMATCH(type, string, v, expected_value); \
         } \
         TEST_ASSERT(v == expected_value); \
         stopchar = string[stopoffset]; \
@@ -79,8 +89,7 @@ void tearDown(void)
         } \
         TEST_ASSERT(x == expected_return); \
         if (v != expected_value) { \
-            /* TODO: PRIi8 vs PRIu8 modifier */ \
-            printf("parse_%s(%s): %d parsed (%d expected)\n", #type, string, v, expected_value); \
+            PRINT_VALUE_MISMATCH(type, string, v, expected_value); \
         } \
         TEST_ASSERT(v == expected_value); \
         stopchar = string[stopoffset]; \
@@ -130,6 +139,57 @@ void strtoint8_t_without_endptr(void)
     TEST_ASSERT(23 == ret);
 }
 
+void good_strntodouble(void)
+{
+    double ret;
+    char *endptr, string[] = "-1.25e-3ABC";
+
+    TEST_ASSERT(PARSE_NUM_NO_ERR == strntodouble(string, string + STR_LEN("-1.25e-3"), &endptr, NULL, NULL, &ret));
+    TEST_ASSERT(-1.25e-3 == ret);
+    TEST_ASSERT('A' == *endptr);
+}
+
+void strtodouble_correctly_rounded(void)
+{
+    double ret;
+    char *endptr;
+
+    /* exactly halfway between 2^53 and 2^53 + 2: ties to even */
+    TEST_ASSERT(PARSE_NUM_NO_ERR == strtodouble("9007199254740993", &endptr, NULL, NULL, &ret));
+    TEST_ASSERT(9007199254740992.0 == ret);
+    /* one digit past the halfway point, far beyond 19 significant digits */
+    TEST_ASSERT(PARSE_NUM_NO_ERR == strtodouble("9007199254740993.0000000000000000000000000001", &endptr, NULL, NULL, &ret));
+    TEST_ASSERT(9007199254740994.0 == ret);
+    TEST_ASSERT(PARSE_NUM_NO_ERR == strtodouble("2.2250738585072011e-308", &endptr, NULL, NULL, &ret));
+    TEST_ASSERT(2.2250738585072011e-308 == ret);
+    TEST_ASSERT('\0' == *endptr);
+}
+
+void strtodouble_out_of_range(void)
+{
+    double ret, max = 10.0;
+    char *endptr;
+
+    TEST_ASSERT(PARSE_NUM_ERR_TOO_LARGE == strtodouble("1e309", &endptr, NULL, NULL, &ret));
+    TEST_ASSERT(ret > 0.0 && ret * 0.5 == ret);
+    TEST_ASSERT(PARSE_NUM_ERR_GREATER_THAN_MAX == strtodouble("12.5", &endptr, NULL, &max, &ret));
+    TEST_ASSERT(PARSE_NUM_NO_ERR == strtodouble("1e-400", &endptr, NULL, NULL, &ret));
+    TEST_ASSERT(0.0 == ret);
+    TEST_ASSERT(PARSE_NUM_ERR_NO_DIGIT_FOUND == strtodouble(".e1", &endptr, NULL, NULL, &ret));
+}
+
+void good_strtofloat(void)
+{
+    float ret;
+    char *endptr;
+
+    TEST_ASSERT(PARSE_NUM_NO_ERR == strtofloat("3.4028235e38", &endptr, NULL, NULL, &ret));
+    TEST_ASSERT(3.4028235e38f == ret);
+    TEST_ASSERT(PARSE_NUM_ERR_TOO_LARGE == strtofloat("3.5e38", &endptr, NULL, NULL, &ret));
+    TEST_ASSERT(PARSE_NUM_ERR_NON_DIGIT_FOUND == strtofloat("0.1f", NULL, NULL, NULL, &ret));
+    TEST_ASSERT(0.1f == ret);
+}
+
 char MessageBuffer[50];
 
 static void runTest(UnityTestFunction test)
@@ -159,6 +219,10 @@ int main(void)
     RUN_TEST(good_strtoint8_t, 115);
     RUN_TEST(strntoint8_t_without_endptr, 125);
     RUN_TEST(strtoint8_t_without_endptr, 134);
+    RUN_TEST(good_strntodouble, 143);
+    RUN_TEST(strtodouble_correctly_rounded, 153);
+    RUN_TEST(strtodouble_out_of_range, 171);
+    RUN_TEST(good_strtofloat, 185);
     fputs("==========\n", stdout);
 #define UT(name, type, string, expected_value, expected_return, base, _min, _max, stopchar) \
     RUN_TEST(test_strtonX_##name##_##type, 0);
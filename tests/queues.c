@@ -0,0 +1,343 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "mpmc_queue.h"
+#include "mpsc_queue.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define ITEMS_PER_PRODUCER 20000
+
+/* item value = producer * ITEMS_PER_PRODUCER + index + 1 (0 being NULL) */
+#define ITEM(producer, i) \
+    ((void *) (intptr_t) ((producer) * ITEMS_PER_PRODUCER + (i) + 1))
+
+static unsigned char delivered[PRODUCERS * ITEMS_PER_PRODUCER + 1];
+
+static void assert_delivered_once(void)
+{
+    size_t i;
+
+    for (i = 1; i < ARRAY_SIZE(delivered); i++) {
+        TEST_ASSERT_EQUAL_UINT(1, delivered[i]);
+    }
+}
+
+void test_mpmc_queue_single_thread(void)
+{
+    intptr_t i;
+    void *v, *values[8];
+    Iterator it;
+    MPMCQueue q;
+
+    TEST_ASSERT_TRUE(mpmc_queue_init(&q, 5, NULL));
+    TEST_ASSERT_EQUAL_UINT(8, mpmc_queue_capacity(&q));
+
+    // empty
+    TEST_ASSERT_EQUAL_UINT(0, mpmc_queue_length(&q));
+    TEST_ASSERT_FALSE(mpmc_queue_dequeue(&q, &v));
+    TEST_ASSERT_EQUAL_UINT(0, mpmc_queue_dequeue_batch(&q, values, ARRAY_SIZE(values)));
+
+    // several turns of the ring, in FIFO order
+    for (i = 1; i <= 20; i++) {
+        TEST_ASSERT_TRUE(mpmc_queue_enqueue(&q, (void *) i));
+        TEST_ASSERT_TRUE(mpmc_queue_enqueue(&q, (void *) -i));
+        TEST_ASSERT_EQUAL_UINT(2, mpmc_queue_length(&q));
+        TEST_ASSERT_TRUE(mpmc_queue_dequeue(&q, &v));
+        TEST_ASSERT_EQUAL_PTR((void *) i, v);
+        TEST_ASSERT_TRUE(mpmc_queue_dequeue(&q, &v));
+        TEST_ASSERT_EQUAL_PTR((void *) -i, v);
+    }
+    TEST_ASSERT_FALSE(mpmc_queue_dequeue(&q, &v));
+
+    // full
+    for (i = 1; i <= 8; i++) {
+        TEST_ASSERT_TRUE(mpmc_queue_enqueue(&q, (void *) i));
+    }
+    TEST_ASSERT_EQUAL_UINT(8, mpmc_queue_length(&q));
+    TEST_ASSERT_FALSE(mpmc_queue_enqueue(&q, (void *) 9));
+    TEST_ASSERT_TRUE(mpmc_queue_dequeue(&q, &v));
+    TEST_ASSERT_EQUAL_PTR((void *) 1, v);
+    TEST_ASSERT_TRUE(mpmc_queue_enqueue(&q, (void *) 9));
+    TEST_ASSERT_FALSE(mpmc_queue_enqueue(&q, (void *) 10));
+
+    // batches are truncated to what is available
+    TEST_ASSERT_EQUAL_UINT(3, mpmc_queue_dequeue_batch(&q, values, 3));
+    for (i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_PTR((void *) (i + 2), values[i]);
+    }
+    for (i = 0; i < 5; i++) {
+        values[i] = (void *) (i + 10);
+    }
+    TEST_ASSERT_EQUAL_UINT(3, mpmc_queue_enqueue_batch(&q, values, 5));
+    TEST_ASSERT_EQUAL_UINT(8, mpmc_queue_length(&q));
+    TEST_ASSERT_EQUAL_UINT(8, mpmc_queue_dequeue_batch(&q, values, ARRAY_SIZE(values)));
+    for (i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_PTR((void *) (i + 5), values[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, mpmc_queue_length(&q));
+
+    // counting or testing emptiness through the iterator doesn't dequeue
+    for (i = 1; i <= 3; i++) {
+        TEST_ASSERT_TRUE(mpmc_queue_enqueue(&q, (void *) i));
+    }
+    mpmc_queue_to_iterator(&it, &q);
+    TEST_ASSERT_EQUAL_UINT(3, iterator_count(&it));
+    TEST_ASSERT_FALSE(iterator_empty(&it));
+    TEST_ASSERT_EQUAL_UINT(3, mpmc_queue_length(&q));
+    for (i = 1, iterator_first(&it); iterator_is_valid(&it, NULL, &v); i++, iterator_next(&it)) {
+        TEST_ASSERT_EQUAL_PTR((void *) i, v);
+    }
+    TEST_ASSERT_EQUAL_INT(4, i);
+    TEST_ASSERT_TRUE(iterator_empty(&it));
+    iterator_close(&it);
+
+    mpmc_queue_destroy(&q);
+}
+
+static MPMCQueue mpmc;
+
+static void *mpmc_producer(void *arg)
+{
+    size_t i;
+    intptr_t producer;
+
+    producer = (intptr_t) arg;
+    for (i = 0; i < ITEMS_PER_PRODUCER; ) {
+        if (0 == i % 7) {
+            void *values[5];
+            size_t j, n;
+
+            n = MIN(ARRAY_SIZE(values), ITEMS_PER_PRODUCER - i);
+            for (j = 0; j < n; j++) {
+                values[j] = ITEM(producer, i + j);
+            }
+            if (0 == (n = mpmc_queue_enqueue_batch(&mpmc, values, n))) {
+                sched_yield();
+            }
+            i += n;
+        } else if (mpmc_queue_enqueue(&mpmc, ITEM(producer, i))) {
+            ++i;
+        } else {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *mpmc_consumer(void *arg)
+{
+    size_t i, n, *count;
+    void *values[4];
+    intptr_t last[PRODUCERS], disorders;
+
+    disorders = 0;
+    count = (size_t *) arg;
+    memset(last, 0, sizeof(last));
+    while (*count < PRODUCERS * ITEMS_PER_PRODUCER / CONSUMERS) {
+        n = mpmc_queue_dequeue_batch(&mpmc, values, MIN(ARRAY_SIZE(values), PRODUCERS * ITEMS_PER_PRODUCER / CONSUMERS - *count));
+        for (i = 0; i < n; i++) {
+            intptr_t v, producer;
+
+            v = (intptr_t) values[i];
+            // values of a same producer are seen in order by each consumer
+            producer = (v - 1) / ITEMS_PER_PRODUCER;
+            disorders += v <= last[producer];
+            last[producer] = v;
+            __atomic_fetch_add(&delivered[v], 1, __ATOMIC_RELAXED);
+        }
+        if (0 == n) {
+            sched_yield();
+        }
+        *count += n;
+    }
+
+    // keep on consuming in any case to not block the other threads
+    return (void *) disorders;
+}
+
+void test_mpmc_queue_threads(void)
+{
+    intptr_t i;
+    void *v;
+    pthread_t producers[PRODUCERS], consumers[CONSUMERS];
+    size_t counts[CONSUMERS];
+
+    memset(delivered, 0, sizeof(delivered));
+    memset(counts, 0, sizeof(counts));
+    // a small capacity to often hit the full and empty cases
+    TEST_ASSERT_TRUE(mpmc_queue_init(&mpmc, 64, NULL));
+    for (i = 0; i < CONSUMERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&consumers[i], NULL, mpmc_consumer, &counts[i]));
+    }
+    for (i = 0; i < PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&producers[i], NULL, mpmc_producer, (void *) i));
+    }
+    for (i = 0; i < PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(producers[i], NULL));
+    }
+    for (i = 0; i < CONSUMERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(consumers[i], &v));
+        TEST_ASSERT_NULL(v);
+    }
+    TEST_ASSERT_FALSE(mpmc_queue_dequeue(&mpmc, &v));
+    assert_delivered_once();
+    mpmc_queue_destroy(&mpmc);
+}
+
+void test_mpsc_queue_single_thread(void)
+{
+    intptr_t i;
+    void *v, *values[8];
+    Iterator it;
+    MPSCQueue q;
+
+    TEST_ASSERT_TRUE(mpsc_queue_init(&q, NULL));
+
+    // empty
+    TEST_ASSERT_EQUAL_UINT(0, mpsc_queue_length(&q));
+    TEST_ASSERT_FALSE(mpsc_queue_dequeue(&q, &v));
+    TEST_ASSERT_EQUAL_UINT(0, mpsc_queue_dequeue_batch(&q, values, ARRAY_SIZE(values)));
+    TEST_ASSERT_TRUE(mpsc_queue_enqueue_batch(&q, values, 0, NULL));
+    TEST_ASSERT_FALSE(mpsc_queue_dequeue(&q, &v));
+
+    // FIFO order
+    for (i = 1; i <= 100; i++) {
+        TEST_ASSERT_TRUE(mpsc_queue_enqueue(&q, (void *) i, NULL));
+    }
+    TEST_ASSERT_EQUAL_UINT(100, mpsc_queue_length(&q));
+    for (i = 1; i <= 50; i++) {
+        TEST_ASSERT_TRUE(mpsc_queue_dequeue(&q, &v));
+        TEST_ASSERT_EQUAL_PTR((void *) i, v);
+    }
+    for (i = 0; i < 5; i++) {
+        values[i] = (void *) (i + 101);
+    }
+    TEST_ASSERT_TRUE(mpsc_queue_enqueue_batch(&q, values, 5, NULL));
+    TEST_ASSERT_EQUAL_UINT(55, mpsc_queue_length(&q));
+    for (i = 51; i <= 105; i += ARRAY_SIZE(values)) {
+        size_t j, n;
+
+        n = mpsc_queue_dequeue_batch(&q, values, ARRAY_SIZE(values));
+        TEST_ASSERT_EQUAL_UINT(MIN(ARRAY_SIZE(values), (size_t) (106 - i)), n);
+        for (j = 0; j < n; j++) {
+            TEST_ASSERT_EQUAL_PTR((void *) (i + j), values[j]);
+        }
+    }
+    TEST_ASSERT_FALSE(mpsc_queue_dequeue(&q, &v));
+
+    // counting or testing emptiness through the iterator doesn't dequeue
+    for (i = 1; i <= 3; i++) {
+        TEST_ASSERT_TRUE(mpsc_queue_enqueue(&q, (void *) i, NULL));
+    }
+    mpsc_queue_to_iterator(&it, &q);
+    TEST_ASSERT_EQUAL_UINT(3, iterator_count(&it));
+    TEST_ASSERT_FALSE(iterator_empty(&it));
+    TEST_ASSERT_EQUAL_UINT(3, mpsc_queue_length(&q));
+    for (i = 1, iterator_first(&it); iterator_is_valid(&it, NULL, &v); i++, iterator_next(&it)) {
+        TEST_ASSERT_EQUAL_PTR((void *) i, v);
+    }
+    TEST_ASSERT_EQUAL_INT(4, i);
+    TEST_ASSERT_TRUE(iterator_empty(&it));
+    iterator_close(&it);
+
+    // destroy frees the nodes of the remaining values
+    TEST_ASSERT_TRUE(mpsc_queue_enqueue(&q, (void *) 1, NULL));
+    mpsc_queue_destroy(&q);
+}
+
+static MPSCQueue mpsc;
+
+static void *mpsc_producer(void *arg)
+{
+    size_t i;
+    intptr_t producer;
+
+    producer = (intptr_t) arg;
+    for (i = 0; i < ITEMS_PER_PRODUCER; ) {
+        if (0 == i % 7 && i + 3 <= ITEMS_PER_PRODUCER) {
+            void *values[3];
+
+            values[0] = ITEM(producer, i);
+            values[1] = ITEM(producer, i + 1);
+            values[2] = ITEM(producer, i + 2);
+            if (!mpsc_queue_enqueue_batch(&mpsc, values, ARRAY_SIZE(values), NULL)) {
+                return arg;
+            }
+            i += ARRAY_SIZE(values);
+        } else {
+            if (!mpsc_queue_enqueue(&mpsc, ITEM(producer, i), NULL)) {
+                return arg;
+            }
+            ++i;
+        }
+    }
+
+    return NULL;
+}
+
+void test_mpsc_queue_threads(void)
+{
+    intptr_t i, last[PRODUCERS];
+    size_t count;
+    void *v;
+    pthread_t producers[PRODUCERS];
+
+    memset(delivered, 0, sizeof(delivered));
+    memset(last, 0, sizeof(last));
+    TEST_ASSERT_TRUE(mpsc_queue_init(&mpsc, NULL));
+    for (i = 0; i < PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&producers[i], NULL, mpsc_producer, (void *) i));
+    }
+    // this thread is the consumer
+    for (count = 0; count < PRODUCERS * ITEMS_PER_PRODUCER; ) {
+        if (mpsc_queue_dequeue(&mpsc, &v)) {
+            intptr_t producer;
+
+            producer = ((intptr_t) v - 1) / ITEMS_PER_PRODUCER;
+            TEST_ASSERT_TRUE((intptr_t) v > last[producer]);
+            last[producer] = (intptr_t) v;
+            ++delivered[(intptr_t) v];
+            ++count;
+        } else {
+            sched_yield();
+        }
+    }
+    for (i = 0; i < PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(producers[i], &v));
+        TEST_ASSERT_NULL(v);
+    }
+    TEST_ASSERT_FALSE(mpsc_queue_dequeue(&mpsc, &v));
+    assert_delivered_once();
+    mpsc_queue_destroy(&mpsc);
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_mpmc_queue_single_thread, 42);
+    RUN_TEST(test_mpmc_queue_threads, 176);
+    RUN_TEST(test_mpsc_queue_single_thread, 205);
+    RUN_TEST(test_mpsc_queue_threads, 296);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
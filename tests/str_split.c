@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "str_split.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+#define MAX_TOKENS 256
+
+typedef enum {
+    SPLIT_CHAR,
+    SPLIT_SET,
+    SPLIT_STRING,
+} SplitKind;
+
+/* the length of the separator at string[i] (0 if there is none) */
+static size_t naive_separator_at(SplitKind kind, const char *string, size_t string_len, size_t i, const char *separator, size_t separator_len)
+{
+    if (SPLIT_STRING == kind) {
+        return i + separator_len <= string_len && 0 == memcmp(string + i, separator, separator_len) ? separator_len : 0;
+    } else {
+        return i < string_len && NULL != memchr(separator, string[i], separator_len) ? 1 : 0;
+    }
+}
+
+static size_t naive_split(SplitKind kind, const char *string, size_t string_len, const char *separator, size_t separator_len, bool no_empty, StrSpan *tokens)
+{
+    size_t i, m, start, count;
+
+    i = start = count = 0;
+    while (true) {
+        m = naive_separator_at(kind, string, string_len, i, separator, separator_len);
+        if (0 != m || i == string_len) {
+            if (!no_empty || i > start) {
+                TEST_ASSERT_TRUE(count < MAX_TOKENS);
+                tokens[count].ptr = string + start;
+                tokens[count].len = i - start;
+                ++count;
+            }
+            if (i == string_len) {
+                break;
+            }
+            start = i += m;
+        } else {
+            ++i;
+        }
+    }
+
+    return count;
+}
+
+static void tokenizer_init(StrTokenizer *t, SplitKind kind, const char *string, size_t string_len, const char *separator, size_t separator_len, bool no_empty)
+{
+    switch (kind) {
+        case SPLIT_CHAR:
+            TEST_ASSERT_EQUAL_UINT(1, separator_len);
+            str_tokenizer_init_char(t, string, string_len, separator[0], no_empty);
+            break;
+        case SPLIT_SET:
+            str_tokenizer_init_set(t, string, string_len, separator, separator_len, no_empty);
+            break;
+        case SPLIT_STRING:
+            str_tokenizer_init_string(t, string, string_len, separator, separator_len, no_empty);
+            break;
+    }
+}
+
+static void assert_spans_equal(const StrSpan *expected, const StrSpan *actual, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL_PTR(expected[i].ptr, actual[i].ptr);
+        TEST_ASSERT_EQUAL_UINT(expected[i].len, actual[i].len);
+    }
+}
+
+/*
+ * Compare the tokens, one by one and by batches of all sizes, to
+ * naive_split. The string is copied in a buffer of its exact size to
+ * catch (with ASan) any read past its end.
+ */
+static void assert_split(SplitKind kind, const char *string, size_t string_len, const char *separator, size_t separator_len, bool no_empty)
+{
+    char *s;
+    StrTokenizer t;
+    size_t i, n, count, expected_count, rest_len;
+    StrSpan token, tokens[MAX_TOKENS], expected[MAX_TOKENS];
+
+    s = malloc(MAX(string_len, (size_t) 1));
+    memcpy(s, string, string_len);
+    expected_count = naive_split(kind, s, string_len, separator, separator_len, no_empty, expected);
+
+    tokenizer_init(&t, kind, s, string_len, separator, separator_len, no_empty);
+    for (count = 0; str_tokenizer_next(&t, &token); count++) {
+        TEST_ASSERT_TRUE(count < expected_count);
+        assert_spans_equal(expected + count, &token, 1);
+    }
+    TEST_ASSERT_EQUAL_UINT(expected_count, count);
+    TEST_ASSERT_FALSE(str_tokenizer_next(&t, &token));
+    TEST_ASSERT_NULL(str_tokenizer_rest(&t, &rest_len));
+    TEST_ASSERT_EQUAL_UINT(0, rest_len);
+
+    for (n = 1; n <= 4; n++) {
+        tokenizer_init(&t, kind, s, string_len, separator, separator_len, no_empty);
+        count = 0;
+        do {
+            i = str_tokenizer_split(&t, tokens, n);
+            TEST_ASSERT_TRUE(i <= n);
+            TEST_ASSERT_TRUE(count + i <= expected_count);
+            assert_spans_equal(expected + count, tokens, i);
+            count += i;
+        } while (i == n);
+        TEST_ASSERT_EQUAL_UINT(expected_count, count);
+    }
+
+    // all at once, the array being larger than needed
+    tokenizer_init(&t, kind, s, string_len, separator, separator_len, no_empty);
+    TEST_ASSERT_EQUAL_UINT(expected_count, str_tokenizer_split(&t, tokens, ARRAY_SIZE(tokens)));
+    assert_spans_equal(expected, tokens, expected_count);
+
+    free(s);
+}
+
+/* split *string* and compare the tokens to the expected ones, given as a NULL-terminated list */
+static void assert_tokens(SplitKind kind, const char *string, const char *separator, bool no_empty, ...)
+{
+    va_list ap;
+    StrSpan token;
+    StrTokenizer t;
+    const char *expected;
+
+    assert_split(kind, string, strlen(string), separator, strlen(separator), no_empty);
+    tokenizer_init(&t, kind, string, strlen(string), separator, strlen(separator), no_empty);
+    va_start(ap, no_empty);
+    while (NULL != (expected = va_arg(ap, const char *))) {
+        TEST_ASSERT_TRUE(str_tokenizer_next(&t, &token));
+        TEST_ASSERT_EQUAL_UINT(strlen(expected), token.len);
+        TEST_ASSERT_TRUE(0 == memcmp(expected, token.ptr, token.len));
+    }
+    va_end(ap);
+    TEST_ASSERT_FALSE(str_tokenizer_next(&t, &token));
+}
+
+void test_str_tokenizer_empty_fields(void)
+{
+    // leading, trailing and consecutive separators
+    assert_tokens(SPLIT_CHAR, ",a,,b,", ",", false, "", "a", "", "b", "", NULL);
+    assert_tokens(SPLIT_CHAR, ",a,,b,", ",", true, "a", "b", NULL);
+    assert_tokens(SPLIT_CHAR, ",,,", ",", false, "", "", "", "", NULL);
+    assert_tokens(SPLIT_CHAR, ",,,", ",", true, NULL);
+    assert_tokens(SPLIT_CHAR, "abc", ",", false, "abc", NULL);
+    assert_tokens(SPLIT_SET, " a\t; b ;", " \t;", false, "", "a", "", "", "b", "", "", NULL);
+    assert_tokens(SPLIT_SET, " a\t; b ;", " \t;", true, "a", "b", NULL);
+    // empty input: a single empty token, unless empty tokens are skipped
+    assert_tokens(SPLIT_CHAR, "", ",", false, "", NULL);
+    assert_tokens(SPLIT_CHAR, "", ",", true, NULL);
+    assert_tokens(SPLIT_SET, "", ",;", false, "", NULL);
+    assert_tokens(SPLIT_SET, "", ",;", true, NULL);
+    assert_tokens(SPLIT_STRING, "", "::", false, "", NULL);
+    assert_tokens(SPLIT_STRING, "", "::", true, NULL);
+}
+
+void test_str_tokenizer_multibyte(void)
+{
+    assert_tokens(SPLIT_STRING, "a::b::::c", "::", false, "a", "b", "", "c", NULL);
+    assert_tokens(SPLIT_STRING, "::a::b::", "::", false, "", "a", "b", "", NULL);
+    assert_tokens(SPLIT_STRING, "::a::b::", "::", true, "a", "b", NULL);
+    // matches do not overlap: they are taken from the left
+    assert_tokens(SPLIT_STRING, "a:::b", "::", false, "a", ":b", NULL);
+    assert_tokens(SPLIT_STRING, "aaaaa", "aa", false, "", "", "a", NULL);
+    // a partial separator at the end is part of the last token
+    assert_tokens(SPLIT_STRING, "a::b:", "::", false, "a", "b:", NULL);
+    assert_tokens(SPLIT_STRING, "a\r\nb\r\n", "\r\n", false, "a", "b", "", NULL);
+    assert_tokens(SPLIT_STRING, "a, b", ", ", false, "a", "b", NULL);
+    assert_tokens(SPLIT_STRING, "ab", "abc", false, "ab", NULL);
+    assert_tokens(SPLIT_STRING, "abc", "abc", false, "", "", NULL);
+}
+
+void test_str_tokenizer_rest(void)
+{
+    size_t rest_len;
+    StrSpan token;
+    StrTokenizer t;
+    const char *string = "k=v=w";
+
+    // split at most once
+    str_tokenizer_init_char(&t, string, strlen(string), '=', false);
+    TEST_ASSERT_EQUAL_PTR(string, str_tokenizer_rest(&t, &rest_len));
+    TEST_ASSERT_EQUAL_UINT(strlen(string), rest_len);
+    TEST_ASSERT_TRUE(str_tokenizer_next(&t, &token));
+    TEST_ASSERT_EQUAL_UINT(1, token.len);
+    TEST_ASSERT_EQUAL_PTR(string + 2, str_tokenizer_rest(&t, &rest_len));
+    TEST_ASSERT_EQUAL_UINT(3, rest_len);
+    TEST_ASSERT_TRUE(str_tokenizer_next(&t, &token));
+    TEST_ASSERT_TRUE(str_tokenizer_next(&t, &token));
+    TEST_ASSERT_EQUAL_PTR(string + 4, token.ptr);
+    TEST_ASSERT_NULL(str_tokenizer_rest(&t, &rest_len));
+    TEST_ASSERT_EQUAL_UINT(0, rest_len);
+
+    // a trailing separator: the rest is empty but there is still an (empty) token
+    str_tokenizer_init_char(&t, "a=", STR_LEN("a="), '=', false);
+    TEST_ASSERT_TRUE(str_tokenizer_next(&t, &token));
+    TEST_ASSERT_NOT_NULL(str_tokenizer_rest(&t, &rest_len));
+    TEST_ASSERT_EQUAL_UINT(0, rest_len);
+    TEST_ASSERT_TRUE(str_tokenizer_next(&t, &token));
+    TEST_ASSERT_EQUAL_UINT(0, token.len);
+    TEST_ASSERT_NULL(str_tokenizer_rest(&t, &rest_len));
+}
+
+void test_str_tokenizer_random(void)
+{
+    char string[100];
+    uint32_t seed;
+    size_t i, len, round;
+    static const struct {
+        SplitKind kind;
+        const char *separator;
+    } separators[] = {
+        { SPLIT_CHAR, "," },
+        { SPLIT_SET, "," },
+        { SPLIT_SET, ",;" },
+        // more than STR_TOKENIZER_SIMD_SET: the bitmap
+        { SPLIT_SET, ",;:!?./-+" },
+        { SPLIT_STRING, "," },
+        { SPLIT_STRING, ",," },
+        { SPLIT_STRING, ",;," },
+        { SPLIT_STRING, "ab" },
+    };
+
+    seed = 42;
+    for (round = 0; round < 20; round++) {
+        // separators at every position relative to the 16/32 byte blocks
+        for (i = 0; i < sizeof(string); i++) {
+            seed = seed * 1103515245 + 12345;
+            string[i] = "ab,;:x"[(seed >> 16) % (round % 2 ? 6 : 3)];
+        }
+        for (i = 0; i < ARRAY_SIZE(separators); i++) {
+            for (len = 0; len <= sizeof(string); len++) {
+                assert_split(separators[i].kind, string, len, separators[i].separator, strlen(separators[i].separator), false);
+                assert_split(separators[i].kind, string, len, separators[i].separator, strlen(separators[i].separator), true);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_str_tokenizer_empty_fields, 158);
+    RUN_TEST(test_str_tokenizer_multibyte, 177);
+    RUN_TEST(test_str_tokenizer_rest, 193);
+    RUN_TEST(test_str_tokenizer_random, 224);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "strbuf.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+#define IS_INLINE(sb) \
+    ((sb)->ptr == (sb)->inline_buffer)
+
+/* the content of the buffer is the *expected_len* first bytes of *expected*, \0 terminated */
+static void assert_strbuf(const StrBuf *sb, const char *expected, size_t expected_len)
+{
+    TEST_ASSERT_EQUAL_UINT(expected_len, sb->length);
+    TEST_ASSERT_TRUE(sb->length < sb->allocated);
+    TEST_ASSERT_TRUE(0 == memcmp(expected, sb->ptr, expected_len));
+    TEST_ASSERT_EQUAL_INT('\0', sb->ptr[sb->length]);
+}
+
+void test_strbuf_append(void)
+{
+    size_t i;
+    StrBuf sb;
+    char expected[1024];
+
+    for (i = 0; i < sizeof(expected); i++) {
+        expected[i] = 'a' + i % 26;
+    }
+    // a byte at a time, across the capacity boundary and a few growths
+    strbuf_init(&sb);
+    assert_strbuf(&sb, expected, 0);
+    for (i = 0; i < 300; i++) {
+        TEST_ASSERT_TRUE(strbuf_append_char(&sb, expected[i], NULL));
+        assert_strbuf(&sb, expected, i + 1);
+        // the string stays inside the StrBuf as long as it fits, \0 included
+        TEST_ASSERT_EQUAL(i + 1 < STRBUF_INLINE_SIZE, IS_INLINE(&sb));
+    }
+    strbuf_destroy(&sb);
+    assert_strbuf(&sb, expected, 0);
+
+    // chunks of every length ending on both sides of the boundary
+    for (i = 0; i < 2 * STRBUF_INLINE_SIZE; i++) {
+        strbuf_init(&sb);
+        TEST_ASSERT_TRUE(strbuf_append_string_len(&sb, expected, STRBUF_INLINE_SIZE / 2, NULL));
+        TEST_ASSERT_TRUE(strbuf_append_string_len(&sb, expected + STRBUF_INLINE_SIZE / 2, i, NULL));
+        assert_strbuf(&sb, expected, STRBUF_INLINE_SIZE / 2 + i);
+        TEST_ASSERT_EQUAL(STRBUF_INLINE_SIZE / 2 + i < STRBUF_INLINE_SIZE, IS_INLINE(&sb));
+        strbuf_destroy(&sb);
+    }
+
+    // large appends, exceeding the doubled capacity
+    strbuf_init(&sb);
+    TEST_ASSERT_TRUE(strbuf_append_string_len(&sb, expected, 10, NULL));
+    TEST_ASSERT_TRUE(strbuf_append_string_len(&sb, expected + 10, sizeof(expected) - 10, NULL));
+    assert_strbuf(&sb, expected, sizeof(expected));
+    TEST_ASSERT_TRUE(strbuf_append_string_len(&sb, NULL, 0, NULL));
+    assert_strbuf(&sb, expected, sizeof(expected));
+    strbuf_destroy(&sb);
+
+    strbuf_init(&sb);
+    {
+        StrSpan span = { "def", 3 };
+
+        TEST_ASSERT_TRUE(strbuf_append_string(&sb, "abc", NULL));
+        TEST_ASSERT_TRUE(strbuf_append_span(&sb, &span, NULL));
+        TEST_ASSERT_TRUE(strbuf_concat(&sb, NULL, "ghi", "", "jkl", NULL));
+        TEST_ASSERT_TRUE(strbuf_append_int64_t(&sb, INT64_MIN, NULL));
+        TEST_ASSERT_TRUE(strbuf_append_uint8_t(&sb, UINT8_MAX, NULL));
+        assert_strbuf(&sb, "abcdefghijkl-9223372036854775808255", STR_LEN("abcdefghijkl-9223372036854775808255"));
+    }
+    strbuf_destroy(&sb);
+}
+
+void test_strbuf_printf(void)
+{
+    size_t i;
+    StrBuf sb;
+    char expected[2048];
+    int expected_len;
+
+    for (i = 0; i < 2 * STRBUF_INLINE_SIZE; i++) {
+        strbuf_init(&sb);
+        // fits in the remaining space or not, by a byte or more
+        TEST_ASSERT_TRUE(strbuf_append_string_len(&sb, "0123456789012345678901234567890123456789", i % 40, NULL));
+        TEST_ASSERT_TRUE(strbuf_append_printf(&sb, NULL, "[%.*s|%d]", (int) i, "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz", (int) i));
+        expected_len = snprintf(expected, sizeof(expected), "%.*s[%.*s|%d]", (int) (i % 40), "0123456789012345678901234567890123456789", (int) i, "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz", (int) i);
+        assert_strbuf(&sb, expected, (size_t) expected_len);
+        strbuf_destroy(&sb);
+    }
+
+    // much larger than the current capacity
+    strbuf_init(&sb);
+    TEST_ASSERT_TRUE(strbuf_append_printf(&sb, NULL, "%s", ""));
+    assert_strbuf(&sb, "", 0);
+    TEST_ASSERT_TRUE(strbuf_append_printf(&sb, NULL, "%1500d|%s", 42, "end"));
+    expected_len = snprintf(expected, sizeof(expected), "%1500d|%s", 42, "end");
+    assert_strbuf(&sb, expected, (size_t) expected_len);
+    strbuf_destroy(&sb);
+}
+
+void test_strbuf_insert(void)
+{
+    size_t i, position;
+    StrBuf sb;
+    char expected[256];
+    const char *insertion = "0123456789012345678901234567890123456789012345678901234567890123456789";
+
+    for (position = 0; position <= 40; position += 5) {
+        for (i = 0; i <= strlen(insertion); i += 7) {
+            strbuf_init(&sb);
+            TEST_ASSERT_TRUE(strbuf_append_string(&sb, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMN", NULL));
+            TEST_ASSERT_TRUE(strbuf_insert_string_len(&sb, position, insertion, i, NULL));
+            memcpy(expected, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMN", position);
+            memcpy(expected + position, insertion, i);
+            memcpy(expected + position + i, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMN" + position, 40 - position);
+            assert_strbuf(&sb, expected, 40 + i);
+            // a second insertion at the very beginning, once allocated
+            TEST_ASSERT_TRUE(strbuf_insert_string_len(&sb, 0, "<", 1, NULL));
+            memmove(expected + 1, expected, 40 + i);
+            expected[0] = '<';
+            assert_strbuf(&sb, expected, 41 + i);
+            strbuf_destroy(&sb);
+        }
+    }
+
+    // into an empty buffer
+    strbuf_init(&sb);
+    TEST_ASSERT_TRUE(strbuf_insert_string_len(&sb, 0, "", 0, NULL));
+    assert_strbuf(&sb, "", 0);
+    TEST_ASSERT_TRUE(strbuf_insert_string_len(&sb, 0, "xyz", 3, NULL));
+    assert_strbuf(&sb, "xyz", 3);
+    strbuf_destroy(&sb);
+}
+
+void test_strbuf_clear_and_shrink(void)
+{
+    size_t i, allocated;
+    StrBuf sb;
+    char *ptr, *stolen, expected[512];
+
+    for (i = 0; i < sizeof(expected); i++) {
+        expected[i] = 'A' + i % 26;
+    }
+    strbuf_init(&sb);
+    // shrinking an inline buffer has no effect
+    strbuf_shrink(&sb);
+    assert_strbuf(&sb, expected, 0);
+    TEST_ASSERT_TRUE(IS_INLINE(&sb));
+    TEST_ASSERT_TRUE(strbuf_append_string_len(&sb, expected, sizeof(expected), NULL));
+    TEST_ASSERT_FALSE(IS_INLINE(&sb));
+    // clearing keeps the memory
+    ptr = sb.ptr;
+    allocated = sb.allocated;
+    strbuf_clear(&sb);
+    assert_strbuf(&sb, expected, 0);
+    TEST_ASSERT_EQUAL_PTR(ptr, sb.ptr);
+    TEST_ASSERT_EQUAL_UINT(allocated, sb.allocated);
+    // reused without any allocation
+    TEST_ASSERT_TRUE(strbuf_append_string_len(&sb, expected, sizeof(expected) / 2, NULL));
+    TEST_ASSERT_EQUAL_PTR(ptr, sb.ptr);
+    assert_strbuf(&sb, expected, sizeof(expected) / 2);
+    // too long to go back inside: the allocation fits the string
+    strbuf_shrink(&sb);
+    assert_strbuf(&sb, expected, sizeof(expected) / 2);
+    TEST_ASSERT_EQUAL_UINT(sizeof(expected) / 2 + 1, sb.allocated);
+    // a full buffer grows again
+    TEST_ASSERT_TRUE(strbuf_append_char(&sb, expected[sizeof(expected) / 2], NULL));
+    assert_strbuf(&sb, expected, sizeof(expected) / 2 + 1);
+    // back to the initial (inline) size
+    strbuf_clear(&sb);
+    TEST_ASSERT_TRUE(strbuf_append_string_len(&sb, expected, STRBUF_INLINE_SIZE - 1, NULL));
+    strbuf_shrink(&sb);
+    TEST_ASSERT_TRUE(IS_INLINE(&sb));
+    TEST_ASSERT_EQUAL_UINT(STRBUF_INLINE_SIZE, sb.allocated);
+    assert_strbuf(&sb, expected, STRBUF_INLINE_SIZE - 1);
+    // and out again
+    TEST_ASSERT_TRUE(strbuf_append_char(&sb, expected[STRBUF_INLINE_SIZE - 1], NULL));
+    TEST_ASSERT_FALSE(IS_INLINE(&sb));
+    assert_strbuf(&sb, expected, STRBUF_INLINE_SIZE);
+
+    // steal resets the buffer
+    stolen = strbuf_steal(&sb, &i, NULL);
+    TEST_ASSERT_EQUAL_UINT(STRBUF_INLINE_SIZE, i);
+    TEST_ASSERT_TRUE(0 == memcmp(expected, stolen, i));
+    TEST_ASSERT_EQUAL_INT('\0', stolen[i]);
+    free(stolen);
+    assert_strbuf(&sb, expected, 0);
+    TEST_ASSERT_TRUE(IS_INLINE(&sb));
+    strbuf_destroy(&sb);
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_strbuf_append, 32);
+    RUN_TEST(test_strbuf_printf, 86);
+    RUN_TEST(test_strbuf_insert, 113);
+    RUN_TEST(test_strbuf_clear_and_shrink, 147);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
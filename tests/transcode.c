@@ -0,0 +1,494 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "transcode.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+typedef enum {
+    UTF8,
+    UTF16LE,
+    UTF16BE,
+    UTF32,
+    LATIN1,
+} encoding_t;
+
+/* size, in bytes, of a unit of each encoding */
+static const size_t unit_sizes[] = { 1, 2, 2, 4, 1 };
+
+/* the 8 conversions, on void * to be handled the same way */
+
+typedef size_t (*length_func_t)(const void *, size_t);
+typedef UnicodeError (*convert_func_t)(const void *, size_t, void *, size_t, size_t *, size_t *);
+
+#define CONVERSION(from, to) \
+    static size_t from## _to_ ##to## _length_adapter(const void *string, size_t string_len) \
+    { \
+        return from## _to_ ##to## _length(string, string_len); \
+    } \
+    static UnicodeError from## _to_ ##to## _adapter(const void *string, size_t string_len, void *buffer, size_t buffer_len, size_t *consumed, size_t *written) \
+    { \
+        return from## _to_ ##to(string, string_len, buffer, buffer_len, consumed, written); \
+    }
+
+/* utf8_to_utf16le and utf8_to_utf16be share utf8_to_utf16_length */
+#define utf8_to_utf16le_length utf8_to_utf16_length
+#define utf8_to_utf16be_length utf8_to_utf16_length
+
+CONVERSION(utf8, utf16le)
+CONVERSION(utf8, utf16be)
+CONVERSION(utf8, utf32)
+CONVERSION(utf8, latin1)
+CONVERSION(utf16le, utf8)
+CONVERSION(utf16be, utf8)
+CONVERSION(utf32, utf8)
+CONVERSION(latin1, utf8)
+
+#undef CONVERSION
+
+static const struct {
+    encoding_t from, to;
+    length_func_t length;
+    convert_func_t convert;
+} conversions[] = {
+    { UTF8, UTF16LE, utf8_to_utf16le_length_adapter, utf8_to_utf16le_adapter },
+    { UTF8, UTF16BE, utf8_to_utf16be_length_adapter, utf8_to_utf16be_adapter },
+    { UTF8, UTF32, utf8_to_utf32_length_adapter, utf8_to_utf32_adapter },
+    { UTF8, LATIN1, utf8_to_latin1_length_adapter, utf8_to_latin1_adapter },
+    { UTF16LE, UTF8, utf16le_to_utf8_length_adapter, utf16le_to_utf8_adapter },
+    { UTF16BE, UTF8, utf16be_to_utf8_length_adapter, utf16be_to_utf8_adapter },
+    { UTF32, UTF8, utf32_to_utf8_length_adapter, utf32_to_utf8_adapter },
+    { LATIN1, UTF8, latin1_to_utf8_length_adapter, latin1_to_utf8_adapter },
+};
+
+/* write *value* as the *index*th unit of *string*, in the byte order of *encoding* */
+static void put_unit(uint8_t *string, encoding_t encoding, size_t index, uint32_t value)
+{
+    switch (encoding) {
+        case UTF8:
+        case LATIN1:
+            string[index] = (uint8_t) value;
+            break;
+        case UTF16LE:
+            string[2 * index] = (uint8_t) value;
+            string[2 * index + 1] = (uint8_t) (value >> 8);
+            break;
+        case UTF16BE:
+            string[2 * index] = (uint8_t) (value >> 8);
+            string[2 * index + 1] = (uint8_t) value;
+            break;
+        case UTF32:
+            memcpy(string + 4 * index, &value, sizeof(value));
+            break;
+    }
+}
+
+/* reference encoder: the units of *cp* in *encoding*, 0 if it can't be represented (Latin-1) */
+static size_t encode_cp(encoding_t encoding, uint32_t cp, uint32_t units[4])
+{
+    switch (encoding) {
+        case UTF8:
+            if (cp < 0x80) {
+                units[0] = cp;
+                return 1;
+            } else if (cp < 0x800) {
+                units[0] = 0xC0 | cp >> 6;
+                units[1] = 0x80 | (cp & 0x3F);
+                return 2;
+            } else if (cp < 0x10000) {
+                units[0] = 0xE0 | cp >> 12;
+                units[1] = 0x80 | (cp >> 6 & 0x3F);
+                units[2] = 0x80 | (cp & 0x3F);
+                return 3;
+            } else {
+                units[0] = 0xF0 | cp >> 18;
+                units[1] = 0x80 | (cp >> 12 & 0x3F);
+                units[2] = 0x80 | (cp >> 6 & 0x3F);
+                units[3] = 0x80 | (cp & 0x3F);
+                return 4;
+            }
+        case UTF16LE:
+        case UTF16BE:
+            if (cp < 0x10000) {
+                units[0] = cp;
+                return 1;
+            } else {
+                units[0] = 0xD800 | (cp - 0x10000) >> 10;
+                units[1] = 0xDC00 | (cp & 0x3FF);
+                return 2;
+            }
+        case UTF32:
+            units[0] = cp;
+            return 1;
+        case LATIN1:
+            units[0] = cp;
+            return cp <= 0xFF;
+    }
+
+    return 0;
+}
+
+/*
+ * Encode the *cps_len* code points of *cps* into *string* (if not NULL).
+ * Returns the number of units or, if *unencodable* is set, the number of
+ * units of the code points before the first which can't be represented.
+ */
+static size_t encode(encoding_t encoding, const uint32_t *cps, size_t cps_len, uint8_t *string, size_t *unencodable)
+{
+    uint32_t units[4];
+    size_t i, j, k, n;
+
+    if (NULL != unencodable) {
+        *unencodable = (size_t) -1;
+    }
+    for (i = j = 0; i < cps_len; i++) {
+        if (0 == (n = encode_cp(encoding, cps[i], units))) {
+            if (NULL != unencodable) {
+                *unencodable = i;
+            }
+            break;
+        }
+        for (k = 0; k < n; k++, j++) {
+            if (NULL != string) {
+                put_unit(string, encoding, j, units[k]);
+            }
+        }
+    }
+
+    return j;
+}
+
+/* a copy of the *len* units of *string* in a buffer of this exact size (for ASan) */
+static void *exact_copy(const void *string, size_t len, encoding_t encoding)
+{
+    void *copy;
+
+    copy = malloc(MAX(len * unit_sizes[encoding], (size_t) 1));
+    memcpy(copy, string, len * unit_sizes[encoding]);
+
+    return copy;
+}
+
+/*
+ * Convert the code points *cps* with each conversion and compare to the
+ * reference encoder: the *_length functions, the output, consumed and
+ * written. Conversions to Latin-1 of other code points have to fail
+ * (UNI_ERR_INVALID) on the first of them.
+ */
+static void assert_conversions(const uint32_t *cps, size_t cps_len)
+{
+    size_t c, input_len, output_len, prefix_len, input_prefix_len, unencodable, consumed, written;
+    uint8_t input[4 * 256], output[4 * 256];
+    void *input_copy, *buffer;
+    UnicodeError err;
+
+    for (c = 0; c < ARRAY_SIZE(conversions); c++) {
+        input_len = encode(conversions[c].from, cps, cps_len, input, &unencodable);
+        if ((size_t) -1 != unencodable) {
+            // Latin-1 input can't have code points above U+00FF
+            continue;
+        }
+        output_len = encode(conversions[c].to, cps, cps_len, output, &unencodable);
+        input_copy = exact_copy(input, input_len, conversions[c].from);
+        buffer = malloc(MAX(4 * (input_len + 1), output_len * unit_sizes[conversions[c].to]));
+        consumed = written = (size_t) -1;
+        err = conversions[c].convert(input_copy, input_len, buffer, 4 * (input_len + 1) / unit_sizes[conversions[c].to], &consumed, &written);
+        if ((size_t) -1 == unencodable) {
+            TEST_ASSERT_EQUAL_UINT(output_len, conversions[c].length(input_copy, input_len));
+            TEST_ASSERT_EQUAL_INT(UNI_ERR_OK, err);
+            TEST_ASSERT_EQUAL_UINT(input_len, consumed);
+        } else {
+            // the offset, in the input, of the first code point above U+00FF
+            input_prefix_len = encode(conversions[c].from, cps, unencodable, NULL, NULL);
+            TEST_ASSERT_EQUAL_INT(UNI_ERR_INVALID, err);
+            TEST_ASSERT_EQUAL_UINT(input_prefix_len, consumed);
+        }
+        TEST_ASSERT_EQUAL_UINT(output_len, written);
+        TEST_ASSERT_TRUE(0 == memcmp(output, buffer, output_len * unit_sizes[conversions[c].to]));
+        free(buffer);
+        if ((size_t) -1 == unencodable) {
+            // into a buffer of the exact size given by the *_length function
+            buffer = malloc(MAX(output_len * unit_sizes[conversions[c].to], (size_t) 1));
+            TEST_ASSERT_EQUAL_INT(UNI_ERR_OK, conversions[c].convert(input_copy, input_len, buffer, output_len, NULL, NULL));
+            TEST_ASSERT_TRUE(0 == memcmp(output, buffer, output_len * unit_sizes[conversions[c].to]));
+            free(buffer);
+            // one unit short: the last code point (at least) can't be written
+            if (output_len > 0) {
+                prefix_len = encode(conversions[c].to, cps, cps_len - 1, NULL, NULL);
+                input_prefix_len = encode(conversions[c].from, cps, cps_len - 1, NULL, NULL);
+                buffer = malloc(MAX((output_len - 1) * unit_sizes[conversions[c].to], (size_t) 1));
+                TEST_ASSERT_EQUAL_INT(UNI_ERR_BUFFER_OVERFLOW, conversions[c].convert(input_copy, input_len, buffer, output_len - 1, &consumed, &written));
+                TEST_ASSERT_EQUAL_UINT(input_prefix_len, consumed);
+                TEST_ASSERT_EQUAL_UINT(prefix_len, written);
+                TEST_ASSERT_TRUE(0 == memcmp(output, buffer, prefix_len * unit_sizes[conversions[c].to]));
+                free(buffer);
+            }
+        }
+        free(input_copy);
+    }
+}
+
+/* a code point of each class: ASCII, Latin-1, 2, 3 and 4 bytes in UTF-8 */
+static const uint32_t samples[] = {
+    0x00, 0x41, 0x7F,
+    0x80, 0xE9, 0xFF,
+    0x100, 0x3B1, 0x7FF,
+    0x800, 0x20AC, 0xD7FF, 0xE000, 0xFFFD, 0xFFFF,
+    0x10000, 0x1F600, 0x10FFFF,
+};
+
+void test_transcode_round_trips(void)
+{
+    size_t i, len, position;
+    uint32_t cps[128];
+
+    // ASCII only, then a non-ASCII code point at every position, around the 16 and 32 units blocks
+    for (len = 0; len <= 66; len++) {
+        for (i = 0; i < len; i++) {
+            cps[i] = 'a' + i % 26;
+        }
+        assert_conversions(cps, len);
+        for (position = 0; position < len; position++) {
+            for (i = 3; i < ARRAY_SIZE(samples); i += 3) {
+                cps[position] = samples[i];
+                assert_conversions(cps, len);
+            }
+            cps[position] = 'a' + position % 26;
+        }
+    }
+    // only non-ASCII code points
+    for (i = 3; i < ARRAY_SIZE(samples); i++) {
+        for (len = 0; len <= 40; len++) {
+            cps[len] = samples[i];
+            assert_conversions(cps, len + 1);
+        }
+    }
+}
+
+void test_transcode_random(void)
+{
+    uint32_t seed, cps[128];
+    size_t i, len, round;
+
+    seed = 42;
+    for (round = 0; round < 2000; round++) {
+        seed = seed * 1103515245 + 12345;
+        len = (seed >> 16) % ARRAY_SIZE(cps);
+        for (i = 0; i < len; i++) {
+            seed = seed * 1103515245 + 12345;
+            // mostly ASCII, to have runs of various lengths
+            if (0 == (seed >> 16) % 4) {
+                cps[i] = samples[(seed >> 20) % ARRAY_SIZE(samples)];
+            } else {
+                cps[i] = 0x20 + (seed >> 20) % 0x60;
+            }
+        }
+        assert_conversions(cps, len);
+    }
+}
+
+/*
+ * Convert *cps*, by parts, into output buffers of *part_len* units (for
+ * ASan), resuming each time from where UNI_ERR_BUFFER_OVERFLOW stopped
+ */
+static void assert_resume(const uint32_t *cps, size_t cps_len, size_t part_len)
+{
+    void *input_copy, *part;
+    UnicodeError err;
+    uint8_t input[4 * 256], output[4 * 256], result[4 * 256];
+    size_t c, input_len, output_len, consumed, written, total_consumed, total_written;
+
+    for (c = 0; c < ARRAY_SIZE(conversions); c++) {
+        if (LATIN1 == conversions[c].from || LATIN1 == conversions[c].to) {
+            continue;
+        }
+        input_len = encode(conversions[c].from, cps, cps_len, input, NULL);
+        output_len = encode(conversions[c].to, cps, cps_len, output, NULL);
+        input_copy = exact_copy(input, input_len, conversions[c].from);
+        part = malloc(part_len * unit_sizes[conversions[c].to]);
+        total_consumed = total_written = 0;
+        do {
+            err = conversions[c].convert((const uint8_t *) input_copy + total_consumed * unit_sizes[conversions[c].from], input_len - total_consumed, part, part_len, &consumed, &written);
+            TEST_ASSERT_TRUE(UNI_ERR_OK == err || UNI_ERR_BUFFER_OVERFLOW == err);
+            TEST_ASSERT_TRUE(written <= part_len);
+            // a part is large enough for any code point
+            TEST_ASSERT_TRUE(written > 0 || 0 == output_len);
+            memcpy(result + total_written * unit_sizes[conversions[c].to], part, written * unit_sizes[conversions[c].to]);
+            total_consumed += consumed;
+            total_written += written;
+        } while (UNI_ERR_BUFFER_OVERFLOW == err);
+        TEST_ASSERT_EQUAL_UINT(input_len, total_consumed);
+        TEST_ASSERT_EQUAL_UINT(output_len, total_written);
+        TEST_ASSERT_TRUE(0 == memcmp(output, result, output_len * unit_sizes[conversions[c].to]));
+        free(part);
+        free(input_copy);
+    }
+}
+
+void test_transcode_buffer_overflow(void)
+{
+    uint32_t seed, cps[128];
+    size_t i, len, round, part_len;
+
+    seed = 42;
+    for (round = 0; round < 200; round++) {
+        seed = seed * 1103515245 + 12345;
+        len = (seed >> 16) % ARRAY_SIZE(cps);
+        for (i = 0; i < len; i++) {
+            seed = seed * 1103515245 + 12345;
+            if (0 == (seed >> 16) % 3) {
+                cps[i] = samples[(seed >> 20) % ARRAY_SIZE(samples)];
+            } else {
+                cps[i] = 0x20 + (seed >> 20) % 0x60;
+            }
+        }
+        for (part_len = 4; part_len <= 40; part_len += 1 + part_len / 8) {
+            assert_resume(cps, len, part_len);
+        }
+    }
+}
+
+static const struct {
+    encoding_t from;
+    UnicodeError error;
+    size_t units_len;
+    uint32_t units[6];
+} invalid_inputs[] = {
+    // overlongs
+    { UTF8, UNI_ERR_INVALID, 2, { 0xC0, 0x80 } },
+    { UTF8, UNI_ERR_INVALID, 2, { 0xC1, 0xBF } },
+    { UTF8, UNI_ERR_INVALID, 3, { 0xE0, 0x9F, 0xBF } },
+    { UTF8, UNI_ERR_INVALID, 4, { 0xF0, 0x8F, 0xBF, 0xBF } },
+    // surrogates
+    { UTF8, UNI_ERR_INVALID, 3, { 0xED, 0xA0, 0x80 } },
+    { UTF8, UNI_ERR_INVALID, 3, { 0xED, 0xBF, 0xBF } },
+    { UTF8, UNI_ERR_INVALID, 6, { 0xED, 0xA0, 0xBD, 0xED, 0xB8, 0x80 } },
+    // above U+10FFFF
+    { UTF8, UNI_ERR_INVALID, 4, { 0xF4, 0x90, 0x80, 0x80 } },
+    { UTF8, UNI_ERR_INVALID, 4, { 0xF5, 0x80, 0x80, 0x80 } },
+    { UTF8, UNI_ERR_INVALID, 1, { 0xFF } },
+    // continuation byte without lead
+    { UTF8, UNI_ERR_INVALID, 1, { 0x80 } },
+    { UTF8, UNI_ERR_INVALID, 1, { 0xBF } },
+    // too short, followed by an other character
+    { UTF8, UNI_ERR_INVALID, 2, { 0xC3, 'A' } },
+    { UTF8, UNI_ERR_INVALID, 3, { 0xE2, 0x82, 'A' } },
+    { UTF8, UNI_ERR_INVALID, 4, { 0xF0, 0x9F, 0x98, 0xC3 } },
+    // truncated by the end of the string
+    { UTF8, UNI_ERR_TRUNCATED, 1, { 0xC3 } },
+    { UTF8, UNI_ERR_TRUNCATED, 2, { 0xE2, 0x82 } },
+    { UTF8, UNI_ERR_TRUNCATED, 3, { 0xF0, 0x9F, 0x98 } },
+    // lone surrogates
+    { UTF16LE, UNI_ERR_INVALID, 2, { 0xD800, 'A' } },
+    { UTF16LE, UNI_ERR_INVALID, 1, { 0xDC00 } },
+    { UTF16LE, UNI_ERR_INVALID, 2, { 0xDFFF, 'A' } },
+    { UTF16LE, UNI_ERR_INVALID, 2, { 0xDBFF, 0xE000 } },
+    { UTF16LE, UNI_ERR_INVALID, 3, { 0xD800, 0xD800, 0xDC00 } },
+    // reversed pair
+    { UTF16LE, UNI_ERR_INVALID, 2, { 0xDC00, 0xD800 } },
+    { UTF16LE, UNI_ERR_INVALID, 2, { 0xDFFF, 0xDBFF } },
+    // truncated by the end of the string
+    { UTF16LE, UNI_ERR_TRUNCATED, 1, { 0xD800 } },
+    { UTF16LE, UNI_ERR_TRUNCATED, 1, { 0xDBFF } },
+    // the same in big endian
+    { UTF16BE, UNI_ERR_INVALID, 2, { 0xD800, 'A' } },
+    { UTF16BE, UNI_ERR_INVALID, 1, { 0xDC00 } },
+    { UTF16BE, UNI_ERR_INVALID, 2, { 0xDC00, 0xD800 } },
+    { UTF16BE, UNI_ERR_TRUNCATED, 1, { 0xDBFF } },
+    // surrogates and above U+10FFFF
+    { UTF32, UNI_ERR_INVALID, 1, { 0xD800 } },
+    { UTF32, UNI_ERR_INVALID, 1, { 0xDFFF } },
+    { UTF32, UNI_ERR_INVALID, 1, { 0x110000 } },
+    { UTF32, UNI_ERR_INVALID, 1, { 0xFFFFFFFF } },
+};
+
+/* an invalid input after some ASCII characters, followed by nothing or a few others */
+void test_transcode_invalid(void)
+{
+    void *input_copy, *buffer;
+    uint8_t input[4 * 128];
+    size_t c, i, k, offset, after, input_len, consumed, written;
+
+    for (i = 0; i < ARRAY_SIZE(invalid_inputs); i++) {
+        for (c = 0; c < ARRAY_SIZE(conversions); c++) {
+            if (conversions[c].from != invalid_inputs[i].from) {
+                continue;
+            }
+            for (offset = 0; offset <= 40; offset++) {
+                // something after a truncated code point makes it invalid
+                for (after = 0; after <= (UNI_ERR_TRUNCATED == invalid_inputs[i].error ? 0 : 20); after += 5) {
+                    input_len = 0;
+                    for (k = 0; k < offset; k++) {
+                        put_unit(input, invalid_inputs[i].from, input_len++, 'a' + k % 26);
+                    }
+                    for (k = 0; k < invalid_inputs[i].units_len; k++) {
+                        put_unit(input, invalid_inputs[i].from, input_len++, invalid_inputs[i].units[k]);
+                    }
+                    for (k = 0; k < after; k++) {
+                        put_unit(input, invalid_inputs[i].from, input_len++, 'z');
+                    }
+                    input_copy = exact_copy(input, input_len, invalid_inputs[i].from);
+                    buffer = malloc(4 * input_len);
+                    consumed = written = (size_t) -1;
+                    TEST_ASSERT_EQUAL_INT(invalid_inputs[i].error, conversions[c].convert(input_copy, input_len, buffer, 4 * input_len / unit_sizes[conversions[c].to], &consumed, &written));
+                    // the ASCII characters before are converted, the faulty code point is where it stopped
+                    TEST_ASSERT_EQUAL_UINT(offset, consumed);
+                    TEST_ASSERT_EQUAL_UINT(offset, written);
+                    free(buffer);
+                    free(input_copy);
+                }
+            }
+        }
+    }
+}
+
+void test_transcode_utf8_to_latin1(void)
+{
+    char buffer[4];
+    size_t consumed, written;
+
+    // the highest Latin-1 code point, then the first ones above
+    TEST_ASSERT_EQUAL_UINT(2, utf8_to_latin1_length("\xC3\xBF" "a", STR_LEN("\xC3\xBF" "a")));
+    TEST_ASSERT_EQUAL_INT(UNI_ERR_OK, utf8_to_latin1("\xC3\xBF" "a", STR_LEN("\xC3\xBF" "a"), buffer, 2, &consumed, &written));
+    TEST_ASSERT_EQUAL_UINT(3, consumed);
+    TEST_ASSERT_EQUAL_UINT(2, written);
+    TEST_ASSERT_TRUE(0 == memcmp("\xFF" "a", buffer, 2));
+    TEST_ASSERT_EQUAL_INT(UNI_ERR_INVALID, utf8_to_latin1("a\xC4\x80", STR_LEN("a\xC4\x80"), buffer, sizeof(buffer), &consumed, &written));
+    TEST_ASSERT_EQUAL_UINT(1, consumed);
+    TEST_ASSERT_EQUAL_UINT(1, written);
+    TEST_ASSERT_EQUAL_INT(UNI_ERR_INVALID, utf8_to_latin1("\xC3\xA9\xE2\x82\xAC", STR_LEN("\xC3\xA9\xE2\x82\xAC"), buffer, sizeof(buffer), &consumed, &written));
+    TEST_ASSERT_EQUAL_UINT(2, consumed);
+    TEST_ASSERT_EQUAL_UINT(1, written);
+    TEST_ASSERT_EQUAL_INT(UNI_ERR_INVALID, utf8_to_latin1("\xF0\x9F\x98\x80", STR_LEN("\xF0\x9F\x98\x80"), buffer, sizeof(buffer), &consumed, &written));
+    TEST_ASSERT_EQUAL_UINT(0, consumed);
+    TEST_ASSERT_EQUAL_UINT(0, written);
+    // the validity of the code point is checked before it is compared to U+00FF
+    TEST_ASSERT_EQUAL_INT(UNI_ERR_TRUNCATED, utf8_to_latin1("\xE2\x82", STR_LEN("\xE2\x82"), buffer, sizeof(buffer), &consumed, &written));
+    TEST_ASSERT_EQUAL_UINT(0, consumed);
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_transcode_round_trips, 252);
+    RUN_TEST(test_transcode_random, 280);
+    RUN_TEST(test_transcode_buffer_overflow, 340);
+    RUN_TEST(test_transcode_invalid, 418);
+    RUN_TEST(test_transcode_utf8_to_latin1, 457);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "ulist.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+#define N (ULIST_CHUNK_CAPACITY * 5 + 3)
+
+static int intptrcmp(const void *a, const void *b)
+{
+    return (int) ((intptr_t) a - (intptr_t) b);
+}
+
+static bool is_odd(const void *value, const void *UNUSED(data))
+{
+    return 0 != ((intptr_t) value & 1);
+}
+
+static void assert_sequence(UList *list, intptr_t from, intptr_t step, size_t count)
+{
+    size_t i;
+    void *v;
+    Iterator it;
+
+    TEST_ASSERT_EQUAL_UINT(count, ulist_length(list));
+    ulist_to_iterator(&it, list);
+    for (i = 0, iterator_first(&it); iterator_is_valid(&it, NULL, &v); i++, iterator_next(&it)) {
+        TEST_ASSERT_EQUAL_INT(from + (intptr_t) i * step, (intptr_t) v);
+    }
+    TEST_ASSERT_EQUAL_UINT(count, i);
+    for (iterator_last(&it); iterator_is_valid(&it, NULL, &v); iterator_previous(&it)) {
+        --i;
+        TEST_ASSERT_EQUAL_INT(from + (intptr_t) i * step, (intptr_t) v);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, i);
+    iterator_close(&it);
+}
+
+void test_ulist_append_prepend(void)
+{
+    void *v;
+    UList list;
+    intptr_t i;
+
+    ulist_init(&list, NULL, NULL);
+    TEST_ASSERT_TRUE(ulist_empty(&list));
+    for (i = N / 2; i < N; i++) {
+        TEST_ASSERT_TRUE(ulist_append(&list, (void *) i, NULL));
+    }
+    for (i = N / 2; i-- > 0; ) {
+        TEST_ASSERT_TRUE(ulist_prepend(&list, (void *) i, NULL));
+    }
+    assert_sequence(&list, 0, 1, N);
+    TEST_ASSERT_TRUE(ulist_at(&list, 0, &v));
+    TEST_ASSERT_EQUAL_INT(0, (intptr_t) v);
+    TEST_ASSERT_TRUE(ulist_at(&list, -1, &v));
+    TEST_ASSERT_EQUAL_INT(N - 1, (intptr_t) v);
+    TEST_ASSERT_TRUE(ulist_at(&list, ULIST_CHUNK_CAPACITY + 1, &v));
+    TEST_ASSERT_EQUAL_INT(ULIST_CHUNK_CAPACITY + 1, (intptr_t) v);
+    TEST_ASSERT_FALSE(ulist_at(&list, N, &v));
+    TEST_ASSERT_FALSE(ulist_at(&list, -N - 1, &v));
+    ulist_remove_head(&list);
+    ulist_remove_tail(&list);
+    assert_sequence(&list, 1, 1, N - 2);
+    ulist_clear(&list);
+    TEST_ASSERT_TRUE(ulist_empty(&list));
+}
+
+void test_ulist_insert(void)
+{
+    UList list;
+    intptr_t i;
+    UListPosition p;
+
+    ulist_init(&list, NULL, NULL);
+    // 0, 2, 4, ... then insert odd values before each even one (forces chunks to split)
+    for (i = 0; i < N; i++) {
+        ulist_append(&list, (void *) (2 * i + 2), NULL);
+    }
+    for (i = 0; i < N; i++) {
+        TEST_ASSERT_TRUE(ulist_find_first(&list, intptrcmp, (void *) (2 * i + 2), &p));
+        TEST_ASSERT_TRUE(ulist_insert_before(&list, &p, (void *) (2 * i + 1), NULL));
+        TEST_ASSERT_EQUAL_INT(2 * i + 2, (intptr_t) p.chunk->data[p.offset]);
+    }
+    assert_sequence(&list, 1, 1, 2 * N);
+    TEST_ASSERT_TRUE(ulist_find_last(&list, intptrcmp, (void *) (2 * N), &p));
+    TEST_ASSERT_TRUE(ulist_insert_after(&list, &p, (void *) (2 * N + 1), NULL));
+    TEST_ASSERT_EQUAL_INT(2 * N, (intptr_t) p.chunk->data[p.offset]);
+    assert_sequence(&list, 1, 1, 2 * N + 1);
+    ulist_clear(&list);
+}
+
+void test_ulist_iterator_delete(void)
+{
+    UList list;
+    intptr_t i;
+    Iterator it;
+
+    ulist_init(&list, NULL, NULL);
+    for (i = 0; i < N; i++) {
+        ulist_append(&list, (void *) i, NULL);
+    }
+    ulist_to_iterator(&it, &list);
+    iterator_reject(&it, is_odd, NULL);
+    iterator_close(&it);
+    assert_sequence(&list, 0, 2, (N + 1) / 2);
+    ulist_to_iterator(&it, &list);
+    iterator_filter(&it, is_odd, NULL);
+    iterator_close(&it);
+    TEST_ASSERT_TRUE(ulist_empty(&list));
+    ulist_clear(&list);
+}
+
+char MessageBuffer[50];
+
+static void runTest(UnityTestFunction test)
+{
+    if (TEST_PROTECT()) {
+        setUp();
+        test();
+    }
+    if (TEST_PROTECT() && !TEST_IS_IGNORED) {
+        tearDown();
+    }
+}
+
+void resetTest(void)
+{
+    tearDown();
+    setUp();
+}
+
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_ulist_append_prepend, 51);
+    RUN_TEST(test_ulist_insert, 81);
+    RUN_TEST(test_ulist_iterator_delete, 105);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,334 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#include "attributes.h"
+#include "utils.h"
+#include "utf8.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*
+ * A byte at a time, after the table of well-formed byte sequences of the
+ * Unicode standard (Table 3-7). Returns the offset of the first byte
+ * which can't be accepted or, if *truncated* is set, of the lead byte of
+ * the incomplete code point ending the string. Returns *len* if valid.
+ */
+static size_t reference_check(const uint8_t *s, size_t len, bool *truncated)
+{
+    size_t i, j, n;
+    uint8_t lo, hi;
+
+    *truncated = false;
+    for (i = 0; i < len; i += n + 1) {
+        lo = 0x80;
+        hi = 0xBF;
+        if (s[i] < 0x80) {
+            n = 0;
+        } else if (s[i] >= 0xC2 && s[i] <= 0xDF) {
+            n = 1;
+        } else if (0xE0 == s[i]) {
+            n = 2;
+            lo = 0xA0;
+        } else if (0xED == s[i]) {
+            n = 2;
+            hi = 0x9F;
+        } else if (s[i] >= 0xE1 && s[i] <= 0xEF) {
+            n = 2;
+        } else if (0xF0 == s[i]) {
+            n = 3;
+            lo = 0x90;
+        } else if (s[i] >= 0xF1 && s[i] <= 0xF3) {
+            n = 3;
+        } else if (0xF4 == s[i]) {
+            n = 3;
+            hi = 0x8F;
+        } else {
+            return i;
+        }
+        for (j = 1; j <= n; j++) {
+            if (i + j == len) {
+                *truncated = true;
+                return i;
+            }
+            if (s[i + j] < (1 == j ? lo : 0x80) || s[i + j] > (1 == j ? hi : 0xBF)) {
+                return i + j;
+            }
+        }
+    }
+
+    return len;
+}
+
+static const char * const valid_sequences[] = {
+    "A",
+    "\x7F",
+    "\xC2\x80",
+    "\xDF\xBF",
+    "\xE0\xA0\x80",
+    "\xE1\x80\x80",
+    "\xED\x9F\xBF",
+    "\xEE\x80\x80",
+    "\xEF\xBF\xBF",
+    "\xF0\x90\x80\x80",
+    "\xF3\xBF\xBF\xBF",
+    "\xF4\x8F\xBF\xBF",
+};
+
+static const char * const invalid_sequences[] = {
+    // overlongs
+    "\xC0\x80",
+    "\xC1\xBF",
+    "\xE0\x80\x80",
+    "\xE0\x9F\xBF",
+    "\xF0\x80\x80\x80",
+    "\xF0\x8F\xBF\xBF",
+    // surrogates
+    "\xED\xA0\x80",
+    "\xED\xB0\x80",
+    "\xED\xBF\xBF",
+    "\xED\xA0\x80\xED\xB0\x80",
+    // above U+10FFFF
+    "\xF4\x90\x80\x80",
+    "\xF4\xBF\xBF\xBF",
+    "\xF5\x80\x80\x80",
+    "\xF7\xBF\xBF\xBF",
+    "\xF8\x88\x80\x80\x80",
+    "\xFC\x84\x80\x80\x80\x80",
+    "\xFE",
+    "\xFF",
+    // continuation bytes without lead
+    "\x80",
+    "\xBF",
+    "\xC3\xA9\xA9",
+    // too short, interrupted by an other character
+    "\xC3" "A",
+    "\xE2\x82" "A",
+    "\xF0\x9F\x98" "A",
+    "\xE2\xC3\xA9",
+    // truncated (at the end of the buffer if nothing follows)
+    "\xC3",
+    "\xE2",
+    "\xE2\x82",
+    "\xF0",
+    "\xF0\x9F",
+    "\xF0\x9F\x98",
+};
+
+/* utf8_check on a copy of exactly *len* bytes (for ASan) gives the same result as reference_check */
+static void assert_check(const char *string, size_t len)
+{
+    char *s;
+    bool valid, truncated;
+    size_t expected;
+    const char *errp;
+
+    s = malloc(MAX(len, (size_t) 1));
+    memcpy(s, string, len);
+    expected = reference_check((const uint8_t *) s, len, &truncated);
+    valid = len == expected && !truncated;
+    errp = s;
+    TEST_ASSERT_EQUAL(valid, utf8_check(s, len, &errp));
+    TEST_ASSERT_EQUAL(valid, utf8_check(s, len, NULL));
+    if (valid) {
+        TEST_ASSERT_NULL(errp);
+    } else {
+        // the rejected byte or the lead byte of the truncated code point
+        TEST_ASSERT_EQUAL_PTR(s + expected, errp);
+    }
+    free(s);
+}
+
+#define next_random(seed) \
+    ((seed) = (seed) * 1103515245 + 12345, (seed) >> 16)
+
+/*
+ * Feed *string* to an Utf8Validator in parts of random lengths (0 included),
+ * each one copied to a buffer of its exact size (for ASan), and compare the
+ * result and the offset to reference_check
+ */
+static void assert_validator(const char *string, size_t len, uint32_t *seed)
+{
+    char *part;
+    bool truncated;
+    Utf8Validator v;
+    UnicodeError err;
+    size_t offset, expected, position, part_len;
+
+    expected = reference_check((const uint8_t *) string, len, &truncated);
+    utf8_validator_init(&v);
+    err = UNI_ERR_OK;
+    for (position = 0; position < len; position += part_len) {
+        part_len = next_random(*seed) % (MIN(len - position, (size_t) 40) + 1);
+        part = malloc(MAX(part_len, (size_t) 1));
+        memcpy(part, string + position, part_len);
+        offset = (size_t) -1;
+        err = utf8_validator_feed(&v, part, part_len, &offset);
+        free(part);
+        if (UNI_ERR_OK != err) {
+            break;
+        }
+        // no error reported before the rejected byte was fed
+        TEST_ASSERT_TRUE(truncated || expected >= position + part_len);
+    }
+    if (expected == len || truncated) {
+        TEST_ASSERT_EQUAL_INT(UNI_ERR_OK, err);
+    } else {
+        TEST_ASSERT_EQUAL_INT(UNI_ERR_INVALID, err);
+        TEST_ASSERT_EQUAL_UINT(expected, offset);
+        // once invalid, anything else is ignored
+        offset = (size_t) -1;
+        TEST_ASSERT_EQUAL_INT(UNI_ERR_INVALID, utf8_validator_feed(&v, "abc", STR_LEN("abc"), &offset));
+        TEST_ASSERT_EQUAL_UINT(expected, offset);
+    }
+    offset = (size_t) -1;
+    err = utf8_validator_finish(&v, &offset);
+    if (expected == len && !truncated) {
+        TEST_ASSERT_EQUAL_INT(UNI_ERR_OK, err);
+    } else {
+        TEST_ASSERT_EQUAL_INT(truncated ? UNI_ERR_TRUNCATED : UNI_ERR_INVALID, err);
+        TEST_ASSERT_EQUAL_UINT(expected, offset);
+    }
+}
+
+/* fill *buffer* with *len* bytes of valid UTF-8: ASCII only or mostly 2 and 3 bytes characters */
+static void fill_valid(char *buffer, size_t len, bool ascii)
+{
+    size_t i;
+
+    for (i = 0; i < len; ) {
+        if (ascii || len - i < 2) {
+            buffer[i] = 'a' + i % 26;
+            ++i;
+        } else if (len - i >= 3 && 0 == i % 5) {
+            memcpy(buffer + i, "\xE2\x82\xAC", 3);
+            i += 3;
+        } else {
+            memcpy(buffer + i, "\xC3\xA9", 2);
+            i += 2;
+        }
+    }
+}
+
+/* *sequence* at every offset of a 1, 2 or 3 blocks long string, followed by nothing or some text */
+static void assert_sequence_everywhere(const char *sequence)
+{
+    char buffer[128];
+    size_t offset, after, sequence_len, filler;
+
+    sequence_len = strlen(sequence);
+    for (filler = 0; filler < 2; filler++) {
+        for (offset = 0; offset <= 70; offset++) {
+            for (after = 0; after <= 40; after += 1 + after / 4) {
+                fill_valid(buffer, offset, 0 == filler);
+                memcpy(buffer + offset, sequence, sequence_len);
+                fill_valid(buffer + offset + sequence_len, after, 0 == after % 2);
+                assert_check(buffer, offset + sequence_len + after);
+            }
+        }
+    }
+}
+
+void test_utf8_check_valid(void)
+{
+    size_t i;
+
+    assert_check("", 0);
+    for (i = 0; i < ARRAY_SIZE(valid_sequences); i++) {
+        assert_sequence_everywhere(valid_sequences[i]);
+    }
+}
+
+void test_utf8_check_invalid(void)
+{
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(invalid_sequences); i++) {
+        assert_sequence_everywhere(invalid_sequences[i]);
+    }
+}
+
+void test_utf8_check_random(void)
+{
+    uint32_t seed;
+    char buffer[100];
+    size_t i, len, round;
+
+    seed = 42;
+    for (round = 0; round < 2000; round++) {
+        // mostly valid characters with, sometimes, a random byte
+        for (len = 0; len < sizeof(buffer) - 4; ) {
+            seed = seed * 1103515245 + 12345;
+            i = (seed >> 16) % ARRAY_SIZE(valid_sequences);
+            memcpy(buffer + len, valid_sequences[i], strlen(valid_sequences[i]));
+            len += strlen(valid_sequences[i]);
+            if (0 == (seed >> 8) % 64) {
+                buffer[len++] = (char) (seed >> 24);
+            }
+        }
+        assert_check(buffer, len);
+    }
+}
+
+void test_utf8_validator(void)
+{
+    char buffer[100];
+    uint32_t seed;
+    size_t i, j, len, round, offset;
+    const char * const *sequences[] = { valid_sequences, invalid_sequences };
+    const size_t sequences_count[] = { ARRAY_SIZE(valid_sequences), ARRAY_SIZE(invalid_sequences) };
+
+    seed = 42;
+    assert_validator("", 0, &seed);
+    // every sequence, between two texts, split in several ways
+    for (i = 0; i < ARRAY_SIZE(sequences); i++) {
+        for (j = 0; j < sequences_count[i]; j++) {
+            size_t sequence_len;
+
+            sequence_len = strlen(sequences[i][j]);
+            for (offset = 0; offset <= 40; offset += 3) {
+                fill_valid(buffer, offset, 0 == offset % 2);
+                memcpy(buffer + offset, sequences[i][j], sequence_len);
+                for (round = 0; round < 8; round++) {
+                    assert_validator(buffer, offset + sequence_len, &seed);
+                    fill_valid(buffer + offset + sequence_len, 10, false);
+                    assert_validator(buffer, offset + sequence_len + 10, &seed);
+                }
+            }
+        }
+    }
+    // random strings, as in test_utf8_check_random
+    for (round = 0; round < 2000; round++) {
+        for (len = 0; len < sizeof(buffer) - 4; ) {
+            i = next_random(seed) % ARRAY_SIZE(valid_sequences);
+            memcpy(buffer + len, valid_sequences[i], strlen(valid_sequences[i]));
+            len += strlen(valid_sequences[i]);
+            if (0 == next_random(seed) % 64) {
+                buffer[len++] = (char) (seed >> 24);
+            }
+        }
+        assert_validator(buffer, len, &seed);
+    }
+}
+
+int main(void)
+{
+    Unity.TestFile = __FILE__;
+    UnityBegin();
+
+    RUN_TEST(test_utf8_check_valid, 241);
+    RUN_TEST(test_utf8_check_invalid, 251);
+    RUN_TEST(test_utf8_check_random, 260);
+    RUN_TEST(test_utf8_validator, 282);
+
+    return (0 == UnityEnd() ? EXIT_SUCCESS : EXIT_FAILURE);
+}
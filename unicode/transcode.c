@@ -0,0 +1,931 @@
+/**
+ * @file unicode/transcode.c
+ * @brief whole buffer conversions between UTF-8, UTF-16, UTF-32 and Latin-1
+ *
+ * Each conversion copies the runs of ASCII characters 16 at a time (SSE2)
+ * then handles the other characters one at a time, checking them as they
+ * are decoded, until the next run of ASCII characters.
+ *
+ * The *_length functions give the exact size (in units of the output
+ * encoding) of the converted string, provided the input is valid, so the
+ * output buffer can be allocated beforehand:
+ *
+ * \code
+ *   size_t utf16_len, consumed;
+ *   uint16_t *utf16;
+ *
+ *   utf16_len = utf8_to_utf16_length(string, string_len);
+ *   utf16 = malloc(utf16_len * sizeof(*utf16));
+ *   if (UNI_ERR_OK != utf8_to_utf16le(string, string_len, utf16, utf16_len, &consumed, &utf16_len)) {
+ *       // invalid UTF-8 at string + consumed
+ *   }
+ * \endcode
+ *
+ * UTF-16 strings are arrays of uint16_t whose bytes are in the order
+ * given by the name of the function (independently of the endianness of
+ * the host), UTF-32 strings are arrays of code points (uint32_t in host
+ * order) and Latin-1 is ISO-8859-1 (the 256 first code points).
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "attributes.h"
+#include "utils.h"
+#include "simd.h"
+#include "transcode.h"
+#include "utf8.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+# define HOST_BIG_ENDIAN true
+#else
+# define HOST_BIG_ENDIAN false
+#endif /* big endian */
+
+#define IS_SURROGATE(cp) \
+    (0xD800 == ((cp) & 0xFFFFF800))
+
+/* convert a UTF-16 unit from or to the given byte order */
+static inline uint16_t utf16_unit(uint16_t unit, bool big_endian)
+{
+    return big_endian == HOST_BIG_ENDIAN ? unit : (uint16_t) (unit << 8 | unit >> 8);
+}
+
+/* ========== SIMD ASCII/counting kernels ========== */
+
+/*
+ * Each kernel handles its input by blocks of 16 units and returns the
+ * number of units processed: for the conversions, it stops before the
+ * first block containing a non-ASCII character, the caller has to ensure
+ * there is room in the output for string_len units.
+ */
+
+#ifdef HAVE_X86_SIMD
+# define LOAD_SSE2(p) _mm_loadu_si128((const __m128i *) (const void *) (p))
+# define STORE_SSE2(p, v) _mm_storeu_si128((__m128i *) (void *) (p), (v))
+/* swap the two bytes of each 16 bits unit */
+# define SWAP16_SSE2(v) _mm_or_si128(_mm_slli_epi16((v), 8), _mm_srli_epi16((v), 8))
+
+static TARGET("sse2") size_t ascii_prefix_sse2(const uint8_t *string, size_t string_len)
+{
+    size_t i;
+
+    for (i = 0; i + 16 <= string_len; i += 16) {
+        if (0 != _mm_movemask_epi8(LOAD_SSE2(string + i))) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+static TARGET("sse2") size_t ascii_to_utf16_sse2(const uint8_t *string, size_t string_len, uint16_t *buffer, bool big_endian)
+{
+    size_t i;
+    const __m128i zero = _mm_setzero_si128();
+
+    for (i = 0; i + 16 <= string_len; i += 16) {
+        __m128i v;
+
+        v = LOAD_SSE2(string + i);
+        if (0 != _mm_movemask_epi8(v)) {
+            break;
+        }
+        if (big_endian) {
+            STORE_SSE2(buffer + i, _mm_unpacklo_epi8(zero, v));
+            STORE_SSE2(buffer + i + 8, _mm_unpackhi_epi8(zero, v));
+        } else {
+            STORE_SSE2(buffer + i, _mm_unpacklo_epi8(v, zero));
+            STORE_SSE2(buffer + i + 8, _mm_unpackhi_epi8(v, zero));
+        }
+    }
+
+    return i;
+}
+
+static TARGET("sse2") size_t ascii_to_utf32_sse2(const uint8_t *string, size_t string_len, uint32_t *buffer)
+{
+    size_t i;
+    const __m128i zero = _mm_setzero_si128();
+
+    for (i = 0; i + 16 <= string_len; i += 16) {
+        __m128i v, lo, hi;
+
+        v = LOAD_SSE2(string + i);
+        if (0 != _mm_movemask_epi8(v)) {
+            break;
+        }
+        lo = _mm_unpacklo_epi8(v, zero);
+        hi = _mm_unpackhi_epi8(v, zero);
+        STORE_SSE2(buffer + i, _mm_unpacklo_epi16(lo, zero));
+        STORE_SSE2(buffer + i + 4, _mm_unpackhi_epi16(lo, zero));
+        STORE_SSE2(buffer + i + 8, _mm_unpacklo_epi16(hi, zero));
+        STORE_SSE2(buffer + i + 12, _mm_unpackhi_epi16(hi, zero));
+    }
+
+    return i;
+}
+
+static TARGET("sse2") size_t utf16_to_ascii_sse2(const uint16_t *string, size_t string_len, uint8_t *buffer, bool big_endian)
+{
+    size_t i;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i non_ascii = _mm_set1_epi16((short) 0xFF80);
+
+    for (i = 0; i + 16 <= string_len; i += 16) {
+        __m128i a, b;
+
+        a = LOAD_SSE2(string + i);
+        b = LOAD_SSE2(string + i + 8);
+        if (big_endian) {
+            a = SWAP16_SSE2(a);
+            b = SWAP16_SSE2(b);
+        }
+        if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), non_ascii), zero))) {
+            break;
+        }
+        STORE_SSE2(buffer + i, _mm_packus_epi16(a, b));
+    }
+
+    return i;
+}
+
+static TARGET("sse2") size_t utf32_to_ascii_sse2(const uint32_t *string, size_t string_len, uint8_t *buffer)
+{
+    size_t i;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i non_ascii = _mm_set1_epi32(~0x7F);
+
+    for (i = 0; i + 16 <= string_len; i += 16) {
+        __m128i a, b, c, d;
+
+        a = LOAD_SSE2(string + i);
+        b = LOAD_SSE2(string + i + 4);
+        c = LOAD_SSE2(string + i + 8);
+        d = LOAD_SSE2(string + i + 12);
+        if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), non_ascii), zero))) {
+            break;
+        }
+        STORE_SSE2(buffer + i, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    }
+
+    return i;
+}
+
+/*
+ * The counting kernels accumulate, in each lane, the -1 of the masks of
+ * the comparisons then sum the lanes before they can overflow (255 blocks
+ * for bytes). This avoids a popcount of the masks, not part of SSE2.
+ */
+
+static TARGET("sse2") size_t sum_epu8_sse2(__m128i v)
+{
+    __m128i sum;
+
+    sum = _mm_sad_epu8(v, _mm_setzero_si128());
+
+    return (size_t) _mm_cvtsi128_si32(sum) + (size_t) _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+}
+
+/* count the bytes which are not continuation bytes (10xxxxxx) and the lead bytes of 4 bytes sequences (11110xxx) */
+static TARGET("sse2") size_t utf8_count_sse2(const uint8_t *string, size_t string_len, size_t *code_points, size_t *supplementaries)
+{
+    size_t i, end;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i last_continuation = _mm_set1_epi8((char) 0xBF);
+    const __m128i before_4_bytes_lead = _mm_set1_epi8((char) 0xEF);
+
+    for (i = 0; i + 16 <= string_len; ) {
+        __m128i cps, sups;
+
+        cps = sups = zero;
+        end = MIN(string_len & ~(size_t) 15, i + 255 * 16);
+        for (; i < end; i += 16) {
+            __m128i v;
+
+            v = LOAD_SSE2(string + i);
+            // signed comparisons: 0xC0-0xFF and 0x00-0x7F are greater than 0xBF, 0xF0-0xFF and 0x00-0x7F than 0xEF
+            cps = _mm_sub_epi8(cps, _mm_cmpgt_epi8(v, last_continuation));
+            sups = _mm_sub_epi8(sups, _mm_and_si128(_mm_cmpgt_epi8(v, before_4_bytes_lead), _mm_cmplt_epi8(v, zero)));
+        }
+        *code_points += sum_epu8_sse2(cps);
+        *supplementaries += sum_epu8_sse2(sups);
+    }
+
+    return i;
+}
+
+/* count the bytes greater than 0x7F */
+static TARGET("sse2") size_t latin1_count_sse2(const uint8_t *string, size_t string_len, size_t *non_ascii)
+{
+    size_t i, end;
+    const __m128i zero = _mm_setzero_si128();
+
+    for (i = 0; i + 16 <= string_len; ) {
+        __m128i count;
+
+        count = zero;
+        end = MIN(string_len & ~(size_t) 15, i + 255 * 16);
+        for (; i < end; i += 16) {
+            count = _mm_sub_epi8(count, _mm_cmplt_epi8(LOAD_SSE2(string + i), zero));
+        }
+        *non_ascii += sum_epu8_sse2(count);
+    }
+
+    return i;
+}
+
+/*
+ * count the extra bytes needed in UTF-8: 2 per unit minus 1 below U+0800,
+ * 1 more below U+0080 and 1 for a surrogate (a pair takes 4 bytes)
+ */
+static TARGET("sse2") size_t utf16_count_sse2(const uint16_t *string, size_t string_len, bool big_endian, size_t *extra)
+{
+    size_t i, end;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i above_7F = _mm_set1_epi16((short) 0xFF80);
+    const __m128i above_7FF = _mm_set1_epi16((short) 0xF800);
+    const __m128i surrogate = _mm_set1_epi16((short) 0xD800);
+
+    for (i = 0; i + 8 <= string_len; ) {
+        int32_t lanes[4];
+        __m128i less;
+
+        // a lane grows by at most 2 for each block, so 2^13 blocks keep it under INT16_MAX
+        less = zero;
+        end = MIN(string_len & ~(size_t) 7, i + 8 * 8192);
+        *extra += 2 * (end - i);
+        for (; i < end; i += 8) {
+            __m128i v, high;
+
+            v = LOAD_SSE2(string + i);
+            if (big_endian) {
+                v = SWAP16_SSE2(v);
+            }
+            high = _mm_and_si128(v, above_7FF);
+            less = _mm_sub_epi16(less, _mm_cmpeq_epi16(_mm_and_si128(v, above_7F), zero));
+            less = _mm_sub_epi16(less, _mm_cmpeq_epi16(high, zero));
+            less = _mm_sub_epi16(less, _mm_cmpeq_epi16(high, surrogate));
+        }
+        STORE_SSE2(lanes, _mm_madd_epi16(less, _mm_set1_epi16(1)));
+        *extra -= (size_t) (lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+
+    return i;
+}
+#endif /* HAVE_X86_SIMD */
+
+/* ========== decoding/encoding of a code point ========== */
+
+static UnicodeError utf8_decode(const uint8_t *string, const uint8_t * const string_end, codepoint *cp, size_t *cp_len)
+{
+    size_t i, len;
+    codepoint c;
+    uint8_t lower, upper;
+
+    c = *string;
+    lower = 0x80;
+    upper = 0xBF;
+    if (c < 0x80) {
+        len = 1;
+    } else if (c < 0xC2) {
+        // continuation byte or overlong 2 bytes sequence
+        return UNI_ERR_INVALID;
+    } else if (c < 0xE0) {
+        len = 2;
+        c &= 0x1F;
+    } else if (c < 0xF0) {
+        len = 3;
+        if (0xE0 == c) {
+            lower = 0xA0; // overlong
+        } else if (0xED == c) {
+            upper = 0x9F; // surrogates
+        }
+        c &= 0x0F;
+    } else if (c < 0xF5) {
+        len = 4;
+        if (0xF0 == c) {
+            lower = 0x90; // overlong
+        } else if (0xF4 == c) {
+            upper = 0x8F; // above U+10FFFF
+        }
+        c &= 0x07;
+    } else {
+        return UNI_ERR_INVALID;
+    }
+    for (i = 1; i < len; i++) {
+        if (string + i >= string_end) {
+            return UNI_ERR_TRUNCATED;
+        }
+        if (string[i] < lower || string[i] > upper) {
+            return UNI_ERR_INVALID;
+        }
+        c = c << 6 | (string[i] & 0x3F);
+        lower = 0x80;
+        upper = 0xBF;
+    }
+    *cp = c;
+    *cp_len = len;
+
+    return UNI_ERR_OK;
+}
+
+static UnicodeError utf16_decode(const uint16_t *string, const uint16_t * const string_end, bool big_endian, codepoint *cp, size_t *cp_len)
+{
+    uint16_t high, low;
+
+    high = utf16_unit(*string, big_endian);
+    if (!IS_SURROGATE(high)) {
+        *cp = high;
+        *cp_len = 1;
+    } else {
+        if (high > 0xDBFF) {
+            // unpaired low surrogate
+            return UNI_ERR_INVALID;
+        }
+        if (string + 1 >= string_end) {
+            return UNI_ERR_TRUNCATED;
+        }
+        low = utf16_unit(string[1], big_endian);
+        if (low < 0xDC00 || low > 0xDFFF) {
+            return UNI_ERR_INVALID;
+        }
+        *cp = 0x10000 + (((uint32_t) high - 0xD800) << 10) + (low - 0xDC00);
+        *cp_len = 2;
+    }
+
+    return UNI_ERR_OK;
+}
+
+static inline size_t utf8_cp_length(codepoint cp)
+{
+    return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+}
+
+/* ========== output sizes ========== */
+
+static void utf8_count(const char *string, size_t string_len, size_t *code_points, size_t *supplementaries)
+{
+    size_t i;
+    const uint8_t * const s = (const uint8_t *) string;
+
+    assert(NULL != string || 0 == string_len);
+
+    i = *code_points = *supplementaries = 0;
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_SSE2()) {
+        i = utf8_count_sse2(s, string_len, code_points, supplementaries);
+    }
+#endif /* HAVE_X86_SIMD */
+    for (; i < string_len; i++) {
+        *code_points += 0x80 != (s[i] & 0xC0);
+        *supplementaries += s[i] >= 0xF0;
+    }
+}
+
+/**
+ * Compute the number of UTF-16 units needed to convert a UTF-8 string
+ *
+ * @param string the UTF-8 string
+ * @param string_len its length, in bytes
+ *
+ * @return the exact number of units, if string is valid UTF-8, that
+ * utf8_to_utf16le/utf8_to_utf16be will write
+ */
+size_t utf8_to_utf16_length(const char *string, size_t string_len)
+{
+    size_t code_points, supplementaries;
+
+    utf8_count(string, string_len, &code_points, &supplementaries);
+
+    return code_points + supplementaries;
+}
+
+/**
+ * Compute the number of code points of a UTF-8 string (the length once
+ * converted to UTF-32)
+ *
+ * @param string the UTF-8 string
+ * @param string_len its length, in bytes
+ *
+ * @return the exact number of code points, if string is valid UTF-8
+ */
+size_t utf8_to_utf32_length(const char *string, size_t string_len)
+{
+    size_t code_points, supplementaries;
+
+    utf8_count(string, string_len, &code_points, &supplementaries);
+
+    return code_points;
+}
+
+/**
+ * Compute the number of bytes needed to convert a UTF-8 string to Latin-1
+ *
+ * @param string the UTF-8 string
+ * @param string_len its length, in bytes
+ *
+ * @return the exact number of bytes, if string is valid UTF-8 and all its
+ * code points are lower than U+0100
+ */
+size_t utf8_to_latin1_length(const char *string, size_t string_len)
+{
+    return utf8_to_utf32_length(string, string_len);
+}
+
+static size_t utf16_to_utf8_length(const uint16_t *string, size_t string_len, bool big_endian)
+{
+    size_t i, length;
+
+    assert(NULL != string || 0 == string_len);
+
+    i = 0;
+    length = string_len;
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_SSE2()) {
+        i = utf16_count_sse2(string, string_len, big_endian, &length);
+    }
+#endif /* HAVE_X86_SIMD */
+    for (; i < string_len; i++) {
+        uint16_t unit;
+
+        unit = utf16_unit(string[i], big_endian);
+        // a surrogate pair takes 4 bytes, 2 for each unit
+        length += (unit >= 0x80) + (unit >= 0x800) - IS_SURROGATE(unit);
+    }
+
+    return length;
+}
+
+/**
+ * Compute the number of bytes needed to convert a UTF-16LE string to UTF-8
+ *
+ * @param string the UTF-16LE string
+ * @param string_len its length, in units (uint16_t)
+ *
+ * @return the exact number of bytes, if string is valid UTF-16LE
+ */
+size_t utf16le_to_utf8_length(const uint16_t *string, size_t string_len)
+{
+    return utf16_to_utf8_length(string, string_len, false);
+}
+
+/**
+ * Compute the number of bytes needed to convert a UTF-16BE string to UTF-8
+ *
+ * @param string the UTF-16BE string
+ * @param string_len its length, in units (uint16_t)
+ *
+ * @return the exact number of bytes, if string is valid UTF-16BE
+ */
+size_t utf16be_to_utf8_length(const uint16_t *string, size_t string_len)
+{
+    return utf16_to_utf8_length(string, string_len, true);
+}
+
+/**
+ * Compute the number of bytes needed to convert a UTF-32 string to UTF-8
+ *
+ * @param string the UTF-32 string
+ * @param string_len its length, in code points
+ *
+ * @return the exact number of bytes, if string is valid UTF-32
+ */
+size_t utf32_to_utf8_length(const uint32_t *string, size_t string_len)
+{
+    size_t i, length;
+
+    assert(NULL != string || 0 == string_len);
+
+    for (i = length = 0; i < string_len; i++) {
+        length += utf8_cp_length(string[i]);
+    }
+
+    return length;
+}
+
+/**
+ * Compute the number of bytes needed to convert a Latin-1 string to UTF-8
+ *
+ * @param string the Latin-1 string
+ * @param string_len its length, in bytes
+ *
+ * @return the exact number of bytes
+ */
+size_t latin1_to_utf8_length(const char *string, size_t string_len)
+{
+    size_t i, length;
+    const uint8_t * const s = (const uint8_t *) string;
+
+    assert(NULL != string || 0 == string_len);
+
+    i = 0;
+    length = string_len;
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_SSE2()) {
+        i = latin1_count_sse2(s, string_len, &length);
+    }
+#endif /* HAVE_X86_SIMD */
+    for (; i < string_len; i++) {
+        length += s[i] >> 7;
+    }
+
+    return length;
+}
+
+/* ========== conversions ========== */
+
+/*
+ * All conversions stop on the first error and set *consumed (if not
+ * NULL) to the number of input units converted (the position of the
+ * faulty code point on error), *written (if not NULL) to the number of
+ * output units written.
+ */
+#define RETURN(error) \
+    do { \
+        if (NULL != consumed) { \
+            *consumed = i; \
+        } \
+        if (NULL != written) { \
+            *written = j; \
+        } \
+        return error; \
+    } while (0)
+
+static UnicodeError utf8_to_utf16(const char *string, size_t string_len, uint16_t *buffer, size_t buffer_len, bool big_endian, size_t *consumed, size_t *written)
+{
+    size_t i, j, n;
+    codepoint cp;
+    UnicodeError error;
+    const uint8_t * const s = (const uint8_t *) string;
+
+    assert(NULL != string || 0 == string_len);
+    assert(NULL != buffer || 0 == buffer_len);
+
+    i = j = 0;
+    while (i < string_len) {
+        if (s[i] < 0x80) {
+#ifdef HAVE_X86_SIMD
+            if (CPU_HAS_SSE2()) {
+                n = ascii_to_utf16_sse2(s + i, MIN(string_len - i, buffer_len - j), buffer + j, big_endian);
+                i += n;
+                j += n;
+            }
+#endif /* HAVE_X86_SIMD */
+            // the ASCII characters left before the next non-ASCII one
+            for (; i < string_len && s[i] < 0x80; i++) {
+                if (j >= buffer_len) {
+                    RETURN(UNI_ERR_BUFFER_OVERFLOW);
+                }
+                buffer[j++] = utf16_unit(s[i], big_endian);
+            }
+            continue;
+        }
+        if (UNI_ERR_OK != (error = utf8_decode(s + i, s + string_len, &cp, &n))) {
+            RETURN(error);
+        }
+        if (cp < 0x10000) {
+            if (j >= buffer_len) {
+                RETURN(UNI_ERR_BUFFER_OVERFLOW);
+            }
+            buffer[j++] = utf16_unit((uint16_t) cp, big_endian);
+        } else {
+            if (buffer_len - j < 2) {
+                RETURN(UNI_ERR_BUFFER_OVERFLOW);
+            }
+            cp -= 0x10000;
+            buffer[j++] = utf16_unit((uint16_t) (0xD800 | (cp >> 10)), big_endian);
+            buffer[j++] = utf16_unit((uint16_t) (0xDC00 | (cp & 0x3FF)), big_endian);
+        }
+        i += n;
+    }
+    RETURN(UNI_ERR_OK);
+}
+
+/**
+ * Convert a UTF-8 string to UTF-16LE
+ *
+ * @param string the UTF-8 string
+ * @param string_len its length, in bytes
+ * @param buffer the output buffer
+ * @param buffer_len its size, in units (uint16_t), see utf8_to_utf16_length
+ * @param consumed, optionnal (NULL to ignore), the number of bytes converted:
+ * on error, the offset of the faulty code point in string
+ * @param written, optionnal (NULL to ignore), the number of units written in buffer
+ *
+ * @return UNI_ERR_OK on success, UNI_ERR_INVALID or UNI_ERR_TRUNCATED if
+ * string is not a valid UTF-8 string, UNI_ERR_BUFFER_OVERFLOW if buffer is
+ * too small (the conversion can be resumed from there)
+ */
+UnicodeError utf8_to_utf16le(const char *string, size_t string_len, uint16_t *buffer, size_t buffer_len, size_t *consumed, size_t *written)
+{
+    return utf8_to_utf16(string, string_len, buffer, buffer_len, false, consumed, written);
+}
+
+/**
+ * Convert a UTF-8 string to UTF-16BE
+ *
+ * @note see utf8_to_utf16le for parameters and return value
+ */
+UnicodeError utf8_to_utf16be(const char *string, size_t string_len, uint16_t *buffer, size_t buffer_len, size_t *consumed, size_t *written)
+{
+    return utf8_to_utf16(string, string_len, buffer, buffer_len, true, consumed, written);
+}
+
+/**
+ * Convert a UTF-8 string to UTF-32
+ *
+ * @param string the UTF-8 string
+ * @param string_len its length, in bytes
+ * @param buffer the output buffer
+ * @param buffer_len its size, in code points, see utf8_to_utf32_length
+ * @param consumed, optionnal (NULL to ignore), the number of bytes converted:
+ * on error, the offset of the faulty code point in string
+ * @param written, optionnal (NULL to ignore), the number of code points written in buffer
+ *
+ * @return UNI_ERR_OK on success, UNI_ERR_INVALID or UNI_ERR_TRUNCATED if
+ * string is not a valid UTF-8 string, UNI_ERR_BUFFER_OVERFLOW if buffer is
+ * too small
+ */
+UnicodeError utf8_to_utf32(const char *string, size_t string_len, uint32_t *buffer, size_t buffer_len, size_t *consumed, size_t *written)
+{
+    size_t i, j, n;
+    codepoint cp;
+    UnicodeError error;
+    const uint8_t * const s = (const uint8_t *) string;
+
+    assert(NULL != string || 0 == string_len);
+    assert(NULL != buffer || 0 == buffer_len);
+
+    i = j = 0;
+    while (i < string_len) {
+        if (s[i] < 0x80) {
+#ifdef HAVE_X86_SIMD
+            if (CPU_HAS_SSE2()) {
+                n = ascii_to_utf32_sse2(s + i, MIN(string_len - i, buffer_len - j), buffer + j);
+                i += n;
+                j += n;
+            }
+#endif /* HAVE_X86_SIMD */
+            // the ASCII characters left before the next non-ASCII one
+            for (; i < string_len && s[i] < 0x80; i++) {
+                if (j >= buffer_len) {
+                    RETURN(UNI_ERR_BUFFER_OVERFLOW);
+                }
+                buffer[j++] = s[i];
+            }
+            continue;
+        }
+        if (UNI_ERR_OK != (error = utf8_decode(s + i, s + string_len, &cp, &n))) {
+            RETURN(error);
+        }
+        if (j >= buffer_len) {
+            RETURN(UNI_ERR_BUFFER_OVERFLOW);
+        }
+        buffer[j++] = cp;
+        i += n;
+    }
+    RETURN(UNI_ERR_OK);
+}
+
+/**
+ * Convert a UTF-8 string to Latin-1
+ *
+ * @param string the UTF-8 string
+ * @param string_len its length, in bytes
+ * @param buffer the output buffer (not nul-terminated)
+ * @param buffer_len its size, in bytes, see utf8_to_latin1_length
+ * @param consumed, optionnal (NULL to ignore), the number of bytes converted:
+ * on error, the offset of the faulty code point in string
+ * @param written, optionnal (NULL to ignore), the number of bytes written in buffer
+ *
+ * @return UNI_ERR_OK on success, UNI_ERR_INVALID or UNI_ERR_TRUNCATED if
+ * string is not a valid UTF-8 string (UNI_ERR_INVALID too for a code point
+ * above U+00FF, which has no Latin-1 equivalent), UNI_ERR_BUFFER_OVERFLOW
+ * if buffer is too small
+ */
+UnicodeError utf8_to_latin1(const char *string, size_t string_len, char *buffer, size_t buffer_len, size_t *consumed, size_t *written)
+{
+    size_t i, j, n;
+    codepoint cp;
+    UnicodeError error;
+    const uint8_t * const s = (const uint8_t *) string;
+
+    assert(NULL != string || 0 == string_len);
+    assert(NULL != buffer || 0 == buffer_len);
+
+    i = j = 0;
+    while (i < string_len) {
+        if (s[i] < 0x80) {
+#ifdef HAVE_X86_SIMD
+            if (CPU_HAS_SSE2()) {
+                n = ascii_prefix_sse2(s + i, MIN(string_len - i, buffer_len - j));
+                memcpy(buffer + j, s + i, n);
+                i += n;
+                j += n;
+            }
+#endif /* HAVE_X86_SIMD */
+            // the ASCII characters left before the next non-ASCII one
+            for (; i < string_len && s[i] < 0x80; i++) {
+                if (j >= buffer_len) {
+                    RETURN(UNI_ERR_BUFFER_OVERFLOW);
+                }
+                buffer[j++] = (char) s[i];
+            }
+            continue;
+        }
+        if (UNI_ERR_OK != (error = utf8_decode(s + i, s + string_len, &cp, &n))) {
+            RETURN(error);
+        }
+        if (cp > 0xFF) {
+            RETURN(UNI_ERR_INVALID);
+        }
+        if (j >= buffer_len) {
+            RETURN(UNI_ERR_BUFFER_OVERFLOW);
+        }
+        buffer[j++] = (char) cp;
+        i += n;
+    }
+    RETURN(UNI_ERR_OK);
+}
+
+static UnicodeError utf16_to_utf8(const uint16_t *string, size_t string_len, char *buffer, size_t buffer_len, bool big_endian, size_t *consumed, size_t *written)
+{
+    size_t i, j, n;
+    codepoint cp;
+    UnicodeError error;
+    uint8_t * const w = (uint8_t *) buffer;
+
+    assert(NULL != string || 0 == string_len);
+    assert(NULL != buffer || 0 == buffer_len);
+
+    i = j = 0;
+    while (i < string_len) {
+        if (utf16_unit(string[i], big_endian) < 0x80) {
+#ifdef HAVE_X86_SIMD
+            if (CPU_HAS_SSE2()) {
+                n = utf16_to_ascii_sse2(string + i, MIN(string_len - i, buffer_len - j), w + j, big_endian);
+                i += n;
+                j += n;
+            }
+#endif /* HAVE_X86_SIMD */
+            // the ASCII characters left before the next non-ASCII one
+            for (; i < string_len && utf16_unit(string[i], big_endian) < 0x80; i++) {
+                if (j >= buffer_len) {
+                    RETURN(UNI_ERR_BUFFER_OVERFLOW);
+                }
+                w[j++] = (uint8_t) utf16_unit(string[i], big_endian);
+            }
+            continue;
+        }
+        if (UNI_ERR_OK != (error = utf16_decode(string + i, string + string_len, big_endian, &cp, &n))) {
+            RETURN(error);
+        }
+        if (buffer_len - j < utf8_cp_length(cp)) {
+            RETURN(UNI_ERR_BUFFER_OVERFLOW);
+        }
+        j += utf8_write_cp(cp, w + j, w + buffer_len);
+        i += n;
+    }
+    RETURN(UNI_ERR_OK);
+}
+
+/**
+ * Convert a UTF-16LE string to UTF-8
+ *
+ * @param string the UTF-16LE string
+ * @param string_len its length, in units (uint16_t)
+ * @param buffer the output buffer (not nul-terminated)
+ * @param buffer_len its size, in bytes, see utf16le_to_utf8_length
+ * @param consumed, optionnal (NULL to ignore), the number of units converted:
+ * on error, the offset of the faulty code point in string
+ * @param written, optionnal (NULL to ignore), the number of bytes written in buffer
+ *
+ * @return UNI_ERR_OK on success, UNI_ERR_INVALID (unpaired surrogate) or
+ * UNI_ERR_TRUNCATED (high surrogate ending the string) if string is not a
+ * valid UTF-16LE string, UNI_ERR_BUFFER_OVERFLOW if buffer is too small
+ */
+UnicodeError utf16le_to_utf8(const uint16_t *string, size_t string_len, char *buffer, size_t buffer_len, size_t *consumed, size_t *written)
+{
+    return utf16_to_utf8(string, string_len, buffer, buffer_len, false, consumed, written);
+}
+
+/**
+ * Convert a UTF-16BE string to UTF-8
+ *
+ * @note see utf16le_to_utf8 for parameters and return value
+ */
+UnicodeError utf16be_to_utf8(const uint16_t *string, size_t string_len, char *buffer, size_t buffer_len, size_t *consumed, size_t *written)
+{
+    return utf16_to_utf8(string, string_len, buffer, buffer_len, true, consumed, written);
+}
+
+/**
+ * Convert a UTF-32 string to UTF-8
+ *
+ * @param string the UTF-32 string
+ * @param string_len its length, in code points
+ * @param buffer the output buffer (not nul-terminated)
+ * @param buffer_len its size, in bytes, see utf32_to_utf8_length
+ * @param consumed, optionnal (NULL to ignore), the number of code points
+ * converted: on error, the offset of the faulty one in string
+ * @param written, optionnal (NULL to ignore), the number of bytes written in buffer
+ *
+ * @return UNI_ERR_OK on success, UNI_ERR_INVALID for a surrogate or a value
+ * above U+10FFFF, UNI_ERR_BUFFER_OVERFLOW if buffer is too small
+ */
+UnicodeError utf32_to_utf8(const uint32_t *string, size_t string_len, char *buffer, size_t buffer_len, size_t *consumed, size_t *written)
+{
+    size_t i, j, n;
+    uint8_t * const w = (uint8_t *) buffer;
+
+    assert(NULL != string || 0 == string_len);
+    assert(NULL != buffer || 0 == buffer_len);
+
+    i = j = 0;
+    while (i < string_len) {
+        if (string[i] < 0x80) {
+#ifdef HAVE_X86_SIMD
+            if (CPU_HAS_SSE2()) {
+                n = utf32_to_ascii_sse2(string + i, MIN(string_len - i, buffer_len - j), w + j);
+                i += n;
+                j += n;
+            }
+#endif /* HAVE_X86_SIMD */
+            // the ASCII characters left before the next non-ASCII one
+            for (; i < string_len && string[i] < 0x80; i++) {
+                if (j >= buffer_len) {
+                    RETURN(UNI_ERR_BUFFER_OVERFLOW);
+                }
+                w[j++] = (uint8_t) string[i];
+            }
+            continue;
+        }
+        if (string[i] > UNICODE_HIGHEST_CODE_POINT || IS_SURROGATE(string[i])) {
+            RETURN(UNI_ERR_INVALID);
+        }
+        n = utf8_cp_length(string[i]);
+        if (buffer_len - j < n) {
+            RETURN(UNI_ERR_BUFFER_OVERFLOW);
+        }
+        j += utf8_write_cp(string[i], w + j, w + buffer_len);
+        i++;
+    }
+    RETURN(UNI_ERR_OK);
+}
+
+/**
+ * Convert a Latin-1 string to UTF-8
+ *
+ * @param string the Latin-1 string
+ * @param string_len its length, in bytes
+ * @param buffer the output buffer (not nul-terminated)
+ * @param buffer_len its size, in bytes, see latin1_to_utf8_length
+ * @param consumed, optionnal (NULL to ignore), the number of bytes converted
+ * @param written, optionnal (NULL to ignore), the number of bytes written in buffer
+ *
+ * @return UNI_ERR_OK on success or UNI_ERR_BUFFER_OVERFLOW if buffer is too
+ * small (any byte is a valid Latin-1 character)
+ */
+UnicodeError latin1_to_utf8(const char *string, size_t string_len, char *buffer, size_t buffer_len, size_t *consumed, size_t *written)
+{
+    size_t i, j;
+    const uint8_t * const s = (const uint8_t *) string;
+
+    assert(NULL != string || 0 == string_len);
+    assert(NULL != buffer || 0 == buffer_len);
+
+    i = j = 0;
+    while (i < string_len) {
+        if (s[i] < 0x80) {
+#ifdef HAVE_X86_SIMD
+            if (CPU_HAS_SSE2()) {
+                size_t n;
+
+                n = ascii_prefix_sse2(s + i, MIN(string_len - i, buffer_len - j));
+                memcpy(buffer + j, s + i, n);
+                i += n;
+                j += n;
+            }
+#endif /* HAVE_X86_SIMD */
+            // the ASCII characters left before the next non-ASCII one
+            for (; i < string_len && s[i] < 0x80; i++) {
+                if (j >= buffer_len) {
+                    RETURN(UNI_ERR_BUFFER_OVERFLOW);
+                }
+                buffer[j++] = (char) s[i];
+            }
+            continue;
+        }
+        if (buffer_len - j < 2) {
+            RETURN(UNI_ERR_BUFFER_OVERFLOW);
+        }
+        buffer[j++] = (char) (0xC0 | (s[i] >> 6));
+        buffer[j++] = (char) (0x80 | (s[i] & 0x3F));
+        i++;
+    }
+    RETURN(UNI_ERR_OK);
+}
+
+#undef RETURN
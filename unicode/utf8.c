@@ -1,5 +1,10 @@
+#include <assert.h>
+#include <string.h>
+
+#include "attributes.h"
 #include "utf8.h"
 #include "utils.h"
+#include "simd.h"
 
 #define U8(c) \
     ((uint8_t) (c))
@@ -198,46 +203,350 @@ php -r 'foreach (range(0x80, 0xBF) as $c) { if ($c == ($c & 0xF0)) echo PHP_EOL;
 };
 #endif /* PRECOMPUTED */
 
+/* ========== validation ========== */
+
+#ifdef HAVE_X86_SIMD
+/*
+ * Blocks are validated by looking at each byte along with the 3 previous
+ * ones (the end of the previous block for the first bytes), as described
+ * by John Keiser and Daniel Lemire in "Validating UTF-8 In Less Than One
+ * Instruction Per Byte": the high nibble of the previous byte, its low
+ * nibble and the high nibble of the current byte are used as indexes in
+ * 3 tables of 16 bytes, each entry being the set of errors which are
+ * possible for such a nibble. An error is found when the 3 sets intersect
+ * except for the 3rd and 4th bytes of a code point which are checked
+ * separately (must23).
+ *
+ * A block of ASCII characters following an other one is skipped.
+ */
+# define TOO_SHORT      (1 << 0) /* lead byte or ASCII followed by a lead byte: 11______ 0_______, 11______ 11______ */
+# define TOO_LONG       (1 << 1) /* ASCII followed by a continuation byte: 0_______ 10______ */
+# define OVERLONG_3     (1 << 2) /* 11100000 100_____ */
+# define TOO_LARGE      (1 << 3) /* above U+10FFFF: 11110100 1001____, 11110100 101_____, 11110101 1001____, ... */
+# define SURROGATE      (1 << 4) /* 11101101 101_____ */
+# define OVERLONG_2     (1 << 5) /* 1100000_ 10______ */
+# define TOO_LARGE_1000 (1 << 6) /* 11110101 1000____, 1111011_ 1000____, 11111___ 1000____ */
+# define OVERLONG_4     (1 << 6) /* 11110000 1000____ */
+# define TWO_CONTS      (1 << 7) /* 10______ 10______ */
+# define CARRY          (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+# define BYTE_1_HIGH \
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, \
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS, \
+    TOO_SHORT | OVERLONG_2, \
+    TOO_SHORT, \
+    TOO_SHORT | OVERLONG_3 | SURROGATE, \
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+
+# define BYTE_1_LOW \
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, \
+    CARRY | OVERLONG_2, \
+    CARRY, \
+    CARRY, \
+    CARRY | TOO_LARGE, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000
+
+# define BYTE_2_HIGH \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4, \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE, \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+
+/* returns the offset of the first block with an error or of the first unprocessed byte */
+# define VALIDATE(name, isa, vector, width, LOAD, SET1, TABLE, SHUFFLE, PREV, SRLI16, SUBS_EPU8, AND, OR, XOR, CMPEQ, MOVEMASK, FULL_MASK) \
+    static TARGET(isa) size_t validate_## name(const uint8_t *string, size_t string_len) \
+    { \
+        size_t i; \
+        vector previous, byte_1_high, byte_1_low, byte_2_high, low_nibble, zero; \
+        bool previous_ascii; \
+ \
+        byte_1_high = TABLE(BYTE_1_HIGH); \
+        byte_1_low = TABLE(BYTE_1_LOW); \
+        byte_2_high = TABLE(BYTE_2_HIGH); \
+        low_nibble = SET1(0x0F); \
+        zero = SET1(0); \
+        previous = zero; \
+        previous_ascii = true; \
+        for (i = 0; i + width <= string_len; i += width) { \
+            bool ascii; \
+            vector input, prev1, errors, must23; \
+ \
+            input = LOAD(string + i); \
+            ascii = 0 == MOVEMASK(input); \
+            if (!ascii || !previous_ascii) { \
+                prev1 = PREV(input, previous, 1); \
+                errors = AND( \
+                    AND( \
+                        SHUFFLE(byte_1_high, AND(SRLI16(prev1, 4), low_nibble)), \
+                        SHUFFLE(byte_1_low, AND(prev1, low_nibble)) \
+                    ), \
+                    SHUFFLE(byte_2_high, AND(SRLI16(input, 4), low_nibble)) \
+                ); \
+                must23 = OR(SUBS_EPU8(PREV(input, previous, 2), SET1(0xE0 - 0x80)), SUBS_EPU8(PREV(input, previous, 3), SET1(0xF0 - 0x80))); \
+                errors = XOR(errors, AND(must23, SET1((char) 0x80))); \
+                if (FULL_MASK != MOVEMASK(CMPEQ(errors, zero))) { \
+                    return i; \
+                } \
+            } \
+            previous = input; \
+            previous_ascii = ascii; \
+        } \
+ \
+        return i; \
+    }
+
+# define LOAD_SSSE3(p) _mm_loadu_si128((const __m128i *) (const void *) (p))
+# define TABLE_SSSE3(...) _mm_setr_epi8(__VA_ARGS__)
+# define PREV_SSSE3(input, previous, n) _mm_alignr_epi8((input), (previous), 16 - (n))
+
+# define LOAD_AVX2(p) _mm256_loadu_si256((const __m256i *) (const void *) (p))
+# define TABLE_AVX2(...) _mm256_setr_epi8(__VA_ARGS__, __VA_ARGS__)
+/* the n last bytes of previous then the 32 - n first of input (alignr works on each 128 bits lane) */
+# define PREV_AVX2(input, previous, n) _mm256_alignr_epi8((input), _mm256_permute2x128_si256((previous), (input), 0x21), 16 - (n))
+
+VALIDATE(ssse3, "ssse3", __m128i, 16, LOAD_SSSE3, _mm_set1_epi8, TABLE_SSSE3, _mm_shuffle_epi8, PREV_SSSE3, _mm_srli_epi16, _mm_subs_epu8, _mm_and_si128, _mm_or_si128, _mm_xor_si128, _mm_cmpeq_epi8, _mm_movemask_epi8, 0xFFFF)
+VALIDATE(avx2, "avx2", __m256i, 32, LOAD_AVX2, _mm256_set1_epi8, TABLE_AVX2, _mm256_shuffle_epi8, PREV_AVX2, _mm256_srli_epi16, _mm256_subs_epu8, _mm256_and_si256, _mm256_or_si256, _mm256_xor_si256, _mm256_cmpeq_epi8, _mm256_movemask_epi8, -1)
+
+# undef VALIDATE
+#endif /* HAVE_X86_SIMD */
+
+/*
+ * The length of a prefix of string which is known to be valid UTF-8 (and
+ * doesn't end in the middle of a code point): the blocks preceding the
+ * first one with an error are valid but the last of them may end with an
+ * incomplete code point which the next block was supposed to complete.
+ * So we step back to its lead byte, if any, and let the state machine
+ * resume from there to find the exact position of the error.
+ */
+static size_t utf8_valid_prefix(const uint8_t *string, size_t string_len)
+{
+    size_t i, j;
+
+    i = 0;
+#ifdef HAVE_X86_SIMD
+    if (CPU_HAS_AVX2()) {
+        i = validate_avx2(string, string_len);
+    } else if (CPU_HAS_SSSE3()) {
+        i = validate_ssse3(string, string_len);
+    }
+#endif /* HAVE_X86_SIMD */
+    for (j = 1; j <= 3 && j <= i; j++) {
+        if (string[i - j] < 0x80) {
+            break;
+        }
+        if (string[i - j] >= 0xC0) {
+            return i - j;
+        }
+    }
+
+    return i;
+}
+
+#define ONES UINT64_C(0x0101010101010101)
+#define HIGHS (ONES * 0x80)
+
+/*
+ * Run the state machine from *state over [s;string_end[, stopping right
+ * after the first invalid byte. Between two code points, ASCII characters
+ * are skipped 8 at a time. *lead is set to the first byte of the last
+ * code point started (left untouched if none was).
+ */
+static const uint8_t *utf8_run(int *state, const uint8_t *s, const uint8_t * const string_end, const uint8_t **lead)
+{
+    int st;
+
+    st = *state;
+    while (s < string_end) {
+        if (S(OK) == st) {
+            uint64_t w;
+
+            while (string_end - s >= (ptrdiff_t) sizeof(w)) {
+                memcpy(&w, s, sizeof(w));
+                if (0 != (w & HIGHS)) {
+                    break;
+                }
+                s += sizeof(w);
+            }
+            if (s == string_end) {
+                break;
+            }
+            *lead = s;
+        }
+        st = state_transition_table[st][*s++];
+        if (S(__) == st) {
+            break;
+        }
+    }
+    *state = st;
+
+    return s;
+}
+
 /**
  * Check if a string is a valid UTF-8 string
  *
  * @param string the string to check
  * @param string_len its length
- * @param errp, optionnal (NULL to ignore), to have a pointer on the first
- * invalid byte found in the string (*errp is set to NULL if none)
+ * @param errp, optionnal (NULL to ignore), set to the first byte which can't
+ * be accepted: the invalid byte or, if the string ends in the middle of a code
+ * point, the lead byte of this code point (*errp is set to NULL if none)
  *
  * @return true if the string is a valid
+ *
+ * @note to check a string received in several parts, see utf8_validator_feed
  */
 bool utf8_check(const char *string, size_t string_len, const char **errp)
 {
     int state;
-    const uint8_t *s;
-    const uint8_t * const string_end = (const uint8_t *) string + string_len;
+    const uint8_t *s, *lead;
 
+    lead = NULL;
     state = S(OK); // accept an empty string
-    for (s = (const uint8_t *) string; S(__) != state && s < string_end; s++) {
-        state = state_transition_table[state][*s];
-    }
+    s = (const uint8_t *) string + utf8_valid_prefix((const uint8_t *) string, string_len);
+    s = utf8_run(&state, s, (const uint8_t *) string + string_len, &lead);
     if (NULL != errp) {
         if (S(OK) == state) {
             *errp = NULL;
+        } else if (S(__) == state) {
+            // s points right after the rejected byte
+            *errp = (const char *) s - 1;
         } else {
-            *errp = (const char *) s;
+            // truncated: the code point started at lead
+            assert(NULL != lead);
+            *errp = (const char *) lead;
         }
     }
-#if 0
-    if (S(OK) != state) {
-        if (S(__) != state && s == string_end) {
-            return TRUNCATED;
+
+    return S(OK) == state;
+}
+
+/**
+ * Initialize a validator, to check a string received in several parts
+ *
+ * \code
+ *   ssize_t len;
+ *   size_t offset;
+ *   Utf8Validator v;
+ *   UnicodeError err;
+ *   char buffer[4096];
+ *
+ *   utf8_validator_init(&v);
+ *   while (0 < (len = read(fd, buffer, sizeof(buffer)))) {
+ *       if (UNI_ERR_OK != utf8_validator_feed(&v, buffer, len, &offset)) {
+ *           break;
+ *       }
+ *   }
+ *   if (UNI_ERR_OK != (err = utf8_validator_finish(&v, &offset))) {
+ *       // UNI_ERR_INVALID or UNI_ERR_TRUNCATED at offset
+ *   }
+ * \endcode
+ *
+ * @param validator the validator to initialize
+ */
+void utf8_validator_init(Utf8Validator *validator)
+{
+    assert(NULL != validator);
+
+    validator->state = S(OK);
+    validator->offset = validator->lead_offset = 0;
+}
+
+/**
+ * Check the next part of a string
+ *
+ * @param validator the validator
+ * @param string the part to check
+ * @param string_len its length
+ * @param offset, optionnal (NULL to ignore), set to the position, from the
+ * very first byte fed to the validator, of the first invalid byte if any
+ * (the same byte utf8_check points to with errp)
+ *
+ * @return UNI_ERR_INVALID if an invalid byte was found in this part or a
+ * previous one (the validator then ignores any further input) else
+ * UNI_ERR_OK. A code point split between this part and the next is not
+ * an error.
+ */
+UnicodeError utf8_validator_feed(Utf8Validator *validator, const char *string, size_t string_len, size_t *offset)
+{
+    const uint8_t *s, *lead;
+    const uint8_t * const string_end = (const uint8_t *) string + string_len;
+
+    assert(NULL != validator);
+    assert(NULL != string || 0 == string_len);
+
+    if (S(__) != validator->state) {
+        lead = NULL;
+        s = (const uint8_t *) string;
+        // first, complete the code point started by the previous part
+        if (S(OK) != validator->state) {
+            while (s < string_end && S(OK) != validator->state && S(__) != validator->state) {
+                validator->state = state_transition_table[validator->state][*s++];
+            }
+        }
+        if (S(OK) == validator->state) {
+            s += utf8_valid_prefix(s, string_end - s);
+            s = utf8_run(&validator->state, s, string_end, &lead);
+        }
+        if (NULL != lead) {
+            validator->lead_offset = validator->offset + (lead - (const uint8_t *) string);
+        }
+        if (S(__) == validator->state) {
+            // offset of the byte which was rejected, s points right after it
+            validator->offset += s - (const uint8_t *) string - 1;
         } else {
-            return INVALID;
+            validator->offset += string_len;
+        }
+    }
+    if (S(__) == validator->state) {
+        if (NULL != offset) {
+            *offset = validator->offset;
         }
+        return UNI_ERR_INVALID;
     } else {
-        return OK;
+        return UNI_ERR_OK;
+    }
+}
+
+/**
+ * Terminate the check of a string fed by parts
+ *
+ * @param validator the validator
+ * @param offset, optionnal (NULL to ignore), set on error to the position
+ * of the first invalid byte (UNI_ERR_INVALID) or of the first byte of the
+ * incomplete code point ending the string (UNI_ERR_TRUNCATED)
+ *
+ * @return UNI_ERR_OK if the whole string is valid UTF-8, UNI_ERR_INVALID
+ * or UNI_ERR_TRUNCATED if not
+ */
+UnicodeError utf8_validator_finish(Utf8Validator *validator, size_t *offset)
+{
+    assert(NULL != validator);
+
+    if (S(OK) == validator->state) {
+        return UNI_ERR_OK;
+    } else if (S(__) == validator->state) {
+        if (NULL != offset) {
+            *offset = validator->offset;
+        }
+        return UNI_ERR_INVALID;
+    } else {
+        if (NULL != offset) {
+            *offset = validator->lead_offset;
+        }
+        return UNI_ERR_TRUNCATED;
     }
-#else
-    return S(OK) == state;
-#endif
 }
 
 /**